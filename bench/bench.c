@@ -0,0 +1,91 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+b_rng_t b_rng_new(uint64_t seed) {
+    return (b_rng_t){.state = seed == 0 ? 0x9e3779b97f4a7c15 : seed};
+}
+
+uint64_t b_rng_next(b_rng_t *rng) {
+    // xorshift64*.
+    rng->state ^= rng->state >> 12;
+    rng->state ^= rng->state << 25;
+    rng->state ^= rng->state >> 27;
+    return rng->state * 0x2545f4914f6cdd1d;
+}
+
+uint64_t b_rng_below(b_rng_t *rng, uint64_t bound) {
+    return bound == 0 ? 0 : b_rng_next(rng) % bound;
+}
+
+uint64_t b_now_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000 + (uint64_t)now.tv_nsec;
+}
+
+size_t b_rss_bytes(void) {
+#if defined(__linux__)
+    FILE *statm = fopen("/proc/self/statm", "r");
+    if (statm != NULL) {
+        unsigned long size, resident;
+        int matched = fscanf(statm, "%lu %lu", &size, &resident);
+        fclose(statm);
+        if (matched == 2) {
+            return (size_t)resident * (size_t)sysconf(_SC_PAGESIZE);
+        }
+    }
+#endif
+    // Fall back to the peak RSS, which is the closest portable measure.
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#if defined(__APPLE__)
+    return (size_t)usage.ru_maxrss;
+#else
+    return (size_t)usage.ru_maxrss * 1024;
+#endif
+}
+
+size_t b_allocated_bytes(void) {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+#else
+    return 0;
+#endif
+}
+
+int b_run_isolated(void (*run)(void *context), void *context) {
+    fflush(stdout);
+    pid_t child = fork();
+    if (child < 0) {
+        return -1;
+    }
+    if (child == 0) {
+        run(context);
+        fflush(stdout);
+        _exit(0);
+    }
+    int status;
+    if (waitpid(child, &status, 0) != child) {
+        return -1;
+    }
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0 ? 0 : -1;
+}
@@ -0,0 +1,47 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef COLLECTC_BENCH_H_
+#define COLLECTC_BENCH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** A small, fast pseudorandom number generator for building workloads. */
+typedef struct b_rng {
+    uint64_t state;
+} b_rng_t;
+
+/** Returns a generator seeded with the given non-zero seed. */
+b_rng_t b_rng_new(uint64_t seed);
+
+/** Returns the next pseudorandom 64-bit value. */
+uint64_t b_rng_next(b_rng_t *rng);
+
+/** Returns a pseudorandom value in the range `[0, bound)`. */
+uint64_t b_rng_below(b_rng_t *rng, uint64_t bound);
+
+/** Returns a monotonic timestamp, in nanoseconds. */
+uint64_t b_now_ns(void);
+
+/**
+ * Returns the resident set size of this process, in bytes, or
+ * zero if the platform doesn't report it.
+ */
+size_t b_rss_bytes(void);
+
+/**
+ * Returns the number of bytes that the allocator reports as in use,
+ * including its own per-chunk overhead, or zero if the platform
+ * doesn't report it.
+ */
+size_t b_allocated_bytes(void);
+
+/**
+ * Runs a function in a child process, so that each measurement
+ * starts with a fresh heap. Returns `0` if the child exited cleanly.
+ */
+int b_run_isolated(void (*run)(void *context), void *context);
+
+#endif // COLLECTC_BENCH_H_
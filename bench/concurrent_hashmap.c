@@ -0,0 +1,155 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <collectc.h>
+
+#include "bench.h"
+
+/** The number of keys in the map, and the range that operations pick keys from. */
+#define KEY_COUNT 65536
+
+#define MAX_THREADS 64
+
+/** The baseline: a hash map behind a readers-writer lock. */
+typedef struct locked_map {
+    pthread_rwlock_t lock;
+    hashmap_t map;
+} locked_map_t;
+
+typedef struct concurrent_run {
+    size_t perThread;
+    /** The percentage of operations that are lookups; the rest are half inserts, half removals. */
+    unsigned readPercent;
+    concurrent_hashmap_t *map;
+    locked_map_t locked;
+} concurrent_run_t;
+
+typedef struct concurrent_thread {
+    concurrent_run_t *run;
+    size_t id;
+    uint64_t sum;
+} concurrent_thread_t;
+
+static void *work_concurrent(void *context) {
+    concurrent_thread_t *thread = context;
+    concurrent_run_t *run = thread->run;
+    b_rng_t rng = b_rng_new(thread->id + 1);
+    for (size_t i = 0; i < run->perThread; i++) {
+        uint64_t random = b_rng_next(&rng);
+        uint64_t key = (random >> 8) % KEY_COUNT;
+        uint64_t value = key;
+        if (random % 100 < run->readPercent) {
+            if (concurrent_hashmap_get(run->map, &key, &value)) {
+                thread->sum += value;
+            }
+        } else if (random & 128) {
+            concurrent_hashmap_insert(run->map, &key, &value);
+        } else {
+            concurrent_hashmap_remove(run->map, &key, NULL);
+        }
+    }
+    return NULL;
+}
+
+static void *work_locked(void *context) {
+    concurrent_thread_t *thread = context;
+    concurrent_run_t *run = thread->run;
+    locked_map_t *locked = &run->locked;
+    b_rng_t rng = b_rng_new(thread->id + 1);
+    for (size_t i = 0; i < run->perThread; i++) {
+        uint64_t random = b_rng_next(&rng);
+        uint64_t key = (random >> 8) % KEY_COUNT;
+        uint64_t value = key;
+        if (random % 100 < run->readPercent) {
+            pthread_rwlock_rdlock(&locked->lock);
+            const uint64_t *found = hashmap_get(&locked->map, &key);
+            if (found != NULL) {
+                thread->sum += *found;
+            }
+            pthread_rwlock_unlock(&locked->lock);
+        } else {
+            pthread_rwlock_wrlock(&locked->lock);
+            if (random & 128) {
+                hashmap_insert(&locked->map, &key, &value);
+            } else {
+                hashmap_remove(&locked->map, &key, NULL);
+            }
+            pthread_rwlock_unlock(&locked->lock);
+        }
+    }
+    return NULL;
+}
+
+/** Runs `threads` threads of random operations, and returns operations per second. */
+static double run_threads(concurrent_run_t *run, size_t threads, void *(*work)(void *)) {
+    pthread_t handles[MAX_THREADS];
+    concurrent_thread_t contexts[MAX_THREADS];
+    uint64_t start = b_now_ns();
+    for (size_t i = 0; i < threads; i++) {
+        contexts[i] = (concurrent_thread_t){.run = run, .id = i};
+        if (pthread_create(&handles[i], NULL, work, &contexts[i]) != 0) {
+            abort();
+        }
+    }
+    uint64_t sum = 0;
+    for (size_t i = 0; i < threads; i++) {
+        pthread_join(handles[i], NULL);
+        sum += contexts[i].sum;
+    }
+    uint64_t elapsedNs = b_now_ns() - start;
+    if (sum == 42) {
+        printf("#\n");
+    }
+    return threads * run->perThread * 1e9 / (double)elapsedNs;
+}
+
+void bench_concurrent_hashmap(double scale) {
+    static const size_t THREADS[] = {1, 2, 4, 8, 16, 32, MAX_THREADS};
+    static const unsigned READ_PERCENTS[] = {95, 50};
+
+    size_t operations = (size_t)(4000000 * scale) + 1;
+    printf("# concurrent_hashmap: %zu operations on %d 8-byte keys, split across N threads\n", operations, KEY_COUNT);
+    printf(
+        "%-8s %18s %18s %18s %18s\n",
+        "threads",
+        "rwlock 95% M op/s",
+        "conc. 95% M op/s",
+        "rwlock 50% M op/s",
+        "conc. 50% M op/s"
+    );
+    for (size_t t = 0; t < sizeof(THREADS) / sizeof(THREADS[0]); t++) {
+        size_t threads = THREADS[t];
+        double rates[4];
+        for (size_t m = 0; m < sizeof(READ_PERCENTS) / sizeof(READ_PERCENTS[0]); m++) {
+            concurrent_run_t run = {.perThread = operations / threads + 1, .readPercent = READ_PERCENTS[m]};
+
+            pthread_rwlock_init(&run.locked.lock, NULL);
+            run.locked.map = hashmap_new(sizeof(uint64_t), sizeof(uint64_t), NULL, NULL);
+            run.map = concurrent_hashmap_new(sizeof(uint64_t), sizeof(uint64_t), NULL, NULL);
+            for (uint64_t key = 0; key < KEY_COUNT; key++) {
+                hashmap_insert(&run.locked.map, &key, &key);
+                concurrent_hashmap_insert(run.map, &key, &key);
+            }
+            rates[m * 2] = run_threads(&run, threads, work_locked);
+            rates[m * 2 + 1] = run_threads(&run, threads, work_concurrent);
+            concurrent_hashmap_delete(run.map);
+            hashmap_delete(&run.locked.map);
+            pthread_rwlock_destroy(&run.locked.lock);
+        }
+        printf(
+            "%-8zu %18.1f %18.1f %18.1f %18.1f\n",
+            threads,
+            rates[0] / 1e6,
+            rates[1] / 1e6,
+            rates[2] / 1e6,
+            rates[3] / 1e6
+        );
+    }
+}
@@ -0,0 +1,87 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <collectc.h>
+
+#include "bench.h"
+
+/** Decodes the whole delta vector in chunks, and returns a checksum. */
+static uint64_t decode_all(const delta_vector_t *dv, uint64_t *chunk, size_t chunkLength) {
+    uint64_t sum = 0;
+    size_t length = delta_vector_len(dv);
+    for (size_t i = 0; i < length; i += chunkLength) {
+        size_t count = length - i < chunkLength ? length - i : chunkLength;
+        delta_vector_decode(dv, i, chunk, count);
+        for (size_t j = 0; j < count; j++) {
+            sum += chunk[j];
+        }
+    }
+    return sum;
+}
+
+void bench_delta_vector(double scale) {
+    static const size_t CHUNK_LENGTH = 4096;
+    static const struct {
+        const char *name;
+        uint64_t maxGap;
+    } SEQUENCES[] = {
+        {"postings", 16},
+        {"timestamps", 2000},
+        {"sparse", 1 << 20},
+    };
+
+    size_t length = (size_t)(20000000 * scale) + 1;
+    uint64_t *chunk = malloc(CHUNK_LENGTH * sizeof(uint64_t));
+    if (chunk == NULL) {
+        abort();
+    }
+
+    printf("# delta_vector: %zu sorted values per sequence\n", length);
+    printf("%-11s %10s %8s %12s %12s %12s\n", "sequence", "B/value", "ratio", "encode M/s", "decode M/s", "seek M/s");
+    for (size_t s = 0; s < sizeof(SEQUENCES) / sizeof(SEQUENCES[0]); s++) {
+        b_rng_t rng = b_rng_new(s + 1);
+        vector_t vec = vector_new(length, sizeof(uint64_t));
+        uint64_t value = 0;
+        for (size_t i = 0; i < length; i++) {
+            value += b_rng_below(&rng, SEQUENCES[s].maxGap + 1);
+            vector_push(&vec, &value, 1);
+        }
+
+        uint64_t start = b_now_ns();
+        delta_vector_t dv = delta_vector_from_vector(vec);
+        uint64_t encodeNs = b_now_ns() - start;
+
+        start = b_now_ns();
+        uint64_t sum = decode_all(&dv, chunk, CHUNK_LENGTH);
+        uint64_t decodeNs = b_now_ns() - start;
+
+        size_t seeks = length / 16;
+        start = b_now_ns();
+        for (size_t i = 0; i < seeks; i++) {
+            sum += delta_vector_lower_bound(&dv, b_rng_below(&rng, value + 1));
+        }
+        uint64_t seekNs = b_now_ns() - start;
+
+        double bytesPerValue = (double)delta_vector_allocation_size(&dv) / (double)length;
+        printf(
+            "%-11s %10.2f %8.2f %12.1f %12.1f %12.2f\n",
+            SEQUENCES[s].name,
+            bytesPerValue,
+            (double)vector_allocation_size(vec) / (double)delta_vector_allocation_size(&dv),
+            length * 1e3 / (double)encodeNs,
+            length * 1e3 / (double)decodeNs,
+            seeks * 1e3 / (double)seekNs
+        );
+        if (sum == 0) {
+            fprintf(stderr, "delta_vector: unexpected checksum\n");
+        }
+
+        delta_vector_delete(&dv);
+        vector_delete(vec);
+    }
+    free(chunk);
+}
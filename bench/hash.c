@@ -0,0 +1,146 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <collectc.h>
+
+#include "bench.h"
+
+/** The size of the keys in the hash map part of the benchmark. */
+#define KEY_SIZE 32
+
+typedef uint64_t (*byte_hash_t)(const void *data, size_t size);
+
+/**
+ * The byte hash that hash maps used before `hash_bytes`: one multiply
+ * per word, in a single dependent chain, then a 64-bit finalizer.
+ */
+static uint64_t word_mixer(const void *data, size_t size) {
+    const unsigned char *bytes = data;
+    uint64_t hash = 0x9e3779b97f4a7c15 ^ size;
+    uint64_t word;
+    for (; size >= sizeof(word); bytes += sizeof(word), size -= sizeof(word)) {
+        memcpy(&word, bytes, sizeof(word));
+        hash = (hash ^ word) * 0xbf58476d1ce4e5b9;
+        hash ^= hash >> 31;
+    }
+    if (size > 0) {
+        word = 0;
+        memcpy(&word, bytes, size);
+        hash = (hash ^ word) * 0xbf58476d1ce4e5b9;
+    }
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccd;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+static uint64_t seeded_hash(const void *data, size_t size) {
+    return hash_bytes(data, size, 0);
+}
+
+static uint64_t crc32c(const void *data, size_t size) {
+    return hash_crc32c(data, size, 0);
+}
+
+static uint64_t hash_key_with_word_mixer(const void *key) {
+    return word_mixer(key, KEY_SIZE);
+}
+
+/**
+ * Returns the nanoseconds per hash of `size` bytes, hashing inputs at
+ * different offsets of a buffer so that no two calls see the same input.
+ */
+static double time_hash(byte_hash_t hash, const unsigned char *buffer, size_t size, size_t hashes) {
+    // Calling through a volatile pointer keeps the compiler from inlining
+    // the word mixer, which the library's hashes can't be.
+    byte_hash_t volatile call = hash;
+    uint64_t sink = 0;
+    uint64_t start = b_now_ns();
+    for (size_t i = 0; i < hashes; i++) {
+        sink ^= call(buffer + (i & 63), size);
+    }
+    double ns = (b_now_ns() - start) / (double)hashes;
+    if (sink == 42) {
+        printf("#\n");
+    }
+    return ns;
+}
+
+typedef struct lookup_run {
+    const char *name;
+    hashmap_hash_t hash;
+    size_t entries;
+    size_t lookups;
+} lookup_run_t;
+
+/** Looks up random keys in a map, and prints the nanoseconds per lookup. */
+static void time_lookups(void *context) {
+    const lookup_run_t *run = context;
+    hashmap_t map = hashmap_new(KEY_SIZE, 0, run->hash, NULL);
+    unsigned char key[KEY_SIZE] = {0};
+    for (size_t i = 0; i < run->entries; i++) {
+        memcpy(key, &i, sizeof(i));
+        hashmap_insert(&map, key, NULL);
+    }
+    b_rng_t rng = b_rng_new(1);
+    size_t found = 0;
+    uint64_t start = b_now_ns();
+    for (size_t i = 0; i < run->lookups; i++) {
+        size_t index = b_rng_below(&rng, run->entries);
+        memcpy(key, &index, sizeof(index));
+        found += hashmap_contains(&map, key);
+    }
+    double ns = (b_now_ns() - start) / (double)run->lookups;
+    if (found != run->lookups) {
+        fprintf(stderr, "hash: found %zu of %zu\n", found, run->lookups);
+    }
+    printf("%-14s %8zu %12.1f\n", run->name, run->entries, ns);
+    hashmap_delete(&map);
+}
+
+void bench_hash(double scale) {
+    static const size_t SIZES[] = {8, 16, 32, 64, 256, 4096, 65536};
+    static const char *NAMES[] = {"word mixer", "hash_bytes", "hash_crc32c"};
+    static const byte_hash_t HASHES[] = {word_mixer, seeded_hash, crc32c};
+    size_t totalBytes = (size_t)(2000000000 * scale) + 1;
+    unsigned char *buffer = malloc(SIZES[sizeof(SIZES) / sizeof(SIZES[0]) - 1] + 64);
+    if (buffer == NULL) {
+        abort();
+    }
+    b_rng_t rng = b_rng_new(1);
+    for (size_t i = 0; i < SIZES[sizeof(SIZES) / sizeof(SIZES[0]) - 1] + 64; i++) {
+        buffer[i] = (unsigned char)b_rng_next(&rng);
+    }
+
+    printf("# hash: bytes hashed from a buffer, and 32-byte hash map keys\n");
+    printf("%-14s %8s %12s %10s\n", "hash", "bytes", "ns/hash", "GB/s");
+    for (size_t s = 0; s < sizeof(SIZES) / sizeof(SIZES[0]); s++) {
+        size_t size = SIZES[s];
+        size_t hashes = totalBytes / size / 8 + 1;
+        for (size_t h = 0; h < sizeof(HASHES) / sizeof(HASHES[0]); h++) {
+            double ns = time_hash(HASHES[h], buffer, size, hashes);
+            printf("%-14s %8zu %12.2f %10.2f\n", NAMES[h], size, ns, size / ns);
+        }
+    }
+    free(buffer);
+
+    // Each map runs in a fresh process, so that neither reuses pages
+    // that the other faulted in.
+    size_t entries = (size_t)(1000000 * scale) + 1;
+    size_t lookups = (size_t)(4000000 * scale) + 1;
+    lookup_run_t runs[] = {
+        {.name = "word mixer", .hash = hash_key_with_word_mixer, .entries = entries, .lookups = lookups},
+        {.name = "hash_bytes", .hash = NULL, .entries = entries, .lookups = lookups},
+    };
+    printf("%-14s %8s %12s\n", "map hash", "entries", "lookup ns");
+    for (size_t r = 0; r < sizeof(runs) / sizeof(runs[0]); r++) {
+        if (b_run_isolated(time_lookups, &runs[r]) != 0) {
+            fprintf(stderr, "hash: run failed\n");
+        }
+    }
+}
@@ -0,0 +1,216 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <collectc.h>
+
+#include "bench.h"
+
+/** The largest map that the sorted vector baseline is built for. */
+#define SORTED_MAX_ENTRIES 1000000
+
+/**
+ * Returns the `i`th key. This is a bijection, so keys `[0, n)` are all
+ * different, and keys from `n` on are all misses.
+ */
+static uint64_t bench_key(uint64_t i) {
+    i = (i ^ (i >> 30)) * 0xbf58476d1ce4e5b9;
+    i = (i ^ (i >> 27)) * 0x94d049bb133111eb;
+    return i ^ (i >> 31);
+}
+
+static int compare_keys(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+void bench_hashmap(double scale) {
+    static const size_t SIZES[] = {1000, 10000, 100000, 1000000, 10000000, 100000000};
+    size_t lookups = (size_t)(4000000 * scale) + 1;
+
+    printf("# hashmap: 8-byte keys and values, random hit and miss lookups\n");
+    printf("%-14s %10s %12s %12s %12s\n", "map", "entries", "insert ns", "hit ns", "miss ns");
+    for (size_t s = 0; s < sizeof(SIZES) / sizeof(SIZES[0]); s++) {
+        // The scale limits the largest map, rather than shrinking them all.
+        size_t entries = SIZES[s];
+        if (s > 0 && entries > SIZES[sizeof(SIZES) / sizeof(SIZES[0]) - 1] * scale) {
+            break;
+        }
+
+        if (entries <= SORTED_MAX_ENTRIES) {
+            // The baseline: a sorted vector of keys, searched with `bsearch`.
+            vector_t sorted = vector_new(entries, sizeof(uint64_t));
+            uint64_t start = b_now_ns();
+            for (size_t i = 0; i < entries; i++) {
+                uint64_t key = bench_key(i);
+                vector_push(&sorted, &key, 1);
+            }
+            qsort(vector_at_mut(sorted, 0), entries, sizeof(uint64_t), compare_keys);
+            uint64_t insertNs = b_now_ns() - start;
+
+            b_rng_t rng = b_rng_new(1);
+            size_t found = 0;
+            start = b_now_ns();
+            for (size_t i = 0; i < lookups; i++) {
+                uint64_t key = bench_key(b_rng_below(&rng, entries));
+                found += bsearch(&key, vector_first(sorted), entries, sizeof(uint64_t), compare_keys) != NULL;
+            }
+            uint64_t hitNs = b_now_ns() - start;
+            start = b_now_ns();
+            for (size_t i = 0; i < lookups; i++) {
+                uint64_t key = bench_key(entries + b_rng_below(&rng, entries));
+                found += bsearch(&key, vector_first(sorted), entries, sizeof(uint64_t), compare_keys) != NULL;
+            }
+            uint64_t missNs = b_now_ns() - start;
+            if (found != lookups) {
+                fprintf(stderr, "hashmap: sorted vector found %zu of %zu\n", found, lookups);
+            }
+            printf(
+                "%-14s %10zu %12.1f %12.1f %12.1f\n",
+                "sorted vector",
+                entries,
+                insertNs / (double)entries,
+                hitNs / (double)lookups,
+                missNs / (double)lookups
+            );
+            vector_delete(sorted);
+        }
+
+        hashmap_t map = hashmap_new(sizeof(uint64_t), sizeof(uint64_t), NULL, NULL);
+        uint64_t start = b_now_ns();
+        for (size_t i = 0; i < entries; i++) {
+            uint64_t key = bench_key(i);
+            hashmap_insert(&map, &key, &i);
+        }
+        uint64_t insertNs = b_now_ns() - start;
+
+        b_rng_t rng = b_rng_new(1);
+        size_t found = 0;
+        start = b_now_ns();
+        for (size_t i = 0; i < lookups; i++) {
+            uint64_t key = bench_key(b_rng_below(&rng, entries));
+            found += hashmap_get(&map, &key) != NULL;
+        }
+        uint64_t hitNs = b_now_ns() - start;
+        start = b_now_ns();
+        for (size_t i = 0; i < lookups; i++) {
+            uint64_t key = bench_key(entries + b_rng_below(&rng, entries));
+            found += hashmap_get(&map, &key) != NULL;
+        }
+        uint64_t missNs = b_now_ns() - start;
+        if (found != lookups) {
+            fprintf(stderr, "hashmap: found %zu of %zu\n", found, lookups);
+        }
+        printf(
+            "%-14s %10zu %12.1f %12.1f %12.1f\n",
+            "hashmap",
+            entries,
+            insertNs / (double)entries,
+            hitNs / (double)lookups,
+            missNs / (double)lookups
+        );
+        hashmap_delete(&map);
+    }
+}
+
+typedef struct latency_run {
+    bool incremental;
+    size_t entries;
+} latency_run_t;
+
+/** Returns the `fraction` percentile of sorted latencies. */
+static uint64_t percentile(const uint64_t *sorted, size_t length, double fraction) {
+    size_t index = (size_t)(fraction * (length - 1));
+    return sorted[index];
+}
+
+/**
+ * Inserts keys one at a time, timing each insert, and a lookup of a random
+ * key that's already in the map after it, then prints percentiles of both.
+ */
+static void time_latencies(void *context) {
+    const latency_run_t *run = context;
+    hashmap_t map = run->incremental ? hashmap_new_incremental(sizeof(uint64_t), sizeof(uint64_t), NULL, NULL)
+                                     : hashmap_new(sizeof(uint64_t), sizeof(uint64_t), NULL, NULL);
+    uint64_t *inserts = malloc(run->entries * sizeof(uint64_t));
+    uint64_t *lookups = malloc(run->entries * sizeof(uint64_t));
+    if (inserts == NULL || lookups == NULL) {
+        abort();
+    }
+    b_rng_t rng = b_rng_new(1);
+    size_t found = 0;
+    uint64_t totalStart = b_now_ns();
+    for (size_t i = 0; i < run->entries; i++) {
+        uint64_t key = bench_key(i);
+        uint64_t start = b_now_ns();
+        hashmap_insert(&map, &key, &i);
+        uint64_t end = b_now_ns();
+        inserts[i] = end - start;
+        key = bench_key(b_rng_below(&rng, i + 1));
+        start = b_now_ns();
+        found += hashmap_get(&map, &key) != NULL;
+        lookups[i] = b_now_ns() - start;
+    }
+    double totalMs = (b_now_ns() - totalStart) / 1e6;
+    if (found != run->entries) {
+        fprintf(stderr, "hashmap: found %zu of %zu\n", found, run->entries);
+    }
+    qsort(inserts, run->entries, sizeof(uint64_t), compare_keys);
+    qsort(lookups, run->entries, sizeof(uint64_t), compare_keys);
+    const char *name = run->incremental ? "incremental" : "hashmap";
+    uint64_t *latencies[] = {inserts, lookups};
+    const char *operations[] = {"insert", "lookup"};
+    for (size_t o = 0; o < 2; o++) {
+        printf(
+            "%-12s %-7s %10zu %8llu %8llu %8llu %10llu %12llu %10.1f\n",
+            name,
+            operations[o],
+            run->entries,
+            (unsigned long long)percentile(latencies[o], run->entries, 0.5),
+            (unsigned long long)percentile(latencies[o], run->entries, 0.99),
+            (unsigned long long)percentile(latencies[o], run->entries, 0.999),
+            (unsigned long long)percentile(latencies[o], run->entries, 0.99999),
+            (unsigned long long)latencies[o][run->entries - 1],
+            totalMs
+        );
+    }
+    free(inserts);
+    free(lookups);
+    hashmap_delete(&map);
+}
+
+void bench_hashmap_latency(double scale) {
+    static const size_t SIZES[] = {100000, 1000000, 10000000};
+
+    printf("# hashmap_latency: ns per insert and per lookup while a map of 8-byte keys and values grows\n");
+    printf(
+        "%-12s %-7s %10s %8s %8s %8s %10s %12s %10s\n",
+        "map",
+        "op",
+        "entries",
+        "p50",
+        "p99",
+        "p99.9",
+        "p99.999",
+        "max",
+        "total ms"
+    );
+    for (size_t s = 0; s < sizeof(SIZES) / sizeof(SIZES[0]); s++) {
+        size_t entries = SIZES[s];
+        if (s > 0 && entries > SIZES[sizeof(SIZES) / sizeof(SIZES[0]) - 1] * scale) {
+            break;
+        }
+        // Each map runs in a fresh process, so that neither reuses pages
+        // that the other faulted in.
+        for (int incremental = 0; incremental < 2; incremental++) {
+            latency_run_t run = {.incremental = incremental, .entries = entries};
+            if (b_run_isolated(time_latencies, &run) != 0) {
+                fprintf(stderr, "hashmap: run failed\n");
+            }
+        }
+    }
+}
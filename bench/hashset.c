@@ -0,0 +1,69 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <collectc.h>
+
+#include "bench.h"
+
+typedef struct dedup_run {
+    vector_t elements;
+    /** Whether to build the set with `hashset_from_vector`, or insert each element. */
+    bool fromVector;
+} dedup_run_t;
+
+static void dedup(void *context) {
+    const dedup_run_t *run = context;
+    size_t length = vector_len(run->elements);
+    uint64_t start = b_now_ns();
+    hashset_t set;
+    if (run->fromVector) {
+        set = hashset_from_vector(run->elements, NULL, NULL);
+    } else {
+        set = hashset_new(sizeof(uint64_t), NULL, NULL);
+        for (size_t i = 0; i < length; i++) {
+            hashset_insert(&set, vector_at(run->elements, i));
+        }
+    }
+    vector_t unique = hashset_to_vector(&set);
+    uint64_t elapsedNs = b_now_ns() - start;
+    printf(
+        "%-16s %10zu %12.1f\n",
+        run->fromVector ? "from vector" : "insert each",
+        vector_len(unique),
+        elapsedNs / (double)length
+    );
+    vector_delete(unique);
+    hashset_delete(&set);
+}
+
+void bench_hashset(double scale) {
+    size_t length = (size_t)(4000000 * scale) + 1;
+    printf("# hashset: deduplicate a vector of %zu 8-byte elements\n", length);
+    printf("%-16s %10s %12s\n", "build", "unique", "ns/element");
+
+    // Draw the elements from a range as long as the vector, so that about
+    // a third are duplicates, and then from a range so large that almost
+    // none are.
+    static const uint64_t RANGES[] = {1, 1000};
+    for (size_t r = 0; r < sizeof(RANGES) / sizeof(RANGES[0]); r++) {
+        b_rng_t rng = b_rng_new(1);
+        vector_t elements = vector_new(length, sizeof(uint64_t));
+        for (size_t i = 0; i < length; i++) {
+            uint64_t value = b_rng_below(&rng, length * RANGES[r]);
+            vector_push(&elements, &value, 1);
+        }
+        // Each build runs in a fresh process, so that neither
+        // reuses pages that the other faulted in.
+        for (int fromVector = 0; fromVector <= 1; fromVector++) {
+            dedup_run_t run = {.elements = elements, .fromVector = fromVector};
+            if (b_run_isolated(dedup, &run) != 0) {
+                fprintf(stderr, "hashset: run failed\n");
+            }
+        }
+        vector_delete(elements);
+    }
+}
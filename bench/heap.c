@@ -0,0 +1,120 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <collectc.h>
+
+#include "bench.h"
+
+/** A timer queue entry. */
+typedef struct bench_timer {
+    uint64_t deadline;
+    uint64_t id;
+} bench_timer_t;
+
+static int compare_timers(const void *a, const void *b) {
+    uint64_t x = ((const bench_timer_t *)a)->deadline;
+    uint64_t y = ((const bench_timer_t *)b)->deadline;
+    return (x > y) - (x < y);
+}
+
+/** Finds where a timer belongs in a sorted vector, by binary search. */
+static size_t sorted_position(vector_t vec, uint64_t deadline) {
+    size_t low = 0;
+    size_t high = vector_len(vec);
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (((const bench_timer_t *)vector_at(vec, middle))->deadline < deadline) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+void bench_heap(double scale) {
+    size_t length = (size_t)(4000000 * scale) + 1;
+    size_t sortedLength = length / 40 + 1;
+
+    printf("# heap: push, then pop, random 16-byte timers\n");
+    printf("%-14s %10s %12s %12s %12s\n", "queue", "entries", "heapify ns", "push ns", "pop ns");
+
+    {
+        // The baseline: a vector kept sorted in descending order,
+        // so popping the earliest timer removes the last element.
+        b_rng_t rng = b_rng_new(1);
+        vector_t vec = vector_new(0, sizeof(bench_timer_t));
+        uint64_t start = b_now_ns();
+        for (size_t i = 0; i < sortedLength; i++) {
+            bench_timer_t timer = {.deadline = UINT64_MAX - b_rng_next(&rng), .id = i};
+            vector_insert(&vec, sorted_position(vec, timer.deadline), &timer, 1);
+        }
+        uint64_t pushNs = b_now_ns() - start;
+        start = b_now_ns();
+        uint64_t sum = 0;
+        while (!vector_is_empty(vec)) {
+            sum += ((const bench_timer_t *)vector_last(vec))->id;
+            vector_remove(vec, vector_len(vec) - 1, 1);
+        }
+        uint64_t popNs = b_now_ns() - start;
+        printf(
+            "%-14s %10zu %12s %12.1f %12.1f\n",
+            "sorted vector",
+            sortedLength,
+            "-",
+            pushNs / (double)sortedLength,
+            popNs / (double)sortedLength
+        );
+        vector_delete(vec);
+        if (sum == 0 && sortedLength > 1) {
+            fprintf(stderr, "heap: unexpected checksum\n");
+        }
+    }
+
+    static const size_t ARITIES[] = {2, 4};
+    for (size_t a = 0; a < sizeof(ARITIES) / sizeof(ARITIES[0]); a++) {
+        b_rng_t rng = b_rng_new(1);
+        heap_t heap = heap_new(sizeof(bench_timer_t), ARITIES[a], compare_timers);
+        uint64_t start = b_now_ns();
+        for (size_t i = 0; i < length; i++) {
+            bench_timer_t timer = {.deadline = b_rng_next(&rng), .id = i};
+            heap_push(&heap, &timer);
+        }
+        uint64_t pushNs = b_now_ns() - start;
+
+        start = b_now_ns();
+        uint64_t previous = 0;
+        bench_timer_t timer;
+        while (heap_pop(&heap, &timer)) {
+            if (timer.deadline < previous) {
+                fprintf(stderr, "heap: out of order\n");
+            }
+            previous = timer.deadline;
+        }
+        uint64_t popNs = b_now_ns() - start;
+        heap_delete(&heap);
+
+        vector_t vec = vector_new(length, sizeof(bench_timer_t));
+        for (size_t i = 0; i < length; i++) {
+            bench_timer_t random = {.deadline = b_rng_next(&rng), .id = i};
+            vector_push(&vec, &random, 1);
+        }
+        start = b_now_ns();
+        heap = heap_from_vector(vec, ARITIES[a], compare_timers);
+        uint64_t heapifyNs = b_now_ns() - start;
+        heap_delete(&heap);
+
+        printf(
+            "%-14s %10zu %12.1f %12.1f %12.1f\n",
+            ARITIES[a] == 2 ? "binary heap" : "4-ary heap",
+            length,
+            heapifyNs / (double)length,
+            pushNs / (double)length,
+            popNs / (double)length
+        );
+    }
+}
@@ -0,0 +1,171 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <collectc.h>
+
+#include "bench.h"
+
+/** The number of outgoing edges from each node. */
+#define DEGREE 8
+
+typedef struct edge {
+    uint32_t to;
+    uint32_t weight;
+} edge_t;
+
+/** A queued node for the lazy search, which may be stale. */
+typedef struct lazy_entry {
+    uint64_t distance;
+    size_t node;
+} lazy_entry_t;
+
+static int compare_distances(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Finds shortest paths by pushing a duplicate entry whenever a node's
+ * distance improves, and skipping stale entries when they're popped.
+ * Returns the sum of all distances, and the peak heap size.
+ */
+static uint64_t search_lazy(const edge_t *edges, size_t nodes, uint64_t *distances, size_t *peak) {
+    heap_t heap = heap_new(sizeof(lazy_entry_t), 4, compare_distances);
+    distances[0] = 0;
+    heap_push(&heap, &(lazy_entry_t){.distance = 0, .node = 0});
+    *peak = 1;
+    lazy_entry_t entry;
+    while (heap_pop(&heap, &entry)) {
+        if (entry.distance > distances[entry.node]) {
+            continue;
+        }
+        for (size_t i = 0; i < DEGREE; i++) {
+            const edge_t *edge = &edges[(entry.node * DEGREE) + i];
+            uint64_t distance = entry.distance + edge->weight;
+            if (distance < distances[edge->to]) {
+                distances[edge->to] = distance;
+                heap_push(&heap, &(lazy_entry_t){.distance = distance, .node = edge->to});
+            }
+        }
+        *peak = heap_len(&heap) > *peak ? heap_len(&heap) : *peak;
+    }
+    heap_delete(&heap);
+
+    uint64_t sum = 0;
+    for (size_t i = 0; i < nodes; i++) {
+        sum += distances[i];
+    }
+    return sum;
+}
+
+/** Finds shortest paths by decreasing the keys of queued nodes. */
+static uint64_t search_indexed(const edge_t *edges, size_t nodes, uint64_t *distances, size_t *peak) {
+    indexed_heap_t heap = indexed_heap_new(sizeof(uint64_t), 4, compare_distances);
+    distances[0] = 0;
+    indexed_heap_push(&heap, 0, &distances[0]);
+    *peak = 1;
+    size_t node;
+    uint64_t current;
+    while (indexed_heap_pop(&heap, &node, &current)) {
+        for (size_t i = 0; i < DEGREE; i++) {
+            const edge_t *edge = &edges[(node * DEGREE) + i];
+            uint64_t distance = current + edge->weight;
+            if (distance < distances[edge->to]) {
+                distances[edge->to] = distance;
+                if (indexed_heap_contains(&heap, edge->to)) {
+                    indexed_heap_decrease_key(&heap, edge->to, &distance);
+                } else {
+                    indexed_heap_push(&heap, edge->to, &distance);
+                }
+            }
+        }
+        *peak = indexed_heap_len(&heap) > *peak ? indexed_heap_len(&heap) : *peak;
+    }
+    indexed_heap_delete(&heap);
+
+    uint64_t sum = 0;
+    for (size_t i = 0; i < nodes; i++) {
+        sum += distances[i];
+    }
+    return sum;
+}
+
+/** Finds shortest paths like `search_lazy`, with a radix heap. */
+static uint64_t search_radix(const edge_t *edges, size_t nodes, uint64_t *distances, size_t *peak) {
+    radix_heap_t heap = radix_heap_new(sizeof(size_t));
+    distances[0] = 0;
+    size_t node = 0;
+    radix_heap_push(&heap, 0, &node);
+    *peak = 1;
+    uint64_t current;
+    while (radix_heap_pop(&heap, &current, &node)) {
+        if (current > distances[node]) {
+            continue;
+        }
+        for (size_t i = 0; i < DEGREE; i++) {
+            const edge_t *edge = &edges[(node * DEGREE) + i];
+            uint64_t distance = current + edge->weight;
+            if (distance < distances[edge->to]) {
+                distances[edge->to] = distance;
+                size_t to = edge->to;
+                radix_heap_push(&heap, distance, &to);
+            }
+        }
+        *peak = radix_heap_len(&heap) > *peak ? radix_heap_len(&heap) : *peak;
+    }
+    radix_heap_delete(&heap);
+
+    uint64_t sum = 0;
+    for (size_t i = 0; i < nodes; i++) {
+        sum += distances[i];
+    }
+    return sum;
+}
+
+void bench_indexed_heap(double scale) {
+    size_t nodes = (size_t)(1000000 * scale) + 1;
+    edge_t *edges = malloc(nodes * DEGREE * sizeof(edge_t));
+    uint64_t *distances = malloc(nodes * sizeof(uint64_t));
+    if (edges == NULL || distances == NULL) {
+        abort();
+    }
+    b_rng_t rng = b_rng_new(1);
+    for (size_t i = 0; i < nodes * DEGREE; i++) {
+        edges[i] = (edge_t){.to = (uint32_t)b_rng_below(&rng, nodes), .weight = (uint32_t)b_rng_below(&rng, 1000)};
+    }
+
+    printf("# indexed_heap: shortest paths on a random graph with %zu nodes and %zu edges\n", nodes, nodes * DEGREE);
+    printf("%-16s %10s %12s\n", "search", "ms", "peak queued");
+    static const struct {
+        const char *name;
+        uint64_t (*search)(const edge_t *edges, size_t nodes, uint64_t *distances, size_t *peak);
+    } SEARCHES[] = {
+        {"lazy heap", search_lazy},
+        {"decrease-key", search_indexed},
+        {"lazy radix heap", search_radix},
+    };
+    uint64_t expected = 0;
+    for (size_t s = 0; s < sizeof(SEARCHES) / sizeof(SEARCHES[0]); s++) {
+        for (size_t i = 0; i < nodes; i++) {
+            distances[i] = UINT64_MAX;
+        }
+        size_t peak;
+        uint64_t start = b_now_ns();
+        uint64_t sum = SEARCHES[s].search(edges, nodes, distances, &peak);
+        uint64_t elapsedNs = b_now_ns() - start;
+        if (s == 0) {
+            expected = sum;
+        } else if (sum != expected) {
+            fprintf(stderr, "indexed_heap: distances differ\n");
+        }
+        printf("%-16s %10.1f %12zu\n", SEARCHES[s].name, elapsedNs / 1e6, peak);
+    }
+
+    free(distances);
+    free(edges);
+}
@@ -0,0 +1,217 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <collectc.h>
+
+#include "bench.h"
+
+/** A 16-byte key, like a short field name in a JSON object. */
+typedef struct field_key {
+    char text[16];
+} field_key_t;
+
+/** A node of a separately-chained hash table, the baseline for a node-based map. */
+typedef struct chain_node {
+    struct chain_node *next;
+    field_key_t key;
+    uint64_t value;
+} chain_node_t;
+
+typedef struct chain_map {
+    chain_node_t **buckets;
+    size_t bucketCount;
+    size_t length;
+} chain_map_t;
+
+typedef enum map_kind {
+    MAP_KIND_INDEXMAP,
+    MAP_KIND_HASHMAP,
+    MAP_KIND_CHAINED,
+} map_kind_t;
+
+typedef struct scan_run {
+    map_kind_t kind;
+    size_t entries;
+    size_t lookups;
+} scan_run_t;
+
+static field_key_t field_key(size_t i) {
+    field_key_t key = {{0}};
+    snprintf(key.text, sizeof(key.text), "field%u", (unsigned)i);
+    return key;
+}
+
+static chain_node_t **chain_find(chain_map_t *map, const field_key_t *key) {
+    chain_node_t **link = &map->buckets[hash_bytes(key, sizeof(*key), 0) & (map->bucketCount - 1)];
+    while (*link != NULL && memcmp(&(*link)->key, key, sizeof(*key)) != 0) {
+        link = &(*link)->next;
+    }
+    return link;
+}
+
+static void chain_insert(chain_map_t *map, const field_key_t *key, uint64_t value) {
+    if (map->length + 1 > map->bucketCount) {
+        size_t bucketCount = map->bucketCount * 2;
+        chain_node_t **buckets = calloc(bucketCount, sizeof(chain_node_t *));
+        if (buckets == NULL) {
+            abort();
+        }
+        for (size_t b = 0; b < map->bucketCount; b++) {
+            for (chain_node_t *node = map->buckets[b], *next; node != NULL; node = next) {
+                next = node->next;
+                chain_node_t **link = &buckets[hash_bytes(&node->key, sizeof(node->key), 0) & (bucketCount - 1)];
+                node->next = *link;
+                *link = node;
+            }
+        }
+        free(map->buckets);
+        map->buckets = buckets;
+        map->bucketCount = bucketCount;
+    }
+    chain_node_t **link = chain_find(map, key);
+    if (*link == NULL) {
+        *link = malloc(sizeof(chain_node_t));
+        if (*link == NULL) {
+            abort();
+        }
+        (*link)->next = NULL;
+        (*link)->key = *key;
+        map->length++;
+    }
+    (*link)->value = value;
+}
+
+/**
+ * Builds a map of one kind, then prints the time to insert, to scan
+ * every entry, and to look up random keys, and the bytes allocated per entry.
+ */
+static void time_map(void *context) {
+    static const char *NAMES[] = {"indexmap", "hashmap", "chained (nodes)"};
+    const scan_run_t *run = context;
+    indexmap_t indexmap = indexmap_new(sizeof(field_key_t), sizeof(uint64_t), NULL, NULL);
+    hashmap_t hashmap = hashmap_new(sizeof(field_key_t), sizeof(uint64_t), NULL, NULL);
+    chain_map_t chained = {.buckets = calloc(16, sizeof(chain_node_t *)), .bucketCount = 16, .length = 0};
+    field_key_t *keys = malloc(run->entries * sizeof(field_key_t));
+    if (chained.buckets == NULL || keys == NULL) {
+        abort();
+    }
+    for (size_t i = 0; i < run->entries; i++) {
+        keys[i] = field_key(i);
+    }
+
+    size_t baseAllocated = b_allocated_bytes();
+    uint64_t start = b_now_ns();
+    for (size_t i = 0; i < run->entries; i++) {
+        uint64_t value = i;
+        switch (run->kind) {
+        case MAP_KIND_INDEXMAP:
+            indexmap_insert(&indexmap, &keys[i], &value);
+            break;
+        case MAP_KIND_HASHMAP:
+            hashmap_insert(&hashmap, &keys[i], &value);
+            break;
+        case MAP_KIND_CHAINED:
+            chain_insert(&chained, &keys[i], value);
+            break;
+        }
+    }
+    double insertNs = (b_now_ns() - start) / (double)run->entries;
+    double bytesPerEntry = (b_allocated_bytes() - baseAllocated) / (double)run->entries;
+
+    // Scan the entries a few times, summing their values.
+    static const size_t SCANS = 10;
+    uint64_t sum = 0;
+    start = b_now_ns();
+    for (size_t s = 0; s < SCANS; s++) {
+        switch (run->kind) {
+        case MAP_KIND_INDEXMAP: {
+            indexmap_iter_t iter = indexmap_iter_new(&indexmap);
+            const void *key;
+            void *value;
+            while (indexmap_iter_next(&iter, &key, &value)) {
+                sum += *(const uint64_t *)value;
+            }
+            break;
+        }
+        case MAP_KIND_HASHMAP: {
+            hashmap_iter_t iter = hashmap_iter_new(&hashmap);
+            const void *key;
+            void *value;
+            while (hashmap_iter_next(&iter, &key, &value)) {
+                sum += *(const uint64_t *)value;
+            }
+            break;
+        }
+        case MAP_KIND_CHAINED:
+            for (size_t b = 0; b < chained.bucketCount; b++) {
+                for (const chain_node_t *node = chained.buckets[b]; node != NULL; node = node->next) {
+                    sum += node->value;
+                }
+            }
+            break;
+        }
+    }
+    double scanNs = (b_now_ns() - start) / (double)(SCANS * run->entries);
+
+    b_rng_t rng = b_rng_new(1);
+    size_t found = 0;
+    start = b_now_ns();
+    for (size_t i = 0; i < run->lookups; i++) {
+        const field_key_t *key = &keys[b_rng_below(&rng, run->entries)];
+        switch (run->kind) {
+        case MAP_KIND_INDEXMAP:
+            found += indexmap_get(&indexmap, key) != NULL;
+            break;
+        case MAP_KIND_HASHMAP:
+            found += hashmap_get(&hashmap, key) != NULL;
+            break;
+        case MAP_KIND_CHAINED:
+            found += *chain_find(&chained, key) != NULL;
+            break;
+        }
+    }
+    double lookupNs = (b_now_ns() - start) / (double)run->lookups;
+    if (found != run->lookups || sum != SCANS * (run->entries * (run->entries - 1) / 2)) {
+        fprintf(stderr, "indexmap: %s found %zu of %zu\n", NAMES[run->kind], found, run->lookups);
+    }
+    printf(
+        "%-16s %10zu %10.1f %10.2f %10.1f %10.1f\n",
+        NAMES[run->kind],
+        run->entries,
+        insertNs,
+        scanNs,
+        lookupNs,
+        bytesPerEntry
+    );
+    // The process exits after each run, so the chained nodes aren't freed.
+    indexmap_delete(&indexmap);
+    hashmap_delete(&hashmap);
+    free(keys);
+}
+
+void bench_indexmap(double scale) {
+    static const size_t SIZES[] = {1000, 100000, 1000000};
+    size_t lookups = (size_t)(2000000 * scale) + 1;
+
+    printf("# indexmap: 16-byte keys and 8-byte values; insert, full scans, random lookups\n");
+    printf("%-16s %10s %10s %10s %10s %10s\n", "map", "entries", "insert ns", "scan ns", "lookup ns", "bytes/ent");
+    for (size_t s = 0; s < sizeof(SIZES) / sizeof(SIZES[0]); s++) {
+        size_t entries = SIZES[s];
+        if (s > 0 && entries > SIZES[sizeof(SIZES) / sizeof(SIZES[0]) - 1] * scale) {
+            break;
+        }
+        // Each map runs in a fresh process, so that allocation counts
+        // start from the same heap.
+        for (map_kind_t kind = MAP_KIND_INDEXMAP; kind <= MAP_KIND_CHAINED; kind++) {
+            scan_run_t run = {.kind = kind, .entries = entries, .lookups = lookups};
+            if (b_run_isolated(time_map, &run) != 0) {
+                fprintf(stderr, "indexmap: run failed\n");
+            }
+        }
+    }
+}
@@ -0,0 +1,77 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+extern void bench_memory(double scale);
+extern void bench_compact(double scale);
+extern void bench_delta_vector(double scale);
+extern void bench_rope(double scale);
+extern void bench_spsc_queue(double scale);
+extern void bench_mpmc_queue(double scale);
+extern void bench_heap(double scale);
+extern void bench_indexed_heap(double scale);
+extern void bench_radix_heap(double scale);
+extern void bench_hashmap(double scale);
+extern void bench_hashmap_latency(double scale);
+extern void bench_hashset(double scale);
+extern void bench_u64map(double scale);
+extern void bench_hash(double scale);
+extern void bench_indexmap(double scale);
+extern void bench_vector_latency(double scale);
+extern void bench_concurrent_hashmap(double scale);
+
+static const struct {
+    const char *name;
+    void (*run)(double scale);
+} BENCHMARKS[] = {
+    {"memory", bench_memory},
+    {"compact", bench_compact},
+    {"delta_vector", bench_delta_vector},
+    {"rope", bench_rope},
+    {"spsc_queue", bench_spsc_queue},
+    {"mpmc_queue", bench_mpmc_queue},
+    {"heap", bench_heap},
+    {"indexed_heap", bench_indexed_heap},
+    {"radix_heap", bench_radix_heap},
+    {"hashmap", bench_hashmap},
+    {"hashmap_latency", bench_hashmap_latency},
+    {"hashset", bench_hashset},
+    {"u64map", bench_u64map},
+    {"hash", bench_hash},
+    {"indexmap", bench_indexmap},
+    {"vector_latency", bench_vector_latency},
+    {"concurrent_hashmap", bench_concurrent_hashmap},
+};
+
+static const size_t BENCHMARK_COUNT = sizeof(BENCHMARKS) / sizeof(BENCHMARKS[0]);
+
+int main(int argc, char **argv) {
+    const char *name = argc > 1 ? argv[1] : NULL;
+    double scale = argc > 2 ? strtod(argv[2], NULL) : 1.0;
+    if (scale <= 0) {
+        scale = 1.0;
+    }
+
+    bool found = false;
+    for (size_t i = 0; i < BENCHMARK_COUNT; i++) {
+        if (name == NULL || strcmp(name, BENCHMARKS[i].name) == 0) {
+            BENCHMARKS[i].run(scale);
+            found = true;
+        }
+    }
+    if (!found) {
+        fprintf(stderr, "usage: %s [mode] [scale]\nmodes:", argv[0]);
+        for (size_t i = 0; i < BENCHMARK_COUNT; i++) {
+            fprintf(stderr, " %s", BENCHMARKS[i].name);
+        }
+        fprintf(stderr, "\n");
+        return 1;
+    }
+
+    return 0;
+}
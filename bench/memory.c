@@ -0,0 +1,269 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#include <collectc.h>
+
+#include "bench.h"
+
+/** How a workload sizes its vectors. */
+typedef enum growth {
+    /** Start empty, and let `vector_push` grow each vector. */
+    GROWTH_PUSH,
+    /** Create each vector with the capacity it'll eventually need. */
+    GROWTH_PRESIZED,
+} growth_t;
+
+/** How the allocator is tuned before building a workload. */
+typedef enum allocator {
+    ALLOCATOR_DEFAULT,
+    /** Return freed memory to the OS eagerly, and don't pad the heap. */
+    ALLOCATOR_TRIM,
+    /** Serve every allocation from the heap, even huge ones. */
+    ALLOCATOR_NO_MMAP,
+} allocator_t;
+
+/** Which kind of vector a workload creates. */
+typedef enum kind {
+    KIND_REGULAR,
+    KIND_COMPACT,
+} kind_t;
+
+static const char *const GROWTH_NAMES[] = {"push", "presized"};
+static const char *const ALLOCATOR_NAMES[] = {"default", "trim", "no-mmap"};
+static const char *const KIND_NAMES[] = {"regular", "compact"};
+
+struct run;
+
+typedef struct workload {
+    const char *name;
+    size_t vectorCount;
+    size_t elementSize;
+    /** The most elements that the workload puts in a single vector. */
+    size_t maxLength;
+    /** Builds the population into `vecs`, and returns the number of elements. */
+    size_t (*build)(const struct run *run, vector_t *vecs);
+} workload_t;
+
+typedef struct run {
+    const workload_t *workload;
+    growth_t growth;
+    allocator_t allocator;
+    kind_t kind;
+} run_t;
+
+/** Creates an empty vector for a run, presizing it if the run asks to. */
+static vector_t run_new_vector(const run_t *run, size_t length) {
+    size_t capacity = run->growth == GROWTH_PRESIZED ? length : 0;
+    switch (run->kind) {
+    case KIND_COMPACT:
+        return vector_new_compact(capacity, run->workload->elementSize);
+    default:
+        return vector_new(capacity, run->workload->elementSize);
+    }
+}
+
+/** Lots of small vectors, like adjacency lists. */
+static size_t build_small(const run_t *run, vector_t *vecs) {
+    const workload_t *workload = run->workload;
+    b_rng_t rng = b_rng_new(1);
+    size_t elements = 0;
+    for (size_t i = 0; i < workload->vectorCount; i++) {
+        size_t length = 1 + b_rng_below(&rng, workload->maxLength);
+        vecs[i] = run_new_vector(run, length);
+        for (uint32_t j = 0; j < length; j++) {
+            vector_push(&vecs[i], &j, 1);
+        }
+        elements += length;
+    }
+    return elements;
+}
+
+/** A few huge vectors, each filled to a length that isn't a growth boundary. */
+static size_t build_huge(const run_t *run, vector_t *vecs) {
+    const workload_t *workload = run->workload;
+    size_t elements = 0;
+    for (size_t i = 0; i < workload->vectorCount; i++) {
+        size_t vectorLength = workload->maxLength - (workload->maxLength / 5) * i;
+        vecs[i] = run_new_vector(run, vectorLength);
+        for (uint64_t j = 0; j < vectorLength; j++) {
+            vector_push(&vecs[i], &j, 1);
+        }
+        elements += vectorLength;
+    }
+    return elements;
+}
+
+/**
+ * Random pushes and removes across many vectors, with a bounded length.
+ * Presized vectors reserve the bound up front.
+ */
+static size_t build_churn(const run_t *run, vector_t *vecs) {
+    const workload_t *workload = run->workload;
+    for (size_t i = 0; i < workload->vectorCount; i++) {
+        vecs[i] = run_new_vector(run, workload->maxLength);
+    }
+    b_rng_t rng = b_rng_new(2);
+    size_t elements = 0;
+    for (size_t op = 0; op < workload->vectorCount * 16; op++) {
+        vector_t *vec = &vecs[b_rng_below(&rng, workload->vectorCount)];
+        size_t length = vector_len(*vec);
+        bool push = length == 0 || (length < workload->maxLength && b_rng_below(&rng, 10) < 6);
+        if (push) {
+            uint32_t element = (uint32_t)op;
+            vector_push(vec, &element, 1);
+            elements++;
+        } else {
+            vector_remove(*vec, b_rng_below(&rng, length), 1);
+            elements--;
+        }
+    }
+    return elements;
+}
+
+static void configure_allocator(allocator_t allocator) {
+#if defined(__GLIBC__)
+    switch (allocator) {
+    case ALLOCATOR_DEFAULT:
+        break;
+    case ALLOCATOR_TRIM:
+        mallopt(M_TRIM_THRESHOLD, 0);
+        mallopt(M_TOP_PAD, 0);
+        break;
+    case ALLOCATOR_NO_MMAP:
+        mallopt(M_MMAP_MAX, 0);
+        break;
+    }
+#else
+    (void)allocator;
+#endif
+}
+
+static void measure(void *context) {
+    const run_t *run = context;
+    const workload_t *workload = run->workload;
+    configure_allocator(run->allocator);
+
+    vector_t *vecs = malloc(workload->vectorCount * sizeof(vector_t));
+    if (vecs == NULL) {
+        abort();
+    }
+    size_t baseAllocated = b_allocated_bytes();
+    size_t baseRss = b_rss_bytes();
+
+    uint64_t start = b_now_ns();
+    size_t elements = workload->build(run, vecs);
+    uint64_t elapsed = b_now_ns() - start;
+
+    size_t allocated = b_allocated_bytes() - baseAllocated;
+    size_t rss = b_rss_bytes() - baseRss;
+
+    // What the vectors asked the allocator for, split into the parts
+    // that hold elements, the spare capacity, and the headers.
+    size_t useful = elements * workload->elementSize;
+    size_t requested = 0;
+    for (size_t i = 0; i < workload->vectorCount; i++) {
+        requested += vector_allocation_size(vecs[i]);
+    }
+    size_t slack = 0;
+    for (size_t i = 0; i < workload->vectorCount; i++) {
+        slack += (vector_capacity(vecs[i]) - vector_len(vecs[i])) * workload->elementSize;
+    }
+    size_t headers = requested - useful - slack;
+
+    double mib = 1024.0 * 1024.0;
+    double perElement = elements == 0 ? 0 : (double)(allocated > 0 ? allocated : rss) / (double)elements;
+    printf(
+        "%-8s %-8s %-9s %-8s %11zu %10.1f %10.1f %10.1f %10.1f %8.2f %8.2f %8.2f %8.2f %8.0f\n",
+        workload->name,
+        KIND_NAMES[run->kind],
+        GROWTH_NAMES[run->growth],
+        ALLOCATOR_NAMES[run->allocator],
+        elements,
+        useful / mib,
+        requested / mib,
+        allocated / mib,
+        rss / mib,
+        perElement,
+        elements == 0 ? 0 : (double)headers / (double)elements,
+        elements == 0 ? 0 : (double)slack / (double)elements,
+        elements == 0 || allocated < requested ? 0 : (double)(allocated - requested) / (double)elements,
+        elapsed / 1e6
+    );
+
+    for (size_t i = 0; i < workload->vectorCount; i++) {
+        vector_delete(vecs[i]);
+    }
+    free(vecs);
+}
+
+static void print_header(const char *title) {
+    printf("# %s: B/el columns are allocator, header, slack, and malloc overhead bytes per live element\n", title);
+    printf(
+        "%-8s %-8s %-9s %-8s %11s %10s %10s %10s %10s %8s %8s %8s %8s %8s\n",
+        "workload",
+        "kind",
+        "growth",
+        "alloc",
+        "elements",
+        "useful MiB",
+        "asked MiB",
+        "alloc MiB",
+        "rss MiB",
+        "B/elem",
+        "hdr B/el",
+        "slack B/el",
+        "mall B/el",
+        "ms"
+    );
+}
+
+static void run_isolated(run_t *run) {
+    if (b_run_isolated(measure, run) != 0) {
+        fprintf(stderr, "%s: %s run failed\n", run->workload->name, KIND_NAMES[run->kind]);
+    }
+}
+
+void bench_memory(double scale) {
+    workload_t workloads[] = {
+        {"small", (size_t)(2000000 * scale) + 1, sizeof(uint32_t), 16, build_small},
+        {"huge", 4, sizeof(uint64_t), (size_t)(8000000 * scale) + 5, build_huge},
+        {"churn", (size_t)(200000 * scale) + 1, sizeof(uint32_t), 32, build_churn},
+    };
+
+    print_header("memory");
+#if defined(__GLIBC__)
+    size_t allocatorCount = sizeof(ALLOCATOR_NAMES) / sizeof(ALLOCATOR_NAMES[0]);
+#else
+    size_t allocatorCount = 1;
+#endif
+    for (size_t w = 0; w < sizeof(workloads) / sizeof(workloads[0]); w++) {
+        for (size_t g = GROWTH_PUSH; g <= GROWTH_PRESIZED; g++) {
+            for (size_t a = 0; a < allocatorCount; a++) {
+                run_t run = {&workloads[w], (growth_t)g, (allocator_t)a, KIND_REGULAR};
+                run_isolated(&run);
+            }
+        }
+    }
+}
+
+void bench_compact(double scale) {
+    // Adjacency lists for a sparse graph, with an average degree of 4.
+    workload_t workload = {"tiny", (size_t)(10000000 * scale) + 1, sizeof(uint32_t), 8, build_small};
+
+    print_header("compact");
+    for (size_t g = GROWTH_PUSH; g <= GROWTH_PRESIZED; g++) {
+        for (size_t k = KIND_REGULAR; k <= KIND_COMPACT; k++) {
+            run_t run = {&workload, (growth_t)g, ALLOCATOR_DEFAULT, (kind_t)k};
+            run_isolated(&run);
+        }
+    }
+}
@@ -0,0 +1,200 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <collectc.h>
+
+#include "bench.h"
+
+/** The capacity of both the queue and the baseline. */
+#define QUEUE_CAPACITY 1024
+
+/** The marker that tells a consumer to stop. */
+#define STOP UINT64_MAX
+
+/** The maximum number of producers, and of consumers. */
+#define MAX_THREADS 32
+
+/**
+ * The baseline: a bounded FIFO made from a vector behind a mutex,
+ * with condition variables for waiting.
+ */
+typedef struct locked_queue {
+    pthread_mutex_t lock;
+    pthread_cond_t notEmpty;
+    pthread_cond_t notFull;
+    vector_t vec;
+} locked_queue_t;
+
+typedef struct mpmc_run {
+    size_t perProducer;
+    size_t batch;
+    mpmc_queue_t *queue;
+    locked_queue_t locked;
+} mpmc_run_t;
+
+typedef struct mpmc_thread {
+    mpmc_run_t *run;
+    size_t id;
+    uint64_t sum;
+} mpmc_thread_t;
+
+static void locked_push(locked_queue_t *locked, const uint64_t *values, size_t count) {
+    pthread_mutex_lock(&locked->lock);
+    while (count > 0) {
+        while (vector_len(locked->vec) == QUEUE_CAPACITY) {
+            pthread_cond_wait(&locked->notFull, &locked->lock);
+        }
+        size_t room = QUEUE_CAPACITY - vector_len(locked->vec);
+        size_t n = count < room ? count : room;
+        vector_push(&locked->vec, values, n);
+        values += n;
+        count -= n;
+        pthread_cond_broadcast(&locked->notEmpty);
+    }
+    pthread_mutex_unlock(&locked->lock);
+}
+
+static size_t locked_pop(locked_queue_t *locked, uint64_t *values, size_t count) {
+    pthread_mutex_lock(&locked->lock);
+    while (vector_is_empty(locked->vec)) {
+        pthread_cond_wait(&locked->notEmpty, &locked->lock);
+    }
+    size_t n = vector_len(locked->vec) < count ? vector_len(locked->vec) : count;
+    vector_slice(locked->vec, 0, values, n);
+    vector_remove(locked->vec, 0, n);
+    pthread_cond_broadcast(&locked->notFull);
+    pthread_mutex_unlock(&locked->lock);
+    return n;
+}
+
+static void *produce_mpmc(void *context) {
+    mpmc_thread_t *thread = context;
+    mpmc_run_t *run = thread->run;
+    uint64_t batch[64];
+    for (size_t next = 0; next < run->perProducer; next += run->batch) {
+        size_t count = run->perProducer - next < run->batch ? run->perProducer - next : run->batch;
+        for (size_t i = 0; i < count; i++) {
+            batch[i] = next + i;
+        }
+        mpmc_queue_push(run->queue, batch, count);
+    }
+    return NULL;
+}
+
+static void *consume_mpmc(void *context) {
+    mpmc_thread_t *thread = context;
+    uint64_t value;
+    // Consumers pop one at a time, so that each takes exactly one marker.
+    while ((mpmc_queue_pop(thread->run->queue, &value, 1), value != STOP)) {
+        thread->sum += value;
+    }
+    return NULL;
+}
+
+static void *produce_locked(void *context) {
+    mpmc_thread_t *thread = context;
+    mpmc_run_t *run = thread->run;
+    uint64_t batch[64];
+    for (size_t next = 0; next < run->perProducer; next += run->batch) {
+        size_t count = run->perProducer - next < run->batch ? run->perProducer - next : run->batch;
+        for (size_t i = 0; i < count; i++) {
+            batch[i] = next + i;
+        }
+        locked_push(&run->locked, batch, count);
+    }
+    return NULL;
+}
+
+static void *consume_locked(void *context) {
+    mpmc_thread_t *thread = context;
+    uint64_t value;
+    while ((locked_pop(&thread->run->locked, &value, 1), value != STOP)) {
+        thread->sum += value;
+    }
+    return NULL;
+}
+
+/**
+ * Runs `threads` producers and `threads` consumers, and returns
+ * messages per second.
+ */
+static double run_threads(
+    mpmc_run_t *run, size_t threads, void *(*produce)(void *), void *(*consume)(void *), void (*stop)(mpmc_run_t *)
+) {
+    pthread_t producers[MAX_THREADS];
+    pthread_t consumers[MAX_THREADS];
+    mpmc_thread_t producerContexts[MAX_THREADS];
+    mpmc_thread_t consumerContexts[MAX_THREADS];
+    uint64_t start = b_now_ns();
+    for (size_t i = 0; i < threads; i++) {
+        producerContexts[i] = (mpmc_thread_t){.run = run, .id = i};
+        consumerContexts[i] = (mpmc_thread_t){.run = run, .id = i};
+        if (pthread_create(&consumers[i], NULL, consume, &consumerContexts[i]) != 0
+            || pthread_create(&producers[i], NULL, produce, &producerContexts[i]) != 0) {
+            abort();
+        }
+    }
+    for (size_t i = 0; i < threads; i++) {
+        pthread_join(producers[i], NULL);
+    }
+    for (size_t i = 0; i < threads; i++) {
+        stop(run);
+    }
+    uint64_t sum = 0;
+    for (size_t i = 0; i < threads; i++) {
+        pthread_join(consumers[i], NULL);
+        sum += consumerContexts[i].sum;
+    }
+    uint64_t elapsedNs = b_now_ns() - start;
+    if (sum != threads * ((uint64_t)run->perProducer * (run->perProducer - 1) / 2)) {
+        fprintf(stderr, "mpmc_queue: unexpected checksum\n");
+    }
+    return threads * run->perProducer * 1e9 / (double)elapsedNs;
+}
+
+static void stop_mpmc(mpmc_run_t *run) {
+    uint64_t stop = STOP;
+    mpmc_queue_push(run->queue, &stop, 1);
+}
+
+static void stop_locked(mpmc_run_t *run) {
+    uint64_t stop = STOP;
+    locked_push(&run->locked, &stop, 1);
+}
+
+void bench_mpmc_queue(double scale) {
+    static const size_t THREADS[] = {1, 2, 4, 8, 16, MAX_THREADS};
+
+    size_t messages = (size_t)(4000000 * scale) + 1;
+    printf("# mpmc_queue: %zu 8-byte messages, with N producers and N consumers\n", messages);
+    printf("%-8s %16s %16s %16s\n", "threads", "mutex M msg/s", "mpmc M msg/s", "mpmc x16 M msg/s");
+    for (size_t t = 0; t < sizeof(THREADS) / sizeof(THREADS[0]); t++) {
+        size_t threads = THREADS[t];
+        mpmc_run_t run = {.perProducer = messages / threads + 1, .batch = 1};
+
+        pthread_mutex_init(&run.locked.lock, NULL);
+        pthread_cond_init(&run.locked.notEmpty, NULL);
+        pthread_cond_init(&run.locked.notFull, NULL);
+        run.locked.vec = vector_new(QUEUE_CAPACITY, sizeof(uint64_t));
+        double lockedRate = run_threads(&run, threads, produce_locked, consume_locked, stop_locked);
+        vector_delete(run.locked.vec);
+        pthread_cond_destroy(&run.locked.notFull);
+        pthread_cond_destroy(&run.locked.notEmpty);
+        pthread_mutex_destroy(&run.locked.lock);
+
+        run.queue = mpmc_queue_new(QUEUE_CAPACITY, sizeof(uint64_t));
+        double mpmcRate = run_threads(&run, threads, produce_mpmc, consume_mpmc, stop_mpmc);
+        run.batch = 16;
+        double batchRate = run_threads(&run, threads, produce_mpmc, consume_mpmc, stop_mpmc);
+        mpmc_queue_delete(run.queue);
+
+        printf("%-8zu %16.1f %16.1f %16.1f\n", threads, lockedRate / 1e6, mpmcRate / 1e6, batchRate / 1e6);
+    }
+}
@@ -0,0 +1,77 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <collectc.h>
+
+#include "bench.h"
+
+/** An event queue entry. */
+typedef struct bench_event {
+    uint64_t time;
+    uint64_t id;
+} bench_event_t;
+
+static int compare_events(const void *a, const void *b) {
+    uint64_t x = ((const bench_event_t *)a)->time;
+    uint64_t y = ((const bench_event_t *)b)->time;
+    return (x > y) - (x < y);
+}
+
+void bench_radix_heap(double scale) {
+    static const size_t PENDING[] = {1000, 100000, 1000000};
+    size_t holds = (size_t)(4000000 * scale) + 1;
+
+    printf("# radix_heap: event clock, pop the next event and schedule one after it\n");
+    printf("%-14s %10s %12s\n", "queue", "pending", "hold ns");
+    for (size_t p = 0; p < sizeof(PENDING) / sizeof(PENDING[0]); p++) {
+        size_t pending = PENDING[p];
+        // Both queues see the same delays, so they pop the same times.
+        uint64_t expected = 0;
+        {
+            b_rng_t rng = b_rng_new(1);
+            heap_t heap = heap_new(sizeof(bench_event_t), 4, compare_events);
+            for (size_t i = 0; i < pending; i++) {
+                heap_push(&heap, &(bench_event_t){.time = b_rng_below(&rng, 1000000), .id = i});
+            }
+            uint64_t checksum = 0;
+            uint64_t start = b_now_ns();
+            for (size_t i = 0; i < holds; i++) {
+                bench_event_t event;
+                heap_pop(&heap, &event);
+                checksum += event.time;
+                event.time += b_rng_below(&rng, 1000000);
+                heap_push(&heap, &event);
+            }
+            uint64_t elapsedNs = b_now_ns() - start;
+            printf("%-14s %10zu %12.1f\n", "4-ary heap", pending, elapsedNs / (double)holds);
+            expected = checksum;
+            heap_delete(&heap);
+        }
+        {
+            b_rng_t rng = b_rng_new(1);
+            radix_heap_t heap = radix_heap_new(sizeof(uint64_t));
+            for (uint64_t i = 0; i < pending; i++) {
+                radix_heap_push(&heap, b_rng_below(&rng, 1000000), &i);
+            }
+            uint64_t checksum = 0;
+            uint64_t start = b_now_ns();
+            for (size_t i = 0; i < holds; i++) {
+                uint64_t time;
+                uint64_t id;
+                radix_heap_pop(&heap, &time, &id);
+                checksum += time;
+                radix_heap_push(&heap, time + b_rng_below(&rng, 1000000), &id);
+            }
+            uint64_t elapsedNs = b_now_ns() - start;
+            printf("%-14s %10zu %12.1f\n", "radix heap", pending, elapsedNs / (double)holds);
+            if (checksum != expected) {
+                fprintf(stderr, "radix_heap: event times differ\n");
+            }
+            radix_heap_delete(&heap);
+        }
+    }
+}
@@ -0,0 +1,78 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <collectc.h>
+
+#include "bench.h"
+
+void bench_rope(double scale) {
+    static const size_t LENGTHS[] = {10000, 100000, 1000000};
+
+    size_t edits = (size_t)(5000 * scale) + 1;
+    printf("# rope: %zu random single-element inserts and removes, against vector_insert\n", edits);
+    printf("%-10s %14s %14s %14s %14s\n", "length", "vector ns/op", "rope ns/op", "rope scan M/s", "speedup");
+    for (size_t l = 0; l < sizeof(LENGTHS) / sizeof(LENGTHS[0]); l++) {
+        size_t length = LENGTHS[l];
+        vector_t vec = vector_new(length + edits, sizeof(uint32_t));
+        rope_t rope = rope_new(sizeof(uint32_t));
+        for (uint32_t i = 0; i < length; i++) {
+            vector_push(&vec, &i, 1);
+        }
+        rope_push(&rope, vector_first(vec), length);
+
+        // Replay the same edits on both: an insert, then a remove
+        // somewhere else, so the length stays the same.
+        b_rng_t rng = b_rng_new(l + 1);
+        uint64_t start = b_now_ns();
+        for (uint32_t i = 0; i < edits; i++) {
+            vector_insert(&vec, b_rng_below(&rng, length + 1), &i, 1);
+            vector_remove(vec, b_rng_below(&rng, length + 1), 1);
+        }
+        uint64_t vectorNs = b_now_ns() - start;
+
+        rng = b_rng_new(l + 1);
+        start = b_now_ns();
+        for (uint32_t i = 0; i < edits; i++) {
+            rope_insert(&rope, b_rng_below(&rng, length + 1), &i, 1);
+            rope_remove(&rope, b_rng_below(&rng, length + 1), 1);
+        }
+        uint64_t ropeNs = b_now_ns() - start;
+
+        start = b_now_ns();
+        uint64_t sum = 0;
+        rope_iter_t iter = rope_iter_new(&rope);
+        size_t chunkLength;
+        const uint32_t *chunk;
+        while ((chunk = rope_iter_next(&iter, &chunkLength)) != NULL) {
+            for (size_t i = 0; i < chunkLength; i++) {
+                sum += chunk[i];
+            }
+        }
+        rope_iter_delete(&iter);
+        uint64_t scanNs = b_now_ns() - start;
+
+        uint64_t expected = 0;
+        for (size_t i = 0; i < length; i++) {
+            expected += *(const uint32_t *)vector_at(vec, i);
+        }
+        if (sum != expected) {
+            fprintf(stderr, "rope: contents differ from vector\n");
+        }
+
+        printf(
+            "%-10zu %14.1f %14.1f %14.1f %13.1fx\n",
+            length,
+            vectorNs / (2.0 * edits),
+            ropeNs / (2.0 * edits),
+            length * 1e3 / (double)scanNs,
+            (double)vectorNs / (double)ropeNs
+        );
+
+        rope_delete(&rope);
+        vector_delete(vec);
+    }
+}
@@ -0,0 +1,152 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <collectc.h>
+
+#include "bench.h"
+
+/** The largest batch that either side passes at once. */
+#define MAX_BATCH 256
+
+/** The capacity of both the queue and the baseline. */
+#define QUEUE_CAPACITY 4096
+
+typedef struct spsc_run {
+    size_t messages;
+    size_t batch;
+    spsc_queue_t *queue;
+    /** The baseline: a vector used as a FIFO, behind a mutex. */
+    pthread_mutex_t lock;
+    vector_t vec;
+} spsc_run_t;
+
+static void *produce_spsc(void *context) {
+    spsc_run_t *run = context;
+    uint64_t batch[MAX_BATCH];
+    for (size_t next = 0; next < run->messages;) {
+        size_t count = run->messages - next < run->batch ? run->messages - next : run->batch;
+        for (size_t i = 0; i < count; i++) {
+            batch[i] = next + i;
+        }
+        size_t pushed = 0;
+        while (pushed < count) {
+            size_t n = spsc_queue_push(run->queue, &batch[pushed], count - pushed);
+            if (n == 0) {
+                sched_yield();
+            }
+            pushed += n;
+        }
+        next += count;
+    }
+    return NULL;
+}
+
+static uint64_t consume_spsc(spsc_run_t *run) {
+    uint64_t sum = 0;
+    uint64_t batch[MAX_BATCH];
+    for (size_t received = 0; received < run->messages;) {
+        size_t count = spsc_queue_pop(run->queue, batch, run->batch);
+        if (count == 0) {
+            sched_yield();
+        }
+        for (size_t i = 0; i < count; i++) {
+            sum += batch[i];
+        }
+        received += count;
+    }
+    return sum;
+}
+
+static void *produce_mutex(void *context) {
+    spsc_run_t *run = context;
+    uint64_t batch[MAX_BATCH];
+    for (size_t next = 0; next < run->messages;) {
+        size_t count = run->messages - next < run->batch ? run->messages - next : run->batch;
+        for (size_t i = 0; i < count; i++) {
+            batch[i] = next + i;
+        }
+        // Bound the vector like the queue, so the consumer's
+        // removals from the front stay cheap.
+        size_t pushed = 0;
+        while (pushed < count) {
+            pthread_mutex_lock(&run->lock);
+            size_t room = QUEUE_CAPACITY - vector_len(run->vec);
+            size_t n = count - pushed < room ? count - pushed : room;
+            vector_push(&run->vec, &batch[pushed], n);
+            pthread_mutex_unlock(&run->lock);
+            if (n == 0) {
+                sched_yield();
+            }
+            pushed += n;
+        }
+        next += count;
+    }
+    return NULL;
+}
+
+static uint64_t consume_mutex(spsc_run_t *run) {
+    uint64_t sum = 0;
+    uint64_t batch[MAX_BATCH];
+    for (size_t received = 0; received < run->messages;) {
+        pthread_mutex_lock(&run->lock);
+        size_t count = vector_len(run->vec) < run->batch ? vector_len(run->vec) : run->batch;
+        vector_slice(run->vec, 0, batch, count);
+        vector_remove(run->vec, 0, count);
+        pthread_mutex_unlock(&run->lock);
+        if (count == 0) {
+            sched_yield();
+        }
+        for (size_t i = 0; i < count; i++) {
+            sum += batch[i];
+        }
+        received += count;
+    }
+    return sum;
+}
+
+/** Runs one producer and one consumer, and returns messages per second. */
+static double run_pair(spsc_run_t *run, void *(*produce)(void *), uint64_t (*consume)(spsc_run_t *)) {
+    pthread_t producer;
+    uint64_t start = b_now_ns();
+    if (pthread_create(&producer, NULL, produce, run) != 0) {
+        abort();
+    }
+    uint64_t sum = consume(run);
+    pthread_join(producer, NULL);
+    uint64_t elapsedNs = b_now_ns() - start;
+    if (sum != (uint64_t)run->messages * (run->messages - 1) / 2) {
+        fprintf(stderr, "spsc_queue: unexpected checksum\n");
+    }
+    return run->messages * 1e9 / (double)elapsedNs;
+}
+
+void bench_spsc_queue(double scale) {
+    static const size_t BATCHES[] = {1, 16, MAX_BATCH};
+
+    spsc_run_t run = {.messages = (size_t)(20000000 * scale) + 1};
+    printf("# spsc_queue: %zu 8-byte messages from one producer to one consumer\n", run.messages);
+    printf("%-8s %16s %16s\n", "batch", "mutex M msg/s", "spsc M msg/s");
+    for (size_t b = 0; b < sizeof(BATCHES) / sizeof(BATCHES[0]); b++) {
+        run.batch = BATCHES[b];
+
+        pthread_mutex_init(&run.lock, NULL);
+        run.vec = vector_new(QUEUE_CAPACITY, sizeof(uint64_t));
+        double mutexRate = run_pair(&run, produce_mutex, consume_mutex);
+        vector_delete(run.vec);
+        pthread_mutex_destroy(&run.lock);
+
+        run.queue = spsc_queue_new(QUEUE_CAPACITY, sizeof(uint64_t));
+        double spscRate = run_pair(&run, produce_spsc, consume_spsc);
+        spsc_queue_delete(run.queue);
+
+        printf("%-8zu %16.1f %16.1f\n", run.batch, mutexRate / 1e6, spscRate / 1e6);
+    }
+}
@@ -0,0 +1,122 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <collectc.h>
+
+#include "bench.h"
+
+/** Returns the `i`th id. This is a bijection, so ids from `n` on are all misses. */
+static uint64_t bench_id(uint64_t i) {
+    i = (i ^ (i >> 30)) * 0xbf58476d1ce4e5b9;
+    i = (i ^ (i >> 27)) * 0x94d049bb133111eb;
+    return i ^ (i >> 31);
+}
+
+static uint64_t hash_id(const void *key) {
+    uint64_t id = *(const uint64_t *)key;
+    id = (id ^ (id >> 33)) * 0xff51afd7ed558ccd;
+    return id ^ (id >> 33);
+}
+
+static bool equal_ids(const void *a, const void *b) {
+    return *(const uint64_t *)a == *(const uint64_t *)b;
+}
+
+typedef struct lookup_times {
+    double insertNs;
+    double hitNs;
+    double missNs;
+} lookup_times_t;
+
+static lookup_times_t time_hashmap(hashmap_hash_t hash, hashmap_equal_t equal, size_t entries, size_t lookups) {
+    lookup_times_t times;
+    hashmap_t map = hashmap_new(sizeof(uint64_t), sizeof(uint64_t), hash, equal);
+    uint64_t start = b_now_ns();
+    for (size_t i = 0; i < entries; i++) {
+        uint64_t id = bench_id(i);
+        hashmap_insert(&map, &id, &i);
+    }
+    times.insertNs = (b_now_ns() - start) / (double)entries;
+
+    b_rng_t rng = b_rng_new(1);
+    size_t found = 0;
+    start = b_now_ns();
+    for (size_t i = 0; i < lookups; i++) {
+        uint64_t id = bench_id(b_rng_below(&rng, entries));
+        found += hashmap_get(&map, &id) != NULL;
+    }
+    times.hitNs = (b_now_ns() - start) / (double)lookups;
+    start = b_now_ns();
+    for (size_t i = 0; i < lookups; i++) {
+        uint64_t id = bench_id(entries + b_rng_below(&rng, entries));
+        found += hashmap_get(&map, &id) != NULL;
+    }
+    times.missNs = (b_now_ns() - start) / (double)lookups;
+    if (found != lookups) {
+        fprintf(stderr, "u64map: hashmap found %zu of %zu\n", found, lookups);
+    }
+    hashmap_delete(&map);
+    return times;
+}
+
+static lookup_times_t time_u64map(size_t entries, size_t lookups) {
+    lookup_times_t times;
+    u64map_t map = u64map_new(sizeof(uint64_t));
+    uint64_t start = b_now_ns();
+    for (size_t i = 0; i < entries; i++) {
+        u64map_insert(&map, bench_id(i), &i);
+    }
+    times.insertNs = (b_now_ns() - start) / (double)entries;
+
+    b_rng_t rng = b_rng_new(1);
+    size_t found = 0;
+    start = b_now_ns();
+    for (size_t i = 0; i < lookups; i++) {
+        found += u64map_get(&map, bench_id(b_rng_below(&rng, entries))) != NULL;
+    }
+    times.hitNs = (b_now_ns() - start) / (double)lookups;
+    start = b_now_ns();
+    for (size_t i = 0; i < lookups; i++) {
+        found += u64map_get(&map, bench_id(entries + b_rng_below(&rng, entries))) != NULL;
+    }
+    times.missNs = (b_now_ns() - start) / (double)lookups;
+    if (found != lookups) {
+        fprintf(stderr, "u64map: found %zu of %zu\n", found, lookups);
+    }
+    u64map_delete(&map);
+    return times;
+}
+
+void bench_u64map(double scale) {
+    static const size_t SIZES[] = {1000, 100000, 1000000, 10000000};
+    size_t lookups = (size_t)(4000000 * scale) + 1;
+
+    printf("# u64map: 8-byte ids and values, random hit and miss lookups\n");
+    printf("%-18s %10s %12s %12s %12s\n", "map", "entries", "insert ns", "hit ns", "miss ns");
+    for (size_t s = 0; s < sizeof(SIZES) / sizeof(SIZES[0]); s++) {
+        size_t entries = SIZES[s];
+        if (s > 0 && entries > SIZES[sizeof(SIZES) / sizeof(SIZES[0]) - 1] * scale) {
+            break;
+        }
+        static const char *NAMES[] = {"hashmap (bytes)", "hashmap (typed)", "u64map"};
+        lookup_times_t times[] = {
+            time_hashmap(NULL, NULL, entries, lookups),
+            time_hashmap(hash_id, equal_ids, entries, lookups),
+            time_u64map(entries, lookups),
+        };
+        for (size_t m = 0; m < sizeof(times) / sizeof(times[0]); m++) {
+            printf(
+                "%-18s %10zu %12.1f %12.1f %12.1f\n",
+                NAMES[m],
+                entries,
+                times[m].insertNs,
+                times[m].hitNs,
+                times[m].missNs
+            );
+        }
+    }
+}
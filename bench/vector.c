@@ -0,0 +1,137 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#include <collectc.h>
+
+#include "bench.h"
+
+/** A 16-byte element, like a key and value pair. */
+typedef struct pair {
+    uint64_t key;
+    uint64_t value;
+} pair_t;
+
+typedef struct latency_run {
+    bool incremental;
+    /**
+     * Serve every allocation from the heap. glibc grows huge allocations
+     * with `mremap`, which moves pages instead of copying them; from the
+     * heap, a grown vector is copied, as it is with most allocators.
+     */
+    bool noMmap;
+    size_t pushes;
+} latency_run_t;
+
+static int compare_ns(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+/** Returns the `fraction` percentile of sorted latencies. */
+static uint64_t percentile(const uint64_t *sorted, size_t length, double fraction) {
+    return sorted[(size_t)(fraction * (length - 1))];
+}
+
+/**
+ * Pushes elements one at a time, in turn into two vectors, so that
+ * neither can grow in place at the top of the heap. Times each push, and
+ * reads a random element after it, then prints percentiles of the push
+ * latencies.
+ */
+static void time_pushes(void *context) {
+    const latency_run_t *run = context;
+#if defined(__GLIBC__)
+    if (run->noMmap) {
+        mallopt(M_MMAP_MAX, 0);
+    }
+#endif
+    vector_t vecs[2];
+    for (size_t v = 0; v < 2; v++) {
+        vecs[v] = run->incremental ? vector_new_incremental(0, sizeof(pair_t)) : vector_new(0, sizeof(pair_t));
+    }
+    uint64_t *latencies = malloc(run->pushes * sizeof(uint64_t));
+    if (latencies == NULL) {
+        abort();
+    }
+
+    b_rng_t rng = b_rng_new(1);
+    uint64_t sum = 0;
+    uint64_t readNs = 0;
+    uint64_t totalStart = b_now_ns();
+    for (size_t i = 0; i < run->pushes; i++) {
+        vector_t *vec = &vecs[i & 1];
+        pair_t pair = {.key = i, .value = ~i};
+        uint64_t start = b_now_ns();
+        vector_push(vec, &pair, 1);
+        uint64_t end = b_now_ns();
+        latencies[i] = end - start;
+        sum += ((const pair_t *)vector_at(*vec, b_rng_below(&rng, vector_len(*vec))))->key;
+        readNs += b_now_ns() - end;
+    }
+    double totalMs = (b_now_ns() - totalStart) / 1e6;
+    if (sum == 42) {
+        printf("#\n");
+    }
+    qsort(latencies, run->pushes, sizeof(uint64_t), compare_ns);
+    printf(
+        "%-12s %-8s %10zu %8llu %8llu %8llu %10llu %12llu %8.1f %10.1f\n",
+        run->incremental ? "incremental" : "vector",
+        run->noMmap ? "no-mmap" : "default",
+        run->pushes,
+        (unsigned long long)percentile(latencies, run->pushes, 0.5),
+        (unsigned long long)percentile(latencies, run->pushes, 0.99),
+        (unsigned long long)percentile(latencies, run->pushes, 0.999),
+        (unsigned long long)percentile(latencies, run->pushes, 0.99999),
+        (unsigned long long)latencies[run->pushes - 1],
+        readNs / (double)run->pushes,
+        totalMs
+    );
+    free(latencies);
+    vector_delete(vecs[0]);
+    vector_delete(vecs[1]);
+}
+
+void bench_vector_latency(double scale) {
+    static const size_t SIZES[] = {100000, 1000000, 10000000, 40000000};
+
+    printf("# vector_latency: ns per push of a 16-byte element into one of two vectors, and per read after it\n");
+    printf(
+        "%-12s %-8s %10s %8s %8s %8s %10s %12s %8s %10s\n",
+        "vector",
+        "malloc",
+        "pushes",
+        "p50",
+        "p99",
+        "p99.9",
+        "p99.999",
+        "max",
+        "read ns",
+        "total ms"
+    );
+    for (size_t s = 0; s < sizeof(SIZES) / sizeof(SIZES[0]); s++) {
+        size_t pushes = SIZES[s];
+        if (s > 0 && pushes > SIZES[sizeof(SIZES) / sizeof(SIZES[0]) - 1] * scale) {
+            break;
+        }
+        // Each vector grows in a fresh process, so that neither reuses
+        // pages that the other faulted in.
+        for (int noMmap = 0; noMmap < 2; noMmap++) {
+            for (int incremental = 0; incremental < 2; incremental++) {
+                latency_run_t run = {.incremental = incremental, .noMmap = noMmap, .pushes = pushes};
+                if (b_run_isolated(time_pushes, &run) != 0) {
+                    fprintf(stderr, "vector_latency: run failed\n");
+                }
+            }
+        }
+    }
+}
@@ -3,3 +3,23 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
 
 #include <collectc/vector.h>
+#include <collectc/ragged_vector.h>
+#include <collectc/soa_vector.h>
+#include <collectc/bitvec.h>
+#include <collectc/packed_int_vector.h>
+#include <collectc/delta_vector.h>
+#include <collectc/gap_buffer.h>
+#include <collectc/rope.h>
+#include <collectc/deque.h>
+#include <collectc/spsc_queue.h>
+#include <collectc/mpmc_queue.h>
+#include <collectc/work_deque.h>
+#include <collectc/heap.h>
+#include <collectc/indexed_heap.h>
+#include <collectc/radix_heap.h>
+#include <collectc/hash.h>
+#include <collectc/hashmap.h>
+#include <collectc/hashset.h>
+#include <collectc/u64map.h>
+#include <collectc/indexmap.h>
+#include <collectc/concurrent_hashmap.h>
@@ -0,0 +1,224 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef COLLECTC_BITVEC_H_
+#define COLLECTC_BITVEC_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <collectc/vector.h>
+
+/**
+ * @brief A growable array of bits.
+ *
+ * Bit vectors pack 64 bits into each word, so they take an eighth of the
+ * memory of a vector of `bool`s. Bulk operations, like `bitvec_and` and
+ * `bitvec_count_ones`, work on whole words at a time, and use AVX2 when
+ * the library is built with it enabled.
+ *
+ * Bit vectors also support rank and select queries, which count the set
+ * bits before an index, and find the index of the n-th set bit. The first
+ * query after modifying a bit vector builds a small index, taking about
+ * 1/8 of the bit vector's memory, that answers later queries in O(1) and
+ * O(log n) time.
+ *
+ * Bit vectors are not internally synchronized.
+ *
+ * The fields of this struct are private.
+ *
+ * @class bitvec_t collectc/bitvec.h
+ */
+typedef struct bitvec {
+    vector_t words;
+    size_t length;
+    vector_t rankIndex;
+} bitvec_t;
+
+/**
+ * @brief Creates a new, empty bit vector.
+ *
+ * Aborts on memory allocation failure.
+ *
+ * @param[in] initialCapacity The number of bits that the bit vector
+ * can hold before reallocating.
+ * @return The new bit vector.
+ *
+ * @memberof bitvec_t
+ * @static
+ */
+bitvec_t bitvec_new(size_t initialCapacity);
+
+/**
+ * @brief Creates a new bit vector with every bit set to the same value.
+ *
+ * Aborts on memory allocation failure.
+ *
+ * @param[in] length The number of bits.
+ * @param[in] bit The value of every bit.
+ * @return The new bit vector.
+ *
+ * @memberof bitvec_t
+ * @static
+ */
+bitvec_t bitvec_new_filled(size_t length, bool bit);
+
+/**
+ * @return The number of bits in the bit vector.
+ *
+ * @memberof bitvec_t
+ */
+size_t bitvec_len(const bitvec_t *bv);
+
+/**
+ * Returns a pointer to the bit vector's words.
+ *
+ * Bit `i` is bit `i % 64` of word `i / 64`. The unused bits
+ * of the last word are always zero.
+ *
+ * @return A pointer to the first word, or `null` if the
+ * bit vector is empty.
+ *
+ * @memberof bitvec_t
+ */
+const uint64_t *bitvec_words(const bitvec_t *bv);
+
+/**
+ * Appends a bit to the bit vector.
+ *
+ * Pushing is amortized O(1). Aborts on memory allocation failure.
+ *
+ * @memberof bitvec_t
+ */
+void bitvec_push(bitvec_t *bv, bool bit);
+
+/**
+ * @return The value of a bit. Aborts if the index is out-of-bounds.
+ *
+ * @memberof bitvec_t
+ */
+bool bitvec_get(const bitvec_t *bv, size_t index);
+
+/**
+ * Sets the value of a bit. Aborts if the index is out-of-bounds.
+ *
+ * @memberof bitvec_t
+ */
+void bitvec_set(bitvec_t *bv, size_t index, bool bit);
+
+/**
+ * Sets each bit of this bit vector to the AND of itself and
+ * the same bit of another bit vector.
+ *
+ * Aborts if the bit vectors have different lengths.
+ *
+ * @memberof bitvec_t
+ */
+void bitvec_and(bitvec_t *bv, const bitvec_t *other);
+
+/**
+ * Sets each bit of this bit vector to the OR of itself and
+ * the same bit of another bit vector.
+ *
+ * Aborts if the bit vectors have different lengths.
+ *
+ * @memberof bitvec_t
+ */
+void bitvec_or(bitvec_t *bv, const bitvec_t *other);
+
+/**
+ * Sets each bit of this bit vector to the XOR of itself and
+ * the same bit of another bit vector.
+ *
+ * Aborts if the bit vectors have different lengths.
+ *
+ * @memberof bitvec_t
+ */
+void bitvec_xor(bitvec_t *bv, const bitvec_t *other);
+
+/**
+ * Flips every bit of the bit vector.
+ *
+ * @memberof bitvec_t
+ */
+void bitvec_not(bitvec_t *bv);
+
+/**
+ * @return The number of set bits in the bit vector.
+ *
+ * @memberof bitvec_t
+ */
+size_t bitvec_count_ones(const bitvec_t *bv);
+
+/**
+ * Finds the first set bit at or after an index.
+ *
+ * @param[in] bv The bit vector.
+ * @param[in] from The zero-based index at which to start searching.
+ *
+ * @return The index of the set bit, or `bitvec_len(bv)` if there
+ * aren't any set bits at or after `from`.
+ *
+ * @memberof bitvec_t
+ */
+size_t bitvec_find_first_set(const bitvec_t *bv, size_t from);
+
+/**
+ * Counts the set bits before an index.
+ *
+ * This operation is O(1), after building the rank index
+ * if the bit vector was modified since the last query.
+ *
+ * Aborts if the index is greater than the length of the bit vector.
+ *
+ * @param[inout] bv The bit vector.
+ * @param[in] index The zero-based index, which can be equal to
+ * the length of the bit vector to count all the set bits.
+ *
+ * @return The number of set bits in the range `[0, index)`.
+ *
+ * @memberof bitvec_t
+ */
+size_t bitvec_rank(bitvec_t *bv, size_t index);
+
+/**
+ * Finds the `n`-th set bit, counting from zero.
+ *
+ * This operation is O(log n), after building the rank index
+ * if the bit vector was modified since the last query.
+ *
+ * @param[inout] bv The bit vector.
+ * @param[in] n The zero-based ordinal of the set bit.
+ *
+ * @return The index of the set bit, or `bitvec_len(bv)` if
+ * there are `n` or fewer set bits.
+ *
+ * @memberof bitvec_t
+ */
+size_t bitvec_select(bitvec_t *bv, size_t n);
+
+/**
+ * Removes all bits from the bit vector, without shrinking its capacity.
+ *
+ * @memberof bitvec_t
+ */
+void bitvec_clear(bitvec_t *bv);
+
+/**
+ * Destroys the bit vector, freeing any memory allocated for it.
+ *
+ * @memberof bitvec_t
+ */
+void bitvec_delete(bitvec_t *bv);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // COLLECTC_BITVEC_H_
@@ -0,0 +1,167 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef COLLECTC_CONCURRENT_HASHMAP_H_
+#define COLLECTC_CONCURRENT_HASHMAP_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <collectc/hashmap.h>
+
+/**
+ * @brief An unordered map from keys to values that any number of threads
+ * can read and write at once.
+ *
+ * The map is split into 64 shards by the top bits of each key's hash.
+ * Each shard is a split-ordered list: one linked list of all its entries,
+ * sorted by their hashes with the bits reversed, and a table of buckets
+ * that are marker nodes in the list. Doubling the number of buckets
+ * splits each bucket's run of the list in two without moving any entries,
+ * so a shard grows in O(1), and new buckets are linked in as they're
+ * first used. Nothing ever rehashes the map, or stops other threads.
+ *
+ * Readers don't take locks, or write to memory that other threads share.
+ * Writers take their shard's lock, so writers to different shards don't
+ * wait for each other. Entries are never changed in place: inserting over
+ * a key links in a new entry in place of the old one, so a reader sees
+ * either the old value or the new one, in full.
+ *
+ * Removed and replaced entries are freed once no reader can still hold
+ * them, using epochs. Each reader counts itself in, in one of two
+ * counters for the current epoch's parity, on a cache line of its own.
+ * Writers advance the epoch once no readers are counted in the previous
+ * one, and free entries that were unlinked two epochs ago.
+ *
+ * Keys are hashed and compared with callbacks, or by their bytes if the
+ * callbacks are `null`. Values are copied out, so readers never hold
+ * pointers into the map.
+ *
+ * Creating and destroying the map must happen while no other threads
+ * are using it.
+ *
+ * @class concurrent_hashmap_t collectc/concurrent_hashmap.h
+ */
+typedef struct concurrent_hashmap concurrent_hashmap_t;
+
+/**
+ * @brief Creates a new, empty concurrent hash map.
+ *
+ * Aborts on memory allocation failure.
+ *
+ * @param[in] keySize The size of each key.
+ * @param[in] valueSize The size of each value, which may be 0.
+ * @param[in] hash The hash function for keys, or `null` to hash
+ * their bytes.
+ * @param[in] equal The equality function for keys, or `null` to compare
+ * their bytes.
+ * @return A pointer to the new map.
+ *
+ * @memberof concurrent_hashmap_t
+ * @static
+ */
+concurrent_hashmap_t *
+concurrent_hashmap_new(size_t keySize, size_t valueSize, hashmap_hash_t hash, hashmap_equal_t equal);
+
+/**
+ * Returns the number of entries in the map.
+ *
+ * If other threads are writing to the map at the same time, the length
+ * may be out-of-date as soon as it's returned.
+ *
+ * @memberof concurrent_hashmap_t
+ */
+size_t concurrent_hashmap_len(const concurrent_hashmap_t *map);
+
+/**
+ * @return The size of each key.
+ *
+ * @memberof concurrent_hashmap_t
+ */
+size_t concurrent_hashmap_key_size(const concurrent_hashmap_t *map);
+
+/**
+ * @return The size of each value.
+ *
+ * @memberof concurrent_hashmap_t
+ */
+size_t concurrent_hashmap_value_size(const concurrent_hashmap_t *map);
+
+/**
+ * Looks up a key, and copies out its value.
+ *
+ * This operation is expected O(1), and never blocks.
+ *
+ * @param[in] map The map.
+ * @param[in] key A pointer to the key.
+ * @param[out] value Memory that can hold the value, or `null` to
+ * ignore it.
+ *
+ * @return `false` if the key isn't in the map.
+ *
+ * @memberof concurrent_hashmap_t
+ */
+bool concurrent_hashmap_get(const concurrent_hashmap_t *map, const void *key, void *value);
+
+/**
+ * @return `true` if the key is in the map.
+ *
+ * @memberof concurrent_hashmap_t
+ */
+bool concurrent_hashmap_contains(const concurrent_hashmap_t *map, const void *key);
+
+/**
+ * Inserts a key and its value into the map, replacing the value if the
+ * key is already in the map.
+ *
+ * Inserting is expected O(1). It waits for other writers to the same
+ * shard, but never for readers.
+ *
+ * Aborts on memory allocation failure.
+ *
+ * @param[inout] map The map.
+ * @param[in] key A pointer to the key.
+ * @param[in] value A pointer to the value, which may be `null` if the
+ * value size is 0.
+ *
+ * @return `true` if the key is new, or `false` if its value was replaced.
+ *
+ * @memberof concurrent_hashmap_t
+ */
+bool concurrent_hashmap_insert(concurrent_hashmap_t *map, const void *key, const void *value);
+
+/**
+ * Removes a key and its value from the map.
+ *
+ * Removing is expected O(1). It waits for other writers to the same
+ * shard, but never for readers.
+ *
+ * @param[inout] map The map.
+ * @param[in] key A pointer to the key.
+ * @param[out] value Memory that can hold the removed value, or `null`
+ * to ignore it.
+ *
+ * @return `false` if the key isn't in the map.
+ *
+ * @memberof concurrent_hashmap_t
+ */
+bool concurrent_hashmap_remove(concurrent_hashmap_t *map, const void *key, void *value);
+
+/**
+ * Destroys the map, freeing any memory allocated for it.
+ *
+ * @memberof concurrent_hashmap_t
+ */
+void concurrent_hashmap_delete(concurrent_hashmap_t *map);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // COLLECTC_CONCURRENT_HASHMAP_H_
@@ -0,0 +1,170 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef COLLECTC_DELTA_VECTOR_H_
+#define COLLECTC_DELTA_VECTOR_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <collectc/vector.h>
+
+/**
+ * @brief A compressed, append-only sequence of sorted unsigned integers.
+ *
+ * Delta vectors split their values into blocks of 128. Each block stores
+ * its first value, and the differences between each value and the one
+ * before it, bit-packed to the width of the block's largest difference.
+ * Sorted sequences with small gaps, like posting lists and timestamps,
+ * compress to a fraction of their size as a vector of `uint64_t`s.
+ *
+ * A skip index holds the first and last value of each block, so finding
+ * a value only decodes one block. The most recent values that don't fill
+ * a block yet are kept unencoded until the block is full.
+ *
+ * Values must be pushed in non-decreasing order.
+ *
+ * Delta vectors are not internally synchronized.
+ *
+ * The fields of this struct are private.
+ *
+ * @class delta_vector_t collectc/delta_vector.h
+ */
+typedef struct delta_vector {
+    vector_t blocks;
+    vector_t data;
+    vector_t tail;
+    size_t length;
+} delta_vector_t;
+
+/**
+ * @brief Creates a new, empty delta vector.
+ *
+ * @return The new delta vector.
+ *
+ * @memberof delta_vector_t
+ * @static
+ */
+delta_vector_t delta_vector_new(void);
+
+/**
+ * @brief Creates a delta vector from a sorted vector of `uint64_t`s.
+ *
+ * Aborts on memory allocation failure, if the vector's elements
+ * aren't `uint64_t`s, or if they aren't sorted.
+ *
+ * @param[in] vec The vector to encode.
+ * @return The new delta vector.
+ *
+ * @memberof delta_vector_t
+ * @static
+ */
+delta_vector_t delta_vector_from_vector(const vector_t vec);
+
+/**
+ * @return The number of values in the delta vector.
+ *
+ * @memberof delta_vector_t
+ */
+size_t delta_vector_len(const delta_vector_t *dv);
+
+/**
+ * Returns the number of bytes that the delta vector uses for its
+ * blocks, skip index, and unencoded values.
+ *
+ * @memberof delta_vector_t
+ */
+size_t delta_vector_allocation_size(const delta_vector_t *dv);
+
+/**
+ * Appends values to the delta vector.
+ *
+ * Pushing is amortized O(count). Aborts on memory allocation failure,
+ * or if the values are smaller than the last value, or aren't sorted.
+ *
+ * @param[inout] dv The delta vector.
+ * @param[in] values A pointer to the first value.
+ * @param[in] count The number of values.
+ *
+ * @memberof delta_vector_t
+ */
+void delta_vector_push(delta_vector_t *dv, const uint64_t *values, size_t count);
+
+/**
+ * Returns the value at an index.
+ *
+ * This operation decodes part of one block. Use `delta_vector_decode`
+ * to read many consecutive values.
+ *
+ * Aborts if the index is out-of-bounds.
+ *
+ * @memberof delta_vector_t
+ */
+uint64_t delta_vector_get(const delta_vector_t *dv, size_t index);
+
+/**
+ * Decodes a range of values into a plain array.
+ *
+ * Decoding is O(count), and unpacks each block's differences
+ * with AVX2 when the library is built with it enabled.
+ *
+ * Aborts if the range `[index, index + count]` is out-of-bounds.
+ *
+ * @param[in] dv The delta vector.
+ * @param[in] index The zero-based index of the first value to decode.
+ * @param[out] values A pointer to memory that can hold `count` values.
+ * @param[in] count The number of values to decode.
+ *
+ * @memberof delta_vector_t
+ */
+void delta_vector_decode(const delta_vector_t *dv, size_t index, uint64_t *values, size_t count);
+
+/**
+ * Finds the first value that's greater than or equal to a value.
+ *
+ * This operation is O(log n), and decodes at most one block.
+ *
+ * @param[in] dv The delta vector.
+ * @param[in] value The value to find.
+ *
+ * @return The index of the first value that isn't less than `value`,
+ * or `delta_vector_len(dv)` if all values are less than `value`.
+ *
+ * @memberof delta_vector_t
+ */
+size_t delta_vector_lower_bound(const delta_vector_t *dv, uint64_t value);
+
+/**
+ * Decodes all the values into a new vector of `uint64_t`s.
+ *
+ * Aborts on memory allocation failure.
+ *
+ * @memberof delta_vector_t
+ */
+vector_t delta_vector_to_vector(const delta_vector_t *dv);
+
+/**
+ * Removes all values from the delta vector.
+ *
+ * @memberof delta_vector_t
+ */
+void delta_vector_clear(delta_vector_t *dv);
+
+/**
+ * Destroys the delta vector, freeing any memory allocated for it.
+ *
+ * @memberof delta_vector_t
+ */
+void delta_vector_delete(delta_vector_t *dv);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // COLLECTC_DELTA_VECTOR_H_
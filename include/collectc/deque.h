@@ -0,0 +1,228 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef COLLECTC_DEQUE_H_
+#define COLLECTC_DEQUE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief A double-ended queue, backed by a growable ring buffer.
+ *
+ * Deques store their elements in one allocation, like vectors, but let the
+ * elements wrap around from the end of the buffer to the start. Pushing and
+ * popping at either end is amortized O(1), so deques make good FIFO queues,
+ * where removing the first element of a vector would be O(n).
+ *
+ * The capacity of a deque is always a power of two, so that indexing is
+ * O(1) and only needs a mask. Because the elements can wrap around, they
+ * may be split into two contiguous runs; `deque_as_slices` returns both,
+ * for bulk copies or vectorized loops.
+ *
+ * Deques assume that their elements have the same size and type.
+ * Pushing can invalidate existing pointers to the deque and any elements.
+ * Deques are not internally synchronized.
+ *
+ * @class deque_t collectc/deque.h
+ */
+typedef uintptr_t deque_t;
+
+/**
+ * @brief Creates a new, empty deque.
+ *
+ * Aborts on memory allocation failure.
+ *
+ * @param[in] initialCapacity The minimum number of elements that the deque
+ * can hold before reallocating. It's rounded up to a power of two.
+ * @param[in] elementSize The size of each element.
+ * @return The new deque.
+ *
+ * @memberof deque_t
+ * @static
+ */
+deque_t deque_new(size_t initialCapacity, size_t elementSize);
+
+/**
+ * @return The number of elements in the deque.
+ *
+ * @memberof deque_t
+ */
+size_t deque_len(const deque_t dq);
+
+/**
+ * @return The number of elements that the deque can hold
+ * without reallocating.
+ *
+ * @memberof deque_t
+ */
+size_t deque_capacity(const deque_t dq);
+
+/**
+ * @return The size of each element.
+ *
+ * @memberof deque_t
+ */
+size_t deque_element_size(const deque_t dq);
+
+/**
+ * @return `true` if the deque is empty.
+ *
+ * @memberof deque_t
+ */
+bool deque_is_empty(const deque_t dq);
+
+/**
+ * Returns a pointer to an element in the deque.
+ *
+ * This operation is O(1).
+ *
+ * @param[in] dq The deque.
+ * @param[in] index The zero-based index of the element, counting
+ * from the front.
+ *
+ * @return A constant pointer to the element at the index, or
+ * `null` if the index is out-of-bounds.
+ *
+ * @memberof deque_t
+ */
+const void *deque_at(const deque_t dq, size_t index);
+
+/**
+ * Returns a mutable pointer to an element in the deque.
+ *
+ * @see deque_at
+ *
+ * @memberof deque_t
+ */
+void *deque_at_mut(deque_t dq, size_t index);
+
+/**
+ * @return A pointer to the first element, or `null` if
+ * the deque is empty.
+ *
+ * @memberof deque_t
+ */
+const void *deque_front(const deque_t dq);
+
+/**
+ * @return A pointer to the last element, or `null` if
+ * the deque is empty.
+ *
+ * @memberof deque_t
+ */
+const void *deque_back(const deque_t dq);
+
+/**
+ * Reserves capacity for at least the given number of elements,
+ * such that the deque will be able to hold
+ * `deque_len(dq) + extraCapacity` elements before reallocating.
+ *
+ * Growing a deque unwraps its elements once, by moving whichever of
+ * its two runs is shorter, so it's O(n) with respect to that run.
+ *
+ * Aborts on memory allocation failure.
+ *
+ * @param[inout] dq A pointer to the deque.
+ * @param[in] extraCapacity Additional capacity to reserve.
+ *
+ * @memberof deque_t
+ */
+void deque_reserve(deque_t *dq, size_t extraCapacity);
+
+/**
+ * Appends elements to the back of the deque.
+ *
+ * Pushing is amortized O(1) per element.
+ *
+ * Aborts on memory allocation failure.
+ *
+ * @param[inout] dq A pointer to the deque.
+ * @param[in] elements A pointer to the first element.
+ * @param[in] count The number of elements.
+ *
+ * @memberof deque_t
+ */
+void deque_push_back(deque_t *dq, const void *elements, size_t count);
+
+/**
+ * Prepends elements to the front of the deque, keeping their order,
+ * so that the first pushed element becomes the new front.
+ *
+ * @see deque_push_back
+ *
+ * @memberof deque_t
+ */
+void deque_push_front(deque_t *dq, const void *elements, size_t count);
+
+/**
+ * Removes elements from the front of the deque, copying them out in
+ * order.
+ *
+ * Popping is O(1) per element.
+ *
+ * Aborts if the deque has fewer than `count` elements.
+ *
+ * @param[in] dq The deque.
+ * @param[out] elements A pointer to memory that can hold `count` elements,
+ * or `null` to discard them.
+ * @param[in] count The number of elements to remove.
+ *
+ * @memberof deque_t
+ */
+void deque_pop_front(deque_t dq, void *elements, size_t count);
+
+/**
+ * Removes elements from the back of the deque, copying them out in
+ * order, so the last element of the deque is the last one copied.
+ *
+ * @see deque_pop_front
+ *
+ * @memberof deque_t
+ */
+void deque_pop_back(deque_t dq, void *elements, size_t count);
+
+/**
+ * Returns the deque's elements as two contiguous runs, in order.
+ *
+ * If the elements don't wrap around, the second run is empty.
+ *
+ * @param[in] dq The deque.
+ * @param[out] first A pointer to the first run, or `null` if the
+ * deque is empty.
+ * @param[out] firstLength The number of elements in the first run.
+ * @param[out] second A pointer to the second run, or `null` if it's empty.
+ * @param[out] secondLength The number of elements in the second run.
+ *
+ * @memberof deque_t
+ */
+void deque_as_slices(
+    const deque_t dq, const void **first, size_t *firstLength, const void **second, size_t *secondLength
+);
+
+/**
+ * Removes all elements from the deque. Clearing a deque won't shrink
+ * its capacity.
+ *
+ * @memberof deque_t
+ */
+void deque_clear(deque_t dq);
+
+/**
+ * Destroys the deque, freeing any memory allocated for it.
+ *
+ * @memberof deque_t
+ */
+void deque_delete(deque_t dq);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // COLLECTC_DEQUE_H_
@@ -0,0 +1,213 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef COLLECTC_GAP_BUFFER_H_
+#define COLLECTC_GAP_BUFFER_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief A growable array with a movable gap, for fast edits
+ * around a cursor.
+ *
+ * Gap buffers store their elements in one allocation, like vectors, but
+ * keep their spare capacity as a gap at the cursor instead of at the end.
+ * Inserting or removing elements at the cursor is amortized O(1), because
+ * it only grows or shrinks the gap. Moving the cursor moves the gap, which
+ * is O(n) with respect to the distance moved, so edits that stay near each
+ * other, like typing in a text editor, are much faster than inserting into
+ * a vector.
+ *
+ * Gap buffers assume that their elements have the same size and type,
+ * and can't be accessed through a single pointer while the gap is in the
+ * middle. `gap_buffer_as_contiguous` moves the gap to the end, and returns
+ * a pointer to all the elements.
+ *
+ * Any edit, or moving the cursor, can invalidate existing pointers to any
+ * elements. Gap buffers are not internally synchronized.
+ *
+ * @class gap_buffer_t collectc/gap_buffer.h
+ */
+typedef uintptr_t gap_buffer_t;
+
+/**
+ * @brief Creates a new, empty gap buffer, with the cursor at the start.
+ *
+ * Aborts on memory allocation failure.
+ *
+ * @param[in] initialCapacity The number of elements that the gap buffer
+ * can hold before reallocating.
+ * @param[in] elementSize The size of each element.
+ * @return The new gap buffer.
+ *
+ * @memberof gap_buffer_t
+ * @static
+ */
+gap_buffer_t gap_buffer_new(size_t initialCapacity, size_t elementSize);
+
+/**
+ * @return The number of elements in the gap buffer.
+ *
+ * @memberof gap_buffer_t
+ */
+size_t gap_buffer_len(const gap_buffer_t gb);
+
+/**
+ * @return The number of elements that the gap buffer can hold
+ * without reallocating.
+ *
+ * @memberof gap_buffer_t
+ */
+size_t gap_buffer_capacity(const gap_buffer_t gb);
+
+/**
+ * @return The size of each element.
+ *
+ * @memberof gap_buffer_t
+ */
+size_t gap_buffer_element_size(const gap_buffer_t gb);
+
+/**
+ * @return `true` if the gap buffer is empty.
+ *
+ * @memberof gap_buffer_t
+ */
+bool gap_buffer_is_empty(const gap_buffer_t gb);
+
+/**
+ * @return The index of the cursor, which is where the gap starts.
+ *
+ * @memberof gap_buffer_t
+ */
+size_t gap_buffer_cursor(const gap_buffer_t gb);
+
+/**
+ * Moves the cursor, and the gap with it.
+ *
+ * Moving the cursor is O(n) with respect to the distance moved.
+ *
+ * Aborts if the index is greater than the length of the gap buffer.
+ *
+ * @param[in] gb The gap buffer.
+ * @param[in] index The new index of the cursor.
+ *
+ * @memberof gap_buffer_t
+ */
+void gap_buffer_move_cursor(gap_buffer_t gb, size_t index);
+
+/**
+ * Returns a pointer to an element in the gap buffer.
+ *
+ * This operation is O(1).
+ *
+ * @param[in] gb The gap buffer.
+ * @param[in] index The zero-based index of the element.
+ *
+ * @return A constant pointer to the element at the index, or
+ * `null` if the index is out-of-bounds.
+ *
+ * @memberof gap_buffer_t
+ */
+const void *gap_buffer_at(const gap_buffer_t gb, size_t index);
+
+/**
+ * Returns a mutable pointer to an element in the gap buffer.
+ *
+ * @see gap_buffer_at
+ *
+ * @memberof gap_buffer_t
+ */
+void *gap_buffer_at_mut(gap_buffer_t gb, size_t index);
+
+/**
+ * Inserts elements into the gap buffer, and moves the cursor to
+ * just after them.
+ *
+ * Inserting at the cursor is amortized O(1) per element. Inserting
+ * anywhere else first moves the cursor to the index.
+ *
+ * Aborts on memory allocation failure, or if the index is greater
+ * than the length of the gap buffer.
+ *
+ * @param[inout] gb A pointer to the gap buffer.
+ * @param[in] index The zero-based index at which to insert the elements.
+ * @param[in] elements A pointer to the first element.
+ * @param[in] count The number of elements.
+ *
+ * @memberof gap_buffer_t
+ */
+void gap_buffer_insert(gap_buffer_t *gb, size_t index, const void *elements, size_t count);
+
+/**
+ * Removes elements from the gap buffer, and moves the cursor to
+ * where they were.
+ *
+ * Removing at the cursor is O(1). Removing anywhere else first moves
+ * the cursor to the index.
+ *
+ * Aborts if the range `[index, index + count]` is out-of-bounds.
+ *
+ * @param[in] gb The gap buffer.
+ * @param[in] index The zero-based index of the first element to remove.
+ * @param[in] count The number of elements to remove.
+ *
+ * @memberof gap_buffer_t
+ */
+void gap_buffer_remove(gap_buffer_t gb, size_t index, size_t count);
+
+/**
+ * Copies elements from the gap buffer, skipping over the gap.
+ *
+ * Aborts if the range `[index, index + count]` is out-of-bounds.
+ *
+ * @param[in] gb The gap buffer.
+ * @param[in] index The zero-based index at which to begin copying.
+ * @param[out] slice A pointer to memory that can hold `count` elements.
+ * @param[in] count The number of elements to copy.
+ *
+ * @memberof gap_buffer_t
+ */
+void gap_buffer_slice(const gap_buffer_t gb, size_t index, void *slice, size_t count);
+
+/**
+ * Closes the gap by moving the cursor to the end, and returns a
+ * pointer to the gap buffer's contiguous elements.
+ *
+ * This is O(n) with respect to the number of elements after the cursor.
+ *
+ * @param[in] gb The gap buffer.
+ *
+ * @return A pointer to the first element, or `null` if
+ * the gap buffer is empty.
+ *
+ * @memberof gap_buffer_t
+ */
+const void *gap_buffer_as_contiguous(gap_buffer_t gb);
+
+/**
+ * Removes all elements from the gap buffer, and moves the cursor to the
+ * start. Clearing a gap buffer won't shrink its capacity.
+ *
+ * @memberof gap_buffer_t
+ */
+void gap_buffer_clear(gap_buffer_t gb);
+
+/**
+ * Destroys the gap buffer, freeing any memory allocated for it.
+ *
+ * @memberof gap_buffer_t
+ */
+void gap_buffer_delete(gap_buffer_t gb);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // COLLECTC_GAP_BUFFER_H_
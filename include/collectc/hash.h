@@ -0,0 +1,112 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef COLLECTC_HASH_H_
+#define COLLECTC_HASH_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file collectc/hash.h
+ * @brief Fast, non-cryptographic hash functions, for hash tables.
+ *
+ * These hashes mix all of their input into all 64 bits of their output,
+ * so tables can use either the high or the low bits. They are not
+ * cryptographic: a seed that an attacker can't guess makes collisions
+ * hard to find on purpose, but doesn't make the hashes safe for anything
+ * other than hash tables.
+ *
+ * Hashes are only stable within a process. They can differ between
+ * machines and between versions of collectc, so they shouldn't be stored
+ * or sent anywhere.
+ */
+
+/**
+ * @brief Hashes a range of bytes.
+ *
+ * Short inputs are hashed by multiplying 64-bit words into 128-bit
+ * products and folding the halves together, after wyhash. On x86 CPUs
+ * that support AES-NI, which is checked at runtime, inputs of 64 bytes
+ * or more are instead hashed 64 bytes at a time with AES rounds.
+ *
+ * @param[in] data The bytes, which may be `null` if `size` is 0.
+ * @param[in] size The number of bytes.
+ * @param[in] seed The seed, which changes every hash. Tables with
+ * untrusted keys should use a random seed from `hash_random_seed`.
+ *
+ * @return The hash.
+ */
+uint64_t hash_bytes(const void *data, size_t size, uint64_t seed);
+
+/**
+ * @brief Hashes a 64-bit integer.
+ *
+ * For a given seed, this is a bijection, so distinct integers never
+ * have the same hash.
+ *
+ * @param[in] value The integer.
+ * @param[in] seed The seed, which changes every hash.
+ *
+ * @return The hash.
+ */
+uint64_t hash_u64(uint64_t value, uint64_t seed);
+
+/**
+ * @brief Hashes a 32-bit integer.
+ *
+ * @see hash_u64
+ */
+uint64_t hash_u32(uint32_t value, uint64_t seed);
+
+/**
+ * @brief Combines two hashes into one, for hashing keys with
+ * several fields.
+ *
+ * The order matters: combining `a` with `b` usually differs from
+ * combining `b` with `a`.
+ *
+ * @return The combined hash.
+ */
+uint64_t hash_combine(uint64_t first, uint64_t second);
+
+/**
+ * @brief Computes the CRC-32C (Castagnoli) checksum of a range of bytes.
+ *
+ * On x86 CPUs that support SSE4.2, which is checked at runtime, this uses
+ * the CPU's CRC32 instruction. Unlike the other functions here, the result
+ * is the standard checksum, so it's the same on every machine.
+ *
+ * CRCs are linear, so they detect corruption well, but they aren't good
+ * hashes for tables: use `hash_bytes` for those.
+ *
+ * @param[in] data The bytes, which may be `null` if `size` is 0.
+ * @param[in] size The number of bytes.
+ * @param[in] crc The checksum of the preceding bytes, to continue
+ * a checksum across several calls, or 0 to start a new one.
+ *
+ * @return The checksum.
+ */
+uint32_t hash_crc32c(const void *data, size_t size, uint32_t crc);
+
+/**
+ * @brief Returns a seed that's hard to predict from outside the process.
+ *
+ * The seed mixes the current time with addresses that vary between runs
+ * where the system randomizes address space layout. It's meant for
+ * seeding hash tables, not for cryptography.
+ *
+ * @return The seed.
+ */
+uint64_t hash_random_seed(void);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // COLLECTC_HASH_H_
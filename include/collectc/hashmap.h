@@ -0,0 +1,331 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef COLLECTC_HASHMAP_H_
+#define COLLECTC_HASHMAP_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Hashes a key.
+ *
+ * Keys that are equal must have the same hash. The map uses both the
+ * high and the low bits of the hash, so all 64 bits should be well mixed.
+ */
+typedef uint64_t (*hashmap_hash_t)(const void *key);
+
+/**
+ * @brief Compares two keys for equality.
+ *
+ * @return `true` if the keys are equal.
+ */
+typedef bool (*hashmap_equal_t)(const void *a, const void *b);
+
+/**
+ * @brief The slots of a hash map, and their control bytes.
+ *
+ * The fields of this struct are private.
+ */
+typedef struct hashmap_table {
+    /**
+     * One control byte per slot, followed by a copy of the first group
+     * of control bytes, so that a group can be loaded at any slot.
+     * The slots follow the control bytes, in the same allocation.
+     */
+    uint8_t *control;
+    char *slots;
+    /** A power of 2, and at least one group; or 0 if nothing's allocated. */
+    size_t capacity;
+    size_t length;
+    /** The number of empty slots that can be filled before growing. */
+    size_t growthLeft;
+} hashmap_table_t;
+
+/**
+ * @brief An unordered map from keys to values, stored in an open-addressed
+ * hash table.
+ *
+ * Hash maps are Swiss tables: next to its slots, the table keeps a control
+ * byte for each slot, which says whether the slot is empty, or holds 7 bits
+ * of its key's hash. Looking up a key compares all 16 control bytes in a
+ * group at once, with SSE2 where it's available, or with 64-bit words
+ * elsewhere. Only slots whose control bytes match are compared with the
+ * key, so lookups rarely compare more than one key, even in a full table.
+ *
+ * Like vectors, all keys of a map have the same size, and all values have
+ * the same size, which may be 0. Keys and values are copied into the map.
+ * The map hashes and compares keys with callbacks; if they're `null`, it
+ * hashes the keys' bytes with `hash_bytes` and compares them with `memcmp`.
+ *
+ * The table grows when it's 7/8 full. Removing a key usually empties its
+ * slot; it only leaves a tombstone if the slot is in a run of at least a
+ * group of full slots, which a lookup might have probed past.
+ *
+ * Growing moves every entry into the new table at once, which can stall
+ * a single insert into a large map for a long time. Incremental hash maps,
+ * created with `hashmap_new_incremental`, keep the old table instead, and
+ * each insert or removal moves at most one group of its slots into the new
+ * table, until it's empty. Lookups check both tables while entries are
+ * being moved, so they can take up to twice as long, but no insert moves
+ * more than one group of entries, however large the map.
+ *
+ * Inserting, and in an incremental map removing, can invalidate existing
+ * pointers to any keys and values. Hash maps are not internally
+ * synchronized.
+ *
+ * The fields of this struct are private.
+ *
+ * @class hashmap_t collectc/hashmap.h
+ */
+typedef struct hashmap {
+    hashmap_table_t table;
+    /**
+     * In an incremental map that's growing, the table that entries are
+     * still being moved out of; otherwise, empty, with capacity 0.
+     */
+    hashmap_table_t old;
+    /** The index of the first slot of `old` that hasn't been moved. */
+    size_t migrated;
+    bool incremental;
+    hashmap_hash_t hash;
+    hashmap_equal_t equal;
+    size_t keySize;
+    size_t valueSize;
+    /** The offset of each value from the start of its slot. */
+    size_t valueOffset;
+    size_t slotSize;
+} hashmap_t;
+
+/**
+ * @brief An iterator over the entries of a hash map, in no particular order.
+ *
+ * The fields of this struct are private.
+ *
+ * @class hashmap_iter_t collectc/hashmap.h
+ */
+typedef struct hashmap_iter {
+    const hashmap_t *map;
+    size_t index;
+} hashmap_iter_t;
+
+/**
+ * @brief Creates a new, empty hash map, which doesn't allocate until
+ * the first insert.
+ *
+ * @param[in] keySize The size of each key.
+ * @param[in] valueSize The size of each value, which may be 0.
+ * @param[in] hash The hash function for keys, or `null` to hash
+ * their bytes.
+ * @param[in] equal The equality function for keys, or `null` to compare
+ * their bytes.
+ * @return The new hash map.
+ *
+ * @memberof hashmap_t
+ * @static
+ */
+hashmap_t hashmap_new(size_t keySize, size_t valueSize, hashmap_hash_t hash, hashmap_equal_t equal);
+
+/**
+ * @brief Creates a new, empty hash map that moves its entries into a
+ * new table a group at a time when it grows, rather than all at once.
+ *
+ * Inserts into an incremental map take a bounded time, however large the
+ * map is, at the cost of slower lookups while it's growing, and of holding
+ * both tables until every entry has been moved.
+ *
+ * @see hashmap_new
+ *
+ * @memberof hashmap_t
+ * @static
+ */
+hashmap_t hashmap_new_incremental(size_t keySize, size_t valueSize, hashmap_hash_t hash, hashmap_equal_t equal);
+
+/**
+ * @return The number of entries in the hash map.
+ *
+ * @memberof hashmap_t
+ */
+size_t hashmap_len(const hashmap_t *map);
+
+/**
+ * @return `true` if the hash map is empty.
+ *
+ * @memberof hashmap_t
+ */
+bool hashmap_is_empty(const hashmap_t *map);
+
+/**
+ * @return The number of entries that the hash map can hold
+ * without growing.
+ *
+ * @memberof hashmap_t
+ */
+size_t hashmap_capacity(const hashmap_t *map);
+
+/**
+ * @return The size of each key.
+ *
+ * @memberof hashmap_t
+ */
+size_t hashmap_key_size(const hashmap_t *map);
+
+/**
+ * @return The size of each value.
+ *
+ * @memberof hashmap_t
+ */
+size_t hashmap_value_size(const hashmap_t *map);
+
+/**
+ * Looks up the value for a key.
+ *
+ * This operation is expected O(1).
+ *
+ * @param[in] map The hash map.
+ * @param[in] key A pointer to the key.
+ *
+ * @return A constant pointer to the key's value, or `null` if the key
+ * isn't in the map.
+ *
+ * @memberof hashmap_t
+ */
+const void *hashmap_get(const hashmap_t *map, const void *key);
+
+/**
+ * Looks up a mutable pointer to the value for a key.
+ *
+ * @see hashmap_get
+ *
+ * @memberof hashmap_t
+ */
+void *hashmap_get_mut(hashmap_t *map, const void *key);
+
+/**
+ * @return `true` if the key is in the hash map.
+ *
+ * @memberof hashmap_t
+ */
+bool hashmap_contains(const hashmap_t *map, const void *key);
+
+/**
+ * Inserts a key and its value into the hash map, replacing the value
+ * if the key is already in the map.
+ *
+ * Inserting is expected O(1), and amortized O(1) if the map grows.
+ *
+ * Aborts on memory allocation failure.
+ *
+ * @param[inout] map The hash map.
+ * @param[in] key A pointer to the key.
+ * @param[in] value A pointer to the value, which may be `null` if the
+ * value size is 0.
+ *
+ * @return `true` if the key is new, or `false` if its value was replaced.
+ *
+ * @memberof hashmap_t
+ */
+bool hashmap_insert(hashmap_t *map, const void *key, const void *value);
+
+/**
+ * Returns the value for a key, inserting the key with a zeroed value
+ * first if it isn't in the map.
+ *
+ * Aborts on memory allocation failure.
+ *
+ * @param[inout] map The hash map.
+ * @param[in] key A pointer to the key.
+ * @param[out] inserted Set to `true` if the key is new, or `null`
+ * to ignore it.
+ *
+ * @return A mutable pointer to the key's value.
+ *
+ * @memberof hashmap_t
+ */
+void *hashmap_get_or_insert(hashmap_t *map, const void *key, bool *inserted);
+
+/**
+ * Removes a key and its value from the hash map.
+ *
+ * Removing is expected O(1), and never shrinks the map.
+ *
+ * @param[inout] map The hash map.
+ * @param[in] key A pointer to the key.
+ * @param[out] value Memory that can hold the removed value, or `null`
+ * to ignore it.
+ *
+ * @return `false` if the key isn't in the map.
+ *
+ * @memberof hashmap_t
+ */
+bool hashmap_remove(hashmap_t *map, const void *key, void *value);
+
+/**
+ * Grows the hash map, if needed, to hold at least `extraCapacity` more
+ * entries without growing again.
+ *
+ * Aborts on memory allocation failure.
+ *
+ * @memberof hashmap_t
+ */
+void hashmap_reserve(hashmap_t *map, size_t extraCapacity);
+
+/**
+ * Shrinks the hash map to the smallest table that holds its entries,
+ * and drops any tombstones. Shrinking an empty map frees its table.
+ *
+ * Aborts on memory allocation failure.
+ *
+ * @memberof hashmap_t
+ */
+void hashmap_shrink(hashmap_t *map);
+
+/**
+ * Removes all entries from the hash map, without shrinking its capacity.
+ *
+ * @memberof hashmap_t
+ */
+void hashmap_clear(hashmap_t *map);
+
+/**
+ * Destroys the hash map, freeing any memory allocated for it.
+ *
+ * @memberof hashmap_t
+ */
+void hashmap_delete(hashmap_t *map);
+
+/**
+ * @brief Creates an iterator over the entries of a hash map.
+ *
+ * Inserting into or removing from the map invalidates the iterator.
+ *
+ * @memberof hashmap_iter_t
+ * @static
+ */
+hashmap_iter_t hashmap_iter_new(const hashmap_t *map);
+
+/**
+ * Advances to the next entry.
+ *
+ * @param[inout] iter The iterator.
+ * @param[out] key Set to a pointer to the entry's key.
+ * @param[out] value Set to a pointer to the entry's value, or `null`
+ * to ignore it.
+ *
+ * @return `false` if there are no more entries.
+ *
+ * @memberof hashmap_iter_t
+ */
+bool hashmap_iter_next(hashmap_iter_t *iter, const void **key, void **value);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // COLLECTC_HASHMAP_H_
@@ -0,0 +1,251 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef COLLECTC_HASHSET_H_
+#define COLLECTC_HASHSET_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <collectc/hashmap.h>
+#include <collectc/vector.h>
+
+/**
+ * @brief An unordered set of unique elements, stored in a hash table.
+ *
+ * Hash sets are hash maps whose values have size 0, so they have the
+ * same Swiss table layout, and the same expected O(1) inserts, lookups,
+ * and removals. Elements are hashed and compared with callbacks, or by
+ * their bytes if the callbacks are `null`.
+ *
+ * Building a set from a vector, and combining sets, grows the table once
+ * up front, instead of rehashing repeatedly as elements are added.
+ *
+ * Like vectors, all elements of a set have the same size. Inserting can
+ * invalidate existing pointers to any elements. Hash sets are not
+ * internally synchronized.
+ *
+ * The fields of this struct are private.
+ *
+ * @class hashset_t collectc/hashset.h
+ */
+typedef struct hashset {
+    hashmap_t map;
+} hashset_t;
+
+/**
+ * @brief An iterator over the elements of a hash set, in no particular order.
+ *
+ * The fields of this struct are private.
+ *
+ * @class hashset_iter_t collectc/hashset.h
+ */
+typedef struct hashset_iter {
+    hashmap_iter_t inner;
+} hashset_iter_t;
+
+/**
+ * @brief Creates a new, empty hash set, which doesn't allocate until
+ * the first insert.
+ *
+ * @param[in] elementSize The size of each element.
+ * @param[in] hash The hash function for elements, or `null` to hash
+ * their bytes.
+ * @param[in] equal The equality function for elements, or `null` to
+ * compare their bytes.
+ * @return The new hash set.
+ *
+ * @memberof hashset_t
+ * @static
+ */
+hashset_t hashset_new(size_t elementSize, hashmap_hash_t hash, hashmap_equal_t equal);
+
+/**
+ * @brief Creates a hash set with the unique elements of a vector.
+ *
+ * The set is sized for all of the vector's elements before any are
+ * inserted, so it never grows while it's built. If many elements are
+ * duplicates, that table is larger than the set needs, and
+ * `hashset_shrink` can trim it. The vector is unchanged.
+ *
+ * Aborts on memory allocation failure.
+ *
+ * @see hashset_new
+ *
+ * @memberof hashset_t
+ * @static
+ */
+hashset_t hashset_from_vector(const vector_t vec, hashmap_hash_t hash, hashmap_equal_t equal);
+
+/**
+ * Copies the elements of the hash set into a new vector, in no
+ * particular order. The vector's capacity is the set's length.
+ *
+ * Aborts on memory allocation failure.
+ *
+ * @memberof hashset_t
+ */
+vector_t hashset_to_vector(const hashset_t *set);
+
+/**
+ * @return The number of elements in the hash set.
+ *
+ * @memberof hashset_t
+ */
+size_t hashset_len(const hashset_t *set);
+
+/**
+ * @return `true` if the hash set is empty.
+ *
+ * @memberof hashset_t
+ */
+bool hashset_is_empty(const hashset_t *set);
+
+/**
+ * @return The number of elements that the hash set can hold
+ * without growing.
+ *
+ * @memberof hashset_t
+ */
+size_t hashset_capacity(const hashset_t *set);
+
+/**
+ * @return The size of each element.
+ *
+ * @memberof hashset_t
+ */
+size_t hashset_element_size(const hashset_t *set);
+
+/**
+ * Inserts an element into the hash set, if it isn't already in the set.
+ *
+ * Aborts on memory allocation failure.
+ *
+ * @param[inout] set The hash set.
+ * @param[in] element A pointer to the element.
+ *
+ * @return `true` if the element is new.
+ *
+ * @memberof hashset_t
+ */
+bool hashset_insert(hashset_t *set, const void *element);
+
+/**
+ * @return `true` if the element is in the hash set.
+ *
+ * @memberof hashset_t
+ */
+bool hashset_contains(const hashset_t *set, const void *element);
+
+/**
+ * Removes an element from the hash set.
+ *
+ * @return `false` if the element isn't in the set.
+ *
+ * @memberof hashset_t
+ */
+bool hashset_remove(hashset_t *set, const void *element);
+
+/**
+ * Adds every element of another set to this set.
+ *
+ * Aborts on memory allocation failure, or if the sets have
+ * different element sizes.
+ *
+ * @param[inout] set This set.
+ * @param[in] other The other set, which is unchanged.
+ *
+ * @memberof hashset_t
+ */
+void hashset_union(hashset_t *set, const hashset_t *other);
+
+/**
+ * Removes every element of this set that isn't in another set.
+ *
+ * Aborts if the sets have different element sizes.
+ *
+ * @param[inout] set This set.
+ * @param[in] other The other set, which is unchanged.
+ *
+ * @memberof hashset_t
+ */
+void hashset_intersection(hashset_t *set, const hashset_t *other);
+
+/**
+ * Removes every element of this set that's in another set.
+ *
+ * Aborts if the sets have different element sizes.
+ *
+ * @param[inout] set This set.
+ * @param[in] other The other set, which is unchanged.
+ *
+ * @memberof hashset_t
+ */
+void hashset_difference(hashset_t *set, const hashset_t *other);
+
+/**
+ * Grows the hash set, if needed, to hold at least `extraCapacity` more
+ * elements without growing again.
+ *
+ * @see hashmap_reserve
+ *
+ * @memberof hashset_t
+ */
+void hashset_reserve(hashset_t *set, size_t extraCapacity);
+
+/**
+ * Shrinks the hash set to the smallest table that holds its elements.
+ *
+ * @see hashmap_shrink
+ *
+ * @memberof hashset_t
+ */
+void hashset_shrink(hashset_t *set);
+
+/**
+ * Removes all elements from the hash set, without shrinking its capacity.
+ *
+ * @memberof hashset_t
+ */
+void hashset_clear(hashset_t *set);
+
+/**
+ * Destroys the hash set, freeing any memory allocated for it.
+ *
+ * @memberof hashset_t
+ */
+void hashset_delete(hashset_t *set);
+
+/**
+ * @brief Creates an iterator over the elements of a hash set.
+ *
+ * Inserting into or removing from the set invalidates the iterator.
+ *
+ * @memberof hashset_iter_t
+ * @static
+ */
+hashset_iter_t hashset_iter_new(const hashset_t *set);
+
+/**
+ * Advances to the next element.
+ *
+ * @param[inout] iter The iterator.
+ * @param[out] element Set to a pointer to the element.
+ *
+ * @return `false` if there are no more elements.
+ *
+ * @memberof hashset_iter_t
+ */
+bool hashset_iter_next(hashset_iter_t *iter, const void **element);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // COLLECTC_HASHSET_H_
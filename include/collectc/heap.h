@@ -0,0 +1,167 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef COLLECTC_HEAP_H_
+#define COLLECTC_HEAP_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <collectc/vector.h>
+
+/**
+ * @brief Compares two elements, like the comparator for `qsort`.
+ *
+ * @return A negative number if `a` comes before `b`, zero if they're
+ * equal, or a positive number if `a` comes after `b`.
+ */
+typedef int (*heap_compare_t)(const void *a, const void *b);
+
+/**
+ * @brief A priority queue, stored as an implicit d-ary heap in a vector.
+ *
+ * Heaps keep their elements partially ordered by a comparator, so that
+ * the first element, in comparator order, is always at the top. Peeking
+ * at the top is O(1), and pushing and popping are O(log n), instead of
+ * the O(n) it takes to keep a vector sorted.
+ *
+ * Each element has either 2 or 4 children, set by the heap's arity. A
+ * 4-ary heap is half as deep as a binary heap, and all of an element's
+ * children are usually in the same cache line, so it's faster for large
+ * heaps, where most comparisons miss the cache.
+ *
+ * Like vectors, all elements of a heap have the same size, and pushing
+ * or popping can invalidate existing pointers to any elements.
+ *
+ * The fields of this struct are private.
+ *
+ * @class heap_t collectc/heap.h
+ */
+typedef struct heap {
+    vector_t elements;
+    heap_compare_t compare;
+    size_t arity;
+    /** Holds the element being sifted through the heap. */
+    void *scratch;
+} heap_t;
+
+/**
+ * @brief Creates a new, empty heap.
+ *
+ * Aborts on memory allocation failure, or if the arity isn't 2 or 4.
+ *
+ * @param[in] elementSize The size of each element.
+ * @param[in] arity The number of children of each element: 2 or 4.
+ * @param[in] compare The comparator. The heap's top is the element
+ * that compares before all others.
+ * @return The new heap.
+ *
+ * @memberof heap_t
+ * @static
+ */
+heap_t heap_new(size_t elementSize, size_t arity, heap_compare_t compare);
+
+/**
+ * @brief Creates a heap from the elements of a vector.
+ *
+ * The heap takes ownership of the vector, and reorders its elements in
+ * place. This is O(n), which is faster than pushing the elements one
+ * at a time.
+ *
+ * Sifting needs the elements in one place, so the heap keeps an
+ * incremental vector contiguous, and pushes that grow it move every
+ * element at once, as with a regular vector.
+ *
+ * @see heap_new
+ *
+ * @memberof heap_t
+ * @static
+ */
+heap_t heap_from_vector(vector_t vec, size_t arity, heap_compare_t compare);
+
+/**
+ * @return The number of elements in the heap.
+ *
+ * @memberof heap_t
+ */
+size_t heap_len(const heap_t *heap);
+
+/**
+ * @return `true` if the heap is empty.
+ *
+ * @memberof heap_t
+ */
+bool heap_is_empty(const heap_t *heap);
+
+/**
+ * @return The size of each element.
+ *
+ * @memberof heap_t
+ */
+size_t heap_element_size(const heap_t *heap);
+
+/**
+ * Returns the top element, which compares before all others.
+ *
+ * @param[in] heap The heap.
+ * @return A pointer to the top element, or `null` if the heap is empty.
+ *
+ * @memberof heap_t
+ */
+const void *heap_peek(const heap_t *heap);
+
+/**
+ * Adds an element to the heap.
+ *
+ * Pushing is O(log n), and amortized O(1) if the element belongs near
+ * the bottom of the heap.
+ *
+ * Aborts on memory allocation failure.
+ *
+ * @param[inout] heap The heap.
+ * @param[in] element A pointer to the element.
+ *
+ * @memberof heap_t
+ */
+void heap_push(heap_t *heap, const void *element);
+
+/**
+ * Removes the top element from the heap.
+ *
+ * Popping is O(log n).
+ *
+ * @param[inout] heap The heap.
+ * @param[out] element A pointer to memory that will hold the removed
+ * element, or `null` to discard it.
+ * @return `true` if an element was removed, or `false` if the heap
+ * was empty.
+ *
+ * @memberof heap_t
+ */
+bool heap_pop(heap_t *heap, void *element);
+
+/**
+ * Removes all elements from the heap, without shrinking its capacity.
+ *
+ * @memberof heap_t
+ */
+void heap_clear(heap_t *heap);
+
+/**
+ * Destroys the heap, freeing any memory allocated for it.
+ *
+ * @memberof heap_t
+ */
+void heap_delete(heap_t *heap);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // COLLECTC_HEAP_H_
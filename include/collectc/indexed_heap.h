@@ -0,0 +1,214 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef COLLECTC_INDEXED_HEAP_H_
+#define COLLECTC_INDEXED_HEAP_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <collectc/heap.h>
+#include <collectc/vector.h>
+
+/**
+ * @brief A priority queue of items with integer ids, whose keys can be
+ * changed in place.
+ *
+ * Indexed heaps are d-ary heaps, like `heap_t`, that also keep a position
+ * map from each item's id to its slot in the heap. This lets them find any
+ * queued item in O(1), and change its key or remove it in O(log n), instead
+ * of pushing a duplicate with the new key and skipping the stale one later.
+ * Shortest-path searches, which lower the keys of queued nodes, are the
+ * classic use.
+ *
+ * Ids index the position map directly, so they should be small and dense,
+ * like array indices: the map takes `O(largest id)` space. Each id can be
+ * in the heap at most once.
+ *
+ * The keys and ids are stored in heap order in two parallel vectors, so
+ * comparisons during sifting read keys contiguously, and the position map
+ * is a third vector.
+ *
+ * The fields of this struct are private.
+ *
+ * @class indexed_heap_t collectc/indexed_heap.h
+ */
+typedef struct indexed_heap {
+    /** The keys, in heap order. */
+    vector_t keys;
+    /** The ids of the keys, in heap order. */
+    vector_t ids;
+    /** The heap slot of each id, or `SIZE_MAX` if it's not in the heap. */
+    vector_t positions;
+    heap_compare_t compare;
+    size_t arity;
+    /** Holds the key being sifted through the heap. */
+    void *scratch;
+} indexed_heap_t;
+
+/**
+ * @brief Creates a new, empty indexed heap.
+ *
+ * Aborts on memory allocation failure, or if the arity isn't 2 or 4.
+ *
+ * @param[in] keySize The size of each key.
+ * @param[in] arity The number of children of each item: 2 or 4.
+ * @param[in] compare The comparator for keys. The heap's top is the
+ * item whose key compares before all others.
+ * @return The new indexed heap.
+ *
+ * @memberof indexed_heap_t
+ * @static
+ */
+indexed_heap_t indexed_heap_new(size_t keySize, size_t arity, heap_compare_t compare);
+
+/**
+ * @return The number of items in the heap.
+ *
+ * @memberof indexed_heap_t
+ */
+size_t indexed_heap_len(const indexed_heap_t *heap);
+
+/**
+ * @return `true` if the heap is empty.
+ *
+ * @memberof indexed_heap_t
+ */
+bool indexed_heap_is_empty(const indexed_heap_t *heap);
+
+/**
+ * @return `true` if the item with the id is in the heap.
+ *
+ * @memberof indexed_heap_t
+ */
+bool indexed_heap_contains(const indexed_heap_t *heap, size_t id);
+
+/**
+ * Returns the key of an item in the heap.
+ *
+ * @param[in] heap The heap.
+ * @param[in] id The item's id.
+ * @return A pointer to the item's key, or `null` if the item isn't
+ * in the heap.
+ *
+ * @memberof indexed_heap_t
+ */
+const void *indexed_heap_key(const indexed_heap_t *heap, size_t id);
+
+/**
+ * Returns the top item, whose key compares before all others.
+ *
+ * @param[in] heap The heap.
+ * @param[out] id Where to store the top item's id.
+ * @return A pointer to the top item's key, or `null` if the heap is empty.
+ *
+ * @memberof indexed_heap_t
+ */
+const void *indexed_heap_peek(const indexed_heap_t *heap, size_t *id);
+
+/**
+ * Adds an item to the heap.
+ *
+ * Pushing is O(log n), and O(id) if the position map needs to grow.
+ *
+ * Aborts on memory allocation failure, if the id is `SIZE_MAX`, or if
+ * the item is already in the heap.
+ *
+ * @param[inout] heap The heap.
+ * @param[in] id The item's id.
+ * @param[in] key A pointer to the item's key.
+ *
+ * @memberof indexed_heap_t
+ */
+void indexed_heap_push(indexed_heap_t *heap, size_t id, const void *key);
+
+/**
+ * Removes the top item from the heap.
+ *
+ * Popping is O(log n).
+ *
+ * @param[inout] heap The heap.
+ * @param[out] id Where to store the removed item's id, or `null`.
+ * @param[out] key A pointer to memory that will hold the removed item's
+ * key, or `null`.
+ * @return `true` if an item was removed, or `false` if the heap was empty.
+ *
+ * @memberof indexed_heap_t
+ */
+bool indexed_heap_pop(indexed_heap_t *heap, size_t *id, void *key);
+
+/**
+ * Replaces an item's key with one that compares before or equal to it,
+ * moving the item toward the top of the heap.
+ *
+ * This is O(log n).
+ *
+ * Aborts if the item isn't in the heap, or if the new key compares
+ * after the current one.
+ *
+ * @param[inout] heap The heap.
+ * @param[in] id The item's id.
+ * @param[in] key A pointer to the new key.
+ *
+ * @memberof indexed_heap_t
+ */
+void indexed_heap_decrease_key(indexed_heap_t *heap, size_t id, const void *key);
+
+/**
+ * Replaces an item's key with one that compares after or equal to it,
+ * moving the item toward the bottom of the heap.
+ *
+ * This is O(log n).
+ *
+ * Aborts if the item isn't in the heap, or if the new key compares
+ * before the current one.
+ *
+ * @see indexed_heap_decrease_key
+ *
+ * @memberof indexed_heap_t
+ */
+void indexed_heap_increase_key(indexed_heap_t *heap, size_t id, const void *key);
+
+/**
+ * Removes an item from anywhere in the heap.
+ *
+ * This is O(log n).
+ *
+ * @param[inout] heap The heap.
+ * @param[in] id The item's id.
+ * @param[out] key A pointer to memory that will hold the removed
+ * item's key, or `null`.
+ * @return `true` if the item was removed, or `false` if it wasn't
+ * in the heap.
+ *
+ * @memberof indexed_heap_t
+ */
+bool indexed_heap_remove(indexed_heap_t *heap, size_t id, void *key);
+
+/**
+ * Removes all items from the heap, without shrinking its capacity.
+ *
+ * This is O(n), to reset the items' positions.
+ *
+ * @memberof indexed_heap_t
+ */
+void indexed_heap_clear(indexed_heap_t *heap);
+
+/**
+ * Destroys the heap, freeing any memory allocated for it.
+ *
+ * @memberof indexed_heap_t
+ */
+void indexed_heap_delete(indexed_heap_t *heap);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // COLLECTC_INDEXED_HEAP_H_
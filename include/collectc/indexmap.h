@@ -0,0 +1,344 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef COLLECTC_INDEXMAP_H_
+#define COLLECTC_INDEXMAP_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <collectc/hashmap.h>
+#include <collectc/vector.h>
+
+/**
+ * @brief A map from keys to values that remembers the order in which
+ * keys were inserted.
+ *
+ * Index maps store their entries densely, in insertion order, in a
+ * vector, so iterating is a linear scan, and entries can be looked up by
+ * their position as well as by key. A separate hash table of 32-bit slots
+ * maps keys to positions. Each slot holds an entry's position, and as many
+ * bits of its key's hash as the position leaves free, so most probes that
+ * don't match are rejected without reading the entry.
+ *
+ * The table is probed linearly, and grows when it's 3/4 full. Entries
+ * are just keys and values, without their hashes, so growing rehashes
+ * every key. The entries grow with the table, to the number of entries
+ * that it can hold, so the two are never out of step.
+ *
+ * Keys are hashed and compared with callbacks, or by their bytes if the
+ * callbacks are `null`. Replacing a key's value keeps its position.
+ * Removing an entry either swaps the last entry into its position, which
+ * is O(1), or shifts the later entries down, which keeps their order
+ * but is O(n).
+ *
+ * An index map holds at most 3 * 2^30 entries, which fill a table of
+ * 2^32 slots to 3/4. All keys have the same size, and all values have the
+ * same size, which may be 0; both are aligned to at most 8 bytes.
+ * Inserting can invalidate existing pointers to any keys and values.
+ * Index maps are not internally synchronized.
+ *
+ * The fields of this struct are private.
+ *
+ * @class indexmap_t collectc/indexmap.h
+ */
+typedef struct indexmap {
+    /** The entries, in order. Each is its key, then its value. */
+    vector_t entries;
+    /**
+     * The hash table. A slot holds 0 if it's empty; otherwise, its bits
+     * below the capacity's hold the entry's position plus 1, and the
+     * rest hold the same bits of the upper half of its key's hash.
+     */
+    uint32_t *slots;
+    /** A power of 2, up to 2^32, or 0 if nothing's allocated. */
+    size_t capacity;
+    hashmap_hash_t hash;
+    hashmap_equal_t equal;
+    size_t keySize;
+    size_t valueSize;
+    size_t valueOffset;
+    size_t entrySize;
+    /** Space for building one entry before it's pushed. */
+    void *scratch;
+} indexmap_t;
+
+/**
+ * @brief An iterator over the entries of an index map, in order.
+ *
+ * The fields of this struct are private.
+ *
+ * @class indexmap_iter_t collectc/indexmap.h
+ */
+typedef struct indexmap_iter {
+    const indexmap_t *map;
+    size_t index;
+} indexmap_iter_t;
+
+/**
+ * @brief Creates a new, empty index map.
+ *
+ * Aborts on memory allocation failure.
+ *
+ * @param[in] keySize The size of each key.
+ * @param[in] valueSize The size of each value, which may be 0.
+ * @param[in] hash The hash function for keys, or `null` to hash
+ * their bytes.
+ * @param[in] equal The equality function for keys, or `null` to compare
+ * their bytes.
+ * @return The new index map.
+ *
+ * @memberof indexmap_t
+ * @static
+ */
+indexmap_t indexmap_new(size_t keySize, size_t valueSize, hashmap_hash_t hash, hashmap_equal_t equal);
+
+/**
+ * @return The number of entries in the index map.
+ *
+ * @memberof indexmap_t
+ */
+size_t indexmap_len(const indexmap_t *map);
+
+/**
+ * @return `true` if the index map is empty.
+ *
+ * @memberof indexmap_t
+ */
+bool indexmap_is_empty(const indexmap_t *map);
+
+/**
+ * @return The number of entries that the index map's table can hold
+ * without growing.
+ *
+ * @memberof indexmap_t
+ */
+size_t indexmap_capacity(const indexmap_t *map);
+
+/**
+ * @return The size of each key.
+ *
+ * @memberof indexmap_t
+ */
+size_t indexmap_key_size(const indexmap_t *map);
+
+/**
+ * @return The size of each value.
+ *
+ * @memberof indexmap_t
+ */
+size_t indexmap_value_size(const indexmap_t *map);
+
+/**
+ * Looks up the value for a key.
+ *
+ * This operation is expected O(1).
+ *
+ * @param[in] map The index map.
+ * @param[in] key A pointer to the key.
+ *
+ * @return A constant pointer to the key's value, or `null` if the key
+ * isn't in the map.
+ *
+ * @memberof indexmap_t
+ */
+const void *indexmap_get(const indexmap_t *map, const void *key);
+
+/**
+ * Looks up a mutable pointer to the value for a key.
+ *
+ * @see indexmap_get
+ *
+ * @memberof indexmap_t
+ */
+void *indexmap_get_mut(indexmap_t *map, const void *key);
+
+/**
+ * @return `true` if the key is in the index map.
+ *
+ * @memberof indexmap_t
+ */
+bool indexmap_contains(const indexmap_t *map, const void *key);
+
+/**
+ * Looks up the position of a key's entry.
+ *
+ * This operation is expected O(1).
+ *
+ * @return The zero-based position of the entry, or `SIZE_MAX` if the
+ * key isn't in the map.
+ *
+ * @memberof indexmap_t
+ */
+size_t indexmap_index_of(const indexmap_t *map, const void *key);
+
+/**
+ * Returns the key of the entry at a position.
+ *
+ * This operation is O(1).
+ *
+ * @param[in] map The index map.
+ * @param[in] index The zero-based position of the entry.
+ *
+ * @return A constant pointer to the key, or `null` if the index
+ * is out-of-bounds.
+ *
+ * @memberof indexmap_t
+ */
+const void *indexmap_key_at(const indexmap_t *map, size_t index);
+
+/**
+ * Returns the value of the entry at a position.
+ *
+ * This operation is O(1).
+ *
+ * @param[in] map The index map.
+ * @param[in] index The zero-based position of the entry.
+ *
+ * @return A constant pointer to the value, or `null` if the index
+ * is out-of-bounds.
+ *
+ * @memberof indexmap_t
+ */
+const void *indexmap_value_at(const indexmap_t *map, size_t index);
+
+/**
+ * Returns a mutable pointer to the value of the entry at a position.
+ *
+ * @see indexmap_value_at
+ *
+ * @memberof indexmap_t
+ */
+void *indexmap_value_at_mut(indexmap_t *map, size_t index);
+
+/**
+ * Inserts a key and its value into the index map. A new key's entry goes
+ * after all the others; if the key is already in the map, its value is
+ * replaced, and its entry keeps its position.
+ *
+ * Inserting is expected O(1), and amortized O(1) if the map grows.
+ *
+ * Aborts on memory allocation failure, or if the map is full.
+ *
+ * @param[inout] map The index map.
+ * @param[in] key A pointer to the key.
+ * @param[in] value A pointer to the value, which may be `null` if the
+ * value size is 0.
+ *
+ * @return `true` if the key is new, or `false` if its value was replaced.
+ *
+ * @memberof indexmap_t
+ */
+bool indexmap_insert(indexmap_t *map, const void *key, const void *value);
+
+/**
+ * Returns the value for a key, inserting the key with a zeroed value
+ * after all the other entries first if it isn't in the map.
+ *
+ * Aborts on memory allocation failure, or if the map is full.
+ *
+ * @param[inout] map The index map.
+ * @param[in] key A pointer to the key.
+ * @param[out] inserted Set to `true` if the key is new, or `null`
+ * to ignore it.
+ *
+ * @return A mutable pointer to the key's value.
+ *
+ * @memberof indexmap_t
+ */
+void *indexmap_get_or_insert(indexmap_t *map, const void *key, bool *inserted);
+
+/**
+ * Removes a key and its value from the index map, moving the last entry
+ * into the removed entry's position.
+ *
+ * This operation is expected O(1), but changes the order of the entries.
+ *
+ * @param[inout] map The index map.
+ * @param[in] key A pointer to the key.
+ * @param[out] value Memory that can hold the removed value, or `null`
+ * to ignore it.
+ *
+ * @return `false` if the key isn't in the map.
+ *
+ * @memberof indexmap_t
+ */
+bool indexmap_swap_remove(indexmap_t *map, const void *key, void *value);
+
+/**
+ * Removes a key and its value from the index map, shifting every later
+ * entry down one position, so the entries stay in order.
+ *
+ * This operation is O(n): it moves the later entries, and renumbers
+ * their slots in the table.
+ *
+ * @param[inout] map The index map.
+ * @param[in] key A pointer to the key.
+ * @param[out] value Memory that can hold the removed value, or `null`
+ * to ignore it.
+ *
+ * @return `false` if the key isn't in the map.
+ *
+ * @memberof indexmap_t
+ */
+bool indexmap_remove(indexmap_t *map, const void *key, void *value);
+
+/**
+ * Grows the index map, if needed, to hold at least `extraCapacity` more
+ * entries without growing again.
+ *
+ * Aborts on memory allocation failure.
+ *
+ * @memberof indexmap_t
+ */
+void indexmap_reserve(indexmap_t *map, size_t extraCapacity);
+
+/**
+ * Removes all entries from the index map, without shrinking its capacity.
+ *
+ * @memberof indexmap_t
+ */
+void indexmap_clear(indexmap_t *map);
+
+/**
+ * Destroys the index map, freeing any memory allocated for it.
+ *
+ * @memberof indexmap_t
+ */
+void indexmap_delete(indexmap_t *map);
+
+/**
+ * @brief Creates an iterator over the entries of an index map, in order.
+ *
+ * Inserting into or removing from the map invalidates the iterator.
+ *
+ * @memberof indexmap_iter_t
+ * @static
+ */
+indexmap_iter_t indexmap_iter_new(const indexmap_t *map);
+
+/**
+ * Advances to the next entry.
+ *
+ * @param[inout] iter The iterator.
+ * @param[out] key Set to a pointer to the entry's key.
+ * @param[out] value Set to a pointer to the entry's value, or `null`
+ * to ignore it.
+ *
+ * @return `false` if there are no more entries.
+ *
+ * @memberof indexmap_iter_t
+ */
+bool indexmap_iter_next(indexmap_iter_t *iter, const void **key, void **value);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // COLLECTC_INDEXMAP_H_
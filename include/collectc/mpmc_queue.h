@@ -0,0 +1,145 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef COLLECTC_MPMC_QUEUE_H_
+#define COLLECTC_MPMC_QUEUE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief A bounded, lock-free queue that any number of producer and
+ * consumer threads can share.
+ *
+ * MPMC queues are ring buffers with a power-of-two capacity, where each
+ * slot holds a sequence number next to its element. A producer claims a
+ * slot by advancing the shared tail index with a compare-and-swap, writes
+ * the element, and then bumps the slot's sequence number to hand it to
+ * consumers; consumers do the same with the head index. Neither side takes
+ * a lock, and producers and consumers only contend with each other when
+ * the queue is nearly full or empty.
+ *
+ * Pushing and popping work on batches of consecutive slots, claimed with
+ * one compare-and-swap per batch. The `try` variants never block. The
+ * blocking variants wait for room or elements on a futex on Linux, and
+ * yield the processor in a loop on other platforms.
+ *
+ * Creating and destroying the queue must happen while no other threads
+ * are using it.
+ *
+ * @class mpmc_queue_t collectc/mpmc_queue.h
+ */
+typedef struct mpmc_queue mpmc_queue_t;
+
+/**
+ * @brief Creates a new, empty MPMC queue.
+ *
+ * Aborts on memory allocation failure.
+ *
+ * @param[in] capacity The minimum number of elements that the queue can
+ * hold. It's rounded up to a power of two, and at least two.
+ * @param[in] elementSize The size of each element.
+ * @return A pointer to the new queue.
+ *
+ * @memberof mpmc_queue_t
+ * @static
+ */
+mpmc_queue_t *mpmc_queue_new(size_t capacity, size_t elementSize);
+
+/**
+ * @return The number of elements that the queue can hold.
+ *
+ * @memberof mpmc_queue_t
+ */
+size_t mpmc_queue_capacity(const mpmc_queue_t *queue);
+
+/**
+ * @return The size of each element.
+ *
+ * @memberof mpmc_queue_t
+ */
+size_t mpmc_queue_element_size(const mpmc_queue_t *queue);
+
+/**
+ * Returns the number of elements in the queue, including elements that
+ * producers have claimed slots for, but haven't finished writing.
+ *
+ * If other threads are using the queue at the same time, the length
+ * may be out-of-date as soon as it's returned.
+ *
+ * @memberof mpmc_queue_t
+ */
+size_t mpmc_queue_len(const mpmc_queue_t *queue);
+
+/**
+ * Appends as many elements as there are consecutive free slots for,
+ * without blocking.
+ *
+ * @param[inout] queue The queue.
+ * @param[in] elements A pointer to the first element.
+ * @param[in] count The number of elements to push.
+ * @return The number of elements pushed, or zero if the queue was full.
+ *
+ * @memberof mpmc_queue_t
+ */
+size_t mpmc_queue_try_push(mpmc_queue_t *queue, const void *elements, size_t count);
+
+/**
+ * Appends all the elements to the queue, waiting for room as needed.
+ *
+ * Other producers' elements may be interleaved with these if they
+ * don't all fit at once.
+ *
+ * @param[inout] queue The queue.
+ * @param[in] elements A pointer to the first element.
+ * @param[in] count The number of elements to push.
+ *
+ * @memberof mpmc_queue_t
+ */
+void mpmc_queue_push(mpmc_queue_t *queue, const void *elements, size_t count);
+
+/**
+ * Removes up to `count` elements from the front of the queue, without
+ * blocking, and copies them out in order.
+ *
+ * @param[inout] queue The queue.
+ * @param[out] elements A pointer to memory that can hold `count` elements.
+ * @param[in] count The maximum number of elements to pop.
+ * @return The number of elements popped, or zero if the queue was empty.
+ *
+ * @memberof mpmc_queue_t
+ */
+size_t mpmc_queue_try_pop(mpmc_queue_t *queue, void *elements, size_t count);
+
+/**
+ * Removes up to `count` elements from the front of the queue, waiting
+ * until there's at least one.
+ *
+ * @param[inout] queue The queue.
+ * @param[out] elements A pointer to memory that can hold `count` elements.
+ * @param[in] count The maximum number of elements to pop, which must
+ * be above zero.
+ * @return The number of elements popped, which is at least one.
+ *
+ * @memberof mpmc_queue_t
+ */
+size_t mpmc_queue_pop(mpmc_queue_t *queue, void *elements, size_t count);
+
+/**
+ * Destroys the queue, freeing any memory allocated for it.
+ *
+ * @memberof mpmc_queue_t
+ */
+void mpmc_queue_delete(mpmc_queue_t *queue);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // COLLECTC_MPMC_QUEUE_H_
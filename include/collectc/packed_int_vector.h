@@ -0,0 +1,161 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef COLLECTC_PACKED_INT_VECTOR_H_
+#define COLLECTC_PACKED_INT_VECTOR_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <collectc/vector.h>
+
+/**
+ * @brief A growable array of unsigned integers, packed into a fixed
+ * number of bits each.
+ *
+ * Packed integer vectors store each value in `width` bits, back-to-back,
+ * so a vector of ids that fit in 24 bits takes 3/8 of the memory of a
+ * vector of `uint64_t`s. Reading a value is O(1), with a shift and a mask.
+ *
+ * Pushing or setting a value that doesn't fit in the current width widens
+ * the vector to fit it, which repacks all the values in O(n). Pushing many
+ * values at once widens the vector at most once.
+ *
+ * Packed integer vectors are not internally synchronized.
+ *
+ * The fields of this struct are private.
+ *
+ * @class packed_int_vector_t collectc/packed_int_vector.h
+ */
+typedef struct packed_int_vector {
+    vector_t words;
+    size_t length;
+    unsigned width;
+} packed_int_vector_t;
+
+/**
+ * @brief Creates a new, empty packed integer vector.
+ *
+ * Aborts on memory allocation failure, or if the width isn't
+ * between 1 and 64.
+ *
+ * @param[in] initialCapacity The number of values that the vector can
+ * hold at its starting width before reallocating.
+ * @param[in] width The starting number of bits for each value.
+ * @return The new vector.
+ *
+ * @memberof packed_int_vector_t
+ * @static
+ */
+packed_int_vector_t packed_int_vector_new(size_t initialCapacity, unsigned width);
+
+/**
+ * @return The number of values in the vector.
+ *
+ * @memberof packed_int_vector_t
+ */
+size_t packed_int_vector_len(const packed_int_vector_t *pv);
+
+/**
+ * @return The number of bits used to store each value.
+ *
+ * @memberof packed_int_vector_t
+ */
+unsigned packed_int_vector_width(const packed_int_vector_t *pv);
+
+/**
+ * Returns the value at an index.
+ *
+ * This operation is O(1). Aborts if the index is out-of-bounds.
+ *
+ * @memberof packed_int_vector_t
+ */
+uint64_t packed_int_vector_get(const packed_int_vector_t *pv, size_t index);
+
+/**
+ * Replaces the value at an index, widening the vector if the
+ * new value doesn't fit.
+ *
+ * Aborts if the index is out-of-bounds.
+ *
+ * @memberof packed_int_vector_t
+ */
+void packed_int_vector_set(packed_int_vector_t *pv, size_t index, uint64_t value);
+
+/**
+ * Appends values to the vector, widening it once if any of
+ * the values don't fit.
+ *
+ * Pushing is amortized O(count). Aborts on memory allocation failure.
+ *
+ * @param[inout] pv The vector.
+ * @param[in] values A pointer to the first value.
+ * @param[in] count The number of values.
+ *
+ * @memberof packed_int_vector_t
+ */
+void packed_int_vector_push(packed_int_vector_t *pv, const uint64_t *values, size_t count);
+
+/**
+ * Appends the contents of a vector of `uint64_t`s to this vector.
+ *
+ * Aborts on memory allocation failure, or if the other vector's
+ * elements aren't `uint64_t`s.
+ *
+ * @memberof packed_int_vector_t
+ */
+void packed_int_vector_extend(packed_int_vector_t *pv, const vector_t other);
+
+/**
+ * Decodes a range of values into a plain array.
+ *
+ * Decoding is O(count), and uses AVX2 to decode several values at once
+ * when the library is built with it enabled.
+ *
+ * Aborts if the range `[index, index + count]` is out-of-bounds.
+ *
+ * @param[in] pv The vector.
+ * @param[in] index The zero-based index of the first value to decode.
+ * @param[out] values A pointer to memory that can hold `count` values.
+ * @param[in] count The number of values to decode.
+ *
+ * @memberof packed_int_vector_t
+ */
+void packed_int_vector_decode(const packed_int_vector_t *pv, size_t index, uint64_t *values, size_t count);
+
+/**
+ * Repacks the vector's values into a wider number of bits.
+ *
+ * Does nothing if the vector is already at least as wide. Aborts on
+ * memory allocation failure, or if the width is greater than 64.
+ *
+ * @memberof packed_int_vector_t
+ */
+void packed_int_vector_widen(packed_int_vector_t *pv, unsigned width);
+
+/**
+ * Removes all values from the vector, without changing its width
+ * or shrinking its capacity.
+ *
+ * @memberof packed_int_vector_t
+ */
+void packed_int_vector_clear(packed_int_vector_t *pv);
+
+/**
+ * Destroys the vector, freeing any memory allocated for it.
+ *
+ * @memberof packed_int_vector_t
+ */
+void packed_int_vector_delete(packed_int_vector_t *pv);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // COLLECTC_PACKED_INT_VECTOR_H_
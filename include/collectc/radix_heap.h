@@ -0,0 +1,171 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef COLLECTC_RADIX_HEAP_H_
+#define COLLECTC_RADIX_HEAP_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <collectc/vector.h>
+
+/**
+ * @brief A priority queue of integer keys that never go below the last
+ * popped key, like distances in a shortest-path search or timestamps
+ * from a monotone clock.
+ *
+ * Radix heaps sort entries into buckets by the highest bit where their
+ * key differs from the last popped key: bucket 0 holds keys equal to it,
+ * and bucket `b` holds keys whose highest differing bit is bit `b - 1`.
+ * Pushing appends to a bucket, which is O(1). Popping takes from bucket 0,
+ * and when that's empty, finds the smallest key in the first non-empty
+ * bucket and spreads that bucket's entries over the lower buckets. Each
+ * entry can only move down, so popping is amortized O(log C), where C is
+ * the largest difference between a pushed key and the last popped key,
+ * and it never compares entries except in one sequential bucket scan.
+ *
+ * Each entry is a 64-bit key and a value of a fixed size, which are
+ * copied in and out of the heap. Each bucket is a vector of entries.
+ *
+ * The fields of this struct are private.
+ *
+ * @class radix_heap_t collectc/radix_heap.h
+ */
+typedef struct radix_heap {
+    /** One bucket for keys equal to `last`, and one for each bit. */
+    vector_t buckets[65];
+    /** Bit `b - 1` is set if bucket `b` isn't empty. */
+    uint64_t occupied;
+    uint64_t last;
+    /**
+     * The smallest key, if `smallestKnown`, which peeking finds without
+     * moving entries, so that it doesn't change `last`.
+     */
+    uint64_t smallest;
+    bool smallestKnown;
+    size_t length;
+    size_t valueSize;
+    /** Holds the entry being pushed. */
+    void *scratch;
+} radix_heap_t;
+
+/**
+ * @brief Creates a new, empty radix heap, whose last popped key is 0.
+ *
+ * Aborts on memory allocation failure.
+ *
+ * @param[in] valueSize The size of each value, which may be 0.
+ * @return The new radix heap.
+ *
+ * @memberof radix_heap_t
+ * @static
+ */
+radix_heap_t radix_heap_new(size_t valueSize);
+
+/**
+ * @return The number of entries in the radix heap.
+ *
+ * @memberof radix_heap_t
+ */
+size_t radix_heap_len(const radix_heap_t *heap);
+
+/**
+ * @return `true` if the radix heap is empty.
+ *
+ * @memberof radix_heap_t
+ */
+bool radix_heap_is_empty(const radix_heap_t *heap);
+
+/**
+ * @return The size of each value.
+ *
+ * @memberof radix_heap_t
+ */
+size_t radix_heap_value_size(const radix_heap_t *heap);
+
+/**
+ * @return The last popped key, which is the smallest key that
+ * can be pushed.
+ *
+ * @memberof radix_heap_t
+ */
+uint64_t radix_heap_last(const radix_heap_t *heap);
+
+/**
+ * Pushes an entry onto the radix heap.
+ *
+ * Pushing is O(1), and amortized O(1) allocations.
+ *
+ * Aborts on memory allocation failure, or if the key is less than the
+ * last popped key.
+ *
+ * @param[inout] heap The radix heap.
+ * @param[in] key The entry's key.
+ * @param[in] value A pointer to the entry's value, which may be `null`
+ * if the value size is 0.
+ *
+ * @memberof radix_heap_t
+ */
+void radix_heap_push(radix_heap_t *heap, uint64_t key, const void *value);
+
+/**
+ * Finds the smallest key in the radix heap, without removing its entry.
+ *
+ * Peeking doesn't change the last popped key, so any key that's at
+ * least the last popped key can still be pushed afterwards. If bucket 0
+ * is empty, peeking scans the first non-empty bucket, and remembers the
+ * smallest key until the next pop, which is why it takes a mutable heap.
+ *
+ * @param[inout] heap The radix heap.
+ * @param[out] key The smallest key.
+ *
+ * @return `false` if the radix heap is empty.
+ *
+ * @memberof radix_heap_t
+ */
+bool radix_heap_peek(radix_heap_t *heap, uint64_t *key);
+
+/**
+ * Removes an entry with the smallest key from the radix heap, and
+ * makes its key the last popped key. Entries with equal keys are
+ * popped in no particular order.
+ *
+ * Popping is amortized O(log C); see `radix_heap_t`.
+ *
+ * @param[inout] heap The radix heap.
+ * @param[out] key The entry's key, or `null` to ignore it.
+ * @param[out] value Memory that can hold the entry's value, or `null`
+ * to ignore it.
+ *
+ * @return `false` if the radix heap is empty.
+ *
+ * @memberof radix_heap_t
+ */
+bool radix_heap_pop(radix_heap_t *heap, uint64_t *key, void *value);
+
+/**
+ * Removes all entries from the radix heap, without shrinking its
+ * buckets, and resets the last popped key to 0.
+ *
+ * @memberof radix_heap_t
+ */
+void radix_heap_clear(radix_heap_t *heap);
+
+/**
+ * Destroys the radix heap, freeing any memory allocated for it.
+ *
+ * @memberof radix_heap_t
+ */
+void radix_heap_delete(radix_heap_t *heap);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // COLLECTC_RADIX_HEAP_H_
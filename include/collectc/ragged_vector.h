@@ -0,0 +1,262 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef COLLECTC_RAGGED_VECTOR_H_
+#define COLLECTC_RAGGED_VECTOR_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <collectc/vector.h>
+
+/**
+ * @brief The location of one row in a ragged vector's values.
+ */
+typedef struct ragged_vector_row {
+    /** The index of the row's first element in the values vector. */
+    size_t start;
+    /** The number of elements in the row. */
+    size_t length;
+} ragged_vector_row_t;
+
+/**
+ * @brief A sequence of variable-length rows, stored in two allocations.
+ *
+ * Ragged vectors store the elements of all their rows back-to-back in one
+ * values vector, and the location of each row in a second rows vector.
+ * This makes a ragged vector a compact replacement for a vector of vectors,
+ * like a list of strings or the adjacency lists of a graph: it allocates
+ * twice instead of once per row, and scanning all the rows in order reads
+ * memory sequentially.
+ *
+ * Removing rows, or truncating them, only updates the rows vector, and
+ * leaves the removed elements in the values vector. Compacting the ragged
+ * vector reclaims that space in one pass.
+ *
+ * Like vectors, all elements of a ragged vector have the same size, and
+ * adding rows or elements can invalidate existing pointers to any rows.
+ *
+ * The fields of this struct are private.
+ *
+ * @class ragged_vector_t collectc/ragged_vector.h
+ */
+typedef struct ragged_vector {
+    vector_t values;
+    vector_t rows;
+    size_t liveLength;
+} ragged_vector_t;
+
+/**
+ * @brief Creates a new, empty ragged vector.
+ *
+ * @param[in] elementSize The size of each element.
+ * @return The new ragged vector.
+ *
+ * @memberof ragged_vector_t
+ * @static
+ */
+ragged_vector_t ragged_vector_new(size_t elementSize);
+
+/**
+ * @brief Creates a ragged vector from a values vector and a rows vector.
+ *
+ * This is the inverse of `ragged_vector_values` and `ragged_vector_rows`,
+ * and can be used to restore a ragged vector from its two flat vectors.
+ * The ragged vector takes ownership of both vectors.
+ *
+ * Rows are read through a pointer to their first element, so the ragged
+ * vector keeps an incremental values vector contiguous, and pushes that
+ * grow it move every value at once, as with a regular vector.
+ *
+ * Aborts if the rows vector doesn't hold `ragged_vector_row_t`s, or if
+ * the rows overlap, are out of order, or are out-of-bounds of the values.
+ *
+ * @param[in] values The values vector.
+ * @param[in] rows The rows vector.
+ * @return The new ragged vector.
+ *
+ * @memberof ragged_vector_t
+ * @static
+ */
+ragged_vector_t ragged_vector_from_parts(vector_t values, vector_t rows);
+
+/**
+ * @return The number of rows in the ragged vector.
+ *
+ * @memberof ragged_vector_t
+ */
+size_t ragged_vector_len(const ragged_vector_t *rv);
+
+/**
+ * @return The total number of elements in all rows of the ragged vector.
+ *
+ * @memberof ragged_vector_t
+ */
+size_t ragged_vector_values_len(const ragged_vector_t *rv);
+
+/**
+ * @return The size of each element.
+ *
+ * @memberof ragged_vector_t
+ */
+size_t ragged_vector_element_size(const ragged_vector_t *rv);
+
+/**
+ * Returns a pointer to the elements of a row.
+ *
+ * This operation is O(1).
+ *
+ * Aborts if the row is out-of-bounds.
+ *
+ * @param[in] rv The ragged vector.
+ * @param[in] row The zero-based index of the row.
+ * @param[out] length The number of elements in the row.
+ *
+ * @return A pointer to the row's first element, or `null` if
+ * the row is empty.
+ *
+ * @memberof ragged_vector_t
+ */
+const void *ragged_vector_row(const ragged_vector_t *rv, size_t row, size_t *length);
+
+/**
+ * Returns a mutable pointer to the elements of a row.
+ *
+ * @see ragged_vector_row
+ *
+ * @memberof ragged_vector_t
+ */
+void *ragged_vector_row_mut(ragged_vector_t *rv, size_t row, size_t *length);
+
+/**
+ * Appends a new row to the ragged vector.
+ *
+ * Pushing a row is amortized O(count).
+ *
+ * Aborts on memory allocation failure.
+ *
+ * @param[inout] rv The ragged vector.
+ * @param[in] elements A pointer to the row's first element.
+ * @param[in] count The number of elements in the row, which can be zero.
+ *
+ * @memberof ragged_vector_t
+ */
+void ragged_vector_push_row(ragged_vector_t *rv, const void *elements, size_t count);
+
+/**
+ * Appends elements to the last row of the ragged vector.
+ *
+ * Pushing elements is amortized O(count).
+ *
+ * Aborts on memory allocation failure, or if the ragged vector
+ * doesn't have any rows.
+ *
+ * @param[inout] rv The ragged vector.
+ * @param[in] elements A pointer to the first element.
+ * @param[in] count The number of elements.
+ *
+ * @memberof ragged_vector_t
+ */
+void ragged_vector_push(ragged_vector_t *rv, const void *elements, size_t count);
+
+/**
+ * Shortens a row, keeping its first `length` elements.
+ *
+ * The removed elements stay in the values vector until the
+ * ragged vector is compacted. This operation is O(1).
+ *
+ * Aborts if the row is out-of-bounds. Does nothing if the row already
+ * has `length` elements or fewer.
+ *
+ * @param[inout] rv The ragged vector.
+ * @param[in] row The zero-based index of the row.
+ * @param[in] length The new length of the row.
+ *
+ * @memberof ragged_vector_t
+ */
+void ragged_vector_truncate_row(ragged_vector_t *rv, size_t row, size_t length);
+
+/**
+ * Removes rows from the ragged vector, shifting all following
+ * rows to the left.
+ *
+ * The removed rows' elements stay in the values vector until the ragged
+ * vector is compacted. Removing rows is O(n) with respect to the number of
+ * following rows, but doesn't move any elements.
+ *
+ * Aborts if the range `[row, row + count]` is out-of-bounds.
+ *
+ * @param[inout] rv The ragged vector.
+ * @param[in] row The zero-based index of the first row to remove.
+ * @param[in] count The number of rows to remove.
+ *
+ * @memberof ragged_vector_t
+ */
+void ragged_vector_remove_rows(ragged_vector_t *rv, size_t row, size_t count);
+
+/**
+ * Moves the elements of all rows together, reclaiming the space left by
+ * removed and truncated rows.
+ *
+ * Compacting is O(n) with respect to the size of the values vector,
+ * and reads and writes the values sequentially. It doesn't shrink the
+ * capacity of the values vector.
+ *
+ * @param[inout] rv The ragged vector.
+ *
+ * @memberof ragged_vector_t
+ */
+void ragged_vector_compact(ragged_vector_t *rv);
+
+/**
+ * Returns the ragged vector's values vector.
+ *
+ * The values vector holds the elements of all rows, in row order. If the
+ * ragged vector isn't compacted, it can also hold the elements of removed
+ * and truncated rows.
+ *
+ * The returned vector is owned by the ragged vector, and is only valid
+ * until the ragged vector is modified.
+ *
+ * @memberof ragged_vector_t
+ */
+vector_t ragged_vector_values(const ragged_vector_t *rv);
+
+/**
+ * Returns the ragged vector's rows vector, which holds a
+ * `ragged_vector_row_t` for each row.
+ *
+ * The returned vector is owned by the ragged vector, and is only valid
+ * until the ragged vector is modified.
+ *
+ * @memberof ragged_vector_t
+ */
+vector_t ragged_vector_rows(const ragged_vector_t *rv);
+
+/**
+ * Removes all rows from the ragged vector.
+ *
+ * Clearing a ragged vector won't shrink its capacity.
+ *
+ * @memberof ragged_vector_t
+ */
+void ragged_vector_clear(ragged_vector_t *rv);
+
+/**
+ * Destroys the ragged vector, freeing any memory allocated for it.
+ *
+ * @memberof ragged_vector_t
+ */
+void ragged_vector_delete(ragged_vector_t *rv);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // COLLECTC_RAGGED_VECTOR_H_
@@ -0,0 +1,242 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef COLLECTC_ROPE_H_
+#define COLLECTC_ROPE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <collectc/vector.h>
+
+struct rope_node;
+
+/**
+ * @brief A sequence stored as a balanced tree of small chunks, for
+ * fast edits anywhere in huge sequences.
+ *
+ * Ropes split their elements into chunks of up to a few kilobytes each,
+ * and keep the chunks in order in a randomized balanced binary tree
+ * (a treap), where each node knows how many elements are in its subtree.
+ * Finding, inserting, and removing elements at any index is expected
+ * O(log n), instead of the O(n) it takes to shift the elements of a
+ * vector, and splitting or concatenating whole ropes is O(log n), too.
+ *
+ * Elements within a chunk are contiguous, so scanning a rope with
+ * `rope_iter_next` reads one chunk at a time. Each chunk's allocation
+ * is sized to its elements, and edits merge a chunk that drops below
+ * half full with its neighbours, so a rope with more than one chunk
+ * keeps each of them at least half full.
+ *
+ * Ropes assume that their elements have the same size and type.
+ * Any edit can invalidate existing pointers to any elements.
+ * Ropes are not internally synchronized.
+ *
+ * The fields of this struct are private.
+ *
+ * @class rope_t collectc/rope.h
+ */
+typedef struct rope {
+    struct rope_node *root;
+    size_t elementSize;
+    size_t chunkCapacity;
+    uint64_t seed;
+} rope_t;
+
+/**
+ * @brief An iterator over the chunks of a rope, in order.
+ *
+ * The fields of this struct are private.
+ *
+ * @class rope_iter_t collectc/rope.h
+ */
+typedef struct rope_iter {
+    vector_t stack;
+} rope_iter_t;
+
+/**
+ * @brief Creates a new, empty rope.
+ *
+ * @param[in] elementSize The size of each element.
+ * @return The new rope.
+ *
+ * @memberof rope_t
+ * @static
+ */
+rope_t rope_new(size_t elementSize);
+
+/**
+ * @return The number of elements in the rope.
+ *
+ * @memberof rope_t
+ */
+size_t rope_len(const rope_t *rope);
+
+/**
+ * @return The size of each element.
+ *
+ * @memberof rope_t
+ */
+size_t rope_element_size(const rope_t *rope);
+
+/**
+ * Returns a pointer to an element in the rope.
+ *
+ * This operation is expected O(log n).
+ *
+ * @param[in] rope The rope.
+ * @param[in] index The zero-based index of the element.
+ *
+ * @return A constant pointer to the element at the index, or
+ * `null` if the index is out-of-bounds.
+ *
+ * @memberof rope_t
+ */
+const void *rope_at(const rope_t *rope, size_t index);
+
+/**
+ * Returns a mutable pointer to an element in the rope.
+ *
+ * @see rope_at
+ *
+ * @memberof rope_t
+ */
+void *rope_at_mut(rope_t *rope, size_t index);
+
+/**
+ * Inserts elements into the rope, shifting all following
+ * elements to the right.
+ *
+ * Inserting is expected O(log n + count).
+ *
+ * Aborts on memory allocation failure, or if the index is greater
+ * than the length of the rope.
+ *
+ * @param[inout] rope The rope.
+ * @param[in] index The zero-based index at which to insert the elements.
+ * @param[in] elements A pointer to the first element.
+ * @param[in] count The number of elements.
+ *
+ * @memberof rope_t
+ */
+void rope_insert(rope_t *rope, size_t index, const void *elements, size_t count);
+
+/**
+ * Appends elements to the rope.
+ *
+ * @see rope_insert
+ *
+ * @memberof rope_t
+ */
+void rope_push(rope_t *rope, const void *elements, size_t count);
+
+/**
+ * Removes elements from the rope, shifting all following
+ * elements to the left.
+ *
+ * Removing is expected O(log n), plus O(count) to free the
+ * removed chunks. It may also copy up to a couple of chunks' elements,
+ * to merge the chunks on either side of the range.
+ *
+ * Aborts if the range `[index, index + count]` is out-of-bounds.
+ *
+ * @param[inout] rope The rope.
+ * @param[in] index The zero-based index of the first element to remove.
+ * @param[in] count The number of elements to remove.
+ *
+ * @memberof rope_t
+ */
+void rope_remove(rope_t *rope, size_t index, size_t count);
+
+/**
+ * Splits the rope in two at an index.
+ *
+ * The rope keeps the elements before the index, and the
+ * returned rope holds the rest. This operation is expected O(log n),
+ * plus copying up to a couple of chunks' elements, to merge a sparse
+ * chunk left at the end of either rope.
+ *
+ * Aborts if the index is greater than the length of the rope.
+ *
+ * @param[inout] rope The rope.
+ * @param[in] index The zero-based index at which to split.
+ * @return A new rope with the elements from the index onward.
+ *
+ * @memberof rope_t
+ */
+rope_t rope_split(rope_t *rope, size_t index);
+
+/**
+ * Appends all the elements of another rope to this rope, leaving
+ * the other rope empty.
+ *
+ * Concatenating is expected O(log n). It only copies elements to merge
+ * sparse chunks where the ropes meet.
+ *
+ * Aborts if the ropes have different element sizes.
+ *
+ * @param[inout] rope This rope.
+ * @param[inout] other The other rope.
+ *
+ * @memberof rope_t
+ */
+void rope_concat(rope_t *rope, rope_t *other);
+
+/**
+ * Returns the number of bytes allocated for the rope's nodes and
+ * their chunks.
+ *
+ * This doesn't include the allocator's own per-allocation overhead.
+ *
+ * @memberof rope_t
+ */
+size_t rope_allocation_size(const rope_t *rope);
+
+/**
+ * Destroys the rope, freeing any memory allocated for it.
+ *
+ * @memberof rope_t
+ */
+void rope_delete(rope_t *rope);
+
+/**
+ * @brief Creates an iterator over the chunks of a rope.
+ *
+ * Modifying the rope invalidates the iterator.
+ *
+ * @memberof rope_iter_t
+ * @static
+ */
+rope_iter_t rope_iter_new(const rope_t *rope);
+
+/**
+ * Returns the next chunk of elements.
+ *
+ * @param[inout] iter The iterator.
+ * @param[out] length The number of elements in the chunk.
+ *
+ * @return A pointer to the chunk's first element, or `null`
+ * if there are no more chunks.
+ *
+ * @memberof rope_iter_t
+ */
+const void *rope_iter_next(rope_iter_t *iter, size_t *length);
+
+/**
+ * Destroys the iterator.
+ *
+ * @memberof rope_iter_t
+ */
+void rope_iter_delete(rope_iter_t *iter);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // COLLECTC_ROPE_H_
@@ -0,0 +1,222 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef COLLECTC_SOA_VECTOR_H_
+#define COLLECTC_SOA_VECTOR_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief A growable table of rows, stored as one contiguous array
+ * per column.
+ *
+ * A structure-of-arrays vector holds rows of several fields, like a vector
+ * of structs, but stores each field in its own column. Scanning one field
+ * of every row only reads that field's column, and each column can be
+ * passed directly to bulk and SIMD routines.
+ *
+ * Columns can have different element sizes, but they all share the same
+ * length and capacity. Pushing and removing rows updates all columns at
+ * once, and growing the vector reallocates all columns together.
+ *
+ * Each column starts at an address aligned to the maximum fundamental
+ * alignment.
+ *
+ * Like vectors, inserting rows can invalidate all pointers to the vector
+ * and its columns, and structure-of-arrays vectors are not internally
+ * synchronized.
+ *
+ * @class soa_vector_t collectc/soa_vector.h
+ */
+typedef uintptr_t soa_vector_t;
+
+/**
+ * @brief Creates a new, empty structure-of-arrays vector.
+ *
+ * Aborts on memory allocation failure, or if there are no columns.
+ *
+ * @param[in] initialCapacity The number of rows that the vector
+ * can hold before reallocating.
+ * @param[in] columnCount The number of columns.
+ * @param[in] elementSizes The size of each column's elements.
+ * @return The new vector.
+ *
+ * @memberof soa_vector_t
+ * @static
+ */
+soa_vector_t soa_vector_new(size_t initialCapacity, size_t columnCount, const size_t *elementSizes);
+
+/**
+ * @return The number of rows in the vector.
+ *
+ * @memberof soa_vector_t
+ */
+size_t soa_vector_len(const soa_vector_t vec);
+
+/**
+ * @return The number of rows that the vector can hold
+ * without reallocating.
+ *
+ * @memberof soa_vector_t
+ */
+size_t soa_vector_capacity(const soa_vector_t vec);
+
+/**
+ * @return The number of columns in the vector.
+ *
+ * @memberof soa_vector_t
+ */
+size_t soa_vector_column_count(const soa_vector_t vec);
+
+/**
+ * @return The size of each element in a column.
+ *
+ * Aborts if the column is out-of-bounds.
+ *
+ * @memberof soa_vector_t
+ */
+size_t soa_vector_element_size(const soa_vector_t vec, size_t column);
+
+/**
+ * @return `true` if the vector is empty.
+ *
+ * @memberof soa_vector_t
+ */
+bool soa_vector_is_empty(const soa_vector_t vec);
+
+/**
+ * Returns a pointer to the first element of a column.
+ *
+ * The column's `soa_vector_len(vec)` elements are contiguous.
+ *
+ * This operation is O(1). Aborts if the column is out-of-bounds.
+ *
+ * @param[in] vec The vector.
+ * @param[in] column The zero-based index of the column.
+ *
+ * @return A mutable pointer to the column's elements.
+ *
+ * @memberof soa_vector_t
+ */
+void *soa_vector_column(soa_vector_t vec, size_t column);
+
+/**
+ * Returns a pointer to one field of a row.
+ *
+ * This operation is O(1). Aborts if the column is out-of-bounds.
+ *
+ * @param[in] vec The vector.
+ * @param[in] column The zero-based index of the column.
+ * @param[in] index The zero-based index of the row.
+ *
+ * @return A constant pointer to the element, or `null` if
+ * the row is out-of-bounds.
+ *
+ * @memberof soa_vector_t
+ */
+const void *soa_vector_at(const soa_vector_t vec, size_t column, size_t index);
+
+/**
+ * Reserves capacity for at least `soa_vector_len(vec) + extraCapacity`
+ * rows in every column.
+ *
+ * Reserving is O(capacity) if the vector needs to reallocate.
+ *
+ * Aborts on memory allocation failure.
+ *
+ * @param[inout] vec A pointer to the vector.
+ * @param[in] extraCapacity Additional capacity to reserve.
+ *
+ * @memberof soa_vector_t
+ */
+void soa_vector_reserve(soa_vector_t *vec, size_t extraCapacity);
+
+/**
+ * Appends rows to the vector.
+ *
+ * Pushing is an amortized O(count) operation.
+ *
+ * Aborts on memory allocation failure.
+ *
+ * @param[inout] vec A pointer to the vector.
+ * @param[in] columns An array with one pointer for each column. Each
+ * pointer points to `count` elements of that column's element size.
+ * @param[in] count The number of rows.
+ *
+ * @memberof soa_vector_t
+ */
+void soa_vector_push(soa_vector_t *vec, const void *const *columns, size_t count);
+
+/**
+ * Copies one row out of the vector.
+ *
+ * Aborts if the row is out-of-bounds.
+ *
+ * @param[in] vec The vector.
+ * @param[in] index The zero-based index of the row.
+ * @param[out] columns An array with one pointer for each column. Each
+ * pointer points to memory that can hold one element of that column.
+ *
+ * @memberof soa_vector_t
+ */
+void soa_vector_get(const soa_vector_t vec, size_t index, void *const *columns);
+
+/**
+ * Removes rows from the vector, shifting all following
+ * rows to the left in every column.
+ *
+ * Removing a row from the beginning of the vector has a
+ * worst-case complexity of O(n).
+ *
+ * Aborts if the range `[index, index + count]` is out-of-bounds.
+ *
+ * @param[in] vec The vector.
+ * @param[in] index The zero-based index of the first row to remove.
+ * @param[in] count The number of rows to remove.
+ *
+ * @memberof soa_vector_t
+ */
+void soa_vector_remove(soa_vector_t vec, size_t index, size_t count);
+
+/**
+ * Removes a row from the vector, replacing it with the last row.
+ *
+ * This doesn't preserve the order of the rows, but is O(1).
+ *
+ * Aborts if the row is out-of-bounds.
+ *
+ * @param[in] vec The vector.
+ * @param[in] index The zero-based index of the row to remove.
+ *
+ * @memberof soa_vector_t
+ */
+void soa_vector_swap_remove(soa_vector_t vec, size_t index);
+
+/**
+ * Removes all rows from the vector.
+ *
+ * Clearing a vector won't shrink its capacity.
+ *
+ * @memberof soa_vector_t
+ */
+void soa_vector_clear(soa_vector_t vec);
+
+/**
+ * Destroys the vector, freeing any memory allocated for it.
+ *
+ * @memberof soa_vector_t
+ */
+void soa_vector_delete(soa_vector_t vec);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // COLLECTC_SOA_VECTOR_H_
@@ -0,0 +1,118 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef COLLECTC_SPSC_QUEUE_H_
+#define COLLECTC_SPSC_QUEUE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief A bounded, lock-free queue for passing elements from exactly one
+ * producer thread to exactly one consumer thread.
+ *
+ * SPSC queues are ring buffers with a power-of-two capacity. The producer
+ * only writes the tail index, and the consumer only writes the head index,
+ * so neither side needs a lock or a compare-and-swap. The two indices live
+ * on separate cache lines, and each side keeps a cached copy of the other
+ * side's index, so it only reads the shared index when the cached copy
+ * says the queue looks full or empty.
+ *
+ * Pushing and popping work on batches of elements, and publish the new
+ * index once per batch, so passing many small elements at a time costs
+ * about as much as a `memcpy`.
+ *
+ * Only one thread may push, and only one thread may pop, at a time. Any
+ * other concurrent use is undefined. Creating and destroying the queue
+ * must happen while no other threads are using it.
+ *
+ * @class spsc_queue_t collectc/spsc_queue.h
+ */
+typedef struct spsc_queue spsc_queue_t;
+
+/**
+ * @brief Creates a new, empty SPSC queue.
+ *
+ * Aborts on memory allocation failure.
+ *
+ * @param[in] capacity The minimum number of elements that the queue can
+ * hold. It's rounded up to a power of two.
+ * @param[in] elementSize The size of each element.
+ * @return A pointer to the new queue.
+ *
+ * @memberof spsc_queue_t
+ * @static
+ */
+spsc_queue_t *spsc_queue_new(size_t capacity, size_t elementSize);
+
+/**
+ * @return The number of elements that the queue can hold.
+ *
+ * @memberof spsc_queue_t
+ */
+size_t spsc_queue_capacity(const spsc_queue_t *queue);
+
+/**
+ * @return The size of each element.
+ *
+ * @memberof spsc_queue_t
+ */
+size_t spsc_queue_element_size(const spsc_queue_t *queue);
+
+/**
+ * Returns the number of elements in the queue.
+ *
+ * If the other side is using the queue at the same time, the length
+ * may be out-of-date as soon as it's returned.
+ *
+ * @memberof spsc_queue_t
+ */
+size_t spsc_queue_len(const spsc_queue_t *queue);
+
+/**
+ * Appends as many elements as fit to the queue, without blocking.
+ * Only the producer thread may push.
+ *
+ * The elements become visible to the consumer all at once.
+ *
+ * @param[inout] queue The queue.
+ * @param[in] elements A pointer to the first element.
+ * @param[in] count The number of elements to push.
+ * @return The number of elements pushed, which is less than `count`
+ * if the queue filled up, or zero if it was full.
+ *
+ * @memberof spsc_queue_t
+ */
+size_t spsc_queue_push(spsc_queue_t *queue, const void *elements, size_t count);
+
+/**
+ * Removes up to `count` elements from the front of the queue, without
+ * blocking, and copies them out in order. Only the consumer thread may pop.
+ *
+ * @param[inout] queue The queue.
+ * @param[out] elements A pointer to memory that can hold `count` elements.
+ * @param[in] count The maximum number of elements to pop.
+ * @return The number of elements popped, or zero if the queue was empty.
+ *
+ * @memberof spsc_queue_t
+ */
+size_t spsc_queue_pop(spsc_queue_t *queue, void *elements, size_t count);
+
+/**
+ * Destroys the queue, freeing any memory allocated for it.
+ *
+ * @memberof spsc_queue_t
+ */
+void spsc_queue_delete(spsc_queue_t *queue);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // COLLECTC_SPSC_QUEUE_H_
@@ -0,0 +1,244 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef COLLECTC_U64MAP_H_
+#define COLLECTC_U64MAP_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief An unordered map from 64-bit integer keys to values, for
+ * maps keyed by ids.
+ *
+ * Integer maps are open-addressed hash tables specialized for integer
+ * keys. They hash keys inline with multiply-shift hashing, which takes
+ * the high bits of the key times a large odd constant, and compare them
+ * with `==`, so there are no callbacks. Keys and values are stored in
+ * two parallel arrays, so probing only reads keys.
+ *
+ * Key 0 marks an empty slot, so there are no control bytes. Key 0 can
+ * still be inserted: its value is kept in a separate slot after the others.
+ * Collisions are resolved by linear probing, and removing a key shifts
+ * the following keys in its run back, so there are no tombstones.
+ *
+ * Maps with 32-bit keys can use integer maps by widening their keys.
+ * All values of a map have the same size, which may be 0. Inserting can
+ * invalidate existing pointers to any values. Integer maps are not
+ * internally synchronized.
+ *
+ * The fields of this struct are private.
+ *
+ * @class u64map_t collectc/u64map.h
+ */
+typedef struct u64map {
+    /** The key in each slot, or 0 if the slot is empty. */
+    uint64_t *keys;
+    /** The value for each slot, followed by the value for key 0. */
+    char *values;
+    /** A power of 2, or 0 if nothing's allocated. */
+    size_t capacity;
+    /** The number of bits that hashing shifts out, which is 64 - log2(capacity). */
+    unsigned shift;
+    /** The number of entries, including key 0. */
+    size_t length;
+    bool hasZeroKey;
+    size_t valueSize;
+} u64map_t;
+
+/**
+ * @brief An iterator over the entries of an integer map, in no
+ * particular order.
+ *
+ * The fields of this struct are private.
+ *
+ * @class u64map_iter_t collectc/u64map.h
+ */
+typedef struct u64map_iter {
+    const u64map_t *map;
+    size_t index;
+} u64map_iter_t;
+
+/**
+ * @brief Creates a new, empty integer map, which doesn't allocate until
+ * the first insert.
+ *
+ * @param[in] valueSize The size of each value, which may be 0.
+ * @return The new integer map.
+ *
+ * @memberof u64map_t
+ * @static
+ */
+u64map_t u64map_new(size_t valueSize);
+
+/**
+ * @return The number of entries in the integer map.
+ *
+ * @memberof u64map_t
+ */
+size_t u64map_len(const u64map_t *map);
+
+/**
+ * @return `true` if the integer map is empty.
+ *
+ * @memberof u64map_t
+ */
+bool u64map_is_empty(const u64map_t *map);
+
+/**
+ * @return The number of entries that the integer map can hold
+ * without growing.
+ *
+ * @memberof u64map_t
+ */
+size_t u64map_capacity(const u64map_t *map);
+
+/**
+ * @return The size of each value.
+ *
+ * @memberof u64map_t
+ */
+size_t u64map_value_size(const u64map_t *map);
+
+/**
+ * Looks up the value for a key.
+ *
+ * This operation is expected O(1).
+ *
+ * @param[in] map The integer map.
+ * @param[in] key The key.
+ *
+ * @return A constant pointer to the key's value, or `null` if the key
+ * isn't in the map.
+ *
+ * @memberof u64map_t
+ */
+const void *u64map_get(const u64map_t *map, uint64_t key);
+
+/**
+ * Looks up a mutable pointer to the value for a key.
+ *
+ * @see u64map_get
+ *
+ * @memberof u64map_t
+ */
+void *u64map_get_mut(u64map_t *map, uint64_t key);
+
+/**
+ * @return `true` if the key is in the integer map.
+ *
+ * @memberof u64map_t
+ */
+bool u64map_contains(const u64map_t *map, uint64_t key);
+
+/**
+ * Inserts a key and its value into the integer map, replacing the value
+ * if the key is already in the map.
+ *
+ * Inserting is expected O(1), and amortized O(1) if the map grows.
+ *
+ * Aborts on memory allocation failure.
+ *
+ * @param[inout] map The integer map.
+ * @param[in] key The key.
+ * @param[in] value A pointer to the value, which may be `null` if the
+ * value size is 0.
+ *
+ * @return `true` if the key is new, or `false` if its value was replaced.
+ *
+ * @memberof u64map_t
+ */
+bool u64map_insert(u64map_t *map, uint64_t key, const void *value);
+
+/**
+ * Returns the value for a key, inserting the key with a zeroed value
+ * first if it isn't in the map.
+ *
+ * Aborts on memory allocation failure.
+ *
+ * @param[inout] map The integer map.
+ * @param[in] key The key.
+ * @param[out] inserted Set to `true` if the key is new, or `null`
+ * to ignore it.
+ *
+ * @return A mutable pointer to the key's value.
+ *
+ * @memberof u64map_t
+ */
+void *u64map_get_or_insert(u64map_t *map, uint64_t key, bool *inserted);
+
+/**
+ * Removes a key and its value from the integer map.
+ *
+ * Removing is expected O(1), and never shrinks the map.
+ *
+ * @param[inout] map The integer map.
+ * @param[in] key The key.
+ * @param[out] value Memory that can hold the removed value, or `null`
+ * to ignore it.
+ *
+ * @return `false` if the key isn't in the map.
+ *
+ * @memberof u64map_t
+ */
+bool u64map_remove(u64map_t *map, uint64_t key, void *value);
+
+/**
+ * Grows the integer map, if needed, to hold at least `extraCapacity`
+ * more entries without growing again.
+ *
+ * Aborts on memory allocation failure.
+ *
+ * @memberof u64map_t
+ */
+void u64map_reserve(u64map_t *map, size_t extraCapacity);
+
+/**
+ * Removes all entries from the integer map, without shrinking its capacity.
+ *
+ * @memberof u64map_t
+ */
+void u64map_clear(u64map_t *map);
+
+/**
+ * Destroys the integer map, freeing any memory allocated for it.
+ *
+ * @memberof u64map_t
+ */
+void u64map_delete(u64map_t *map);
+
+/**
+ * @brief Creates an iterator over the entries of an integer map.
+ *
+ * Inserting into or removing from the map invalidates the iterator.
+ *
+ * @memberof u64map_iter_t
+ * @static
+ */
+u64map_iter_t u64map_iter_new(const u64map_t *map);
+
+/**
+ * Advances to the next entry.
+ *
+ * @param[inout] iter The iterator.
+ * @param[out] key Set to the entry's key.
+ * @param[out] value Set to a pointer to the entry's value, or `null`
+ * to ignore it.
+ *
+ * @return `false` if there are no more entries.
+ *
+ * @memberof u64map_iter_t
+ */
+bool u64map_iter_next(u64map_iter_t *iter, uint64_t *key, void **value);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // COLLECTC_U64MAP_H_
@@ -57,6 +57,94 @@ typedef uintptr_t vector_t;
  */
 vector_t vector_new(size_t initialCapacity, size_t elementSize);
 
+/**
+ * @brief Creates a new, empty compact vector.
+ *
+ * Compact vectors have a smaller header than regular vectors, with a
+ * 32-bit length and capacity, and a 16-bit element size. This makes them
+ * a good fit for programs that hold millions of small vectors, where the
+ * header can take up more space than the elements.
+ *
+ * Compact vectors support all the same operations as regular vectors.
+ *
+ * Aborts on memory allocation failure, if the element size doesn't fit
+ * in 16 bits, or if the vector grows past 2^32 - 1 elements.
+ *
+ * @param[in] initialCapacity The starting capacity of the vector.
+ * If zero, the vector won't allocate until it's modified.
+ * @param[in] elementSize The size of each element.
+ * @return The new vector.
+ *
+ * @memberof vector_t
+ * @static
+ */
+vector_t vector_new_compact(size_t initialCapacity, size_t elementSize);
+
+/**
+ * @brief Creates a new, empty devector.
+ *
+ * Devectors are vectors that keep spare capacity before their first
+ * element, as well as after their last. Pushing to the front with
+ * `vector_push_front` is amortized O(1), like pushing to the back, and
+ * inserting or removing elements shifts whichever side of the index is
+ * shorter. Removing the first element is O(1), so devectors also work
+ * as FIFO queues.
+ *
+ * The elements of a devector are always contiguous, so devectors
+ * support all the same operations as regular vectors. When a devector
+ * grows, it centers its elements in the new allocation. Its capacity
+ * counts the spare capacity at both ends.
+ *
+ * Aborts on memory allocation failure.
+ *
+ * @param[in] initialCapacity The starting capacity of the devector.
+ * If zero, the devector won't allocate until it's modified.
+ * @param[in] elementSize The size of each element.
+ * @return The new devector.
+ *
+ * @memberof vector_t
+ * @static
+ */
+vector_t vector_new_devector(size_t initialCapacity, size_t elementSize);
+
+/**
+ * @brief Creates a new, empty incremental vector.
+ *
+ * Growing a regular vector copies all its elements into the new
+ * allocation at once, so one push into a large vector can take a long
+ * time. When an incremental vector grows, it keeps its old allocation,
+ * and each later insert moves a bounded batch of elements into the new
+ * one: twice as many as it inserts, plus 4 KiB of them. Unless capacity
+ * is reserved exactly, every element has moved before the vector grows
+ * again, so no push copies more than a batch, however large it is. Indexing finds each element in
+ * whichever allocation holds it.
+ *
+ * While elements are moving, they're in up to three runs, split between
+ * the two allocations, so a pointer to one element can only be used to
+ * reach the others in its run; `vector_run_len` says how many those are,
+ * and `vector_make_contiguous` moves them all at once. Inserting among
+ * the moving elements, or removing any of them except from the end, does
+ * the same; pushing and removing from the end don't.
+ *
+ * Every vector function works with incremental vectors. Of the other
+ * collections that take vectors, `delta_vector_from_vector`,
+ * `packed_int_vector_extend` and `hashset_from_vector` read them a run
+ * or an element at a time, while heaps and ragged vectors make the
+ * vectors they own contiguous, which gives up the bounded latency. Incremental vectors trade a larger header, and
+ * more memory while they're growing, for bounded push latency.
+ *
+ * Aborts on memory allocation failure.
+ *
+ * @param[in] initialCapacity The starting capacity of the vector.
+ * If zero, the vector won't allocate until it's modified.
+ * @param[in] elementSize The size of each element.
+ * @return The new vector.
+ *
+ * @memberof vector_t
+ * @static
+ */
+vector_t vector_new_incremental(size_t initialCapacity, size_t elementSize);
+
 /**
  * @return The number of elements in the vector.
  *
@@ -79,6 +167,71 @@ size_t vector_capacity(const vector_t vec);
  */
 size_t vector_element_size(const vector_t vec);
 
+/**
+ * @return `true` if the vector was created with `vector_new_compact`.
+ *
+ * @memberof vector_t
+ */
+bool vector_is_compact(const vector_t vec);
+
+/**
+ * @return `true` if the vector was created with `vector_new_devector`.
+ *
+ * @memberof vector_t
+ */
+bool vector_is_devector(const vector_t vec);
+
+/**
+ * @return `true` if the vector was created with `vector_new_incremental`.
+ *
+ * @memberof vector_t
+ */
+bool vector_is_incremental(const vector_t vec);
+
+/**
+ * Makes the elements of an incremental vector contiguous, by moving any
+ * that are still in its previous allocation. For any other vector, this
+ * does nothing.
+ *
+ * This operation is O(n) if elements are still moving.
+ *
+ * @memberof vector_t
+ */
+void vector_make_contiguous(vector_t vec);
+
+/**
+ * Returns the number of elements, from an index on, that are contiguous
+ * in memory with the element at the index, so that they can be reached
+ * from a pointer to it. This is every element from the index on, except
+ * in an incremental vector whose elements are still moving.
+ *
+ * This operation is O(1).
+ *
+ * @param[in] vec The vector.
+ * @param[in] index The zero-based index of the first element.
+ *
+ * @return The number of elements in the run, or zero if the index is
+ * out-of-bounds.
+ *
+ * @memberof vector_t
+ */
+size_t vector_run_len(const vector_t vec, size_t index);
+
+/**
+ * Returns the number of bytes that the vector has requested from the
+ * allocator, including its header and any unused capacity, and the
+ * previous allocation of an incremental vector whose elements are
+ * still moving.
+ *
+ * This doesn't include the allocator's own per-allocation overhead.
+ *
+ * @return The size of the vector's allocation, or zero if the vector
+ * hasn't allocated.
+ *
+ * @memberof vector_t
+ */
+size_t vector_allocation_size(const vector_t vec);
+
 /**
  * @return `true` if the vector is empty.
  *
@@ -89,6 +242,9 @@ bool vector_is_empty(const vector_t vec);
 /**
  * Returns the first element of the vector.
  *
+ * The elements after it can be reached from it only up to
+ * `vector_run_len(vec, 0)`.
+ *
  * This operation is O(1).
  *
  * @param[in] vec The vector.
@@ -144,6 +300,40 @@ void *vector_at_mut(vector_t vec, size_t index);
  */
 const void *vector_last(const vector_t vec);
 
+/**
+ * Hashes the elements of the vector, so that vectors can be used as
+ * keys in hash maps and sets.
+ *
+ * The hash covers the bytes of the elements, not the vector's capacity
+ * or kind, so vectors that are equal by `vector_equal` have the same
+ * hash. Vectors whose elements have padding bytes should have those
+ * bytes zeroed.
+ *
+ * This operation is O(n). The bytes are hashed in blocks of 4 KiB, each
+ * with `hash_bytes` seeded with the previous block's hash, so that the
+ * hash doesn't depend on where the runs of an incremental vector split.
+ *
+ * @param[in] vec The vector.
+ *
+ * @return The hash. For vectors of at most 4 KiB of elements, this is
+ * `hash_bytes` of the elements with seed 0.
+ *
+ * @memberof vector_t
+ */
+uint64_t vector_hash(const vector_t vec);
+
+/**
+ * Compares the elements of two vectors.
+ *
+ * This operation is O(n).
+ *
+ * @return `true` if the vectors have the same element size, the same
+ * length, and the same bytes in each element.
+ *
+ * @memberof vector_t
+ */
+bool vector_equal(const vector_t a, const vector_t b);
+
 /**
  * Reserves capacity for at least the given number of elements,
  * such that the vector will be able to hold
@@ -162,6 +352,21 @@ const void *vector_last(const vector_t vec);
  */
 void vector_reserve(vector_t *vec, size_t extraCapacity);
 
+/**
+ * Reserves capacity for exactly `vector_len(vec) + extraCapacity`
+ * elements, if the vector can't already hold that many.
+ *
+ * Unlike `vector_reserve`, this doesn't leave room for further growth,
+ * so it's for containers that decide their own growth, and reserving
+ * repeatedly with it can be O(n^2). Devectors still leave room at both
+ * ends, as they do for `vector_reserve`.
+ *
+ * @see vector_reserve
+ *
+ * @memberof vector_t
+ */
+void vector_reserve_exact(vector_t *vec, size_t extraCapacity);
+
 /**
  * Inserts elements into the vector, shifting all following
  * elements to the right.
@@ -200,6 +405,23 @@ void vector_insert(vector_t *vec, size_t index, const void *elements, size_t cou
  */
 void vector_push(vector_t *vec, const void *elements, size_t count);
 
+/**
+ * Prepends elements to the vector, keeping their order, so that
+ * the first pushed element becomes the vector's first element.
+ *
+ * Pushing to the front of a devector is amortized O(1). For other
+ * vectors, it's O(n), like inserting at the beginning.
+ *
+ * Aborts on memory allocation failure.
+ *
+ * @param[inout] vec A pointer to the vector.
+ * @param[in] elements A pointer to the first element.
+ * @param[in] count The number of elements.
+ *
+ * @memberof vector_t
+ */
+void vector_push_front(vector_t *vec, const void *elements, size_t count);
+
 /**
  * Copies elements from the vector.
  *
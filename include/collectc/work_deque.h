@@ -0,0 +1,139 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef COLLECTC_WORK_DEQUE_H_
+#define COLLECTC_WORK_DEQUE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief A growable, lock-free work-stealing deque, for task schedulers.
+ *
+ * Work-stealing deques (also known as Chase-Lev deques) have one owner
+ * thread, which pushes and pops elements at the bottom, like a stack, and
+ * any number of thief threads, which steal elements from the top. The
+ * owner only needs an atomic read-modify-write to pop the last element,
+ * when it might race with a thief; thieves claim elements with a
+ * compare-and-swap on the top index.
+ *
+ * The deque stores its elements by value, in a circular buffer that
+ * doubles in size when the owner fills it. Thieves might still be reading
+ * from the old buffer, so it's retired, and the owner frees it once no
+ * thief is in the middle of a steal. Each thief counts itself in and out
+ * of a shared counter around a steal, and the owner checks the counter
+ * when it grows the deque, and every 64 pushes while any buffers are
+ * retired. Since each buffer is half the size of the next, retired
+ * buffers never take up more space than the current one.
+ *
+ * Only the owner thread may push or pop. Creating and destroying the
+ * deque must happen while no other threads are using it.
+ *
+ * @class work_deque_t collectc/work_deque.h
+ */
+typedef struct work_deque work_deque_t;
+
+/**
+ * @brief Creates a new, empty work-stealing deque.
+ *
+ * Aborts on memory allocation failure.
+ *
+ * @param[in] initialCapacity The minimum number of elements that the deque
+ * can hold before growing. It's rounded up to a power of two.
+ * @param[in] elementSize The size of each element.
+ * @return A pointer to the new deque.
+ *
+ * @memberof work_deque_t
+ * @static
+ */
+work_deque_t *work_deque_new(size_t initialCapacity, size_t elementSize);
+
+/**
+ * @return The size of each element.
+ *
+ * @memberof work_deque_t
+ */
+size_t work_deque_element_size(const work_deque_t *deque);
+
+/**
+ * Returns the number of elements in the deque.
+ *
+ * If other threads are using the deque at the same time, the length
+ * may be out-of-date as soon as it's returned.
+ *
+ * @memberof work_deque_t
+ */
+size_t work_deque_len(const work_deque_t *deque);
+
+/**
+ * Returns the number of bytes that the deque's buffers take up,
+ * including any retired buffers that haven't been freed yet. Only the
+ * owner thread may call this.
+ *
+ * @memberof work_deque_t
+ */
+size_t work_deque_allocation_size(const work_deque_t *deque);
+
+/**
+ * Pushes an element onto the bottom of the deque. Only the owner
+ * thread may push.
+ *
+ * Pushing is amortized O(1), and O(n) if the deque needs to grow.
+ *
+ * Aborts on memory allocation failure.
+ *
+ * @param[inout] deque The deque.
+ * @param[in] element A pointer to the element.
+ *
+ * @memberof work_deque_t
+ */
+void work_deque_push(work_deque_t *deque, const void *element);
+
+/**
+ * Pops the most recently pushed element from the bottom of the deque.
+ * Only the owner thread may pop.
+ *
+ * @param[inout] deque The deque.
+ * @param[out] element A pointer to memory that can hold one element.
+ * @return `true` if an element was popped, or `false` if the deque was
+ * empty, or a thief stole the last element first.
+ *
+ * @memberof work_deque_t
+ */
+bool work_deque_pop(work_deque_t *deque, void *element);
+
+/**
+ * Steals the oldest element from the top of the deque. Any thread may
+ * steal.
+ *
+ * If another thief steals the same element first, this tries again
+ * with the next one.
+ *
+ * @param[inout] deque The deque.
+ * @param[out] element A pointer to memory that can hold one element.
+ * @return `true` if an element was stolen, or `false` if the deque
+ * was empty.
+ *
+ * @memberof work_deque_t
+ */
+bool work_deque_steal(work_deque_t *deque, void *element);
+
+/**
+ * Destroys the deque, freeing any memory allocated for it, including
+ * retired buffers.
+ *
+ * @memberof work_deque_t
+ */
+void work_deque_delete(work_deque_t *deque);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // COLLECTC_WORK_DEQUE_H_
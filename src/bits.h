@@ -0,0 +1,234 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef COLLECTC_BITS_H_
+#define COLLECTC_BITS_H_
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// The AVX2 paths are compiled with per-function target attributes, so
+// the library itself still runs on any x86-64 CPU, and they're only
+// called once `bits_has_avx2` has checked the CPU. A build that enables
+// AVX2 for the whole library, such as with -mavx2, skips the check.
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define BITS_AVX2 1
+#define BITS_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#endif
+
+/**
+ * Bit manipulation helpers, shared by the bit-oriented collections.
+ * These use compiler builtins where they're available, and portable
+ * fallbacks everywhere else.
+ */
+
+/**
+ * Returns whether the CPU supports AVX2. Each file that includes this
+ * header checks once, and threads that race to check for the first
+ * time all store the same value.
+ */
+static inline bool bits_has_avx2(void) {
+#if defined(__AVX2__)
+    return true;
+#elif defined(BITS_AVX2)
+    // 0 until checked, then 1 without AVX2, or 2 with it.
+    static atomic_uint avx2;
+    unsigned checked = atomic_load_explicit(&avx2, memory_order_relaxed);
+    if (checked == 0) {
+        __builtin_cpu_init();
+        checked = __builtin_cpu_supports("avx2") ? 2 : 1;
+        atomic_store_explicit(&avx2, checked, memory_order_relaxed);
+    }
+    return checked == 2;
+#else
+    return false;
+#endif
+}
+
+/** Returns the number of set bits in a word. */
+static inline unsigned bits_popcount64(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned)__builtin_popcountll(x);
+#else
+    x = x - ((x >> 1) & 0x5555555555555555);
+    x = (x & 0x3333333333333333) + ((x >> 2) & 0x3333333333333333);
+    x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0f;
+    return (unsigned)((x * 0x0101010101010101) >> 56);
+#endif
+}
+
+/** Returns the index of the lowest set bit in a non-zero word. */
+static inline unsigned bits_ctz64(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned)__builtin_ctzll(x);
+#else
+    return bits_popcount64((x & (~x + 1)) - 1);
+#endif
+}
+
+/** Returns the number of leading zero bits in a non-zero word. */
+static inline unsigned bits_clz64(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned)__builtin_clzll(x);
+#else
+    unsigned n = 0;
+    for (uint64_t bit = (uint64_t)1 << 63; (x & bit) == 0; bit >>= 1) {
+        n++;
+    }
+    return n;
+#endif
+}
+
+/**
+ * Returns the index of the `k`-th lowest set bit in a word, counting
+ * from zero. The word must have more than `k` set bits.
+ */
+static inline unsigned bits_select64(uint64_t x, unsigned k) {
+    // Skip whole bytes first, then clear the lower set bits
+    // in the byte that holds the one we want.
+    unsigned shift = 0;
+    for (;;) {
+        unsigned count = bits_popcount64((x >> shift) & 0xff);
+        if (k < count) {
+            break;
+        }
+        k -= count;
+        shift += 8;
+    }
+    uint64_t byte = (x >> shift) & 0xff;
+    for (unsigned i = 0; i < k; i++) {
+        byte &= byte - 1;
+    }
+    return shift + bits_ctz64(byte);
+}
+
+/** Returns a mask with the lowest `count` bits set, for `count <= 64`. */
+static inline uint64_t bits_mask64(unsigned count) {
+    return count >= 64 ? UINT64_MAX : ((uint64_t)1 << count) - 1;
+}
+
+/** Reverses the order of the bits of a word. */
+static inline uint64_t bits_reverse64(uint64_t x) {
+    x = ((x >> 1) & 0x5555555555555555) | ((x & 0x5555555555555555) << 1);
+    x = ((x >> 2) & 0x3333333333333333) | ((x & 0x3333333333333333) << 2);
+    x = ((x >> 4) & 0x0f0f0f0f0f0f0f0f) | ((x & 0x0f0f0f0f0f0f0f0f) << 4);
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_bswap64(x);
+#else
+    x = ((x >> 8) & 0x00ff00ff00ff00ff) | ((x & 0x00ff00ff00ff00ff) << 8);
+    x = ((x >> 16) & 0x0000ffff0000ffff) | ((x & 0x0000ffff0000ffff) << 16);
+    return (x >> 32) | (x << 32);
+#endif
+}
+
+/**
+ * Returns the number of bits needed to represent a value,
+ * which is at least 1.
+ */
+static inline unsigned bits_width64(uint64_t x) {
+    return x == 0 ? 1 : 64 - bits_clz64(x);
+}
+
+/**
+ * Reads the `index`-th `width`-bit value from an array of packed values.
+ *
+ * Packed arrays store their values back-to-back, starting from the lowest
+ * bit of the first word, and must be followed by at least one extra word
+ * so that reading the last value never needs a branch.
+ */
+static inline uint64_t bits_unpack_one(const uint64_t *words, size_t index, unsigned width) {
+    size_t bit = index * width;
+    size_t word = bit / 64;
+    unsigned offset = bit % 64;
+    // Shifting in two steps avoids an undefined shift by 64
+    // when the value starts at the beginning of a word.
+    uint64_t low = words[word] >> offset;
+    uint64_t high = (words[word + 1] << 1) << (63 - offset);
+    return (low | high) & bits_mask64(width);
+}
+
+/**
+ * Writes the `index`-th `width`-bit value into an array of packed values.
+ * The value must fit in `width` bits, and the bits that it's written to
+ * must be zero.
+ */
+static inline void bits_pack_one(uint64_t *words, size_t index, unsigned width, uint64_t value) {
+    size_t bit = index * width;
+    size_t word = bit / 64;
+    unsigned offset = bit % 64;
+    words[word] |= value << offset;
+    if (offset + width > 64) {
+        words[word + 1] |= value >> (64 - offset);
+    }
+}
+
+/** Clears the `index`-th `width`-bit value in an array of packed values. */
+static inline void bits_clear_one(uint64_t *words, size_t index, unsigned width) {
+    size_t bit = index * width;
+    size_t word = bit / 64;
+    unsigned offset = bit % 64;
+    uint64_t mask = bits_mask64(width);
+    words[word] &= ~(mask << offset);
+    if (offset + width > 64) {
+        words[word + 1] &= ~(mask >> (64 - offset));
+    }
+}
+
+#if defined(BITS_AVX2)
+/**
+ * Unpacks values four at a time, using gathers to load the words that
+ * each value spans, and per-lane shifts to extract them. Returns the
+ * number of values unpacked, which is `count` rounded down to a
+ * multiple of 4.
+ */
+BITS_TARGET_AVX2 static inline size_t bits_unpack_avx2(
+    const uint64_t *words, size_t index, unsigned width, uint64_t *out, size_t count
+) {
+    size_t i = 0;
+    const __m256i mask = _mm256_set1_epi64x((long long)bits_mask64(width));
+    const __m256i sixtyThree = _mm256_set1_epi64x(63);
+    const __m256i one = _mm256_set1_epi64x(1);
+    const __m256i step = _mm256_set1_epi64x((long long)(4 * (uint64_t)width));
+    __m256i bits = _mm256_set_epi64x(
+        (long long)((index + 3) * width),
+        (long long)((index + 2) * width),
+        (long long)((index + 1) * width),
+        (long long)(index * width)
+    );
+    for (; i + 4 <= count; i += 4) {
+        __m256i word = _mm256_srli_epi64(bits, 6);
+        __m256i offset = _mm256_and_si256(bits, sixtyThree);
+        __m256i low = _mm256_i64gather_epi64((const long long *)words, word, 8);
+        __m256i high = _mm256_i64gather_epi64((const long long *)words, _mm256_add_epi64(word, one), 8);
+        low = _mm256_srlv_epi64(low, offset);
+        high = _mm256_sllv_epi64(_mm256_slli_epi64(high, 1), _mm256_sub_epi64(sixtyThree, offset));
+        _mm256_storeu_si256((__m256i *)&out[i], _mm256_and_si256(_mm256_or_si256(low, high), mask));
+        bits = _mm256_add_epi64(bits, step);
+    }
+    return i;
+}
+#endif
+
+/**
+ * Reads `count` consecutive `width`-bit values from an array of packed
+ * values, starting at `index`, into a plain array.
+ *
+ * With AVX2, this decodes four values at a time.
+ */
+static inline void bits_unpack(const uint64_t *words, size_t index, unsigned width, uint64_t *out, size_t count) {
+    size_t i = 0;
+#if defined(BITS_AVX2)
+    if (bits_has_avx2()) {
+        i = bits_unpack_avx2(words, index, width, out, count);
+    }
+#endif
+    for (; i < count; i++) {
+        out[i] = bits_unpack_one(words, index + i, width);
+    }
+}
+
+#endif // COLLECTC_BITS_H_
@@ -0,0 +1,289 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <collectc.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "bits.h"
+
+/** The number of words counted by each entry of the rank index. */
+static const size_t WORDS_PER_RANK_BLOCK = 8;
+
+/** Returns the number of words needed to hold a number of bits. */
+static inline size_t bitvec_word_count(size_t length) {
+    return (length + 63) / 64;
+}
+
+static inline uint64_t *bitvec_words_mut(bitvec_t *bv) {
+    return vector_at_mut(bv->words, 0);
+}
+
+/** Clears the unused bits of the last word, after a bulk operation. */
+static inline void bitvec_mask_last_word(bitvec_t *bv) {
+    size_t usedBits = bv->length % 64;
+    if (usedBits > 0) {
+        uint64_t *last = vector_at_mut(bv->words, vector_len(bv->words) - 1);
+        *last &= bits_mask64((unsigned)usedBits);
+    }
+}
+
+/** Discards the rank index, after the bits change. */
+static inline void bitvec_invalidate(bitvec_t *bv) {
+    vector_clear(bv->rankIndex);
+}
+
+bitvec_t bitvec_new(size_t initialCapacity) {
+    return (bitvec_t){
+        .words = vector_new(bitvec_word_count(initialCapacity), sizeof(uint64_t)),
+        .length = 0,
+        .rankIndex = vector_new(0, sizeof(size_t)),
+    };
+}
+
+bitvec_t bitvec_new_filled(size_t length, bool bit) {
+    bitvec_t bv = bitvec_new(length);
+    uint64_t word = bit ? UINT64_MAX : 0;
+    for (size_t i = 0; i < bitvec_word_count(length); i++) {
+        vector_push(&bv.words, &word, 1);
+    }
+    bv.length = length;
+    bitvec_mask_last_word(&bv);
+    return bv;
+}
+
+size_t bitvec_len(const bitvec_t *bv) {
+    return bv->length;
+}
+
+const uint64_t *bitvec_words(const bitvec_t *bv) {
+    return vector_first(bv->words);
+}
+
+void bitvec_push(bitvec_t *bv, bool bit) {
+    if (bv->length % 64 == 0) {
+        uint64_t word = 0;
+        vector_push(&bv->words, &word, 1);
+    }
+    bv->length++;
+    bitvec_set(bv, bv->length - 1, bit);
+}
+
+bool bitvec_get(const bitvec_t *bv, size_t index) {
+    if (index >= bv->length) {
+        abort();
+    }
+    const uint64_t *word = vector_at(bv->words, index / 64);
+    return (*word >> (index % 64)) & 1;
+}
+
+void bitvec_set(bitvec_t *bv, size_t index, bool bit) {
+    if (index >= bv->length) {
+        abort();
+    }
+    uint64_t *word = vector_at_mut(bv->words, index / 64);
+    uint64_t mask = (uint64_t)1 << (index % 64);
+    *word = bit ? (*word | mask) : (*word & ~mask);
+    bitvec_invalidate(bv);
+}
+
+/**
+ * Defines a function that combines the words of two bit vectors, using
+ * AVX2 for blocks of four words if the CPU supports it, and plain word
+ * operations for the rest.
+ */
+#if defined(BITS_AVX2)
+#define BITVEC_DEFINE_BINARY_OP(name, op, vectorOp)                                                                    \
+    BITS_TARGET_AVX2 static size_t name##_avx2(uint64_t *words, const uint64_t *otherWords, size_t count) {            \
+        size_t i = 0;                                                                                                  \
+        for (; i + 4 <= count; i += 4) {                                                                               \
+            __m256i a = _mm256_loadu_si256((const __m256i *)&words[i]);                                                \
+            __m256i b = _mm256_loadu_si256((const __m256i *)&otherWords[i]);                                           \
+            _mm256_storeu_si256((__m256i *)&words[i], vectorOp(a, b));                                                 \
+        }                                                                                                              \
+        return i;                                                                                                      \
+    }                                                                                                                  \
+                                                                                                                       \
+    void name(bitvec_t *bv, const bitvec_t *other) {                                                                   \
+        if (bv->length != other->length) {                                                                             \
+            abort();                                                                                                   \
+        }                                                                                                              \
+        uint64_t *words = bitvec_words_mut(bv);                                                                        \
+        const uint64_t *otherWords = bitvec_words(other);                                                              \
+        size_t count = bitvec_word_count(bv->length);                                                                  \
+        size_t i = bits_has_avx2() ? name##_avx2(words, otherWords, count) : 0;                                        \
+        for (; i < count; i++) {                                                                                       \
+            words[i] = words[i] op otherWords[i];                                                                      \
+        }                                                                                                              \
+        bitvec_invalidate(bv);                                                                                         \
+    }
+#else
+#define BITVEC_DEFINE_BINARY_OP(name, op, vectorOp)                                                                    \
+    void name(bitvec_t *bv, const bitvec_t *other) {                                                                   \
+        if (bv->length != other->length) {                                                                             \
+            abort();                                                                                                   \
+        }                                                                                                              \
+        uint64_t *words = bitvec_words_mut(bv);                                                                        \
+        const uint64_t *otherWords = bitvec_words(other);                                                              \
+        size_t count = bitvec_word_count(bv->length);                                                                  \
+        for (size_t i = 0; i < count; i++) {                                                                           \
+            words[i] = words[i] op otherWords[i];                                                                      \
+        }                                                                                                              \
+        bitvec_invalidate(bv);                                                                                         \
+    }
+#endif
+
+BITVEC_DEFINE_BINARY_OP(bitvec_and, &, _mm256_and_si256)
+BITVEC_DEFINE_BINARY_OP(bitvec_or, |, _mm256_or_si256)
+BITVEC_DEFINE_BINARY_OP(bitvec_xor, ^, _mm256_xor_si256)
+
+#if defined(BITS_AVX2)
+/** Inverts blocks of four words, and returns the number of words inverted. */
+BITS_TARGET_AVX2 static size_t bitvec_not_avx2(uint64_t *words, size_t count) {
+    size_t i = 0;
+    __m256i ones = _mm256_set1_epi64x(-1);
+    for (; i + 4 <= count; i += 4) {
+        __m256i a = _mm256_loadu_si256((const __m256i *)&words[i]);
+        _mm256_storeu_si256((__m256i *)&words[i], _mm256_xor_si256(a, ones));
+    }
+    return i;
+}
+#endif
+
+void bitvec_not(bitvec_t *bv) {
+    uint64_t *words = bitvec_words_mut(bv);
+    size_t count = bitvec_word_count(bv->length);
+    size_t i = 0;
+#if defined(BITS_AVX2)
+    if (bits_has_avx2()) {
+        i = bitvec_not_avx2(words, count);
+    }
+#endif
+    for (; i < count; i++) {
+        words[i] = ~words[i];
+    }
+    bitvec_mask_last_word(bv);
+    bitvec_invalidate(bv);
+}
+
+size_t bitvec_count_ones(const bitvec_t *bv) {
+    const uint64_t *words = bitvec_words(bv);
+    size_t count = bitvec_word_count(bv->length);
+    // Four independent sums let the CPU run several
+    // population counts at once.
+    size_t sums[4] = {0, 0, 0, 0};
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        sums[0] += bits_popcount64(words[i]);
+        sums[1] += bits_popcount64(words[i + 1]);
+        sums[2] += bits_popcount64(words[i + 2]);
+        sums[3] += bits_popcount64(words[i + 3]);
+    }
+    for (; i < count; i++) {
+        sums[0] += bits_popcount64(words[i]);
+    }
+    return sums[0] + sums[1] + sums[2] + sums[3];
+}
+
+size_t bitvec_find_first_set(const bitvec_t *bv, size_t from) {
+    if (from >= bv->length) {
+        return bv->length;
+    }
+    const uint64_t *words = bitvec_words(bv);
+    size_t count = bitvec_word_count(bv->length);
+    size_t i = from / 64;
+    uint64_t word = words[i] & (UINT64_MAX << (from % 64));
+    while (word == 0) {
+        if (++i == count) {
+            return bv->length;
+        }
+        word = words[i];
+    }
+    return (i * 64) + bits_ctz64(word);
+}
+
+/**
+ * Builds the rank index if it's missing. The index holds the number of
+ * set bits before each block of `WORDS_PER_RANK_BLOCK` words, followed
+ * by the total number of set bits.
+ */
+static void bitvec_build_rank_index(bitvec_t *bv) {
+    size_t count = bitvec_word_count(bv->length);
+    size_t blockCount = (count + WORDS_PER_RANK_BLOCK - 1) / WORDS_PER_RANK_BLOCK;
+    if (vector_len(bv->rankIndex) == blockCount + 1) {
+        return;
+    }
+    vector_clear(bv->rankIndex);
+    vector_reserve(&bv->rankIndex, blockCount + 1);
+    const uint64_t *words = bitvec_words(bv);
+    size_t rank = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (i % WORDS_PER_RANK_BLOCK == 0) {
+            vector_push(&bv->rankIndex, &rank, 1);
+        }
+        rank += bits_popcount64(words[i]);
+    }
+    vector_push(&bv->rankIndex, &rank, 1);
+}
+
+size_t bitvec_rank(bitvec_t *bv, size_t index) {
+    if (index > bv->length) {
+        abort();
+    }
+    bitvec_build_rank_index(bv);
+    const uint64_t *words = bitvec_words(bv);
+    const size_t *blocks = vector_first(bv->rankIndex);
+    size_t wordIndex = index / 64;
+    size_t block = wordIndex / WORDS_PER_RANK_BLOCK;
+    size_t rank = blocks[block];
+    for (size_t i = block * WORDS_PER_RANK_BLOCK; i < wordIndex; i++) {
+        rank += bits_popcount64(words[i]);
+    }
+    if (index % 64 > 0) {
+        rank += bits_popcount64(words[wordIndex] & bits_mask64((unsigned)(index % 64)));
+    }
+    return rank;
+}
+
+size_t bitvec_select(bitvec_t *bv, size_t n) {
+    bitvec_build_rank_index(bv);
+    const size_t *blocks = vector_first(bv->rankIndex);
+    size_t blockCount = vector_len(bv->rankIndex) - 1;
+    if (n >= blocks[blockCount]) {
+        return bv->length;
+    }
+    // Find the last block that starts with `n` or fewer set bits
+    // before it; the `n`-th set bit must be in that block.
+    size_t low = 0;
+    size_t high = blockCount;
+    while (high - low > 1) {
+        size_t middle = low + (high - low) / 2;
+        if (blocks[middle] <= n) {
+            low = middle;
+        } else {
+            high = middle;
+        }
+    }
+    const uint64_t *words = bitvec_words(bv);
+    size_t remaining = n - blocks[low];
+    for (size_t i = low * WORDS_PER_RANK_BLOCK;; i++) {
+        unsigned ones = bits_popcount64(words[i]);
+        if (remaining < ones) {
+            return (i * 64) + bits_select64(words[i], (unsigned)remaining);
+        }
+        remaining -= ones;
+    }
+}
+
+void bitvec_clear(bitvec_t *bv) {
+    vector_clear(bv->words);
+    bv->length = 0;
+    bitvec_invalidate(bv);
+}
+
+void bitvec_delete(bitvec_t *bv) {
+    vector_delete(bv->words);
+    vector_delete(bv->rankIndex);
+}
@@ -0,0 +1,551 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#if defined(__linux__)
+#define _GNU_SOURCE
+#else
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <collectc.h>
+
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <sched.h>
+#endif
+
+#include "bits.h"
+
+/** The assumed size of a cache line, for keeping shards and counters apart. */
+#define CACHE_LINE_SIZE 64
+
+/** The number of top hash bits that pick a key's shard. */
+#define SHARD_BITS 6
+#define SHARD_COUNT (1 << SHARD_BITS)
+
+/**
+ * The number of reader counters. Each thread counts itself in on its
+ * own counter, until there are more threads than counters.
+ */
+#define READER_SLOTS 64
+
+/**
+ * The most bucket segments a shard can have. Segment 0 holds bucket 0,
+ * and each segment `s > 0` holds buckets `[2^(s - 1), 2^s)`, so doubling
+ * the buckets allocates one new segment, and never moves the old ones.
+ */
+#define SEGMENT_COUNT 64
+
+/** The average number of entries per bucket above which a shard doubles its buckets. */
+#define MAX_LOAD 1
+
+/** The number of retired nodes that a shard collects before it tries to free them. */
+#define RECLAIM_THRESHOLD 64
+
+/**
+ * The number of buckets that each write links markers in for, besides
+ * its own. This keeps the markers ahead of growth, so readers don't
+ * fall back to a parent bucket, and scan its longer run of the list.
+ */
+#define MARKS_PER_WRITE 2
+
+/** The number of times a writer checks a held lock before it sleeps. */
+#define LOCK_SPINS 64
+
+/**
+ * A node of a shard's list: an entry, followed by its key and value, a
+ * bucket's marker, or the shard's tail. A node's fields never change once
+ * it's linked in, except for `next`, which is only `null` in the tail and
+ * in markers that aren't linked in yet.
+ */
+typedef struct concurrent_hashmap_node {
+    _Atomic(struct concurrent_hashmap_node *) next;
+    /**
+     * The node's place in the list. An entry's is its hash with the bits
+     * reversed, and the lowest bit set; a marker's is its bucket's index
+     * with the bits reversed, which is even, and sorts before every entry
+     * in the bucket. The tail's is `UINT64_MAX`.
+     */
+    uint64_t order;
+} concurrent_hashmap_node_t;
+
+/** A node that's been unlinked, and the epoch it was unlinked in. */
+typedef struct concurrent_hashmap_retired {
+    concurrent_hashmap_node_t *node;
+    uint64_t epoch;
+} concurrent_hashmap_retired_t;
+
+typedef struct concurrent_hashmap_shard {
+    /** 0 if unlocked, 1 if locked, or 2 if locked and writers may be sleeping. */
+    _Alignas(CACHE_LINE_SIZE) atomic_uint lock;
+    /** A power of 2. Buckets are only allocated once it covers them. */
+    atomic_size_t bucketCount;
+    atomic_size_t length;
+    /** The buckets before this have markers. Only writers use it. */
+    size_t marked;
+    /**
+     * The buckets, which are their markers, so that a lookup goes
+     * straight from the bucket to its first entry. A marker isn't linked
+     * in until a writer first uses its bucket; readers start from the
+     * nearest parent bucket instead, which comes earlier in the list.
+     */
+    _Atomic(concurrent_hashmap_node_t *) segments[SEGMENT_COUNT];
+    /** The end of the list, after every entry, so that linked nodes never point to `null`. */
+    concurrent_hashmap_node_t tail;
+    /** The nodes this shard's writers have unlinked, oldest first. */
+    vector_t retired;
+} concurrent_hashmap_shard_t;
+
+/** The number of readers that counted themselves in during even and odd epochs. */
+typedef struct concurrent_hashmap_readers {
+    _Alignas(CACHE_LINE_SIZE) atomic_size_t active[2];
+} concurrent_hashmap_readers_t;
+
+struct concurrent_hashmap {
+    /**
+     * The epoch only advances from `e` to `e + 1` once every reader that
+     * counted itself in during `e - 1` has left. So a node unlinked
+     * during `e` can be freed in `e + 2`, when no reader can still hold it.
+     */
+    _Alignas(CACHE_LINE_SIZE) atomic_uint_least64_t epoch;
+    concurrent_hashmap_readers_t readers[READER_SLOTS];
+
+    _Alignas(CACHE_LINE_SIZE) hashmap_hash_t hash;
+    hashmap_equal_t equal;
+    size_t keySize;
+    size_t valueSize;
+    /** The offset of each value from the start of its key. */
+    size_t valueOffset;
+    size_t nodeSize;
+    concurrent_hashmap_shard_t shards[SHARD_COUNT];
+};
+
+/** The counter this thread reads with, plus 1, or 0 before its first read. */
+static _Thread_local unsigned readerSlot;
+
+/** The counter for the next thread that reads. */
+static atomic_uint nextReaderSlot;
+
+static inline uint64_t concurrent_hashmap_hash_key(const concurrent_hashmap_t *map, const void *key) {
+    return map->hash == NULL ? hash_bytes(key, map->keySize, 0) : map->hash(key);
+}
+
+static inline bool concurrent_hashmap_keys_equal(const concurrent_hashmap_t *map, const void *a, const void *b) {
+    return map->equal == NULL ? memcmp(a, b, map->keySize) == 0 : map->equal(a, b);
+}
+
+static inline char *concurrent_hashmap_key(concurrent_hashmap_node_t *node) {
+    return (char *)node + sizeof(concurrent_hashmap_node_t);
+}
+
+static inline uint64_t concurrent_hashmap_entry_order(uint64_t hash) {
+    return bits_reverse64(hash) | 1;
+}
+
+/** Returns the index of a bucket's parent, by clearing its highest bit. */
+static inline size_t concurrent_hashmap_parent(size_t index) {
+    return index & ~((size_t)1 << (bits_width64(index) - 1));
+}
+
+/** Returns the marker of a bucket, or `null` if its segment isn't allocated. */
+static concurrent_hashmap_node_t *concurrent_hashmap_bucket(concurrent_hashmap_shard_t *shard, size_t index) {
+    unsigned segment = index == 0 ? 0 : bits_width64(index);
+    concurrent_hashmap_node_t *buckets = atomic_load_explicit(&shard->segments[segment], memory_order_acquire);
+    if (buckets == NULL) {
+        return NULL;
+    }
+    return &buckets[index == 0 ? 0 : index - ((size_t)1 << (segment - 1))];
+}
+
+/** Returns the marker of a bucket, or of its nearest parent, if it isn't linked in. */
+static concurrent_hashmap_node_t *concurrent_hashmap_marker(concurrent_hashmap_shard_t *shard, size_t index) {
+    for (;;) {
+        concurrent_hashmap_node_t *marker = concurrent_hashmap_bucket(shard, index);
+        if (marker != NULL && atomic_load_explicit(&marker->next, memory_order_acquire) != NULL) {
+            return marker;
+        }
+        // Bucket 0 always has a marker, so this ends.
+        index = concurrent_hashmap_parent(index);
+    }
+}
+
+/**
+ * Finds a key's entry in the list, starting from a marker before it.
+ * Sets `pred` to the node before the entry, or before where it would be
+ * linked in. Returns `null` if the key isn't in the list.
+ */
+static concurrent_hashmap_node_t *concurrent_hashmap_search(
+    const concurrent_hashmap_t *map,
+    concurrent_hashmap_node_t *marker,
+    const void *key,
+    uint64_t order,
+    concurrent_hashmap_node_t **pred
+) {
+    concurrent_hashmap_node_t *prev = marker;
+    concurrent_hashmap_node_t *node = atomic_load_explicit(&marker->next, memory_order_acquire);
+    while (node->order <= order) {
+        if (node->order == order) {
+            // Only the tail has no key, and it's last.
+            if (atomic_load_explicit(&node->next, memory_order_relaxed) == NULL) {
+                break;
+            }
+            if (concurrent_hashmap_keys_equal(map, key, concurrent_hashmap_key(node))) {
+                *pred = prev;
+                return node;
+            }
+        }
+        prev = node;
+        node = atomic_load_explicit(&node->next, memory_order_acquire);
+    }
+    *pred = prev;
+    return NULL;
+}
+
+/**
+ * Counts this thread in as a reader of the current epoch, and returns
+ * the counter to count it out with. The epoch is checked again after
+ * counting in: if it advanced in between, a writer may not have seen the
+ * count, so the reader counts itself in to the new epoch instead.
+ */
+static atomic_size_t *concurrent_hashmap_enter(concurrent_hashmap_t *map) {
+    if (readerSlot == 0) {
+        readerSlot = (atomic_fetch_add_explicit(&nextReaderSlot, 1, memory_order_relaxed) % READER_SLOTS) + 1;
+    }
+    concurrent_hashmap_readers_t *readers = &map->readers[readerSlot - 1];
+    for (;;) {
+        uint64_t epoch = atomic_load(&map->epoch);
+        atomic_size_t *active = &readers->active[epoch & 1];
+        atomic_fetch_add(active, 1);
+        if (atomic_load(&map->epoch) == epoch) {
+            return active;
+        }
+        atomic_fetch_sub_explicit(active, 1, memory_order_release);
+    }
+}
+
+static inline void concurrent_hashmap_exit(atomic_size_t *active) {
+    atomic_fetch_sub_explicit(active, 1, memory_order_release);
+}
+
+/** Returns `true` if no readers are counted in during epochs with a parity. */
+static bool concurrent_hashmap_drained(concurrent_hashmap_t *map, unsigned parity) {
+    for (size_t i = 0; i < READER_SLOTS; i++) {
+        if (atomic_load(&map->readers[i].active[parity]) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Advances the epoch if the readers of the previous one have left, and
+ * frees the shard's retired nodes that no reader can still hold.
+ */
+static void concurrent_hashmap_reclaim(concurrent_hashmap_t *map, concurrent_hashmap_shard_t *shard) {
+    uint64_t epoch = atomic_load(&map->epoch);
+    // Readers of `epoch - 2` left before the epoch advanced to `epoch`.
+    // If readers of `epoch - 1` have left too, nodes unlinked during it
+    // are safe to free, and the epoch can advance.
+    uint64_t lag = 2;
+    if (concurrent_hashmap_drained(map, (unsigned)(epoch + 1) & 1)) {
+        // If another writer advanced it first, this only checked the
+        // readers up to `epoch`, so frees against `epoch` all the same.
+        uint64_t expected = epoch;
+        atomic_compare_exchange_strong(&map->epoch, &expected, epoch + 1);
+        lag = 1;
+    }
+    size_t freed = 0;
+    size_t length = vector_len(shard->retired);
+    const concurrent_hashmap_retired_t *retired = vector_first(shard->retired);
+    while (freed < length && retired[freed].epoch + lag <= epoch) {
+        free(retired[freed].node);
+        freed++;
+    }
+    vector_remove(shard->retired, 0, freed);
+}
+
+/** Retires a node that a writer has just unlinked, to be freed once no reader can hold it. */
+static void concurrent_hashmap_retire(
+    concurrent_hashmap_t *map, concurrent_hashmap_shard_t *shard, concurrent_hashmap_node_t *node
+) {
+    // The unlink must be visible before the epoch is read: otherwise a
+    // reader that enters in the next epoch could still reach the node,
+    // and be missed when the node is freed.
+    atomic_thread_fence(memory_order_seq_cst);
+    concurrent_hashmap_retired_t retired = {.node = node, .epoch = atomic_load(&map->epoch)};
+    vector_push(&shard->retired, &retired, 1);
+    if (vector_len(shard->retired) >= RECLAIM_THRESHOLD) {
+        concurrent_hashmap_reclaim(map, shard);
+    }
+}
+
+static void concurrent_hashmap_lock(atomic_uint *lock) {
+    unsigned state = 0;
+    for (size_t spin = 0; spin < LOCK_SPINS; spin++) {
+        if (atomic_compare_exchange_weak_explicit(lock, &state, 1, memory_order_acquire, memory_order_relaxed)) {
+            return;
+        }
+        state = 0;
+    }
+    // Mark the lock contended, so the holder wakes a sleeper when it unlocks.
+    while (atomic_exchange_explicit(lock, 2, memory_order_acquire) != 0) {
+#if defined(__linux__)
+        syscall(SYS_futex, (unsigned *)lock, FUTEX_WAIT_PRIVATE, 2, NULL, NULL, 0);
+#else
+        sched_yield();
+#endif
+    }
+}
+
+static void concurrent_hashmap_unlock(atomic_uint *lock) {
+    if (atomic_exchange_explicit(lock, 0, memory_order_release) == 2) {
+#if defined(__linux__)
+        syscall(SYS_futex, (unsigned *)lock, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+#endif
+    }
+}
+
+/** Allocates an entry, with its key and value copied in. */
+static concurrent_hashmap_node_t *concurrent_hashmap_entry_new(
+    const concurrent_hashmap_t *map, uint64_t order, const void *key, const void *value
+) {
+    concurrent_hashmap_node_t *node = malloc(map->nodeSize);
+    if (node == NULL) {
+        abort();
+    }
+    atomic_init(&node->next, NULL);
+    node->order = order;
+    memcpy(concurrent_hashmap_key(node), key, map->keySize);
+    if (map->valueSize > 0) {
+        memcpy(concurrent_hashmap_key(node) + map->valueOffset, value, map->valueSize);
+    }
+    return node;
+}
+
+/**
+ * Returns the marker of a bucket, linking it in first if the bucket
+ * hasn't been used. The bucket's segment must be allocated. Writers
+ * only call this with the shard's lock held.
+ */
+static concurrent_hashmap_node_t *concurrent_hashmap_marker_init(concurrent_hashmap_shard_t *shard, size_t index) {
+    concurrent_hashmap_node_t *marker = concurrent_hashmap_bucket(shard, index);
+    if (atomic_load_explicit(&marker->next, memory_order_relaxed) != NULL) {
+        return marker;
+    }
+    concurrent_hashmap_node_t *prev = concurrent_hashmap_marker_init(shard, concurrent_hashmap_parent(index));
+    marker->order = bits_reverse64(index);
+    concurrent_hashmap_node_t *next = atomic_load_explicit(&prev->next, memory_order_relaxed);
+    while (next->order < marker->order) {
+        prev = next;
+        next = atomic_load_explicit(&next->next, memory_order_relaxed);
+    }
+    // Readers may start from the marker as soon as it points on into
+    // the list, which is already the right place to start.
+    atomic_store_explicit(&marker->next, next, memory_order_release);
+    atomic_store_explicit(&prev->next, marker, memory_order_release);
+    return marker;
+}
+
+/** Links in markers for the next few buckets that don't have them yet. */
+static void concurrent_hashmap_mark_ahead(concurrent_hashmap_shard_t *shard, size_t bucketCount) {
+    for (size_t i = 0; i < MARKS_PER_WRITE && shard->marked < bucketCount; i++) {
+        concurrent_hashmap_marker_init(shard, shard->marked++);
+    }
+}
+
+/**
+ * Doubles a shard's buckets, by allocating the segment for the new half.
+ * Each new bucket's entries are already in the list, right after their
+ * parent's, so nothing moves.
+ */
+static void concurrent_hashmap_grow(concurrent_hashmap_shard_t *shard, size_t bucketCount) {
+    unsigned segment = bits_width64(bucketCount);
+    if (segment >= SEGMENT_COUNT) {
+        return;
+    }
+    // All-zero bytes are markers that aren't linked in, since they're
+    // null atomic pointers on every platform with lock-free ones.
+    concurrent_hashmap_node_t *buckets = calloc(bucketCount, sizeof(concurrent_hashmap_node_t));
+    if (buckets == NULL) {
+        abort();
+    }
+    atomic_store_explicit(&shard->segments[segment], buckets, memory_order_release);
+    atomic_store_explicit(&shard->bucketCount, bucketCount * 2, memory_order_release);
+}
+
+concurrent_hashmap_t *
+concurrent_hashmap_new(size_t keySize, size_t valueSize, hashmap_hash_t hash, hashmap_equal_t equal) {
+    concurrent_hashmap_t *map = aligned_alloc(CACHE_LINE_SIZE, sizeof(concurrent_hashmap_t));
+    if (map == NULL) {
+        abort();
+    }
+    size_t valueAlignment = valueSize & (~valueSize + 1);
+    if (valueAlignment == 0 || valueAlignment > 16) {
+        valueAlignment = 16;
+    }
+    map->hash = hash;
+    map->equal = equal;
+    map->keySize = keySize;
+    map->valueSize = valueSize;
+    map->valueOffset = (keySize + valueAlignment - 1) & ~(valueAlignment - 1);
+    map->nodeSize = sizeof(concurrent_hashmap_node_t) + map->valueOffset + valueSize;
+    atomic_init(&map->epoch, 0);
+    for (size_t i = 0; i < READER_SLOTS; i++) {
+        atomic_init(&map->readers[i].active[0], 0);
+        atomic_init(&map->readers[i].active[1], 0);
+    }
+    for (size_t s = 0; s < SHARD_COUNT; s++) {
+        concurrent_hashmap_shard_t *shard = &map->shards[s];
+        atomic_init(&shard->lock, 0);
+        atomic_init(&shard->bucketCount, 1);
+        atomic_init(&shard->length, 0);
+        shard->marked = 1;
+        for (size_t i = 0; i < SEGMENT_COUNT; i++) {
+            atomic_init(&shard->segments[i], NULL);
+        }
+        atomic_init(&shard->tail.next, NULL);
+        shard->tail.order = UINT64_MAX;
+        concurrent_hashmap_node_t *first = malloc(sizeof(concurrent_hashmap_node_t));
+        if (first == NULL) {
+            abort();
+        }
+        atomic_init(&first->next, &shard->tail);
+        first->order = 0;
+        atomic_init(&shard->segments[0], first);
+        shard->retired = vector_new(0, sizeof(concurrent_hashmap_retired_t));
+    }
+    return map;
+}
+
+size_t concurrent_hashmap_len(const concurrent_hashmap_t *map) {
+    size_t length = 0;
+    for (size_t s = 0; s < SHARD_COUNT; s++) {
+        length += atomic_load_explicit(&((concurrent_hashmap_t *)map)->shards[s].length, memory_order_relaxed);
+    }
+    return length;
+}
+
+size_t concurrent_hashmap_key_size(const concurrent_hashmap_t *map) {
+    return map->keySize;
+}
+
+size_t concurrent_hashmap_value_size(const concurrent_hashmap_t *map) {
+    return map->valueSize;
+}
+
+bool concurrent_hashmap_get(const concurrent_hashmap_t *map, const void *key, void *value) {
+    // Readers only write to their own counters, which live in the map.
+    concurrent_hashmap_t *mutableMap = (concurrent_hashmap_t *)map;
+    uint64_t hash = concurrent_hashmap_hash_key(map, key);
+    concurrent_hashmap_shard_t *shard = &mutableMap->shards[hash >> (64 - SHARD_BITS)];
+    atomic_size_t *active = concurrent_hashmap_enter(mutableMap);
+    size_t bucketCount = atomic_load_explicit(&shard->bucketCount, memory_order_acquire);
+    concurrent_hashmap_node_t *marker = concurrent_hashmap_marker(shard, hash & (bucketCount - 1));
+    concurrent_hashmap_node_t *pred;
+    concurrent_hashmap_node_t *node = concurrent_hashmap_search(
+        map, marker, key, concurrent_hashmap_entry_order(hash), &pred
+    );
+    if (node != NULL && value != NULL && map->valueSize > 0) {
+        memcpy(value, concurrent_hashmap_key(node) + map->valueOffset, map->valueSize);
+    }
+    concurrent_hashmap_exit(active);
+    return node != NULL;
+}
+
+bool concurrent_hashmap_contains(const concurrent_hashmap_t *map, const void *key) {
+    return concurrent_hashmap_get(map, key, NULL);
+}
+
+bool concurrent_hashmap_insert(concurrent_hashmap_t *map, const void *key, const void *value) {
+    uint64_t hash = concurrent_hashmap_hash_key(map, key);
+    uint64_t order = concurrent_hashmap_entry_order(hash);
+    concurrent_hashmap_shard_t *shard = &map->shards[hash >> (64 - SHARD_BITS)];
+    // Build the entry before taking the lock, to keep the lock held briefly.
+    concurrent_hashmap_node_t *entry = concurrent_hashmap_entry_new(map, order, key, value);
+    concurrent_hashmap_lock(&shard->lock);
+    size_t bucketCount = atomic_load_explicit(&shard->bucketCount, memory_order_relaxed);
+    concurrent_hashmap_node_t *marker = concurrent_hashmap_marker_init(shard, hash & (bucketCount - 1));
+    concurrent_hashmap_node_t *pred;
+    concurrent_hashmap_node_t *old = concurrent_hashmap_search(map, marker, key, order, &pred);
+    if (old != NULL) {
+        // Replace the old entry, so that readers never see a value
+        // that's only partly written.
+        atomic_init(&entry->next, atomic_load_explicit(&old->next, memory_order_relaxed));
+        atomic_store_explicit(&pred->next, entry, memory_order_release);
+        concurrent_hashmap_retire(map, shard, old);
+    } else {
+        atomic_init(&entry->next, atomic_load_explicit(&pred->next, memory_order_relaxed));
+        atomic_store_explicit(&pred->next, entry, memory_order_release);
+        size_t length = atomic_load_explicit(&shard->length, memory_order_relaxed) + 1;
+        atomic_store_explicit(&shard->length, length, memory_order_relaxed);
+        if (length > bucketCount * MAX_LOAD) {
+            concurrent_hashmap_grow(shard, bucketCount);
+        }
+    }
+    concurrent_hashmap_mark_ahead(shard, bucketCount);
+    concurrent_hashmap_unlock(&shard->lock);
+    return old == NULL;
+}
+
+bool concurrent_hashmap_remove(concurrent_hashmap_t *map, const void *key, void *value) {
+    uint64_t hash = concurrent_hashmap_hash_key(map, key);
+    concurrent_hashmap_shard_t *shard = &map->shards[hash >> (64 - SHARD_BITS)];
+    concurrent_hashmap_lock(&shard->lock);
+    size_t bucketCount = atomic_load_explicit(&shard->bucketCount, memory_order_relaxed);
+    concurrent_hashmap_node_t *marker = concurrent_hashmap_marker(shard, hash & (bucketCount - 1));
+    concurrent_hashmap_node_t *pred;
+    concurrent_hashmap_node_t *node = concurrent_hashmap_search(
+        map, marker, key, concurrent_hashmap_entry_order(hash), &pred
+    );
+    if (node != NULL) {
+        if (value != NULL && map->valueSize > 0) {
+            memcpy(value, concurrent_hashmap_key(node) + map->valueOffset, map->valueSize);
+        }
+        // Readers that are on the node still find their way on from it.
+        concurrent_hashmap_node_t *next = atomic_load_explicit(&node->next, memory_order_relaxed);
+        atomic_store_explicit(&pred->next, next, memory_order_release);
+        atomic_store_explicit(
+            &shard->length, atomic_load_explicit(&shard->length, memory_order_relaxed) - 1, memory_order_relaxed
+        );
+        concurrent_hashmap_retire(map, shard, node);
+    }
+    concurrent_hashmap_mark_ahead(shard, bucketCount);
+    concurrent_hashmap_unlock(&shard->lock);
+    return node != NULL;
+}
+
+void concurrent_hashmap_delete(concurrent_hashmap_t *map) {
+    if (map == NULL) {
+        return;
+    }
+    for (size_t s = 0; s < SHARD_COUNT; s++) {
+        concurrent_hashmap_shard_t *shard = &map->shards[s];
+        concurrent_hashmap_node_t *first = concurrent_hashmap_bucket(shard, 0);
+        concurrent_hashmap_node_t *node = atomic_load_explicit(&first->next, memory_order_relaxed);
+        while (node != &shard->tail) {
+            concurrent_hashmap_node_t *next = atomic_load_explicit(&node->next, memory_order_relaxed);
+            // Markers live in their segments.
+            if ((node->order & 1) != 0) {
+                free(node);
+            }
+            node = next;
+        }
+        const concurrent_hashmap_retired_t *retired = vector_first(shard->retired);
+        for (size_t i = 0; i < vector_len(shard->retired); i++) {
+            free(retired[i].node);
+        }
+        vector_delete(shard->retired);
+        for (size_t i = 0; i < SEGMENT_COUNT; i++) {
+            free((void *)atomic_load_explicit(&shard->segments[i], memory_order_relaxed));
+        }
+    }
+    free(map);
+}
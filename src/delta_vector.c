@@ -0,0 +1,238 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <collectc.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "bits.h"
+
+/** The number of values in each encoded block. */
+#define BLOCK_LENGTH 128
+
+/** A skip index entry, describing one encoded block. */
+typedef struct delta_vector_block {
+    uint64_t first;
+    uint64_t last;
+    /** The index of the block's first word in the data vector. */
+    size_t offset;
+    /** The number of bits in each of the block's differences. */
+    unsigned width;
+} delta_vector_block_t;
+
+/**
+ * Decodes a whole block into `values`, which must hold `BLOCK_LENGTH`
+ * values. The first value is the block's base; each following value
+ * adds its packed difference to the value before it.
+ */
+static void delta_vector_decode_block(const delta_vector_t *dv, const delta_vector_block_t *block, uint64_t *values) {
+    values[0] = block->first;
+    if (block->width == 0) {
+        for (size_t i = 1; i < BLOCK_LENGTH; i++) {
+            values[i] = block->first;
+        }
+        return;
+    }
+    const uint64_t *words = vector_at(dv->data, block->offset);
+    if (bits_has_avx2()) {
+        bits_unpack(words, 0, block->width, &values[1], BLOCK_LENGTH - 1);
+        for (size_t i = 1; i < BLOCK_LENGTH; i++) {
+            values[i] += values[i - 1];
+        }
+        return;
+    }
+    // Without AVX2, unpacking and summing in the same pass
+    // avoids writing the differences out and reading them back.
+    uint64_t mask = bits_mask64(block->width);
+    uint64_t value = block->first;
+    size_t bit = 0;
+    for (size_t i = 1; i < BLOCK_LENGTH; i++, bit += block->width) {
+        size_t word = bit / 64;
+        unsigned offset = bit % 64;
+        uint64_t gap = ((words[word] >> offset) | ((words[word + 1] << 1) << (63 - offset))) & mask;
+        value += gap;
+        values[i] = value;
+    }
+}
+
+/** Encodes the full tail as a new block, and empties the tail. */
+static void delta_vector_seal(delta_vector_t *dv) {
+    const uint64_t *values = vector_first(dv->tail);
+    uint64_t gaps = 0;
+    for (size_t i = 1; i < BLOCK_LENGTH; i++) {
+        gaps |= values[i] - values[i - 1];
+    }
+    delta_vector_block_t block = {
+        .first = values[0],
+        .last = values[BLOCK_LENGTH - 1],
+        // The data vector always ends with a zero padding word, which
+        // `bits_unpack` can read past the last value. The new block
+        // starts there, and adds a new padding word after itself.
+        .offset = vector_len(dv->data) - 1,
+        .width = gaps == 0 ? 0 : bits_width64(gaps),
+    };
+    size_t wordCount = (((BLOCK_LENGTH - 1) * block.width) + 63) / 64;
+    vector_reserve(&dv->data, wordCount);
+    uint64_t zero = 0;
+    for (size_t i = 0; i < wordCount; i++) {
+        vector_push(&dv->data, &zero, 1);
+    }
+    if (block.width > 0) {
+        uint64_t *words = vector_at_mut(dv->data, block.offset);
+        for (size_t i = 1; i < BLOCK_LENGTH; i++) {
+            bits_pack_one(words, i - 1, block.width, values[i] - values[i - 1]);
+        }
+    }
+    vector_push(&dv->blocks, &block, 1);
+    vector_clear(dv->tail);
+}
+
+delta_vector_t delta_vector_new(void) {
+    delta_vector_t dv = {
+        .blocks = vector_new(0, sizeof(delta_vector_block_t)),
+        .data = vector_new(1, sizeof(uint64_t)),
+        .tail = vector_new(0, sizeof(uint64_t)),
+        .length = 0,
+    };
+    uint64_t padding = 0;
+    vector_push(&dv.data, &padding, 1);
+    return dv;
+}
+
+delta_vector_t delta_vector_from_vector(vector_t vec) {
+    if (vector_element_size(vec) != sizeof(uint64_t)) {
+        abort();
+    }
+    delta_vector_t dv = delta_vector_new();
+    size_t length = vector_len(vec);
+    for (size_t index = 0; index < length;) {
+        size_t run = vector_run_len(vec, index);
+        delta_vector_push(&dv, vector_at(vec, index), run);
+        index += run;
+    }
+    return dv;
+}
+
+size_t delta_vector_len(const delta_vector_t *dv) {
+    return dv->length;
+}
+
+size_t delta_vector_allocation_size(const delta_vector_t *dv) {
+    return vector_allocation_size(dv->blocks) + vector_allocation_size(dv->data) + vector_allocation_size(dv->tail);
+}
+
+void delta_vector_push(delta_vector_t *dv, const uint64_t *values, size_t count) {
+    const uint64_t *last = vector_last(dv->tail);
+    if (last == NULL && vector_len(dv->blocks) > 0) {
+        last = &((const delta_vector_block_t *)vector_last(dv->blocks))->last;
+    }
+    uint64_t previous = last == NULL ? 0 : *last;
+    for (size_t i = 0; i < count; i++) {
+        if (values[i] < previous) {
+            abort();
+        }
+        previous = values[i];
+        vector_push(&dv->tail, &values[i], 1);
+        if (vector_len(dv->tail) == BLOCK_LENGTH) {
+            delta_vector_seal(dv);
+        }
+    }
+    dv->length += count;
+}
+
+uint64_t delta_vector_get(const delta_vector_t *dv, size_t index) {
+    uint64_t value;
+    delta_vector_decode(dv, index, &value, 1);
+    return value;
+}
+
+void delta_vector_decode(const delta_vector_t *dv, size_t index, uint64_t *values, size_t count) {
+    if (index + count > dv->length) {
+        abort();
+    }
+    size_t blockCount = vector_len(dv->blocks);
+    size_t blockIndex = index / BLOCK_LENGTH;
+    size_t start = index % BLOCK_LENGTH;
+    while (count > 0 && blockIndex < blockCount) {
+        size_t n = BLOCK_LENGTH - start < count ? BLOCK_LENGTH - start : count;
+        if (start == 0 && n == BLOCK_LENGTH) {
+            // Decode whole blocks directly into the output.
+            delta_vector_decode_block(dv, vector_at(dv->blocks, blockIndex), values);
+        } else {
+            uint64_t block[BLOCK_LENGTH];
+            delta_vector_decode_block(dv, vector_at(dv->blocks, blockIndex), block);
+            memcpy(values, &block[start], n * sizeof(uint64_t));
+        }
+        values += n;
+        count -= n;
+        blockIndex++;
+        start = 0;
+    }
+    if (count > 0) {
+        vector_slice(dv->tail, start, values, count);
+    }
+}
+
+size_t delta_vector_lower_bound(const delta_vector_t *dv, uint64_t value) {
+    // Find the first block whose last value isn't less than `value`.
+    size_t low = 0;
+    size_t high = vector_len(dv->blocks);
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        const delta_vector_block_t *block = vector_at(dv->blocks, middle);
+        if (block->last < value) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    if (low < vector_len(dv->blocks)) {
+        const delta_vector_block_t *block = vector_at(dv->blocks, low);
+        if (block->first >= value) {
+            return low * BLOCK_LENGTH;
+        }
+        uint64_t values[BLOCK_LENGTH];
+        delta_vector_decode_block(dv, block, values);
+        size_t i = 1;
+        while (values[i] < value) {
+            i++;
+        }
+        return (low * BLOCK_LENGTH) + i;
+    }
+    size_t tailStart = vector_len(dv->blocks) * BLOCK_LENGTH;
+    const uint64_t *tail = vector_first(dv->tail);
+    for (size_t i = 0; i < vector_len(dv->tail); i++) {
+        if (tail[i] >= value) {
+            return tailStart + i;
+        }
+    }
+    return dv->length;
+}
+
+vector_t delta_vector_to_vector(const delta_vector_t *dv) {
+    vector_t vec = vector_new(dv->length, sizeof(uint64_t));
+    size_t blockCount = vector_len(dv->blocks);
+    uint64_t block[BLOCK_LENGTH];
+    for (size_t i = 0; i < blockCount; i++) {
+        delta_vector_decode_block(dv, vector_at(dv->blocks, i), block);
+        vector_push(&vec, block, BLOCK_LENGTH);
+    }
+    vector_extend(&vec, dv->tail);
+    return vec;
+}
+
+void delta_vector_clear(delta_vector_t *dv) {
+    vector_clear(dv->blocks);
+    vector_clear(dv->tail);
+    vector_remove(dv->data, 1, vector_len(dv->data) - 1);
+    *(uint64_t *)vector_at_mut(dv->data, 0) = 0;
+    dv->length = 0;
+}
+
+void delta_vector_delete(delta_vector_t *dv) {
+    vector_delete(dv->blocks);
+    vector_delete(dv->data);
+    vector_delete(dv->tail);
+}
@@ -0,0 +1,218 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <collectc.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * The allocation header for a deque. The element at index `i` is in slot
+ * `(head + i) & (capacity - 1)`. The capacity is zero or a power of two.
+ */
+typedef struct deque_header {
+    size_t capacity;
+    size_t head;
+    size_t length;
+    size_t elementSize;
+} deque_header_t;
+
+static inline deque_header_t *deque_header(deque_t dq) {
+    return (deque_header_t *)dq;
+}
+
+static inline char *deque_slot(deque_header_t *header, size_t slot) {
+    return (char *)header + sizeof(*header) + (slot * header->elementSize);
+}
+
+/** Returns the slot that holds the element at an index. */
+static inline size_t deque_slot_index(const deque_header_t *header, size_t index) {
+    return (header->head + index) & (header->capacity - 1);
+}
+
+/** Rounds a capacity up to the next power of two. */
+static size_t deque_round_capacity(size_t capacity) {
+    size_t rounded = 1;
+    while (rounded < capacity) {
+        rounded <<= 1;
+    }
+    return rounded;
+}
+
+/** Copies elements into the ring, starting at a slot and wrapping around. */
+static void deque_copy_in(deque_header_t *header, size_t slot, const void *elements, size_t count) {
+    size_t beforeEnd = header->capacity - slot < count ? header->capacity - slot : count;
+    memcpy(deque_slot(header, slot), elements, beforeEnd * header->elementSize);
+    if (count > beforeEnd) {
+        const char *rest = (const char *)elements + (beforeEnd * header->elementSize);
+        memcpy(deque_slot(header, 0), rest, (count - beforeEnd) * header->elementSize);
+    }
+}
+
+/** Copies elements out of the ring, starting at a slot and wrapping around. */
+static void deque_copy_out(deque_header_t *header, size_t slot, void *elements, size_t count) {
+    size_t beforeEnd = header->capacity - slot < count ? header->capacity - slot : count;
+    memcpy(elements, deque_slot(header, slot), beforeEnd * header->elementSize);
+    if (count > beforeEnd) {
+        char *rest = (char *)elements + (beforeEnd * header->elementSize);
+        memcpy(rest, deque_slot(header, 0), (count - beforeEnd) * header->elementSize);
+    }
+}
+
+deque_t deque_new(size_t initialCapacity, size_t elementSize) {
+    size_t capacity = initialCapacity == 0 ? 0 : deque_round_capacity(initialCapacity);
+    deque_header_t *header = malloc(sizeof(deque_header_t) + (capacity * elementSize));
+    if (header == NULL) {
+        abort();
+    }
+    header->capacity = capacity;
+    header->head = 0;
+    header->length = 0;
+    header->elementSize = elementSize;
+    return (deque_t)header;
+}
+
+size_t deque_len(deque_t dq) {
+    return deque_header(dq)->length;
+}
+
+size_t deque_capacity(deque_t dq) {
+    return deque_header(dq)->capacity;
+}
+
+size_t deque_element_size(deque_t dq) {
+    return deque_header(dq)->elementSize;
+}
+
+bool deque_is_empty(deque_t dq) {
+    return deque_len(dq) == 0;
+}
+
+const void *deque_at(deque_t dq, size_t index) {
+    return deque_at_mut(dq, index);
+}
+
+void *deque_at_mut(deque_t dq, size_t index) {
+    deque_header_t *header = deque_header(dq);
+    if (index >= header->length) {
+        return NULL;
+    }
+    return deque_slot(header, deque_slot_index(header, index));
+}
+
+const void *deque_front(deque_t dq) {
+    return deque_at(dq, 0);
+}
+
+const void *deque_back(deque_t dq) {
+    size_t length = deque_len(dq);
+    return length > 0 ? deque_at(dq, length - 1) : NULL;
+}
+
+void deque_reserve(deque_t *dq, size_t extraCapacity) {
+    deque_header_t *header = deque_header(*dq);
+    if (header->length + extraCapacity <= header->capacity) {
+        return;
+    }
+    size_t oldCapacity = header->capacity;
+    size_t newCapacity = deque_round_capacity(header->length + extraCapacity);
+    if (newCapacity < oldCapacity * 2) {
+        newCapacity = oldCapacity * 2;
+    }
+    header = realloc(header, sizeof(deque_header_t) + (newCapacity * header->elementSize));
+    if (header == NULL) {
+        abort();
+    }
+    header->capacity = newCapacity;
+    if (header->head + header->length > oldCapacity) {
+        // The elements wrapped around the old end. At least doubling the
+        // capacity leaves room to unwrap them by moving either run.
+        size_t headRun = oldCapacity - header->head;
+        size_t wrappedRun = header->length - headRun;
+        if (wrappedRun <= headRun) {
+            memcpy(deque_slot(header, oldCapacity), deque_slot(header, 0), wrappedRun * header->elementSize);
+        } else {
+            size_t newHead = newCapacity - headRun;
+            memcpy(deque_slot(header, newHead), deque_slot(header, header->head), headRun * header->elementSize);
+            header->head = newHead;
+        }
+    }
+    *dq = (deque_t)header;
+}
+
+void deque_push_back(deque_t *dq, const void *elements, size_t count) {
+    if (count == 0) {
+        return;
+    }
+    deque_reserve(dq, count);
+    deque_header_t *header = deque_header(*dq);
+    deque_copy_in(header, deque_slot_index(header, header->length), elements, count);
+    header->length += count;
+}
+
+void deque_push_front(deque_t *dq, const void *elements, size_t count) {
+    if (count == 0) {
+        return;
+    }
+    deque_reserve(dq, count);
+    deque_header_t *header = deque_header(*dq);
+    header->head = (header->head - count) & (header->capacity - 1);
+    deque_copy_in(header, header->head, elements, count);
+    header->length += count;
+}
+
+void deque_pop_front(deque_t dq, void *elements, size_t count) {
+    deque_header_t *header = deque_header(dq);
+    if (count > header->length) {
+        abort();
+    }
+    if (count == 0) {
+        return;
+    }
+    if (elements != NULL) {
+        deque_copy_out(header, header->head, elements, count);
+    }
+    header->head = deque_slot_index(header, count);
+    header->length -= count;
+}
+
+void deque_pop_back(deque_t dq, void *elements, size_t count) {
+    deque_header_t *header = deque_header(dq);
+    if (count > header->length) {
+        abort();
+    }
+    if (count == 0) {
+        return;
+    }
+    header->length -= count;
+    if (elements != NULL) {
+        deque_copy_out(header, deque_slot_index(header, header->length), elements, count);
+    }
+}
+
+void deque_as_slices(deque_t dq, const void **first, size_t *firstLength, const void **second, size_t *secondLength) {
+    deque_header_t *header = deque_header(dq);
+    size_t headRun = header->capacity - header->head;
+    if (header->length <= headRun) {
+        *first = header->length > 0 ? deque_slot(header, header->head) : NULL;
+        *firstLength = header->length;
+        *second = NULL;
+        *secondLength = 0;
+    } else {
+        *first = deque_slot(header, header->head);
+        *firstLength = headRun;
+        *second = deque_slot(header, 0);
+        *secondLength = header->length - headRun;
+    }
+}
+
+void deque_clear(deque_t dq) {
+    deque_header_t *header = deque_header(dq);
+    header->head = 0;
+    header->length = 0;
+}
+
+void deque_delete(deque_t dq) {
+    free(deque_header(dq));
+}
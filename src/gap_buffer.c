@@ -0,0 +1,183 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <collectc.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * The allocation header for a gap buffer. The elements before the gap
+ * are at `[0, gapStart)`, and the elements after it are at
+ * `[gapEnd, capacity)`.
+ */
+typedef struct gap_buffer_header {
+    size_t capacity;
+    size_t gapStart;
+    size_t gapEnd;
+    size_t elementSize;
+} gap_buffer_header_t;
+
+static inline gap_buffer_header_t *gap_buffer_header(gap_buffer_t gb) {
+    return (gap_buffer_header_t *)gb;
+}
+
+/** Returns a pointer to a slot in the buffer, ignoring the gap. */
+static inline char *gap_buffer_slot(gap_buffer_header_t *header, size_t slot) {
+    return (char *)header + sizeof(*header) + (slot * header->elementSize);
+}
+
+/** Returns the slot that holds the element at an index. */
+static inline size_t gap_buffer_slot_index(const gap_buffer_header_t *header, size_t index) {
+    return index < header->gapStart ? index : index + (header->gapEnd - header->gapStart);
+}
+
+gap_buffer_t gap_buffer_new(size_t initialCapacity, size_t elementSize) {
+    gap_buffer_header_t *header = malloc(sizeof(gap_buffer_header_t) + (initialCapacity * elementSize));
+    if (header == NULL) {
+        abort();
+    }
+    header->capacity = initialCapacity;
+    header->gapStart = 0;
+    header->gapEnd = initialCapacity;
+    header->elementSize = elementSize;
+    return (gap_buffer_t)header;
+}
+
+size_t gap_buffer_len(gap_buffer_t gb) {
+    gap_buffer_header_t *header = gap_buffer_header(gb);
+    return header->capacity - (header->gapEnd - header->gapStart);
+}
+
+size_t gap_buffer_capacity(gap_buffer_t gb) {
+    return gap_buffer_header(gb)->capacity;
+}
+
+size_t gap_buffer_element_size(gap_buffer_t gb) {
+    return gap_buffer_header(gb)->elementSize;
+}
+
+bool gap_buffer_is_empty(gap_buffer_t gb) {
+    return gap_buffer_len(gb) == 0;
+}
+
+size_t gap_buffer_cursor(gap_buffer_t gb) {
+    return gap_buffer_header(gb)->gapStart;
+}
+
+void gap_buffer_move_cursor(gap_buffer_t gb, size_t index) {
+    gap_buffer_header_t *header = gap_buffer_header(gb);
+    if (index > gap_buffer_len(gb)) {
+        abort();
+    }
+    if (index < header->gapStart) {
+        // Move the elements between the index and the gap
+        // to the other side of the gap.
+        size_t count = header->gapStart - index;
+        memmove(
+            gap_buffer_slot(header, header->gapEnd - count),
+            gap_buffer_slot(header, index),
+            count * header->elementSize
+        );
+        header->gapStart -= count;
+        header->gapEnd -= count;
+    } else if (index > header->gapStart) {
+        size_t count = index - header->gapStart;
+        memmove(
+            gap_buffer_slot(header, header->gapStart),
+            gap_buffer_slot(header, header->gapEnd),
+            count * header->elementSize
+        );
+        header->gapStart += count;
+        header->gapEnd += count;
+    }
+}
+
+const void *gap_buffer_at(gap_buffer_t gb, size_t index) {
+    return gap_buffer_at_mut(gb, index);
+}
+
+void *gap_buffer_at_mut(gap_buffer_t gb, size_t index) {
+    gap_buffer_header_t *header = gap_buffer_header(gb);
+    if (index >= gap_buffer_len(gb)) {
+        return NULL;
+    }
+    return gap_buffer_slot(header, gap_buffer_slot_index(header, index));
+}
+
+/** Widens the gap to hold at least `extraCapacity` more elements. */
+static void gap_buffer_reserve(gap_buffer_t *gb, size_t extraCapacity) {
+    gap_buffer_header_t *header = gap_buffer_header(*gb);
+    size_t gapLength = header->gapEnd - header->gapStart;
+    if (extraCapacity <= gapLength) {
+        return;
+    }
+    size_t oldCapacity = header->capacity;
+    size_t newCapacity = oldCapacity + (oldCapacity / 2 * 3) + extraCapacity;
+    header = realloc(header, sizeof(gap_buffer_header_t) + (newCapacity * header->elementSize));
+    if (header == NULL) {
+        abort();
+    }
+    // Move the elements after the gap to the end of the
+    // new allocation, so that the new space joins the gap.
+    size_t afterGap = oldCapacity - header->gapEnd;
+    size_t newGapEnd = newCapacity - afterGap;
+    memmove(gap_buffer_slot(header, newGapEnd), gap_buffer_slot(header, header->gapEnd), afterGap * header->elementSize);
+    header->gapEnd = newGapEnd;
+    header->capacity = newCapacity;
+    *gb = (gap_buffer_t)header;
+}
+
+void gap_buffer_insert(gap_buffer_t *gb, size_t index, const void *elements, size_t count) {
+    gap_buffer_move_cursor(*gb, index);
+    if (count == 0) {
+        return;
+    }
+    gap_buffer_reserve(gb, count);
+    gap_buffer_header_t *header = gap_buffer_header(*gb);
+    memcpy(gap_buffer_slot(header, header->gapStart), elements, count * header->elementSize);
+    header->gapStart += count;
+}
+
+void gap_buffer_remove(gap_buffer_t gb, size_t index, size_t count) {
+    if (index + count > gap_buffer_len(gb)) {
+        abort();
+    }
+    gap_buffer_move_cursor(gb, index);
+    gap_buffer_header(gb)->gapEnd += count;
+}
+
+void gap_buffer_slice(gap_buffer_t gb, size_t index, void *slice, size_t count) {
+    gap_buffer_header_t *header = gap_buffer_header(gb);
+    if (index + count > gap_buffer_len(gb)) {
+        abort();
+    }
+    char *to = slice;
+    if (index < header->gapStart) {
+        size_t beforeGap = header->gapStart - index < count ? header->gapStart - index : count;
+        memcpy(to, gap_buffer_slot(header, index), beforeGap * header->elementSize);
+        to += beforeGap * header->elementSize;
+        index += beforeGap;
+        count -= beforeGap;
+    }
+    if (count > 0) {
+        memcpy(to, gap_buffer_slot(header, gap_buffer_slot_index(header, index)), count * header->elementSize);
+    }
+}
+
+const void *gap_buffer_as_contiguous(gap_buffer_t gb) {
+    size_t length = gap_buffer_len(gb);
+    gap_buffer_move_cursor(gb, length);
+    return length > 0 ? gap_buffer_slot(gap_buffer_header(gb), 0) : NULL;
+}
+
+void gap_buffer_clear(gap_buffer_t gb) {
+    gap_buffer_header_t *header = gap_buffer_header(gb);
+    header->gapStart = 0;
+    header->gapEnd = header->capacity;
+}
+
+void gap_buffer_delete(gap_buffer_t gb) {
+    free(gap_buffer_header(gb));
+}
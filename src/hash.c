@@ -0,0 +1,271 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <collectc.h>
+
+#include <stdatomic.h>
+#include <string.h>
+#include <time.h>
+
+// The AES and CRC32 paths are compiled with per-function target
+// attributes, so the library itself still runs on any x86-64 CPU, and
+// they're only called once the CPU is known to support them.
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define HASH_X86_DISPATCH 1
+#include <immintrin.h>
+#endif
+
+/** Inputs at least this long are hashed with AES rounds, where AES-NI is available. */
+#define AES_MIN_SIZE 64
+
+/** Set in `hashFeatures` once the CPU's features have been checked. */
+#define FEATURE_CHECKED 1u
+#define FEATURE_AES 2u
+#define FEATURE_CRC32 4u
+
+/** Random odd constants with balanced bits, from wyhash. */
+static const uint64_t SECRET[4] = {
+    0x2d358dccaa6c78a5,
+    0x8bb84b93962eacc9,
+    0x4b33a62ed433d4a3,
+    0x4d5a2da51de1aa47,
+};
+
+/** 2^64 divided by the golden ratio. */
+static const uint64_t GOLDEN_RATIO = 0x9e3779b97f4a7c15;
+
+/** The CRC-32C of each 4-bit value, for the reflected polynomial 0x82f63b78. */
+static const uint32_t CRC32C_NIBBLES[16] = {
+    0x00000000, 0x105ec76f, 0x20bd8ede, 0x30e349b1, 0x417b1dbc, 0x5125dad3, 0x61c69362, 0x7198540d,
+    0x82f63b78, 0x92a8fc17, 0xa24bb5a6, 0xb21572c9, 0xc38d26c4, 0xd3d3e1ab, 0xe330a81a, 0xf36e6f75,
+};
+
+/** The CPU features that the hashes can use, or 0 if they haven't been checked yet. */
+static atomic_uint hashFeatures;
+
+/** A counter that makes every random seed different. */
+static atomic_uint_least64_t seedCounter;
+
+/**
+ * Returns the CPU features that the hashes can use. Threads that race
+ * to check them for the first time all store the same value.
+ */
+static inline unsigned hash_features(void) {
+    unsigned features = atomic_load_explicit(&hashFeatures, memory_order_relaxed);
+    if (features == 0) {
+        features = FEATURE_CHECKED;
+#if defined(HASH_X86_DISPATCH)
+        __builtin_cpu_init();
+        features |= __builtin_cpu_supports("aes") ? FEATURE_AES : 0;
+        features |= __builtin_cpu_supports("sse4.2") ? FEATURE_CRC32 : 0;
+#endif
+        atomic_store_explicit(&hashFeatures, features, memory_order_relaxed);
+    }
+    return features;
+}
+
+static inline uint64_t hash_read64(const unsigned char *bytes) {
+    uint64_t word;
+    memcpy(&word, bytes, sizeof(word));
+    return word;
+}
+
+static inline uint64_t hash_read32(const unsigned char *bytes) {
+    uint32_t word;
+    memcpy(&word, bytes, sizeof(word));
+    return word;
+}
+
+/** Computes the full 128-bit product of two words, as its low and high halves. */
+static inline void hash_multiply(uint64_t *low, uint64_t *high) {
+#if defined(__SIZEOF_INT128__)
+    __extension__ typedef unsigned __int128 uint128_t;
+    uint128_t product = (uint128_t)*low * *high;
+    *low = (uint64_t)product;
+    *high = (uint64_t)(product >> 64);
+#else
+    uint64_t aLow = (uint32_t)*low, aHigh = *low >> 32;
+    uint64_t bLow = (uint32_t)*high, bHigh = *high >> 32;
+    uint64_t lowLow = aLow * bLow, lowHigh = aLow * bHigh;
+    uint64_t highLow = aHigh * bLow, highHigh = aHigh * bHigh;
+    uint64_t middle = (lowLow >> 32) + (uint32_t)lowHigh + (uint32_t)highLow;
+    *low = (middle << 32) | (uint32_t)lowLow;
+    *high = highHigh + (lowHigh >> 32) + (highLow >> 32) + (middle >> 32);
+#endif
+}
+
+/** Multiplies two words and folds the halves of the product together. */
+static inline uint64_t hash_mix(uint64_t a, uint64_t b) {
+    hash_multiply(&a, &b);
+    return a ^ b;
+}
+
+/**
+ * Hashes bytes a word pair at a time, after wyhash (final version 4).
+ * Inputs of up to 16 bytes are read as two possibly-overlapping words,
+ * with no loop; longer inputs are consumed 48 bytes at a time by three
+ * independent multiply chains, and then 16 bytes at a time.
+ */
+static uint64_t hash_bytes_portable(const unsigned char *bytes, size_t size, uint64_t seed) {
+    seed ^= hash_mix(seed ^ SECRET[0], SECRET[1]);
+    uint64_t a;
+    uint64_t b;
+    if (size <= 16) {
+        if (size >= 4) {
+            // Two overlapping reads from each end cover 4 to 16 bytes.
+            size_t middle = (size >> 3) << 2;
+            a = (hash_read32(bytes) << 32) | hash_read32(bytes + middle);
+            b = (hash_read32(bytes + size - 4) << 32) | hash_read32(bytes + size - 4 - middle);
+        } else if (size > 0) {
+            a = ((uint64_t)bytes[0] << 16) | ((uint64_t)bytes[size >> 1] << 8) | bytes[size - 1];
+            b = 0;
+        } else {
+            a = 0;
+            b = 0;
+        }
+    } else {
+        size_t left = size;
+        if (left > 48) {
+            uint64_t seed1 = seed;
+            uint64_t seed2 = seed;
+            do {
+                seed = hash_mix(hash_read64(bytes) ^ SECRET[1], hash_read64(bytes + 8) ^ seed);
+                seed1 = hash_mix(hash_read64(bytes + 16) ^ SECRET[2], hash_read64(bytes + 24) ^ seed1);
+                seed2 = hash_mix(hash_read64(bytes + 32) ^ SECRET[3], hash_read64(bytes + 40) ^ seed2);
+                bytes += 48;
+                left -= 48;
+            } while (left > 48);
+            seed ^= seed1 ^ seed2;
+        }
+        for (; left > 16; bytes += 16, left -= 16) {
+            seed = hash_mix(hash_read64(bytes) ^ SECRET[1], hash_read64(bytes + 8) ^ seed);
+        }
+        // The last 16 bytes, which may overlap bytes that were already mixed.
+        a = hash_read64(bytes + left - 16);
+        b = hash_read64(bytes + left - 8);
+    }
+    a ^= SECRET[1];
+    b ^= seed;
+    hash_multiply(&a, &b);
+    return hash_mix(a ^ SECRET[0] ^ size, b ^ SECRET[1]);
+}
+
+#if defined(HASH_X86_DISPATCH)
+/**
+ * Hashes at least 64 bytes with AES rounds. Four lanes each absorb 16
+ * bytes of every 64-byte block, with one round per block, so the rounds
+ * of different lanes overlap in the pipeline. One round only spreads a
+ * byte across its column of the state, so the lanes are combined and
+ * then put through three more rounds, after which every output bit
+ * depends on every input byte.
+ */
+__attribute__((target("aes"))) static uint64_t hash_bytes_aes(
+    const unsigned char *bytes, size_t size, uint64_t seed
+) {
+    __m128i key = _mm_set_epi64x((long long)SECRET[1], (long long)(seed ^ SECRET[0]));
+    __m128i lane0 = _mm_xor_si128(key, _mm_set_epi64x(0, (long long)size));
+    __m128i lane1 = _mm_aesenc_si128(lane0, key);
+    __m128i lane2 = _mm_aesenc_si128(lane1, key);
+    __m128i lane3 = _mm_aesenc_si128(lane2, key);
+    // The last block is read from the end, so it overlaps the block
+    // before it unless the size is a multiple of 64.
+    size_t lastOffset = size - 64;
+    for (size_t offset = 0;; offset += 64) {
+        if (offset > lastOffset) {
+            offset = lastOffset;
+        }
+        const __m128i *block = (const __m128i *)(bytes + offset);
+        lane0 = _mm_aesenc_si128(_mm_xor_si128(lane0, _mm_loadu_si128(block)), key);
+        lane1 = _mm_aesenc_si128(_mm_xor_si128(lane1, _mm_loadu_si128(block + 1)), key);
+        lane2 = _mm_aesenc_si128(_mm_xor_si128(lane2, _mm_loadu_si128(block + 2)), key);
+        lane3 = _mm_aesenc_si128(_mm_xor_si128(lane3, _mm_loadu_si128(block + 3)), key);
+        if (offset == lastOffset) {
+            break;
+        }
+    }
+    __m128i state = _mm_aesenc_si128(_mm_aesenc_si128(lane0, lane1), _mm_aesenc_si128(lane2, lane3));
+    state = _mm_aesenc_si128(state, key);
+    state = _mm_aesenc_si128(state, key);
+    state = _mm_aesenc_si128(state, key);
+    return (uint64_t)_mm_cvtsi128_si64(state) ^ (uint64_t)_mm_cvtsi128_si64(_mm_unpackhi_epi64(state, state));
+}
+
+/** Continues a CRC-32C with the CPU's CRC32 instruction, 8 bytes at a time. */
+__attribute__((target("sse4.2"))) static uint32_t hash_crc32c_sse42(
+    const unsigned char *bytes, size_t size, uint32_t crc
+) {
+    uint64_t wide = crc;
+    for (; size >= 8; bytes += 8, size -= 8) {
+        wide = _mm_crc32_u64(wide, hash_read64(bytes));
+    }
+    crc = (uint32_t)wide;
+    for (; size > 0; bytes++, size--) {
+        crc = _mm_crc32_u8(crc, *bytes);
+    }
+    return crc;
+}
+#endif
+
+/** Continues a CRC-32C a nibble at a time, with a 64-byte table. */
+static uint32_t hash_crc32c_portable(const unsigned char *bytes, size_t size, uint32_t crc) {
+    for (size_t i = 0; i < size; i++) {
+        crc ^= bytes[i];
+        crc = (crc >> 4) ^ CRC32C_NIBBLES[crc & 15];
+        crc = (crc >> 4) ^ CRC32C_NIBBLES[crc & 15];
+    }
+    return crc;
+}
+
+uint64_t hash_bytes(const void *data, size_t size, uint64_t seed) {
+#if defined(HASH_X86_DISPATCH)
+    if (size >= AES_MIN_SIZE && (hash_features() & FEATURE_AES) != 0) {
+        return hash_bytes_aes(data, size, seed);
+    }
+#endif
+    return hash_bytes_portable(data, size, seed);
+}
+
+uint64_t hash_u64(uint64_t value, uint64_t seed) {
+    // The finalizer of SplitMix64. Each step is invertible, so the
+    // whole function is a bijection for a given seed.
+    value ^= seed + GOLDEN_RATIO;
+    value ^= value >> 30;
+    value *= 0xbf58476d1ce4e5b9;
+    value ^= value >> 27;
+    value *= 0x94d049bb133111eb;
+    value ^= value >> 31;
+    return value;
+}
+
+uint64_t hash_u32(uint32_t value, uint64_t seed) {
+    return hash_u64(value, seed);
+}
+
+uint64_t hash_combine(uint64_t first, uint64_t second) {
+    // Multiplying the first hash by an odd constant before adding the
+    // second makes the order matter, and keeps pairs of small integers
+    // from colliding.
+    return hash_u64((first * GOLDEN_RATIO) + second, 0);
+}
+
+uint32_t hash_crc32c(const void *data, size_t size, uint32_t crc) {
+    crc = ~crc;
+#if defined(HASH_X86_DISPATCH)
+    if ((hash_features() & FEATURE_CRC32) != 0) {
+        return ~hash_crc32c_sse42(data, size, crc);
+    }
+#endif
+    return ~hash_crc32c_portable(data, size, crc);
+}
+
+uint64_t hash_random_seed(void) {
+    struct timespec now = {0};
+    timespec_get(&now, TIME_UTC);
+    uint64_t seed = hash_combine((uint64_t)now.tv_sec, (uint64_t)now.tv_nsec);
+    // A stack address and a static address, which differ between runs
+    // when the stack and the executable are placed randomly.
+    seed = hash_combine(seed, (uint64_t)(uintptr_t)&now);
+    seed = hash_combine(seed, (uint64_t)(uintptr_t)&seedCounter);
+    return hash_combine(seed, atomic_fetch_add_explicit(&seedCounter, 1, memory_order_relaxed));
+}
@@ -0,0 +1,567 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#if defined(__linux__)
+#define _GNU_SOURCE
+#endif
+
+#include <collectc.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HASHMAP_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#include "bits.h"
+
+/** The number of control bytes that are compared at once. */
+#define GROUP_WIDTH 16
+
+/**
+ * Control bytes for slots that aren't full. Both have their high bit
+ * clear; a full slot's control byte holds the top 7 bits of its key's
+ * hash under a set high bit. Empty is 0, so a zeroed control array is
+ * all empty, and a new table can come from calloc() without a pass
+ * over its control bytes.
+ */
+#define CONTROL_EMPTY ((uint8_t)0x00)
+#define CONTROL_DELETED ((uint8_t)0x7f)
+#define CONTROL_FULL ((uint8_t)0x80)
+
+/**
+ * The control bytes of a group, loaded at once. Each match returns a
+ * bitmask with bit `i` set for each matching byte `i` in the group.
+ */
+#if defined(HASHMAP_SSE2)
+
+typedef __m128i hashmap_group_t;
+
+static inline hashmap_group_t hashmap_group_load(const uint8_t *control) {
+    return _mm_loadu_si128((const __m128i *)control);
+}
+
+static inline unsigned hashmap_group_match(hashmap_group_t group, uint8_t byte) {
+    return (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8((char)byte)));
+}
+
+static inline unsigned hashmap_group_match_empty(hashmap_group_t group) {
+    return hashmap_group_match(group, CONTROL_EMPTY);
+}
+
+static inline unsigned hashmap_group_match_empty_or_deleted(hashmap_group_t group) {
+    return (unsigned)_mm_movemask_epi8(group) ^ 0xffff;
+}
+
+#else
+
+/** Without SSE2, a group is two 64-bit words, compared a byte at a time in each word. */
+typedef struct hashmap_group {
+    uint64_t words[2];
+} hashmap_group_t;
+
+static const uint64_t LOW_BITS = 0x0101010101010101;
+static const uint64_t HIGH_BITS = 0x8080808080808080;
+
+static inline uint64_t hashmap_load_le64(const uint8_t *bytes) {
+    uint64_t word;
+    memcpy(&word, bytes, sizeof(word));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    word = __builtin_bswap64(word);
+#endif
+    return word;
+}
+
+static inline hashmap_group_t hashmap_group_load(const uint8_t *control) {
+    return (hashmap_group_t){{hashmap_load_le64(control), hashmap_load_le64(control + 8)}};
+}
+
+/** Gathers the high bit of each byte of both words into a bitmask. */
+static inline unsigned hashmap_group_bitmask(uint64_t low, uint64_t high) {
+    unsigned lowMask = (unsigned)((((low & HIGH_BITS) >> 7) * 0x0102040810204080) >> 56);
+    unsigned highMask = (unsigned)((((high & HIGH_BITS) >> 7) * 0x0102040810204080) >> 56);
+    return lowMask | (highMask << 8);
+}
+
+/**
+ * Finds the bytes that equal `byte`. This can report a false match
+ * just above a real one, when a borrow carries into it, but matches
+ * are only hints: every matching slot's key is compared anyway.
+ */
+static inline unsigned hashmap_group_match(hashmap_group_t group, uint8_t byte) {
+    uint64_t low = group.words[0] ^ (LOW_BITS * byte);
+    uint64_t high = group.words[1] ^ (LOW_BITS * byte);
+    return hashmap_group_bitmask((low - LOW_BITS) & ~low, (high - LOW_BITS) & ~high);
+}
+
+static inline unsigned hashmap_group_match_empty(hashmap_group_t group) {
+    // Empty bytes have their high bit clear, and bit 0 clear.
+    return hashmap_group_bitmask(~(group.words[0] | (group.words[0] << 7)), ~(group.words[1] | (group.words[1] << 7)));
+}
+
+static inline unsigned hashmap_group_match_empty_or_deleted(hashmap_group_t group) {
+    return hashmap_group_bitmask(~group.words[0], ~group.words[1]);
+}
+
+#endif
+
+/** Returns the control byte for a full slot with a hash. */
+static inline uint8_t hashmap_h2(uint64_t hash) {
+    return (uint8_t)(hash >> 57) | CONTROL_FULL;
+}
+
+/** Returns the number of entries a table can hold before it grows. */
+static inline size_t hashmap_full_capacity(size_t capacity) {
+    return capacity - (capacity / 8);
+}
+
+/** Returns the smallest table capacity that can hold `count` entries. */
+static size_t hashmap_capacity_for(size_t count) {
+    if (count == 0) {
+        return 0;
+    }
+    size_t capacity = GROUP_WIDTH;
+    while (hashmap_full_capacity(capacity) < count) {
+        capacity *= 2;
+    }
+    return capacity;
+}
+
+/** Returns the largest alignment that an element of a size can need. */
+static inline size_t hashmap_alignment(size_t size) {
+    size_t alignment = size & (~size + 1);
+    if (alignment == 0) {
+        return 1;
+    }
+    return alignment > 16 ? 16 : alignment;
+}
+
+static inline uint64_t hashmap_hash_key(const hashmap_t *map, const void *key) {
+    return map->hash == NULL ? hash_bytes(key, map->keySize, 0) : map->hash(key);
+}
+
+static inline bool hashmap_keys_equal(const hashmap_t *map, const void *a, const void *b) {
+    return map->equal == NULL ? memcmp(a, b, map->keySize) == 0 : map->equal(a, b);
+}
+
+static inline char *hashmap_slot(const hashmap_t *map, const hashmap_table_t *table, size_t index) {
+    return table->slots + (index * map->slotSize);
+}
+
+/**
+ * Sets a slot's control byte. The first group's bytes are also copied
+ * after the last slot, for loads that wrap around the end of the table;
+ * for every other slot, this writes the same byte twice.
+ */
+static inline void hashmap_set_control(hashmap_table_t *table, size_t index, uint8_t control) {
+    table->control[index] = control;
+    table->control[((index - GROUP_WIDTH) & (table->capacity - 1)) + GROUP_WIDTH] = control;
+}
+
+/**
+ * Allocates a table with all its slots empty. The control bytes start
+ * zeroed, which is empty, so growing a large table takes fresh zero
+ * pages from the system rather than writing every control byte up front.
+ */
+static hashmap_table_t hashmap_table_new(const hashmap_t *map, size_t capacity) {
+    hashmap_table_t table = {
+        .control = NULL,
+        .slots = NULL,
+        .capacity = capacity,
+        .length = 0,
+        .growthLeft = hashmap_full_capacity(capacity),
+    };
+    if (capacity == 0) {
+        return table;
+    }
+    size_t controlSize = (capacity + GROUP_WIDTH + 15) & ~(size_t)15;
+    table.control = calloc(1, controlSize + (capacity * map->slotSize));
+    if (table.control == NULL) {
+        abort();
+    }
+    table.slots = (char *)table.control + controlSize;
+    return table;
+}
+
+/**
+ * Finds the slot that holds a key, by probing groups in a triangular
+ * sequence: the first group starts at the hash's slot, and each next
+ * group starts one more group further on than the last. With a power
+ * of 2 number of groups, the sequence visits every group.
+ *
+ * Returns `SIZE_MAX` if the key isn't in the table.
+ */
+static size_t hashmap_table_find(const hashmap_t *map, const hashmap_table_t *table, const void *key, uint64_t hash) {
+    if (table->length == 0) {
+        return SIZE_MAX;
+    }
+    size_t mask = table->capacity - 1;
+    size_t position = hash & mask;
+    uint8_t h2 = hashmap_h2(hash);
+    for (size_t stride = GROUP_WIDTH;; stride += GROUP_WIDTH) {
+        hashmap_group_t group = hashmap_group_load(&table->control[position]);
+        for (unsigned matches = hashmap_group_match(group, h2); matches != 0; matches &= matches - 1) {
+            size_t index = (position + bits_ctz64(matches)) & mask;
+            if (hashmap_keys_equal(map, key, hashmap_slot(map, table, index))) {
+                return index;
+            }
+        }
+        // A key is never stored past an empty slot in its probe sequence.
+        if (hashmap_group_match_empty(group) != 0) {
+            return SIZE_MAX;
+        }
+        position = (position + stride) & mask;
+    }
+}
+
+/** Finds the first empty or deleted slot in a hash's probe sequence. */
+static size_t hashmap_table_find_insert_slot(const hashmap_table_t *table, uint64_t hash) {
+    size_t mask = table->capacity - 1;
+    size_t position = hash & mask;
+    for (size_t stride = GROUP_WIDTH;; stride += GROUP_WIDTH) {
+        unsigned matches = hashmap_group_match_empty_or_deleted(hashmap_group_load(&table->control[position]));
+        if (matches != 0) {
+            return (position + bits_ctz64(matches)) & mask;
+        }
+        position = (position + stride) & mask;
+    }
+}
+
+#if defined(__linux__)
+/** The size of the blocks in which a migrating table's slots go back to the system. */
+#define RELEASE_BYTES ((uintptr_t)256 * 1024)
+
+/**
+ * Gives the old table's slot memory between two migration positions back
+ * to the system, in whole aligned blocks. Nothing reads a slot below the
+ * migration position again, since it's empty or its entry has moved.
+ * Without this, the free() of a large old table unmaps all of its pages
+ * in the one insert that finishes the migration.
+ */
+static void hashmap_release_migrated(const hashmap_t *map, size_t from, size_t to) {
+    uintptr_t slots = (uintptr_t)map->old.slots;
+    uintptr_t base = (slots + RELEASE_BYTES - 1) & ~(RELEASE_BYTES - 1);
+    uintptr_t start = (slots + (from * map->slotSize)) & ~(RELEASE_BYTES - 1);
+    uintptr_t end = (slots + (to * map->slotSize)) & ~(RELEASE_BYTES - 1);
+    if (start < base) {
+        start = base;
+    }
+    if (start < end) {
+        madvise((void *)start, end - start, MADV_DONTNEED);
+    }
+}
+#endif
+
+/**
+ * Moves the entries in the next `count` slots of the old table into the
+ * new one, and frees the old table once it's empty. Each moved slot is
+ * left as a tombstone, so lookups in the old table still probe past it.
+ */
+static void hashmap_migrate(hashmap_t *map, size_t count) {
+    hashmap_table_t *old = &map->old;
+    hashmap_table_t *table = &map->table;
+#if defined(__linux__)
+    size_t from = map->migrated;
+#endif
+    size_t end = old->capacity - map->migrated > count ? map->migrated + count : old->capacity;
+    for (; map->migrated < end && old->length > 0; map->migrated++) {
+        if ((old->control[map->migrated] & CONTROL_FULL) == 0) {
+            continue;
+        }
+        const char *slot = hashmap_slot(map, old, map->migrated);
+        uint64_t hash = hashmap_hash_key(map, slot);
+        size_t index = hashmap_table_find_insert_slot(table, hash);
+        table->growthLeft -= table->control[index] == CONTROL_EMPTY;
+        hashmap_set_control(table, index, hashmap_h2(hash));
+        memcpy(hashmap_slot(map, table, index), slot, map->slotSize);
+        table->length++;
+        hashmap_set_control(old, map->migrated, CONTROL_DELETED);
+        old->length--;
+    }
+    if (old->length == 0 && old->capacity > 0) {
+        free(old->control);
+        *old = hashmap_table_new(map, 0);
+        map->migrated = 0;
+        return;
+    }
+#if defined(__linux__)
+    if (old->capacity > 0) {
+        hashmap_release_migrated(map, from, map->migrated);
+    }
+#endif
+}
+
+/**
+ * Moves every entry into a new table with a capacity, which drops all
+ * tombstones. An incremental map keeps the old table, to move its entries
+ * a group at a time, unless it's still moving them out of an older one.
+ */
+static void hashmap_resize(hashmap_t *map, size_t capacity) {
+    hashmap_migrate(map, SIZE_MAX);
+    hashmap_table_t old = map->table;
+    map->table = hashmap_table_new(map, capacity);
+    if (map->incremental && old.length > 0) {
+        map->old = old;
+        map->migrated = 0;
+        return;
+    }
+    for (size_t i = 0; i < old.capacity; i++) {
+        if ((old.control[i] & CONTROL_FULL) == 0) {
+            continue;
+        }
+        const char *slot = hashmap_slot(map, &old, i);
+        uint64_t hash = hashmap_hash_key(map, slot);
+        size_t index = hashmap_table_find_insert_slot(&map->table, hash);
+        hashmap_set_control(&map->table, index, hashmap_h2(hash));
+        memcpy(hashmap_slot(map, &map->table, index), slot, map->slotSize);
+    }
+    map->table.length = old.length;
+    map->table.growthLeft -= old.length;
+    free(old.control);
+}
+
+/**
+ * Makes room for one more entry. If tombstones fill at least half the
+ * table, rehashing at the same capacity clears them; otherwise the table
+ * doubles, so that the cost is amortized over many inserts.
+ */
+static void hashmap_grow(hashmap_t *map) {
+    size_t fullCapacity = hashmap_full_capacity(map->table.capacity);
+    size_t needed = map->table.length + map->old.length + 1;
+    if (needed <= fullCapacity / 2) {
+        hashmap_resize(map, map->table.capacity);
+    } else {
+        hashmap_resize(map, hashmap_capacity_for(needed > fullCapacity + 1 ? needed : fullCapacity + 1));
+    }
+}
+
+/**
+ * Returns the slot for a key, inserting the key into a new slot first
+ * if it isn't in the map. A new slot's value is left uninitialized.
+ */
+static char *hashmap_claim(hashmap_t *map, const void *key, bool *inserted) {
+    if (map->old.capacity > 0) {
+        hashmap_migrate(map, GROUP_WIDTH);
+    }
+    uint64_t hash = hashmap_hash_key(map, key);
+    size_t index = hashmap_table_find(map, &map->table, key, hash);
+    if (index != SIZE_MAX) {
+        *inserted = false;
+        return hashmap_slot(map, &map->table, index);
+    }
+    index = hashmap_table_find(map, &map->old, key, hash);
+    if (index != SIZE_MAX) {
+        *inserted = false;
+        return hashmap_slot(map, &map->old, index);
+    }
+    hashmap_table_t *table = &map->table;
+    if (table->capacity == 0) {
+        hashmap_grow(map);
+    }
+    index = hashmap_table_find_insert_slot(table, hash);
+    // Filling a tombstone doesn't use up any growth. The entries that are
+    // still in the old table have growth set aside for them.
+    if (table->growthLeft <= map->old.length && table->control[index] == CONTROL_EMPTY) {
+        hashmap_grow(map);
+        index = hashmap_table_find_insert_slot(table, hash);
+    }
+    table->growthLeft -= table->control[index] == CONTROL_EMPTY;
+    hashmap_set_control(table, index, hashmap_h2(hash));
+    table->length++;
+    char *slot = hashmap_slot(map, table, index);
+    memcpy(slot, key, map->keySize);
+    *inserted = true;
+    return slot;
+}
+
+hashmap_t hashmap_new(size_t keySize, size_t valueSize, hashmap_hash_t hash, hashmap_equal_t equal) {
+    size_t keyAlignment = hashmap_alignment(keySize);
+    size_t valueAlignment = hashmap_alignment(valueSize);
+    size_t slotAlignment = keyAlignment > valueAlignment ? keyAlignment : valueAlignment;
+    size_t valueOffset = (keySize + valueAlignment - 1) & ~(valueAlignment - 1);
+    size_t slotSize = (valueOffset + valueSize + slotAlignment - 1) & ~(slotAlignment - 1);
+    hashmap_t map = {
+        .migrated = 0,
+        .incremental = false,
+        .hash = hash,
+        .equal = equal,
+        .keySize = keySize,
+        .valueSize = valueSize,
+        .valueOffset = valueOffset,
+        .slotSize = slotSize,
+    };
+    map.table = hashmap_table_new(&map, 0);
+    map.old = hashmap_table_new(&map, 0);
+    return map;
+}
+
+hashmap_t hashmap_new_incremental(size_t keySize, size_t valueSize, hashmap_hash_t hash, hashmap_equal_t equal) {
+    hashmap_t map = hashmap_new(keySize, valueSize, hash, equal);
+    map.incremental = true;
+    return map;
+}
+
+size_t hashmap_len(const hashmap_t *map) {
+    return map->table.length + map->old.length;
+}
+
+bool hashmap_is_empty(const hashmap_t *map) {
+    return hashmap_len(map) == 0;
+}
+
+size_t hashmap_capacity(const hashmap_t *map) {
+    return map->table.length + map->table.growthLeft;
+}
+
+size_t hashmap_key_size(const hashmap_t *map) {
+    return map->keySize;
+}
+
+size_t hashmap_value_size(const hashmap_t *map) {
+    return map->valueSize;
+}
+
+const void *hashmap_get(const hashmap_t *map, const void *key) {
+    return hashmap_get_mut((hashmap_t *)map, key);
+}
+
+void *hashmap_get_mut(hashmap_t *map, const void *key) {
+    uint64_t hash = hashmap_hash_key(map, key);
+    size_t index = hashmap_table_find(map, &map->table, key, hash);
+    if (index != SIZE_MAX) {
+        return hashmap_slot(map, &map->table, index) + map->valueOffset;
+    }
+    index = hashmap_table_find(map, &map->old, key, hash);
+    return index == SIZE_MAX ? NULL : hashmap_slot(map, &map->old, index) + map->valueOffset;
+}
+
+bool hashmap_contains(const hashmap_t *map, const void *key) {
+    return hashmap_get(map, key) != NULL;
+}
+
+bool hashmap_insert(hashmap_t *map, const void *key, const void *value) {
+    bool inserted;
+    char *slot = hashmap_claim(map, key, &inserted);
+    if (map->valueSize > 0) {
+        memcpy(slot + map->valueOffset, value, map->valueSize);
+    }
+    return inserted;
+}
+
+void *hashmap_get_or_insert(hashmap_t *map, const void *key, bool *inserted) {
+    bool isNew;
+    char *slot = hashmap_claim(map, key, &isNew);
+    if (isNew) {
+        memset(slot + map->valueOffset, 0, map->valueSize);
+    }
+    if (inserted != NULL) {
+        *inserted = isNew;
+    }
+    return slot + map->valueOffset;
+}
+
+bool hashmap_remove(hashmap_t *map, const void *key, void *value) {
+    if (map->old.capacity > 0) {
+        hashmap_migrate(map, GROUP_WIDTH);
+    }
+    uint64_t hash = hashmap_hash_key(map, key);
+    hashmap_table_t *table = &map->table;
+    size_t index = hashmap_table_find(map, table, key, hash);
+    if (index == SIZE_MAX) {
+        table = &map->old;
+        index = hashmap_table_find(map, table, key, hash);
+    }
+    if (index == SIZE_MAX) {
+        return false;
+    }
+    if (value != NULL && map->valueSize > 0) {
+        memcpy(value, hashmap_slot(map, table, index) + map->valueOffset, map->valueSize);
+    }
+    // A lookup stops at the first group with an empty slot, so the slot
+    // can only be emptied if every group-wide window around it already
+    // has one. Otherwise, a lookup might have probed past it, and it
+    // needs a tombstone to keep that lookup going.
+    size_t mask = table->capacity - 1;
+    unsigned emptyBefore = hashmap_group_match_empty(hashmap_group_load(&table->control[(index - GROUP_WIDTH) & mask]));
+    unsigned emptyAfter = hashmap_group_match_empty(hashmap_group_load(&table->control[index]));
+    size_t fullBefore = emptyBefore == 0 ? GROUP_WIDTH : bits_clz64(emptyBefore) - (64 - GROUP_WIDTH);
+    size_t fullAfter = emptyAfter == 0 ? GROUP_WIDTH : bits_ctz64(emptyAfter);
+    if (fullBefore + fullAfter >= GROUP_WIDTH) {
+        hashmap_set_control(table, index, CONTROL_DELETED);
+    } else {
+        hashmap_set_control(table, index, CONTROL_EMPTY);
+        table->growthLeft++;
+    }
+    table->length--;
+    return true;
+}
+
+void hashmap_reserve(hashmap_t *map, size_t extraCapacity) {
+    if (extraCapacity > map->table.growthLeft - map->old.length) {
+        hashmap_resize(map, hashmap_capacity_for(hashmap_len(map) + extraCapacity));
+    }
+}
+
+void hashmap_shrink(hashmap_t *map) {
+    hashmap_migrate(map, SIZE_MAX);
+    size_t capacity = hashmap_capacity_for(map->table.length);
+    bool hasTombstones = map->table.length + map->table.growthLeft < hashmap_full_capacity(map->table.capacity);
+    if (capacity < map->table.capacity || hasTombstones) {
+        hashmap_resize(map, capacity);
+    }
+}
+
+void hashmap_clear(hashmap_t *map) {
+    free(map->old.control);
+    map->old = hashmap_table_new(map, 0);
+    map->migrated = 0;
+    hashmap_table_t *table = &map->table;
+    if (table->capacity > 0) {
+        memset(table->control, CONTROL_EMPTY, table->capacity + GROUP_WIDTH);
+    }
+    table->length = 0;
+    table->growthLeft = hashmap_full_capacity(table->capacity);
+}
+
+void hashmap_delete(hashmap_t *map) {
+    free(map->old.control);
+    free(map->table.control);
+}
+
+hashmap_iter_t hashmap_iter_new(const hashmap_t *map) {
+    return (hashmap_iter_t){
+        .map = map,
+        .index = 0,
+    };
+}
+
+/** Visits the entries still in the old table, then those in the new one. */
+bool hashmap_iter_next(hashmap_iter_t *iter, const void **key, void **value) {
+    const hashmap_table_t *old = &iter->map->old;
+    const hashmap_table_t *table = &iter->map->table;
+    while (iter->index < old->capacity + table->capacity) {
+        size_t index = iter->index++;
+        if (index < old->capacity) {
+            table = old;
+        } else {
+            table = &iter->map->table;
+            index -= old->capacity;
+        }
+        if (table->control[index] & CONTROL_FULL) {
+            char *slot = hashmap_slot(iter->map, table, index);
+            *key = slot;
+            if (value != NULL) {
+                *value = slot + iter->map->valueOffset;
+            }
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,133 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <collectc.h>
+
+#include <stdlib.h>
+
+static void hashset_check_sizes(const hashset_t *set, const hashset_t *other) {
+    if (hashmap_key_size(&set->map) != hashmap_key_size(&other->map)) {
+        abort();
+    }
+}
+
+/**
+ * Removes every element of a set whose membership in another set
+ * matches `keep`. Removing only rewrites the control byte of the
+ * iterator's current slot, so the scan can continue past it.
+ */
+static void hashset_retain(hashset_t *set, const hashset_t *other, bool keep) {
+    hashset_check_sizes(set, other);
+    hashmap_iter_t iter = hashmap_iter_new(&set->map);
+    const void *element;
+    while (hashmap_iter_next(&iter, &element, NULL)) {
+        if (hashmap_contains(&other->map, element) != keep) {
+            hashmap_remove(&set->map, element, NULL);
+        }
+    }
+}
+
+hashset_t hashset_new(size_t elementSize, hashmap_hash_t hash, hashmap_equal_t equal) {
+    return (hashset_t){
+        .map = hashmap_new(elementSize, 0, hash, equal),
+    };
+}
+
+hashset_t hashset_from_vector(const vector_t vec, hashmap_hash_t hash, hashmap_equal_t equal) {
+    size_t length = vector_len(vec);
+    hashset_t set = hashset_new(vector_element_size(vec), hash, equal);
+    hashmap_reserve(&set.map, length);
+    for (size_t i = 0; i < length; i++) {
+        hashmap_insert(&set.map, vector_at(vec, i), NULL);
+    }
+    return set;
+}
+
+vector_t hashset_to_vector(const hashset_t *set) {
+    vector_t vec = vector_new(hashmap_len(&set->map), hashmap_key_size(&set->map));
+    hashmap_iter_t iter = hashmap_iter_new(&set->map);
+    const void *element;
+    while (hashmap_iter_next(&iter, &element, NULL)) {
+        vector_push(&vec, element, 1);
+    }
+    return vec;
+}
+
+size_t hashset_len(const hashset_t *set) {
+    return hashmap_len(&set->map);
+}
+
+bool hashset_is_empty(const hashset_t *set) {
+    return hashmap_is_empty(&set->map);
+}
+
+size_t hashset_capacity(const hashset_t *set) {
+    return hashmap_capacity(&set->map);
+}
+
+size_t hashset_element_size(const hashset_t *set) {
+    return hashmap_key_size(&set->map);
+}
+
+bool hashset_insert(hashset_t *set, const void *element) {
+    return hashmap_insert(&set->map, element, NULL);
+}
+
+bool hashset_contains(const hashset_t *set, const void *element) {
+    return hashmap_contains(&set->map, element);
+}
+
+bool hashset_remove(hashset_t *set, const void *element) {
+    return hashmap_remove(&set->map, element, NULL);
+}
+
+void hashset_union(hashset_t *set, const hashset_t *other) {
+    hashset_check_sizes(set, other);
+    if (set == other) {
+        return;
+    }
+    // If this set already has elements, some of the other set's are
+    // probably duplicates, so only reserve for half of them.
+    size_t otherLength = hashmap_len(&other->map);
+    hashmap_reserve(&set->map, hashmap_is_empty(&set->map) ? otherLength : (otherLength + 1) / 2);
+    hashmap_iter_t iter = hashmap_iter_new(&other->map);
+    const void *element;
+    while (hashmap_iter_next(&iter, &element, NULL)) {
+        hashmap_insert(&set->map, element, NULL);
+    }
+}
+
+void hashset_intersection(hashset_t *set, const hashset_t *other) {
+    hashset_retain(set, other, true);
+}
+
+void hashset_difference(hashset_t *set, const hashset_t *other) {
+    hashset_retain(set, other, false);
+}
+
+void hashset_reserve(hashset_t *set, size_t extraCapacity) {
+    hashmap_reserve(&set->map, extraCapacity);
+}
+
+void hashset_shrink(hashset_t *set) {
+    hashmap_shrink(&set->map);
+}
+
+void hashset_clear(hashset_t *set) {
+    hashmap_clear(&set->map);
+}
+
+void hashset_delete(hashset_t *set) {
+    hashmap_delete(&set->map);
+}
+
+hashset_iter_t hashset_iter_new(const hashset_t *set) {
+    return (hashset_iter_t){
+        .inner = hashmap_iter_new(&set->map),
+    };
+}
+
+bool hashset_iter_next(hashset_iter_t *iter, const void **element) {
+    return hashmap_iter_next(&iter->inner, element, NULL);
+}
@@ -0,0 +1,145 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <collectc.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+static inline char *heap_slot(char *base, size_t elementSize, size_t index) {
+    return base + (index * elementSize);
+}
+
+/**
+ * Moves the element in the scratch space up from the hole at `index`,
+ * past every parent that it compares before, and stores it there.
+ */
+static void heap_sift_up(heap_t *heap, char *base, size_t index) {
+    size_t elementSize = vector_element_size(heap->elements);
+    while (index > 0) {
+        size_t parent = (index - 1) / heap->arity;
+        char *parentSlot = heap_slot(base, elementSize, parent);
+        if (heap->compare(heap->scratch, parentSlot) >= 0) {
+            break;
+        }
+        memcpy(heap_slot(base, elementSize, index), parentSlot, elementSize);
+        index = parent;
+    }
+    memcpy(heap_slot(base, elementSize, index), heap->scratch, elementSize);
+}
+
+/**
+ * Moves the element in the scratch space down from the hole at `index`,
+ * pulling up the first of its children until none of them compare before
+ * it, and stores it there.
+ */
+static void heap_sift_down(heap_t *heap, char *base, size_t length, size_t index) {
+    size_t elementSize = vector_element_size(heap->elements);
+    for (;;) {
+        size_t firstChild = (index * heap->arity) + 1;
+        if (firstChild >= length) {
+            break;
+        }
+        size_t lastChild = firstChild + heap->arity < length ? firstChild + heap->arity : length;
+        size_t best = firstChild;
+        for (size_t child = firstChild + 1; child < lastChild; child++) {
+            if (heap->compare(heap_slot(base, elementSize, child), heap_slot(base, elementSize, best)) < 0) {
+                best = child;
+            }
+        }
+        char *bestSlot = heap_slot(base, elementSize, best);
+        if (heap->compare(bestSlot, heap->scratch) >= 0) {
+            break;
+        }
+        memcpy(heap_slot(base, elementSize, index), bestSlot, elementSize);
+        index = best;
+    }
+    memcpy(heap_slot(base, elementSize, index), heap->scratch, elementSize);
+}
+
+heap_t heap_new(size_t elementSize, size_t arity, heap_compare_t compare) {
+    return heap_from_vector(vector_new(0, elementSize), arity, compare);
+}
+
+heap_t heap_from_vector(vector_t vec, size_t arity, heap_compare_t compare) {
+    if (arity != 2 && arity != 4) {
+        abort();
+    }
+    size_t elementSize = vector_element_size(vec);
+    heap_t heap = {
+        .elements = vec,
+        .compare = compare,
+        .arity = arity,
+        .scratch = malloc(elementSize > 0 ? elementSize : 1),
+    };
+    if (heap.scratch == NULL) {
+        abort();
+    }
+    // Sifting reaches elements through a pointer to the first one.
+    vector_make_contiguous(vec);
+    // Sift down every element that has children, from the last one up,
+    // so each one joins two heaps that are already in order.
+    size_t length = vector_len(vec);
+    if (length > 1) {
+        char *base = vector_at_mut(vec, 0);
+        for (size_t index = (length - 2) / arity + 1; index-- > 0;) {
+            memcpy(heap.scratch, heap_slot(base, elementSize, index), elementSize);
+            heap_sift_down(&heap, base, length, index);
+        }
+    }
+    return heap;
+}
+
+size_t heap_len(const heap_t *heap) {
+    return vector_len(heap->elements);
+}
+
+bool heap_is_empty(const heap_t *heap) {
+    return heap_len(heap) == 0;
+}
+
+size_t heap_element_size(const heap_t *heap) {
+    return vector_element_size(heap->elements);
+}
+
+const void *heap_peek(const heap_t *heap) {
+    return vector_first(heap->elements);
+}
+
+void heap_push(heap_t *heap, const void *element) {
+    size_t length = vector_len(heap->elements);
+    vector_push(&heap->elements, element, 1);
+    vector_make_contiguous(heap->elements);
+    memcpy(heap->scratch, element, vector_element_size(heap->elements));
+    heap_sift_up(heap, vector_at_mut(heap->elements, 0), length);
+}
+
+bool heap_pop(heap_t *heap, void *element) {
+    size_t length = vector_len(heap->elements);
+    if (length == 0) {
+        return false;
+    }
+    size_t elementSize = vector_element_size(heap->elements);
+    char *base = vector_at_mut(heap->elements, 0);
+    if (element != NULL) {
+        memcpy(element, base, elementSize);
+    }
+    // Move the last element into the hole at the top.
+    length--;
+    memcpy(heap->scratch, heap_slot(base, elementSize, length), elementSize);
+    vector_remove(heap->elements, length, 1);
+    if (length > 0) {
+        heap_sift_down(heap, base, length, 0);
+    }
+    return true;
+}
+
+void heap_clear(heap_t *heap) {
+    vector_clear(heap->elements);
+}
+
+void heap_delete(heap_t *heap) {
+    vector_delete(heap->elements);
+    free(heap->scratch);
+}
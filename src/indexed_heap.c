@@ -0,0 +1,254 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <collectc.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+/** The position of an id that isn't in the heap. */
+static const size_t NOT_QUEUED = SIZE_MAX;
+
+/** Pointers to the heap's vectors, taken once per operation. */
+typedef struct indexed_heap_view {
+    char *keys;
+    size_t *ids;
+    size_t *positions;
+    size_t keySize;
+} indexed_heap_view_t;
+
+static indexed_heap_view_t indexed_heap_view(indexed_heap_t *heap) {
+    return (indexed_heap_view_t){
+        .keys = vector_at_mut(heap->keys, 0),
+        .ids = vector_at_mut(heap->ids, 0),
+        .positions = vector_at_mut(heap->positions, 0),
+        .keySize = vector_element_size(heap->keys),
+    };
+}
+
+static inline char *indexed_heap_slot(const indexed_heap_view_t *view, size_t slot) {
+    return view->keys + (slot * view->keySize);
+}
+
+/** Moves the item in `from` to the slot `to`, and updates its position. */
+static inline void indexed_heap_move(const indexed_heap_view_t *view, size_t from, size_t to) {
+    memcpy(indexed_heap_slot(view, to), indexed_heap_slot(view, from), view->keySize);
+    view->ids[to] = view->ids[from];
+    view->positions[view->ids[to]] = to;
+}
+
+/** Stores the key in the scratch space and an id in a slot. */
+static inline void indexed_heap_place(indexed_heap_t *heap, const indexed_heap_view_t *view, size_t slot, size_t id) {
+    memcpy(indexed_heap_slot(view, slot), heap->scratch, view->keySize);
+    view->ids[slot] = id;
+    view->positions[id] = slot;
+}
+
+/**
+ * Moves the item with the id and the key in the scratch space up from the
+ * hole at `slot`, past every parent whose key it compares before.
+ */
+static void indexed_heap_sift_up(indexed_heap_t *heap, const indexed_heap_view_t *view, size_t slot, size_t id) {
+    while (slot > 0) {
+        size_t parent = (slot - 1) / heap->arity;
+        if (heap->compare(heap->scratch, indexed_heap_slot(view, parent)) >= 0) {
+            break;
+        }
+        indexed_heap_move(view, parent, slot);
+        slot = parent;
+    }
+    indexed_heap_place(heap, view, slot, id);
+}
+
+/**
+ * Moves the item with the id and the key in the scratch space down from
+ * the hole at `slot`, pulling up the first of its children until none of
+ * them compare before it.
+ */
+static void indexed_heap_sift_down(
+    indexed_heap_t *heap, const indexed_heap_view_t *view, size_t length, size_t slot, size_t id
+) {
+    for (;;) {
+        size_t firstChild = (slot * heap->arity) + 1;
+        if (firstChild >= length) {
+            break;
+        }
+        size_t lastChild = firstChild + heap->arity < length ? firstChild + heap->arity : length;
+        size_t best = firstChild;
+        for (size_t child = firstChild + 1; child < lastChild; child++) {
+            if (heap->compare(indexed_heap_slot(view, child), indexed_heap_slot(view, best)) < 0) {
+                best = child;
+            }
+        }
+        if (heap->compare(indexed_heap_slot(view, best), heap->scratch) >= 0) {
+            break;
+        }
+        indexed_heap_move(view, best, slot);
+        slot = best;
+    }
+    indexed_heap_place(heap, view, slot, id);
+}
+
+/**
+ * Fills the hole at `slot` with the last item, and shrinks the heap by
+ * one. The caller must have copied out the hole's key and id.
+ */
+static void indexed_heap_fill_hole(indexed_heap_t *heap, size_t slot) {
+    indexed_heap_view_t view = indexed_heap_view(heap);
+    size_t last = vector_len(heap->ids) - 1;
+    size_t lastId = view.ids[last];
+    memcpy(heap->scratch, indexed_heap_slot(&view, last), view.keySize);
+    vector_remove(heap->keys, last, 1);
+    vector_remove(heap->ids, last, 1);
+    if (slot == last) {
+        return;
+    }
+    // The last item can belong above or below the hole.
+    if (slot > 0 && heap->compare(heap->scratch, indexed_heap_slot(&view, (slot - 1) / heap->arity)) < 0) {
+        indexed_heap_sift_up(heap, &view, slot, lastId);
+    } else {
+        indexed_heap_sift_down(heap, &view, last, slot, lastId);
+    }
+}
+
+/** Returns the slot of a queued item, or aborts if it's not queued. */
+static size_t indexed_heap_position(const indexed_heap_t *heap, size_t id) {
+    const size_t *position = vector_at(heap->positions, id);
+    if (position == NULL || *position == NOT_QUEUED) {
+        abort();
+    }
+    return *position;
+}
+
+indexed_heap_t indexed_heap_new(size_t keySize, size_t arity, heap_compare_t compare) {
+    if (arity != 2 && arity != 4) {
+        abort();
+    }
+    indexed_heap_t heap = {
+        .keys = vector_new(0, keySize),
+        .ids = vector_new(0, sizeof(size_t)),
+        .positions = vector_new(0, sizeof(size_t)),
+        .compare = compare,
+        .arity = arity,
+        .scratch = malloc(keySize > 0 ? keySize : 1),
+    };
+    if (heap.scratch == NULL) {
+        abort();
+    }
+    return heap;
+}
+
+size_t indexed_heap_len(const indexed_heap_t *heap) {
+    return vector_len(heap->ids);
+}
+
+bool indexed_heap_is_empty(const indexed_heap_t *heap) {
+    return indexed_heap_len(heap) == 0;
+}
+
+bool indexed_heap_contains(const indexed_heap_t *heap, size_t id) {
+    const size_t *position = vector_at(heap->positions, id);
+    return position != NULL && *position != NOT_QUEUED;
+}
+
+const void *indexed_heap_key(const indexed_heap_t *heap, size_t id) {
+    if (!indexed_heap_contains(heap, id)) {
+        return NULL;
+    }
+    return vector_at(heap->keys, *(const size_t *)vector_at(heap->positions, id));
+}
+
+const void *indexed_heap_peek(const indexed_heap_t *heap, size_t *id) {
+    if (indexed_heap_is_empty(heap)) {
+        return NULL;
+    }
+    *id = *(const size_t *)vector_first(heap->ids);
+    return vector_first(heap->keys);
+}
+
+void indexed_heap_push(indexed_heap_t *heap, size_t id, const void *key) {
+    if (id == NOT_QUEUED || indexed_heap_contains(heap, id)) {
+        abort();
+    }
+    if (id >= vector_len(heap->positions)) {
+        size_t extra = id + 1 - vector_len(heap->positions);
+        vector_reserve(&heap->positions, extra);
+        for (size_t i = 0; i < extra; i++) {
+            vector_push(&heap->positions, &NOT_QUEUED, 1);
+        }
+    }
+    size_t length = vector_len(heap->ids);
+    vector_push(&heap->keys, key, 1);
+    vector_push(&heap->ids, &id, 1);
+    memcpy(heap->scratch, key, vector_element_size(heap->keys));
+    indexed_heap_view_t view = indexed_heap_view(heap);
+    indexed_heap_sift_up(heap, &view, length, id);
+}
+
+bool indexed_heap_pop(indexed_heap_t *heap, size_t *id, void *key) {
+    if (indexed_heap_is_empty(heap)) {
+        return false;
+    }
+    size_t topId = *(const size_t *)vector_first(heap->ids);
+    if (id != NULL) {
+        *id = topId;
+    }
+    if (key != NULL) {
+        memcpy(key, vector_first(heap->keys), vector_element_size(heap->keys));
+    }
+    *(size_t *)vector_at_mut(heap->positions, topId) = NOT_QUEUED;
+    indexed_heap_fill_hole(heap, 0);
+    return true;
+}
+
+void indexed_heap_decrease_key(indexed_heap_t *heap, size_t id, const void *key) {
+    size_t slot = indexed_heap_position(heap, id);
+    indexed_heap_view_t view = indexed_heap_view(heap);
+    if (heap->compare(key, indexed_heap_slot(&view, slot)) > 0) {
+        abort();
+    }
+    memcpy(heap->scratch, key, view.keySize);
+    indexed_heap_sift_up(heap, &view, slot, id);
+}
+
+void indexed_heap_increase_key(indexed_heap_t *heap, size_t id, const void *key) {
+    size_t slot = indexed_heap_position(heap, id);
+    indexed_heap_view_t view = indexed_heap_view(heap);
+    if (heap->compare(key, indexed_heap_slot(&view, slot)) < 0) {
+        abort();
+    }
+    memcpy(heap->scratch, key, view.keySize);
+    indexed_heap_sift_down(heap, &view, vector_len(heap->ids), slot, id);
+}
+
+bool indexed_heap_remove(indexed_heap_t *heap, size_t id, void *key) {
+    if (!indexed_heap_contains(heap, id)) {
+        return false;
+    }
+    size_t slot = indexed_heap_position(heap, id);
+    if (key != NULL) {
+        memcpy(key, vector_at(heap->keys, slot), vector_element_size(heap->keys));
+    }
+    *(size_t *)vector_at_mut(heap->positions, id) = NOT_QUEUED;
+    indexed_heap_fill_hole(heap, slot);
+    return true;
+}
+
+void indexed_heap_clear(indexed_heap_t *heap) {
+    size_t length = vector_len(heap->ids);
+    const size_t *ids = vector_first(heap->ids);
+    size_t *positions = vector_at_mut(heap->positions, 0);
+    for (size_t i = 0; i < length; i++) {
+        positions[ids[i]] = NOT_QUEUED;
+    }
+    vector_clear(heap->keys);
+    vector_clear(heap->ids);
+}
+
+void indexed_heap_delete(indexed_heap_t *heap) {
+    vector_delete(heap->keys);
+    vector_delete(heap->ids);
+    vector_delete(heap->positions);
+    free(heap->scratch);
+}
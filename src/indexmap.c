@@ -0,0 +1,419 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <collectc.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define INDEXMAP_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#include "bits.h"
+
+/** The smallest table that the map allocates. */
+#define MIN_CAPACITY 8
+
+/**
+ * The number of slots that probing compares at once. The first
+ * `BLOCK_LENGTH - 1` slots are copied after the last slot, so that a
+ * block can start at any slot without wrapping around.
+ */
+#define BLOCK_LENGTH 4
+
+/** The largest table, whose slots have no bits left over for the hash. */
+#define MAX_CAPACITY ((uint64_t)1 << 32)
+
+/** Returns the number of entries a table can hold before it grows: 3/4 of its slots. */
+static inline size_t indexmap_max_length(size_t capacity) {
+    return capacity - (capacity / 4);
+}
+
+/**
+ * Returns the largest power of 2 that divides a size, up to 8, which
+ * aligns a key or value of that size. Vectors only align their elements to 8.
+ */
+static inline size_t indexmap_alignment(size_t size) {
+    size_t alignment = size & (~size + 1);
+    if (alignment == 0) {
+        return 1;
+    }
+    return alignment > 8 ? 8 : alignment;
+}
+
+/** Returns the bits of a slot that hold an entry's position plus 1. The rest hold hash bits. */
+static inline uint32_t indexmap_mask(const indexmap_t *map) {
+    return (uint32_t)(map->capacity - 1);
+}
+
+static inline uint64_t indexmap_hash_key(const indexmap_t *map, const void *key) {
+    return map->hash == NULL ? hash_bytes(key, map->keySize, 0) : map->hash(key);
+}
+
+static inline bool indexmap_keys_equal(const indexmap_t *map, const void *a, const void *b) {
+    return map->equal == NULL ? memcmp(a, b, map->keySize) == 0 : map->equal(a, b);
+}
+
+/** Returns the entry at a position, which must be in bounds. Each entry is its key, then its value. */
+static inline char *indexmap_entry(const indexmap_t *map, size_t index) {
+    return (char *)vector_first(map->entries) + (index * map->entrySize);
+}
+
+/** Returns the bits of a hash that a slot keeps. Probing compares them before reading entries. */
+static inline uint32_t indexmap_tag(const indexmap_t *map, uint64_t hash) {
+    return (uint32_t)(hash >> 32) & ~indexmap_mask(map);
+}
+
+/** Sets a slot, and its copy after the last slot. */
+static inline void indexmap_set_slot(indexmap_t *map, size_t index, uint32_t slot) {
+    map->slots[index] = slot;
+    if (index < BLOCK_LENGTH - 1) {
+        map->slots[map->capacity + index] = slot;
+    }
+}
+
+/**
+ * Returns a bitmask of the empty slots in the block at `slots`, and sets
+ * `tagged` to a bitmask of the full slots whose hash bits are `tag`.
+ * The comparisons don't branch, so a probe that ends anywhere in the
+ * block costs one branch, which is usually predicted correctly.
+ */
+static inline unsigned indexmap_block_match(const uint32_t *slots, uint32_t tagMask, uint32_t tag, unsigned *tagged) {
+#if defined(INDEXMAP_SSE2)
+    __m128i block = _mm_loadu_si128((const __m128i *)slots);
+    __m128i tags = _mm_and_si128(block, _mm_set1_epi32((int)tagMask));
+    unsigned empty = (unsigned)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(block, _mm_setzero_si128())));
+    *tagged = (unsigned)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(tags, _mm_set1_epi32((int)tag)))) & ~empty;
+    return empty;
+#else
+    unsigned empty = 0;
+    *tagged = 0;
+    for (unsigned i = 0; i < BLOCK_LENGTH; i++) {
+        empty |= (unsigned)(slots[i] == 0) << i;
+        *tagged |= (unsigned)(slots[i] != 0 && (slots[i] & tagMask) == tag) << i;
+    }
+    return empty;
+#endif
+}
+
+/**
+ * Finds a key's entry, and sets `slot` to the index of the slot that
+ * points to it. Returns `null` if the key isn't in the map.
+ */
+static char *indexmap_find(const indexmap_t *map, const void *key, uint64_t hash, size_t *slot) {
+    if (map->capacity == 0) {
+        return NULL;
+    }
+    uint32_t mask = indexmap_mask(map);
+    uint32_t tag = indexmap_tag(map, hash);
+    char *entries = (char *)vector_first(map->entries);
+    for (size_t i = hash & mask;; i = (i + BLOCK_LENGTH) & mask) {
+        unsigned tagged;
+        unsigned empty = indexmap_block_match(&map->slots[i], ~mask, tag, &tagged);
+        // Slots after the first empty one aren't in the key's run.
+        tagged &= (empty & (~empty + 1)) - 1;
+        for (; tagged != 0; tagged &= tagged - 1) {
+            *slot = (i + bits_ctz64(tagged)) & mask;
+            char *entry = entries + (((map->slots[*slot] & mask) - 1) * map->entrySize);
+            if (indexmap_keys_equal(map, entry, key)) {
+                return entry;
+            }
+        }
+        if (empty != 0) {
+            return NULL;
+        }
+    }
+}
+
+/** Finds the slot that points to the entry at a position, which must be in the map. */
+static size_t indexmap_find_index(const indexmap_t *map, uint64_t hash, size_t index) {
+    uint32_t mask = indexmap_mask(map);
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        if ((map->slots[i] & mask) == index + 1) {
+            return i;
+        }
+    }
+}
+
+/** Puts a slot for the entry at a position in the first empty slot of its probe sequence. */
+static void indexmap_place(indexmap_t *map, uint64_t hash, size_t index) {
+    uint32_t mask = indexmap_mask(map);
+    size_t i = hash & mask;
+    while (map->slots[i] != 0) {
+        i = (i + 1) & mask;
+    }
+    indexmap_set_slot(map, i, indexmap_tag(map, hash) | (uint32_t)(index + 1));
+}
+
+/**
+ * Empties a slot. Every following slot in the run that can't be found
+ * from its home slot once the hole is there, that is, every slot whose
+ * home isn't cyclically in `(hole, i]`, is shifted back into the hole.
+ */
+static void indexmap_remove_slot(indexmap_t *map, size_t hole) {
+    uint32_t mask = indexmap_mask(map);
+    for (size_t i = (hole + 1) & mask; map->slots[i] != 0; i = (i + 1) & mask) {
+        size_t home = indexmap_hash_key(map, indexmap_entry(map, (map->slots[i] & mask) - 1)) & mask;
+        bool reachable = hole <= i ? (hole < home && home <= i) : (hole < home || home <= i);
+        if (!reachable) {
+            indexmap_set_slot(map, hole, map->slots[i]);
+            hole = i;
+        }
+    }
+    indexmap_set_slot(map, hole, 0);
+}
+
+/**
+ * Rebuilds the table with a capacity, rehashing every key, and grows the
+ * entries to the number that the table can hold, so that the entries
+ * never grow on their own, by more than the table does.
+ */
+static void indexmap_resize(indexmap_t *map, size_t capacity) {
+    if ((uint64_t)capacity > MAX_CAPACITY) {
+        abort();
+    }
+    free(map->slots);
+    map->slots = calloc(capacity + BLOCK_LENGTH - 1, sizeof(uint32_t));
+    if (map->slots == NULL) {
+        abort();
+    }
+    map->capacity = capacity;
+    size_t length = vector_len(map->entries);
+    vector_reserve_exact(&map->entries, indexmap_max_length(capacity) - length);
+    for (size_t i = 0; i < length; i++) {
+        char *entry = indexmap_entry(map, i);
+        indexmap_place(map, indexmap_hash_key(map, entry), i);
+    }
+}
+
+/**
+ * Returns the value of a key's entry, appending an entry for the key
+ * first if it isn't in the map. A new entry's value is left uninitialized.
+ */
+static char *indexmap_claim(indexmap_t *map, const void *key, bool *inserted) {
+    uint64_t hash = indexmap_hash_key(map, key);
+    size_t slot;
+    char *entry = indexmap_find(map, key, hash, &slot);
+    if (entry != NULL) {
+        *inserted = false;
+        return entry + map->valueOffset;
+    }
+    size_t length = vector_len(map->entries);
+    if (map->capacity == 0) {
+        indexmap_resize(map, MIN_CAPACITY);
+    } else if (length + 1 > indexmap_max_length(map->capacity)) {
+        indexmap_resize(map, map->capacity * 2);
+    }
+    memcpy(map->scratch, key, map->keySize);
+    vector_push(&map->entries, map->scratch, 1);
+    indexmap_place(map, hash, length);
+    *inserted = true;
+    return indexmap_entry(map, length) + map->valueOffset;
+}
+
+/**
+ * Finds a key's entry and removes its slot from the table, copying out
+ * its value. Returns the entry's position, or `SIZE_MAX` if the key
+ * isn't in the map.
+ */
+static size_t indexmap_take(indexmap_t *map, const void *key, void *value) {
+    size_t slot;
+    char *entry = indexmap_find(map, key, indexmap_hash_key(map, key), &slot);
+    if (entry == NULL) {
+        return SIZE_MAX;
+    }
+    if (value != NULL && map->valueSize > 0) {
+        memcpy(value, entry + map->valueOffset, map->valueSize);
+    }
+    size_t index = (map->slots[slot] & indexmap_mask(map)) - 1;
+    indexmap_remove_slot(map, slot);
+    return index;
+}
+
+indexmap_t indexmap_new(size_t keySize, size_t valueSize, hashmap_hash_t hash, hashmap_equal_t equal) {
+    size_t keyAlignment = indexmap_alignment(keySize);
+    size_t valueAlignment = indexmap_alignment(valueSize);
+    size_t entryAlignment = keyAlignment > valueAlignment ? keyAlignment : valueAlignment;
+    size_t valueOffset = (keySize + valueAlignment - 1) & ~(valueAlignment - 1);
+    size_t entrySize = (valueOffset + valueSize + entryAlignment - 1) & ~(entryAlignment - 1);
+    indexmap_t map = {
+        .entries = vector_new(0, entrySize),
+        .slots = NULL,
+        .capacity = 0,
+        .hash = hash,
+        .equal = equal,
+        .keySize = keySize,
+        .valueSize = valueSize,
+        .valueOffset = valueOffset,
+        .entrySize = entrySize,
+        .scratch = calloc(1, entrySize),
+    };
+    if (map.scratch == NULL) {
+        abort();
+    }
+    return map;
+}
+
+size_t indexmap_len(const indexmap_t *map) {
+    return vector_len(map->entries);
+}
+
+bool indexmap_is_empty(const indexmap_t *map) {
+    return vector_is_empty(map->entries);
+}
+
+size_t indexmap_capacity(const indexmap_t *map) {
+    return indexmap_max_length(map->capacity);
+}
+
+size_t indexmap_key_size(const indexmap_t *map) {
+    return map->keySize;
+}
+
+size_t indexmap_value_size(const indexmap_t *map) {
+    return map->valueSize;
+}
+
+const void *indexmap_get(const indexmap_t *map, const void *key) {
+    return indexmap_get_mut((indexmap_t *)map, key);
+}
+
+void *indexmap_get_mut(indexmap_t *map, const void *key) {
+    size_t slot;
+    char *entry = indexmap_find(map, key, indexmap_hash_key(map, key), &slot);
+    return entry == NULL ? NULL : entry + map->valueOffset;
+}
+
+bool indexmap_contains(const indexmap_t *map, const void *key) {
+    return indexmap_get(map, key) != NULL;
+}
+
+size_t indexmap_index_of(const indexmap_t *map, const void *key) {
+    size_t slot;
+    if (indexmap_find(map, key, indexmap_hash_key(map, key), &slot) == NULL) {
+        return SIZE_MAX;
+    }
+    return (map->slots[slot] & indexmap_mask(map)) - 1;
+}
+
+const void *indexmap_key_at(const indexmap_t *map, size_t index) {
+    return index < vector_len(map->entries) ? indexmap_entry(map, index) : NULL;
+}
+
+const void *indexmap_value_at(const indexmap_t *map, size_t index) {
+    return indexmap_value_at_mut((indexmap_t *)map, index);
+}
+
+void *indexmap_value_at_mut(indexmap_t *map, size_t index) {
+    return index < vector_len(map->entries) ? indexmap_entry(map, index) + map->valueOffset : NULL;
+}
+
+bool indexmap_insert(indexmap_t *map, const void *key, const void *value) {
+    bool inserted;
+    char *slot = indexmap_claim(map, key, &inserted);
+    if (map->valueSize > 0) {
+        memcpy(slot, value, map->valueSize);
+    }
+    return inserted;
+}
+
+void *indexmap_get_or_insert(indexmap_t *map, const void *key, bool *inserted) {
+    bool isNew;
+    char *slot = indexmap_claim(map, key, &isNew);
+    if (isNew) {
+        memset(slot, 0, map->valueSize);
+    }
+    if (inserted != NULL) {
+        *inserted = isNew;
+    }
+    return slot;
+}
+
+bool indexmap_swap_remove(indexmap_t *map, const void *key, void *value) {
+    size_t index = indexmap_take(map, key, value);
+    if (index == SIZE_MAX) {
+        return false;
+    }
+    size_t last = vector_len(map->entries) - 1;
+    if (index != last) {
+        // Point the last entry's slot at the hole, then move it there.
+        const char *lastEntry = indexmap_entry(map, last);
+        size_t slot = indexmap_find_index(map, indexmap_hash_key(map, lastEntry), last);
+        indexmap_set_slot(map, slot, (map->slots[slot] & ~indexmap_mask(map)) | (uint32_t)(index + 1));
+        memcpy(indexmap_entry(map, index), lastEntry, map->entrySize);
+    }
+    vector_remove(map->entries, last, 1);
+    return true;
+}
+
+bool indexmap_remove(indexmap_t *map, const void *key, void *value) {
+    size_t index = indexmap_take(map, key, value);
+    if (index == SIZE_MAX) {
+        return false;
+    }
+    // Every later entry moves down one position. If there are only a few,
+    // find each one's slot; otherwise, renumbering every slot in one pass
+    // is cheaper. Either way, the positions only ever go down by 1, so
+    // they never borrow from the hash bits.
+    size_t length = vector_len(map->entries);
+    uint32_t mask = indexmap_mask(map);
+    if (length - index - 1 < map->capacity / 16) {
+        for (size_t i = index + 1; i < length; i++) {
+            size_t slot = indexmap_find_index(map, indexmap_hash_key(map, indexmap_entry(map, i)), i);
+            indexmap_set_slot(map, slot, map->slots[slot] - 1);
+        }
+    } else {
+        for (size_t i = 0; i < map->capacity; i++) {
+            map->slots[i] -= (map->slots[i] & mask) > index + 1;
+        }
+        memcpy(&map->slots[map->capacity], map->slots, (BLOCK_LENGTH - 1) * sizeof(uint32_t));
+    }
+    vector_remove(map->entries, index, 1);
+    return true;
+}
+
+void indexmap_reserve(indexmap_t *map, size_t extraCapacity) {
+    size_t needed = vector_len(map->entries) + extraCapacity;
+    size_t capacity = map->capacity == 0 ? MIN_CAPACITY : map->capacity;
+    while (indexmap_max_length(capacity) < needed) {
+        capacity *= 2;
+    }
+    if (capacity != map->capacity) {
+        indexmap_resize(map, capacity);
+    }
+}
+
+void indexmap_clear(indexmap_t *map) {
+    vector_clear(map->entries);
+    if (map->capacity > 0) {
+        memset(map->slots, 0, (map->capacity + BLOCK_LENGTH - 1) * sizeof(uint32_t));
+    }
+}
+
+void indexmap_delete(indexmap_t *map) {
+    vector_delete(map->entries);
+    free(map->slots);
+    free(map->scratch);
+}
+
+indexmap_iter_t indexmap_iter_new(const indexmap_t *map) {
+    return (indexmap_iter_t){
+        .map = map,
+        .index = 0,
+    };
+}
+
+bool indexmap_iter_next(indexmap_iter_t *iter, const void **key, void **value) {
+    if (iter->index >= vector_len(iter->map->entries)) {
+        return false;
+    }
+    char *entry = indexmap_entry(iter->map, iter->index++);
+    *key = entry;
+    if (value != NULL) {
+        *value = entry + iter->map->valueOffset;
+    }
+    return true;
+}
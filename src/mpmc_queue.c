@@ -0,0 +1,261 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#if defined(__linux__)
+#define _GNU_SOURCE
+#else
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <collectc.h>
+
+#include <limits.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <sched.h>
+#endif
+
+/** The assumed size of a cache line, for keeping indices apart. */
+#define CACHE_LINE_SIZE 64
+
+/**
+ * A futex word that blocked threads wait on, and a flag that says whether
+ * any threads might be waiting. Threads that make progress clear the flag,
+ * bump the epoch, and wake the waiters, but only if the flag was set, so
+ * the uncontended path never makes a system call, and a burst of progress
+ * only makes one.
+ */
+typedef struct mpmc_queue_waiters {
+    _Alignas(CACHE_LINE_SIZE) atomic_uint epoch;
+    atomic_uint sleeping;
+} mpmc_queue_waiters_t;
+
+/**
+ * Each slot starts with a sequence number, followed by the element. For
+ * the slot at position `pos`, a sequence number of `pos` means that the
+ * slot is free for the producer of `pos`, and `pos + 1` means that it
+ * holds an element for the consumer of `pos`. Consumers release a slot
+ * by setting it to `pos + capacity`, the producer's position on the next
+ * lap around the ring.
+ */
+struct mpmc_queue {
+    _Alignas(CACHE_LINE_SIZE) atomic_size_t tail;
+    _Alignas(CACHE_LINE_SIZE) atomic_size_t head;
+    /** Wakes blocked producers when consumers free slots. */
+    mpmc_queue_waiters_t notFull;
+    /** Wakes blocked consumers when producers fill slots. */
+    mpmc_queue_waiters_t notEmpty;
+
+    _Alignas(CACHE_LINE_SIZE) size_t mask;
+    size_t elementSize;
+    /** The distance between slots, in bytes. */
+    size_t stride;
+    char *slots;
+};
+
+static inline atomic_size_t *mpmc_queue_sequence(const mpmc_queue_t *queue, size_t pos) {
+    return (atomic_size_t *)(queue->slots + ((pos & queue->mask) * queue->stride));
+}
+
+static inline char *mpmc_queue_element(const mpmc_queue_t *queue, size_t pos) {
+    return queue->slots + ((pos & queue->mask) * queue->stride) + sizeof(atomic_size_t);
+}
+
+/** Sleeps until the epoch changes from `epoch`, or spuriously. */
+static void mpmc_queue_wait(mpmc_queue_waiters_t *waiters, unsigned epoch) {
+#if defined(__linux__)
+    syscall(SYS_futex, (unsigned *)&waiters->epoch, FUTEX_WAIT_PRIVATE, epoch, NULL, NULL, 0);
+#else
+    (void)waiters;
+    (void)epoch;
+    sched_yield();
+#endif
+}
+
+/** Wakes any threads that are waiting, after making progress. */
+static void mpmc_queue_wake(mpmc_queue_waiters_t *waiters) {
+    // Pairs with the fence in `mpmc_queue_prepare_wait`: either the waiter
+    // sees our progress when it retries, or we see that it's sleeping.
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&waiters->sleeping, memory_order_relaxed) == 0
+        || atomic_exchange_explicit(&waiters->sleeping, 0, memory_order_acq_rel) == 0) {
+        return;
+    }
+    atomic_fetch_add_explicit(&waiters->epoch, 1, memory_order_release);
+#if defined(__linux__)
+    syscall(SYS_futex, (unsigned *)&waiters->epoch, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+#endif
+}
+
+/**
+ * Marks a thread as sleeping, and returns the epoch to wait on. The thread
+ * must retry its operation before calling `mpmc_queue_wait`. Reading the
+ * epoch before setting the flag means that any thread that clears the flag
+ * afterward also changes the epoch, so the wait can't miss its wakeup.
+ */
+static unsigned mpmc_queue_prepare_wait(mpmc_queue_waiters_t *waiters) {
+    unsigned epoch = atomic_load_explicit(&waiters->epoch, memory_order_acquire);
+    atomic_store_explicit(&waiters->sleeping, 1, memory_order_seq_cst);
+    atomic_thread_fence(memory_order_seq_cst);
+    return epoch;
+}
+
+mpmc_queue_t *mpmc_queue_new(size_t capacity, size_t elementSize) {
+    size_t rounded = 2;
+    while (rounded < capacity) {
+        rounded <<= 1;
+    }
+    size_t stride = (sizeof(atomic_size_t) + elementSize + _Alignof(atomic_size_t) - 1)
+                    & ~(_Alignof(atomic_size_t) - 1);
+    size_t slotsSize = ((rounded * stride) + CACHE_LINE_SIZE - 1) & ~(size_t)(CACHE_LINE_SIZE - 1);
+    mpmc_queue_t *queue = aligned_alloc(CACHE_LINE_SIZE, sizeof(mpmc_queue_t));
+    char *slots = aligned_alloc(CACHE_LINE_SIZE, slotsSize);
+    if (queue == NULL || slots == NULL) {
+        abort();
+    }
+    atomic_init(&queue->tail, 0);
+    atomic_init(&queue->head, 0);
+    atomic_init(&queue->notFull.epoch, 0);
+    atomic_init(&queue->notFull.sleeping, 0);
+    atomic_init(&queue->notEmpty.epoch, 0);
+    atomic_init(&queue->notEmpty.sleeping, 0);
+    queue->mask = rounded - 1;
+    queue->elementSize = elementSize;
+    queue->stride = stride;
+    queue->slots = slots;
+    for (size_t pos = 0; pos < rounded; pos++) {
+        atomic_init(mpmc_queue_sequence(queue, pos), pos);
+    }
+    return queue;
+}
+
+size_t mpmc_queue_capacity(const mpmc_queue_t *queue) {
+    return queue->mask + 1;
+}
+
+size_t mpmc_queue_element_size(const mpmc_queue_t *queue) {
+    return queue->elementSize;
+}
+
+size_t mpmc_queue_len(const mpmc_queue_t *queue) {
+    size_t head = atomic_load_explicit(&((mpmc_queue_t *)queue)->head, memory_order_acquire);
+    size_t tail = atomic_load_explicit(&((mpmc_queue_t *)queue)->tail, memory_order_acquire);
+    // The indices are read separately, so the head can pass the tail.
+    return tail - head > queue->mask + 1 ? 0 : tail - head;
+}
+
+/**
+ * Claims up to `count` consecutive slots from one of the queue's indices,
+ * and returns the position of the first one through `pos`. A slot at
+ * position `p` can be claimed if its sequence number is `p + ready`.
+ * Returns the number of slots claimed, or zero if the first slot isn't
+ * ready, which means the queue is full or empty.
+ */
+static size_t mpmc_queue_claim(mpmc_queue_t *queue, atomic_size_t *index, size_t ready, size_t count, size_t *pos) {
+    if (count == 0) {
+        return 0;
+    }
+    if (count > queue->mask + 1) {
+        count = queue->mask + 1;
+    }
+    size_t start = atomic_load_explicit(index, memory_order_relaxed);
+    for (;;) {
+        // Only this thread can change the sequence numbers of the slots it
+        // checks here, once it claims them, so the check stays valid if
+        // the compare-and-swap succeeds.
+        size_t claimed = 0;
+        intptr_t difference = 0;
+        while (claimed < count) {
+            size_t sequence = atomic_load_explicit(mpmc_queue_sequence(queue, start + claimed), memory_order_acquire);
+            difference = (intptr_t)(sequence - (start + claimed + ready));
+            if (difference != 0) {
+                break;
+            }
+            claimed++;
+        }
+        if (claimed == 0) {
+            if (difference < 0) {
+                return 0;
+            }
+            // Another thread claimed the first slot first.
+            start = atomic_load_explicit(index, memory_order_relaxed);
+            continue;
+        }
+        size_t end = start + claimed;
+        if (atomic_compare_exchange_weak_explicit(index, &start, end, memory_order_relaxed, memory_order_relaxed)) {
+            *pos = start;
+            return claimed;
+        }
+    }
+}
+
+size_t mpmc_queue_try_push(mpmc_queue_t *queue, const void *elements, size_t count) {
+    size_t pos;
+    size_t claimed = mpmc_queue_claim(queue, &queue->tail, 0, count, &pos);
+    const char *from = elements;
+    for (size_t i = 0; i < claimed; i++, from += queue->elementSize) {
+        memcpy(mpmc_queue_element(queue, pos + i), from, queue->elementSize);
+        atomic_store_explicit(mpmc_queue_sequence(queue, pos + i), pos + i + 1, memory_order_release);
+    }
+    if (claimed > 0) {
+        mpmc_queue_wake(&queue->notEmpty);
+    }
+    return claimed;
+}
+
+void mpmc_queue_push(mpmc_queue_t *queue, const void *elements, size_t count) {
+    const char *from = elements;
+    size_t pushed = mpmc_queue_try_push(queue, from, count);
+    while (pushed < count) {
+        unsigned epoch = mpmc_queue_prepare_wait(&queue->notFull);
+        size_t n = mpmc_queue_try_push(queue, from + (pushed * queue->elementSize), count - pushed);
+        if (n == 0) {
+            mpmc_queue_wait(&queue->notFull, epoch);
+        }
+        pushed += n;
+    }
+}
+
+size_t mpmc_queue_try_pop(mpmc_queue_t *queue, void *elements, size_t count) {
+    size_t pos;
+    size_t claimed = mpmc_queue_claim(queue, &queue->head, 1, count, &pos);
+    char *to = elements;
+    for (size_t i = 0; i < claimed; i++, to += queue->elementSize) {
+        memcpy(to, mpmc_queue_element(queue, pos + i), queue->elementSize);
+        atomic_store_explicit(mpmc_queue_sequence(queue, pos + i), pos + i + queue->mask + 1, memory_order_release);
+    }
+    if (claimed > 0) {
+        mpmc_queue_wake(&queue->notFull);
+    }
+    return claimed;
+}
+
+size_t mpmc_queue_pop(mpmc_queue_t *queue, void *elements, size_t count) {
+    if (count == 0) {
+        abort();
+    }
+    size_t popped = mpmc_queue_try_pop(queue, elements, count);
+    while (popped == 0) {
+        unsigned epoch = mpmc_queue_prepare_wait(&queue->notEmpty);
+        popped = mpmc_queue_try_pop(queue, elements, count);
+        if (popped == 0) {
+            mpmc_queue_wait(&queue->notEmpty, epoch);
+        }
+    }
+    return popped;
+}
+
+void mpmc_queue_delete(mpmc_queue_t *queue) {
+    if (queue != NULL) {
+        free(queue->slots);
+        free(queue);
+    }
+}
@@ -0,0 +1,137 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <collectc.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "bits.h"
+
+/**
+ * Returns the number of words needed to hold a number of values,
+ * including the padding word that `bits_unpack_one` reads past the end.
+ */
+static inline size_t packed_int_vector_word_count(size_t length, unsigned width) {
+    return ((length * width) + 63) / 64 + 1;
+}
+
+/**
+ * Grows the words vector to hold a number of values, filling the
+ * new words with zeros.
+ */
+static void packed_int_vector_resize(packed_int_vector_t *pv, size_t length) {
+    size_t oldCount = vector_len(pv->words);
+    size_t newCount = packed_int_vector_word_count(length, pv->width);
+    if (newCount <= oldCount) {
+        return;
+    }
+    vector_reserve(&pv->words, newCount - oldCount);
+    uint64_t zero = 0;
+    for (size_t i = oldCount; i < newCount; i++) {
+        vector_push(&pv->words, &zero, 1);
+    }
+}
+
+packed_int_vector_t packed_int_vector_new(size_t initialCapacity, unsigned width) {
+    if (width == 0 || width > 64) {
+        abort();
+    }
+    packed_int_vector_t pv = {
+        .words = vector_new(packed_int_vector_word_count(initialCapacity, width), sizeof(uint64_t)),
+        .length = 0,
+        .width = width,
+    };
+    packed_int_vector_resize(&pv, 0);
+    return pv;
+}
+
+size_t packed_int_vector_len(const packed_int_vector_t *pv) {
+    return pv->length;
+}
+
+unsigned packed_int_vector_width(const packed_int_vector_t *pv) {
+    return pv->width;
+}
+
+uint64_t packed_int_vector_get(const packed_int_vector_t *pv, size_t index) {
+    if (index >= pv->length) {
+        abort();
+    }
+    return bits_unpack_one(vector_first(pv->words), index, pv->width);
+}
+
+void packed_int_vector_set(packed_int_vector_t *pv, size_t index, uint64_t value) {
+    if (index >= pv->length) {
+        abort();
+    }
+    packed_int_vector_widen(pv, bits_width64(value));
+    uint64_t *words = vector_at_mut(pv->words, 0);
+    bits_clear_one(words, index, pv->width);
+    bits_pack_one(words, index, pv->width, value);
+}
+
+void packed_int_vector_push(packed_int_vector_t *pv, const uint64_t *values, size_t count) {
+    uint64_t bits = 0;
+    for (size_t i = 0; i < count; i++) {
+        bits |= values[i];
+    }
+    packed_int_vector_widen(pv, bits_width64(bits));
+    packed_int_vector_resize(pv, pv->length + count);
+    uint64_t *words = vector_at_mut(pv->words, 0);
+    for (size_t i = 0; i < count; i++) {
+        bits_pack_one(words, pv->length + i, pv->width, values[i]);
+    }
+    pv->length += count;
+}
+
+void packed_int_vector_extend(packed_int_vector_t *pv, vector_t other) {
+    if (vector_element_size(other) != sizeof(uint64_t)) {
+        abort();
+    }
+    size_t length = vector_len(other);
+    for (size_t index = 0; index < length;) {
+        size_t run = vector_run_len(other, index);
+        packed_int_vector_push(pv, vector_at(other, index), run);
+        index += run;
+    }
+}
+
+void packed_int_vector_decode(const packed_int_vector_t *pv, size_t index, uint64_t *values, size_t count) {
+    if (index + count > pv->length) {
+        abort();
+    }
+    bits_unpack(vector_first(pv->words), index, pv->width, values, count);
+}
+
+void packed_int_vector_widen(packed_int_vector_t *pv, unsigned width) {
+    if (width > 64) {
+        abort();
+    }
+    if (width <= pv->width) {
+        return;
+    }
+    packed_int_vector_t wider = packed_int_vector_new(pv->length, width);
+    packed_int_vector_resize(&wider, pv->length);
+    const uint64_t *from = vector_first(pv->words);
+    uint64_t *to = vector_at_mut(wider.words, 0);
+    for (size_t i = 0; i < pv->length; i++) {
+        bits_pack_one(to, i, width, bits_unpack_one(from, i, pv->width));
+    }
+    wider.length = pv->length;
+    vector_delete(pv->words);
+    *pv = wider;
+}
+
+void packed_int_vector_clear(packed_int_vector_t *pv) {
+    // Keep the invariant that the bits past the end are zero,
+    // so that pushing can OR new values into place.
+    uint64_t *words = vector_at_mut(pv->words, 0);
+    memset(words, 0, vector_len(pv->words) * sizeof(uint64_t));
+    pv->length = 0;
+}
+
+void packed_int_vector_delete(packed_int_vector_t *pv) {
+    vector_delete(pv->words);
+}
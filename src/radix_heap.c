@@ -0,0 +1,181 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <collectc.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "bits.h"
+
+/**
+ * Each entry is its key, followed by its value, padded to
+ * a multiple of the key's size so that keys stay aligned.
+ */
+static inline size_t radix_heap_entry_size(size_t valueSize) {
+    return sizeof(uint64_t) + ((valueSize + sizeof(uint64_t) - 1) & ~(sizeof(uint64_t) - 1));
+}
+
+static inline uint64_t radix_heap_entry_key(const void *entry) {
+    uint64_t key;
+    memcpy(&key, entry, sizeof(key));
+    return key;
+}
+
+/** Returns the bucket for a key, relative to the last popped key. */
+static inline size_t radix_heap_bucket(uint64_t last, uint64_t key) {
+    return key == last ? 0 : 64 - bits_clz64(key ^ last);
+}
+
+/** Appends an entry to the bucket for its key. */
+static inline void radix_heap_place(radix_heap_t *heap, const void *entry) {
+    size_t bucket = radix_heap_bucket(heap->last, radix_heap_entry_key(entry));
+    vector_push(&heap->buckets[bucket], entry, 1);
+    if (bucket > 0) {
+        heap->occupied |= (uint64_t)1 << (bucket - 1);
+    }
+}
+
+/**
+ * Refills bucket 0, if it's empty, from the first non-empty bucket. The
+ * smallest key in that bucket becomes the last popped key, and since all
+ * of the bucket's keys share their bits above the bucket's bit with it,
+ * each entry lands in a lower bucket.
+ */
+static void radix_heap_refill(radix_heap_t *heap) {
+    if (!vector_is_empty(heap->buckets[0]) || heap->occupied == 0) {
+        return;
+    }
+    size_t bucket = bits_ctz64(heap->occupied) + 1;
+    vector_t entries = heap->buckets[bucket];
+    size_t count = vector_len(entries);
+    size_t entrySize = vector_element_size(entries);
+    const char *first = vector_first(entries);
+
+    uint64_t smallest = UINT64_MAX;
+    for (size_t i = 0; i < count; i++) {
+        uint64_t key = radix_heap_entry_key(first + (i * entrySize));
+        smallest = key < smallest ? key : smallest;
+    }
+    heap->last = smallest;
+    heap->occupied &= ~((uint64_t)1 << (bucket - 1));
+    for (size_t i = 0; i < count; i++) {
+        radix_heap_place(heap, first + (i * entrySize));
+    }
+    vector_clear(entries);
+}
+
+radix_heap_t radix_heap_new(size_t valueSize) {
+    size_t entrySize = radix_heap_entry_size(valueSize);
+    radix_heap_t heap = {
+        .occupied = 0,
+        .last = 0,
+        .smallest = 0,
+        .smallestKnown = false,
+        .length = 0,
+        .valueSize = valueSize,
+        .scratch = malloc(entrySize),
+    };
+    if (heap.scratch == NULL) {
+        abort();
+    }
+    for (size_t i = 0; i < sizeof(heap.buckets) / sizeof(heap.buckets[0]); i++) {
+        heap.buckets[i] = vector_new(0, entrySize);
+    }
+    return heap;
+}
+
+size_t radix_heap_len(const radix_heap_t *heap) {
+    return heap->length;
+}
+
+bool radix_heap_is_empty(const radix_heap_t *heap) {
+    return heap->length == 0;
+}
+
+size_t radix_heap_value_size(const radix_heap_t *heap) {
+    return heap->valueSize;
+}
+
+uint64_t radix_heap_last(const radix_heap_t *heap) {
+    return heap->last;
+}
+
+void radix_heap_push(radix_heap_t *heap, uint64_t key, const void *value) {
+    if (key < heap->last) {
+        abort();
+    }
+    memcpy(heap->scratch, &key, sizeof(key));
+    if (heap->valueSize > 0) {
+        memcpy((char *)heap->scratch + sizeof(key), value, heap->valueSize);
+    }
+    radix_heap_place(heap, heap->scratch);
+    heap->length++;
+    if (key < heap->smallest) {
+        heap->smallest = key;
+    }
+}
+
+bool radix_heap_peek(radix_heap_t *heap, uint64_t *key) {
+    if (heap->length == 0) {
+        return false;
+    }
+    if (!vector_is_empty(heap->buckets[0])) {
+        *key = heap->last;
+        return true;
+    }
+    if (!heap->smallestKnown) {
+        vector_t entries = heap->buckets[bits_ctz64(heap->occupied) + 1];
+        size_t count = vector_len(entries);
+        size_t entrySize = vector_element_size(entries);
+        const char *first = vector_first(entries);
+        heap->smallest = UINT64_MAX;
+        for (size_t i = 0; i < count; i++) {
+            uint64_t entryKey = radix_heap_entry_key(first + (i * entrySize));
+            heap->smallest = entryKey < heap->smallest ? entryKey : heap->smallest;
+        }
+        heap->smallestKnown = true;
+    }
+    *key = heap->smallest;
+    return true;
+}
+
+bool radix_heap_pop(radix_heap_t *heap, uint64_t *key, void *value) {
+    if (heap->length == 0) {
+        return false;
+    }
+    radix_heap_refill(heap);
+    // Every entry in bucket 0 has the last popped key,
+    // so take whichever is cheapest to remove.
+    vector_t entries = heap->buckets[0];
+    size_t index = vector_len(entries) - 1;
+    const char *entry = vector_at(entries, index);
+    if (key != NULL) {
+        *key = heap->last;
+    }
+    if (value != NULL && heap->valueSize > 0) {
+        memcpy(value, entry + sizeof(uint64_t), heap->valueSize);
+    }
+    vector_remove(entries, index, 1);
+    heap->length--;
+    heap->smallestKnown = false;
+    return true;
+}
+
+void radix_heap_clear(radix_heap_t *heap) {
+    for (size_t i = 0; i < sizeof(heap->buckets) / sizeof(heap->buckets[0]); i++) {
+        vector_clear(heap->buckets[i]);
+    }
+    heap->occupied = 0;
+    heap->last = 0;
+    heap->smallestKnown = false;
+    heap->length = 0;
+}
+
+void radix_heap_delete(radix_heap_t *heap) {
+    for (size_t i = 0; i < sizeof(heap->buckets) / sizeof(heap->buckets[0]); i++) {
+        vector_delete(heap->buckets[i]);
+    }
+    free(heap->scratch);
+}
@@ -0,0 +1,150 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <collectc.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+ragged_vector_t ragged_vector_new(size_t elementSize) {
+    return (ragged_vector_t){
+        .values = vector_new(0, elementSize),
+        .rows = vector_new(0, sizeof(ragged_vector_row_t)),
+        .liveLength = 0,
+    };
+}
+
+ragged_vector_t ragged_vector_from_parts(vector_t values, vector_t rows) {
+    if (vector_element_size(rows) != sizeof(ragged_vector_row_t)) {
+        abort();
+    }
+    size_t liveLength = 0;
+    size_t end = 0;
+    for (size_t i = 0; i < vector_len(rows); i++) {
+        const ragged_vector_row_t *row = vector_at(rows, i);
+        if (row->start < end || row->start + row->length > vector_len(values)) {
+            abort();
+        }
+        end = row->start + row->length;
+        liveLength += row->length;
+    }
+    // Rows are handed out as pointers to their first element, so the
+    // values stay in one place.
+    vector_make_contiguous(values);
+    return (ragged_vector_t){.values = values, .rows = rows, .liveLength = liveLength};
+}
+
+size_t ragged_vector_len(const ragged_vector_t *rv) {
+    return vector_len(rv->rows);
+}
+
+size_t ragged_vector_values_len(const ragged_vector_t *rv) {
+    return rv->liveLength;
+}
+
+size_t ragged_vector_element_size(const ragged_vector_t *rv) {
+    return vector_element_size(rv->values);
+}
+
+void *ragged_vector_row_mut(ragged_vector_t *rv, size_t row, size_t *length) {
+    const ragged_vector_row_t *location = vector_at(rv->rows, row);
+    if (location == NULL) {
+        abort();
+    }
+    *length = location->length;
+    return location->length > 0 ? vector_at_mut(rv->values, location->start) : NULL;
+}
+
+const void *ragged_vector_row(const ragged_vector_t *rv, size_t row, size_t *length) {
+    return ragged_vector_row_mut((ragged_vector_t *)rv, row, length);
+}
+
+void ragged_vector_push_row(ragged_vector_t *rv, const void *elements, size_t count) {
+    ragged_vector_row_t row = {.start = vector_len(rv->values), .length = count};
+    vector_push(&rv->values, elements, count);
+    vector_make_contiguous(rv->values);
+    vector_push(&rv->rows, &row, 1);
+    rv->liveLength += count;
+}
+
+void ragged_vector_push(ragged_vector_t *rv, const void *elements, size_t count) {
+    size_t rowCount = vector_len(rv->rows);
+    if (rowCount == 0) {
+        abort();
+    }
+    ragged_vector_row_t *last = vector_at_mut(rv->rows, rowCount - 1);
+    // If the last row was truncated, or the rows after it were removed,
+    // drop the leftover elements so that the row can grow in place.
+    size_t end = last->start + last->length;
+    size_t valuesLength = vector_len(rv->values);
+    if (end < valuesLength) {
+        vector_remove(rv->values, end, valuesLength - end);
+    }
+    vector_push(&rv->values, elements, count);
+    vector_make_contiguous(rv->values);
+    last->length += count;
+    rv->liveLength += count;
+}
+
+void ragged_vector_truncate_row(ragged_vector_t *rv, size_t row, size_t length) {
+    ragged_vector_row_t *location = vector_at_mut(rv->rows, row);
+    if (location == NULL) {
+        abort();
+    }
+    if (length < location->length) {
+        rv->liveLength -= location->length - length;
+        location->length = length;
+    }
+}
+
+void ragged_vector_remove_rows(ragged_vector_t *rv, size_t row, size_t count) {
+    if (row + count > vector_len(rv->rows)) {
+        abort();
+    }
+    for (size_t i = row; i < row + count; i++) {
+        const ragged_vector_row_t *location = vector_at(rv->rows, i);
+        rv->liveLength -= location->length;
+    }
+    vector_remove(rv->rows, row, count);
+}
+
+void ragged_vector_compact(ragged_vector_t *rv) {
+    size_t valuesLength = vector_len(rv->values);
+    if (rv->liveLength == valuesLength) {
+        return;
+    }
+    size_t elementSize = vector_element_size(rv->values);
+    size_t end = 0;
+    for (size_t i = 0; i < vector_len(rv->rows); i++) {
+        ragged_vector_row_t *row = vector_at_mut(rv->rows, i);
+        // Rows are stored in the same order as their elements, so
+        // moving each row down never overwrites a row that hasn't
+        // been moved yet.
+        if (row->start != end && row->length > 0) {
+            memmove(vector_at_mut(rv->values, end), vector_at(rv->values, row->start), row->length * elementSize);
+        }
+        row->start = end;
+        end += row->length;
+    }
+    vector_remove(rv->values, end, valuesLength - end);
+}
+
+vector_t ragged_vector_values(const ragged_vector_t *rv) {
+    return rv->values;
+}
+
+vector_t ragged_vector_rows(const ragged_vector_t *rv) {
+    return rv->rows;
+}
+
+void ragged_vector_clear(ragged_vector_t *rv) {
+    vector_clear(rv->values);
+    vector_clear(rv->rows);
+    rv->liveLength = 0;
+}
+
+void ragged_vector_delete(ragged_vector_t *rv) {
+    vector_delete(rv->values);
+    vector_delete(rv->rows);
+}
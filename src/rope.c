@@ -0,0 +1,486 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <collectc.h>
+
+#include <stdlib.h>
+
+/** The target size of each chunk, in bytes. */
+static const size_t CHUNK_BYTES = 2048;
+
+/**
+ * A node in the treap. Nodes are ordered by position, so the elements
+ * of the left subtree come before this node's chunk, and the elements
+ * of the right subtree come after it. Each node's priority is greater
+ * than or equal to its children's.
+ */
+typedef struct rope_node {
+    struct rope_node *left;
+    struct rope_node *right;
+    /** The number of elements in this node's subtree, including its chunk. */
+    size_t size;
+    uint64_t priority;
+    vector_t chunk;
+} rope_node_t;
+
+static inline size_t rope_node_size(const rope_node_t *node) {
+    return node == NULL ? 0 : node->size;
+}
+
+static inline void rope_node_update(rope_node_t *node) {
+    node->size = rope_node_size(node->left) + vector_len(node->chunk) + rope_node_size(node->right);
+}
+
+/** Returns the next pseudorandom node priority. */
+static uint64_t rope_next_priority(rope_t *rope) {
+    // xorshift64*.
+    rope->seed ^= rope->seed >> 12;
+    rope->seed ^= rope->seed << 25;
+    rope->seed ^= rope->seed >> 27;
+    return rope->seed * 0x2545f4914f6cdd1d;
+}
+
+static rope_node_t *rope_node_new(rope_t *rope, uint64_t priority, const void *elements, size_t count) {
+    rope_node_t *node = malloc(sizeof(rope_node_t));
+    if (node == NULL) {
+        abort();
+    }
+    node->left = NULL;
+    node->right = NULL;
+    node->priority = priority;
+    node->chunk = vector_new(count, rope->elementSize);
+    vector_push(&node->chunk, elements, count);
+    node->size = count;
+    return node;
+}
+
+/**
+ * Makes room for `count` more elements in a chunk. Chunks start out
+ * sized to their elements, and grow by half at a time up to the chunk
+ * capacity, so that sparse chunks don't hold a whole chunk's memory.
+ */
+static void rope_chunk_reserve(const rope_t *rope, vector_t *chunk, size_t count) {
+    size_t length = vector_len(*chunk);
+    size_t capacity = vector_capacity(*chunk);
+    if (length + count <= capacity) {
+        return;
+    }
+    size_t newCapacity = capacity + (capacity / 2);
+    if (newCapacity < length + count) {
+        newCapacity = length + count;
+    }
+    if (newCapacity > rope->chunkCapacity) {
+        newCapacity = rope->chunkCapacity;
+    }
+    vector_reserve_exact(chunk, newCapacity - length);
+}
+
+/** Moves a chunk into a smaller allocation, once it uses half or less of its capacity. */
+static void rope_chunk_trim(const rope_t *rope, vector_t *chunk) {
+    size_t length = vector_len(*chunk);
+    if (length == 0 || length > vector_capacity(*chunk) / 2) {
+        return;
+    }
+    vector_t trimmed = vector_new(length, rope->elementSize);
+    vector_push(&trimmed, vector_first(*chunk), length);
+    vector_delete(*chunk);
+    *chunk = trimmed;
+}
+
+static void rope_node_delete(rope_node_t *node) {
+    if (node != NULL) {
+        rope_node_delete(node->left);
+        rope_node_delete(node->right);
+        vector_delete(node->chunk);
+        free(node);
+    }
+}
+
+/** Joins two treaps, where all of `left`'s elements come first. */
+static rope_node_t *rope_merge(rope_node_t *left, rope_node_t *right) {
+    if (left == NULL) {
+        return right;
+    }
+    if (right == NULL) {
+        return left;
+    }
+    if (left->priority >= right->priority) {
+        left->right = rope_merge(left->right, right);
+        rope_node_update(left);
+        return left;
+    }
+    right->left = rope_merge(left, right->left);
+    rope_node_update(right);
+    return right;
+}
+
+/**
+ * Splits a treap into one with its first `index` elements, and
+ * one with the rest. If the split falls inside a chunk, the chunk's
+ * tail moves to a new node with the same priority, which keeps the
+ * heap order intact.
+ */
+static void rope_split_node(rope_t *rope, rope_node_t *node, size_t index, rope_node_t **left, rope_node_t **right) {
+    if (node == NULL) {
+        *left = NULL;
+        *right = NULL;
+        return;
+    }
+    size_t leftSize = rope_node_size(node->left);
+    size_t chunkLength = vector_len(node->chunk);
+    if (index <= leftSize) {
+        rope_split_node(rope, node->left, index, left, &node->left);
+        rope_node_update(node);
+        *right = node;
+    } else if (index >= leftSize + chunkLength) {
+        rope_split_node(rope, node->right, index - leftSize - chunkLength, &node->right, right);
+        rope_node_update(node);
+        *left = node;
+    } else {
+        size_t offset = index - leftSize;
+        rope_node_t *tail =
+            rope_node_new(rope, node->priority, vector_at(node->chunk, offset), chunkLength - offset);
+        vector_remove(node->chunk, offset, chunkLength - offset);
+        rope_chunk_trim(rope, &node->chunk);
+        tail->right = node->right;
+        node->right = NULL;
+        rope_node_update(tail);
+        rope_node_update(node);
+        *left = node;
+        *right = tail;
+    }
+}
+
+/**
+ * Builds a treap from elements, split evenly into as few chunks as
+ * can hold them. With more than one chunk, each is at least half full.
+ */
+static rope_node_t *rope_build(rope_t *rope, const void *elements, size_t count) {
+    rope_node_t *root = NULL;
+    const char *from = elements;
+    size_t chunks = (count + rope->chunkCapacity - 1) / rope->chunkCapacity;
+    for (; chunks > 0; chunks--) {
+        size_t chunkLength = count / chunks;
+        rope_node_t *node = rope_node_new(rope, rope_next_priority(rope), from, chunkLength);
+        root = rope_merge(root, node);
+        from += chunkLength * rope->elementSize;
+        count -= chunkLength;
+    }
+    return root;
+}
+
+static const rope_node_t *rope_first_node(const rope_node_t *node) {
+    while (node != NULL && node->left != NULL) {
+        node = node->left;
+    }
+    return node;
+}
+
+static const rope_node_t *rope_last_node(const rope_node_t *node) {
+    while (node != NULL && node->right != NULL) {
+        node = node->right;
+    }
+    return node;
+}
+
+/**
+ * Evens out two adjacent single-node treaps whose chunks are too big
+ * to merge, so that both are at least half full.
+ */
+static void rope_balance(const rope_t *rope, rope_node_t *left, rope_node_t *right) {
+    size_t leftLength = vector_len(left->chunk);
+    size_t target = (leftLength + vector_len(right->chunk)) / 2;
+    if (leftLength < target) {
+        size_t count = target - leftLength;
+        rope_chunk_reserve(rope, &left->chunk, count);
+        vector_push(&left->chunk, vector_first(right->chunk), count);
+        vector_remove(right->chunk, 0, count);
+        rope_chunk_trim(rope, &right->chunk);
+    } else {
+        size_t count = leftLength - target;
+        rope_chunk_reserve(rope, &right->chunk, count);
+        vector_insert(&right->chunk, 0, vector_at(left->chunk, target), count);
+        vector_remove(left->chunk, target, count);
+        rope_chunk_trim(rope, &left->chunk);
+    }
+    rope_node_update(left);
+    rope_node_update(right);
+}
+
+/**
+ * Joins two treaps like `rope_merge`, but first fixes up the chunks
+ * where they meet: if either is less than half full, the two merge into
+ * one chunk if they fit, or even out if they don't. A merged chunk that's
+ * still less than half full goes on to merge with its other neighbour.
+ *
+ * Splits and removes only leave sparse chunks where the pieces are
+ * joined back together, so joining this way keeps every chunk of a
+ * multi-chunk rope at least half full.
+ */
+static rope_node_t *rope_join(rope_t *rope, rope_node_t *left, rope_node_t *right) {
+    size_t half = rope->chunkCapacity / 2;
+    for (;;) {
+        const rope_node_t *last = rope_last_node(left);
+        const rope_node_t *first = rope_first_node(right);
+        if (last == NULL || first == NULL) {
+            return rope_merge(left, right);
+        }
+        size_t lastLength = vector_len(last->chunk);
+        size_t firstLength = vector_len(first->chunk);
+        if (lastLength >= half && firstLength >= half) {
+            return rope_merge(left, right);
+        }
+        // Both are at the ends of their treaps, so these splits take
+        // them out as single nodes, without splitting any chunks. Split
+        // chunks share their node's priority, so the nodes that are left
+        // get new ones; otherwise, chunks that only ever split and merge
+        // would end up with the same priority, and the treap would
+        // degrade into a list.
+        rope_node_t *tail;
+        rope_node_t *head;
+        rope_split_node(rope, left, rope_node_size(left) - lastLength, &left, &tail);
+        rope_split_node(rope, right, firstLength, &head, &right);
+        tail->priority = rope_next_priority(rope);
+        head->priority = rope_next_priority(rope);
+        if (lastLength + firstLength > rope->chunkCapacity) {
+            rope_balance(rope, tail, head);
+            return rope_merge(rope_merge(left, tail), rope_merge(head, right));
+        }
+        rope_chunk_reserve(rope, &tail->chunk, firstLength);
+        vector_push(&tail->chunk, vector_first(head->chunk), firstLength);
+        rope_node_update(tail);
+        rope_node_delete(head);
+        if (vector_len(tail->chunk) >= half) {
+            return rope_merge(rope_merge(left, tail), right);
+        }
+        if (left != NULL) {
+            right = rope_merge(tail, right);
+        } else {
+            left = tail;
+        }
+    }
+}
+
+/**
+ * Finds the node whose chunk holds an index, and the index's offset
+ * in that chunk. An index at the end of a chunk belongs to that chunk,
+ * so that appending to a chunk doesn't need a new node.
+ */
+static rope_node_t *rope_find(rope_node_t *node, size_t index, size_t *offset) {
+    while (node != NULL) {
+        size_t leftSize = rope_node_size(node->left);
+        size_t chunkLength = vector_len(node->chunk);
+        if (index < leftSize) {
+            node = node->left;
+        } else if (index <= leftSize + chunkLength) {
+            *offset = index - leftSize;
+            return node;
+        } else {
+            index -= leftSize + chunkLength;
+            node = node->right;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Adjusts the sizes of every node on the path to the node
+ * found by `rope_find` for an index.
+ */
+static void rope_resize_path(rope_node_t *node, size_t index, size_t added, size_t removed) {
+    while (node != NULL) {
+        node->size = node->size + added - removed;
+        size_t leftSize = rope_node_size(node->left);
+        size_t chunkLength = vector_len(node->chunk);
+        if (index < leftSize) {
+            node = node->left;
+        } else if (index <= leftSize + chunkLength) {
+            return;
+        } else {
+            index -= leftSize + chunkLength;
+            node = node->right;
+        }
+    }
+}
+
+rope_t rope_new(size_t elementSize) {
+    size_t chunkCapacity = elementSize == 0 ? CHUNK_BYTES : CHUNK_BYTES / elementSize;
+    return (rope_t){
+        .root = NULL,
+        .elementSize = elementSize,
+        .chunkCapacity = chunkCapacity < 4 ? 4 : chunkCapacity,
+        .seed = 0x9e3779b97f4a7c15,
+    };
+}
+
+size_t rope_len(const rope_t *rope) {
+    return rope_node_size(rope->root);
+}
+
+size_t rope_element_size(const rope_t *rope) {
+    return rope->elementSize;
+}
+
+const void *rope_at(const rope_t *rope, size_t index) {
+    return rope_at_mut((rope_t *)rope, index);
+}
+
+void *rope_at_mut(rope_t *rope, size_t index) {
+    if (index >= rope_len(rope)) {
+        return NULL;
+    }
+    const rope_node_t *node = rope->root;
+    for (;;) {
+        size_t leftSize = rope_node_size(node->left);
+        size_t chunkLength = vector_len(node->chunk);
+        if (index < leftSize) {
+            node = node->left;
+        } else if (index < leftSize + chunkLength) {
+            return vector_at_mut(node->chunk, index - leftSize);
+        } else {
+            index -= leftSize + chunkLength;
+            node = node->right;
+        }
+    }
+}
+
+void rope_insert(rope_t *rope, size_t index, const void *elements, size_t count) {
+    if (index > rope_len(rope)) {
+        abort();
+    }
+    if (count == 0) {
+        return;
+    }
+    // If the chunk at the index has room, insert into it directly.
+    size_t offset;
+    rope_node_t *node = rope_find(rope->root, index, &offset);
+    if (node != NULL && vector_len(node->chunk) + count <= rope->chunkCapacity) {
+        rope_resize_path(rope->root, index, count, 0);
+        rope_chunk_reserve(rope, &node->chunk, count);
+        vector_insert(&node->chunk, offset, elements, count);
+        return;
+    }
+    rope_node_t *left;
+    rope_node_t *right;
+    rope_split_node(rope, rope->root, index, &left, &right);
+    rope->root = rope_join(rope, rope_join(rope, left, rope_build(rope, elements, count)), right);
+}
+
+void rope_push(rope_t *rope, const void *elements, size_t count) {
+    rope_insert(rope, rope_len(rope), elements, count);
+}
+
+void rope_remove(rope_t *rope, size_t index, size_t count) {
+    if (index + count > rope_len(rope)) {
+        abort();
+    }
+    if (count == 0) {
+        return;
+    }
+    // If the range is inside one chunk, and leaves it at least half
+    // full, remove from it directly. Otherwise, the chunk needs to
+    // merge with a neighbour when the pieces are joined.
+    size_t offset;
+    rope_node_t *node = rope_find(rope->root, index, &offset);
+    if (node != NULL && offset + count <= vector_len(node->chunk) &&
+        vector_len(node->chunk) - count >= rope->chunkCapacity / 2) {
+        rope_resize_path(rope->root, index, 0, count);
+        vector_remove(node->chunk, offset, count);
+        return;
+    }
+    rope_node_t *left;
+    rope_node_t *middle;
+    rope_node_t *right;
+    rope_split_node(rope, rope->root, index, &left, &middle);
+    rope_split_node(rope, middle, count, &middle, &right);
+    rope_node_delete(middle);
+    rope->root = rope_join(rope, left, right);
+}
+
+rope_t rope_split(rope_t *rope, size_t index) {
+    if (index > rope_len(rope)) {
+        abort();
+    }
+    rope_t other = *rope;
+    other.seed = rope_next_priority(rope) | 1;
+    rope_node_t *left;
+    rope_node_t *right;
+    rope_split_node(rope, rope->root, index, &left, &right);
+    // The split can leave a sparse chunk at the end of each rope, so
+    // join each end chunk back onto the rest of its rope.
+    const rope_node_t *last = rope_last_node(left);
+    const rope_node_t *first = rope_first_node(right);
+    rope_node_t *tail = NULL;
+    rope_node_t *head = NULL;
+    if (last != NULL) {
+        rope_split_node(rope, left, rope_node_size(left) - vector_len(last->chunk), &left, &tail);
+        tail->priority = rope_next_priority(rope);
+    }
+    if (first != NULL) {
+        rope_split_node(rope, right, vector_len(first->chunk), &head, &right);
+        head->priority = rope_next_priority(&other);
+    }
+    rope->root = rope_join(rope, left, tail);
+    other.root = rope_join(&other, head, right);
+    return other;
+}
+
+void rope_concat(rope_t *rope, rope_t *other) {
+    if (rope->elementSize != other->elementSize) {
+        abort();
+    }
+    rope->root = rope_join(rope, rope->root, other->root);
+    other->root = NULL;
+}
+
+static size_t rope_node_allocation_size(const rope_node_t *node) {
+    if (node == NULL) {
+        return 0;
+    }
+    return sizeof(rope_node_t) + vector_allocation_size(node->chunk) + rope_node_allocation_size(node->left) +
+           rope_node_allocation_size(node->right);
+}
+
+size_t rope_allocation_size(const rope_t *rope) {
+    return rope_node_allocation_size(rope->root);
+}
+
+void rope_delete(rope_t *rope) {
+    rope_node_delete(rope->root);
+    rope->root = NULL;
+}
+
+/** Pushes a node and its chain of left children onto the stack. */
+static void rope_iter_descend(rope_iter_t *iter, const rope_node_t *node) {
+    while (node != NULL) {
+        vector_push(&iter->stack, &node, 1);
+        node = node->left;
+    }
+}
+
+rope_iter_t rope_iter_new(const rope_t *rope) {
+    rope_iter_t iter = {
+        .stack = vector_new(0, sizeof(const rope_node_t *)),
+    };
+    rope_iter_descend(&iter, rope->root);
+    return iter;
+}
+
+const void *rope_iter_next(rope_iter_t *iter, size_t *length) {
+    size_t depth = vector_len(iter->stack);
+    if (depth == 0) {
+        *length = 0;
+        return NULL;
+    }
+    // Edits never leave empty chunks, so every node has elements.
+    const rope_node_t *node = *(const rope_node_t *const *)vector_last(iter->stack);
+    vector_remove(iter->stack, depth - 1, 1);
+    rope_iter_descend(iter, node->right);
+    *length = vector_len(node->chunk);
+    return vector_first(node->chunk);
+}
+
+void rope_iter_delete(rope_iter_t *iter) {
+    vector_delete(iter->stack);
+}
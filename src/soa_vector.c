@@ -0,0 +1,220 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <collectc.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+/** The element size and location of one column. */
+typedef struct soa_vector_column {
+    size_t elementSize;
+    /** The offset of the column's first element from the base address. */
+    size_t offset;
+} soa_vector_column_t;
+
+/**
+ * The allocation header for a structure-of-arrays vector. The header is
+ * followed by the columns' descriptors, and then the columns themselves.
+ */
+typedef struct soa_vector_header {
+    size_t capacity;
+    size_t length;
+    size_t columnCount;
+    soa_vector_column_t columns[];
+} soa_vector_header_t;
+
+/** Rounds a size up to the maximum fundamental alignment. */
+static inline size_t soa_vector_align(size_t size) {
+    return (size + _Alignof(max_align_t) - 1) & ~(_Alignof(max_align_t) - 1);
+}
+
+static inline soa_vector_header_t *soa_vector_header(soa_vector_t vec) {
+    return (soa_vector_header_t *)vec;
+}
+
+static inline soa_vector_column_t *soa_vector_column_at(soa_vector_t vec, size_t column) {
+    soa_vector_header_t *header = soa_vector_header(vec);
+    if (column >= header->columnCount) {
+        abort();
+    }
+    return &header->columns[column];
+}
+
+/** Returns the offset of the first column, just past the column descriptors. */
+static inline size_t soa_vector_columns_offset(size_t columnCount) {
+    return soa_vector_align(sizeof(soa_vector_header_t) + (columnCount * sizeof(soa_vector_column_t)));
+}
+
+/**
+ * Allocates a vector with the given capacity and number of columns.
+ * The caller must fill in the columns' element sizes, then lay them out.
+ */
+static soa_vector_header_t *soa_vector_allocate(size_t capacity, size_t columnCount, size_t columnsSize) {
+    soa_vector_header_t *header = malloc(soa_vector_columns_offset(columnCount) + columnsSize);
+    if (header == NULL) {
+        abort();
+    }
+    header->capacity = capacity;
+    header->length = 0;
+    header->columnCount = columnCount;
+    return header;
+}
+
+/** Places the columns one after the other, for the header's capacity. */
+static void soa_vector_layout(soa_vector_header_t *header) {
+    size_t offset = soa_vector_columns_offset(header->columnCount);
+    for (size_t i = 0; i < header->columnCount; i++) {
+        header->columns[i].offset = offset;
+        offset += soa_vector_align(header->capacity * header->columns[i].elementSize);
+    }
+}
+
+soa_vector_t soa_vector_new(size_t initialCapacity, size_t columnCount, const size_t *elementSizes) {
+    if (columnCount == 0) {
+        abort();
+    }
+    size_t columnsSize = 0;
+    for (size_t i = 0; i < columnCount; i++) {
+        columnsSize += soa_vector_align(initialCapacity * elementSizes[i]);
+    }
+    soa_vector_header_t *header = soa_vector_allocate(initialCapacity, columnCount, columnsSize);
+    for (size_t i = 0; i < columnCount; i++) {
+        header->columns[i].elementSize = elementSizes[i];
+    }
+    soa_vector_layout(header);
+    return (soa_vector_t)header;
+}
+
+size_t soa_vector_len(soa_vector_t vec) {
+    return soa_vector_header(vec)->length;
+}
+
+size_t soa_vector_capacity(soa_vector_t vec) {
+    return soa_vector_header(vec)->capacity;
+}
+
+size_t soa_vector_column_count(soa_vector_t vec) {
+    return soa_vector_header(vec)->columnCount;
+}
+
+size_t soa_vector_element_size(soa_vector_t vec, size_t column) {
+    return soa_vector_column_at(vec, column)->elementSize;
+}
+
+bool soa_vector_is_empty(soa_vector_t vec) {
+    return soa_vector_len(vec) == 0;
+}
+
+void *soa_vector_column(soa_vector_t vec, size_t column) {
+    return (char *)vec + soa_vector_column_at(vec, column)->offset;
+}
+
+const void *soa_vector_at(soa_vector_t vec, size_t column, size_t index) {
+    soa_vector_column_t *descriptor = soa_vector_column_at(vec, column);
+    if (index >= soa_vector_len(vec)) {
+        return NULL;
+    }
+    return (char *)vec + descriptor->offset + (index * descriptor->elementSize);
+}
+
+void soa_vector_reserve(soa_vector_t *vec, size_t extraCapacity) {
+    soa_vector_header_t *oldHeader = soa_vector_header(*vec);
+    size_t length = oldHeader->length;
+    size_t oldCapacity = oldHeader->capacity;
+    if (length + extraCapacity <= oldCapacity) {
+        return;
+    }
+    // Growing moves every column, because each column's offset depends
+    // on the capacities of the columns before it.
+    size_t newCapacity = oldCapacity + (oldCapacity / 2 * 3) + extraCapacity;
+    size_t columnsSize = 0;
+    for (size_t i = 0; i < oldHeader->columnCount; i++) {
+        columnsSize += soa_vector_align(newCapacity * oldHeader->columns[i].elementSize);
+    }
+    soa_vector_header_t *newHeader = soa_vector_allocate(newCapacity, oldHeader->columnCount, columnsSize);
+    for (size_t i = 0; i < oldHeader->columnCount; i++) {
+        newHeader->columns[i].elementSize = oldHeader->columns[i].elementSize;
+    }
+    soa_vector_layout(newHeader);
+    for (size_t i = 0; i < oldHeader->columnCount; i++) {
+        memcpy(
+            (char *)newHeader + newHeader->columns[i].offset,
+            (char *)oldHeader + oldHeader->columns[i].offset,
+            length * oldHeader->columns[i].elementSize
+        );
+    }
+    newHeader->length = length;
+    free(oldHeader);
+    *vec = (soa_vector_t)newHeader;
+}
+
+void soa_vector_push(soa_vector_t *vec, const void *const *columns, size_t count) {
+    if (count == 0) {
+        return;
+    }
+    soa_vector_reserve(vec, count);
+    soa_vector_header_t *header = soa_vector_header(*vec);
+    for (size_t i = 0; i < header->columnCount; i++) {
+        soa_vector_column_t *column = &header->columns[i];
+        char *to = (char *)header + column->offset + (header->length * column->elementSize);
+        memcpy(to, columns[i], count * column->elementSize);
+    }
+    header->length += count;
+}
+
+void soa_vector_get(soa_vector_t vec, size_t index, void *const *columns) {
+    soa_vector_header_t *header = soa_vector_header(vec);
+    if (index >= header->length) {
+        abort();
+    }
+    for (size_t i = 0; i < header->columnCount; i++) {
+        soa_vector_column_t *column = &header->columns[i];
+        memcpy(columns[i], (char *)header + column->offset + (index * column->elementSize), column->elementSize);
+    }
+}
+
+void soa_vector_remove(soa_vector_t vec, size_t index, size_t count) {
+    soa_vector_header_t *header = soa_vector_header(vec);
+    if (index + count > header->length) {
+        abort();
+    }
+    if (count == 0) {
+        return;
+    }
+    for (size_t i = 0; i < header->columnCount; i++) {
+        soa_vector_column_t *column = &header->columns[i];
+        char *base = (char *)header + column->offset;
+        memmove(
+            base + (index * column->elementSize),
+            base + ((index + count) * column->elementSize),
+            (header->length - index - count) * column->elementSize
+        );
+    }
+    header->length -= count;
+}
+
+void soa_vector_swap_remove(soa_vector_t vec, size_t index) {
+    soa_vector_header_t *header = soa_vector_header(vec);
+    if (index >= header->length) {
+        abort();
+    }
+    size_t last = header->length - 1;
+    if (index < last) {
+        for (size_t i = 0; i < header->columnCount; i++) {
+            soa_vector_column_t *column = &header->columns[i];
+            char *base = (char *)header + column->offset;
+            memcpy(base + (index * column->elementSize), base + (last * column->elementSize), column->elementSize);
+        }
+    }
+    header->length = last;
+}
+
+void soa_vector_clear(soa_vector_t vec) {
+    soa_vector_header(vec)->length = 0;
+}
+
+void soa_vector_delete(soa_vector_t vec) {
+    free(soa_vector_header(vec));
+}
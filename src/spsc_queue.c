@@ -0,0 +1,140 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <collectc.h>
+
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** The assumed size of a cache line, for keeping indices apart. */
+#define CACHE_LINE_SIZE 64
+
+/**
+ * The indices only ever increase, and wrap around at `SIZE_MAX`. The
+ * slot for an index is `index & mask`, and the queue holds the elements
+ * at `[head, tail)`.
+ */
+struct spsc_queue {
+    /** Written by the producer. */
+    _Alignas(CACHE_LINE_SIZE) atomic_size_t tail;
+    /** The producer's last-seen copy of `head`. */
+    size_t cachedHead;
+
+    /** Written by the consumer. */
+    _Alignas(CACHE_LINE_SIZE) atomic_size_t head;
+    /** The consumer's last-seen copy of `tail`. */
+    size_t cachedTail;
+
+    _Alignas(CACHE_LINE_SIZE) size_t mask;
+    size_t elementSize;
+    char *slots;
+};
+
+static inline char *spsc_queue_slot(const spsc_queue_t *queue, size_t index) {
+    return queue->slots + ((index & queue->mask) * queue->elementSize);
+}
+
+spsc_queue_t *spsc_queue_new(size_t capacity, size_t elementSize) {
+    size_t rounded = 1;
+    while (rounded < capacity) {
+        rounded <<= 1;
+    }
+    spsc_queue_t *queue = aligned_alloc(CACHE_LINE_SIZE, sizeof(spsc_queue_t));
+    char *slots = malloc(rounded * elementSize);
+    if (queue == NULL || slots == NULL) {
+        abort();
+    }
+    atomic_init(&queue->tail, 0);
+    queue->cachedHead = 0;
+    atomic_init(&queue->head, 0);
+    queue->cachedTail = 0;
+    queue->mask = rounded - 1;
+    queue->elementSize = elementSize;
+    queue->slots = slots;
+    return queue;
+}
+
+size_t spsc_queue_capacity(const spsc_queue_t *queue) {
+    return queue->mask + 1;
+}
+
+size_t spsc_queue_element_size(const spsc_queue_t *queue) {
+    return queue->elementSize;
+}
+
+size_t spsc_queue_len(const spsc_queue_t *queue) {
+    // Read the head first, so the length never looks negative.
+    size_t head = atomic_load_explicit(&((spsc_queue_t *)queue)->head, memory_order_acquire);
+    size_t tail = atomic_load_explicit(&((spsc_queue_t *)queue)->tail, memory_order_acquire);
+    return tail - head;
+}
+
+/** Copies elements into the ring, starting at an index and wrapping around. */
+static void spsc_queue_copy_in(spsc_queue_t *queue, size_t index, const void *elements, size_t count) {
+    size_t slot = index & queue->mask;
+    size_t beforeEnd = queue->mask + 1 - slot < count ? queue->mask + 1 - slot : count;
+    memcpy(spsc_queue_slot(queue, index), elements, beforeEnd * queue->elementSize);
+    if (count > beforeEnd) {
+        const char *rest = (const char *)elements + (beforeEnd * queue->elementSize);
+        memcpy(queue->slots, rest, (count - beforeEnd) * queue->elementSize);
+    }
+}
+
+/** Copies elements out of the ring, starting at an index and wrapping around. */
+static void spsc_queue_copy_out(const spsc_queue_t *queue, size_t index, void *elements, size_t count) {
+    size_t slot = index & queue->mask;
+    size_t beforeEnd = queue->mask + 1 - slot < count ? queue->mask + 1 - slot : count;
+    memcpy(elements, spsc_queue_slot(queue, index), beforeEnd * queue->elementSize);
+    if (count > beforeEnd) {
+        char *rest = (char *)elements + (beforeEnd * queue->elementSize);
+        memcpy(rest, queue->slots, (count - beforeEnd) * queue->elementSize);
+    }
+}
+
+size_t spsc_queue_push(spsc_queue_t *queue, const void *elements, size_t count) {
+    size_t tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    size_t capacity = queue->mask + 1;
+    size_t room = capacity - (tail - queue->cachedHead);
+    if (room < count) {
+        // Only look at the consumer's index when the cached
+        // copy says there isn't enough room.
+        queue->cachedHead = atomic_load_explicit(&queue->head, memory_order_acquire);
+        room = capacity - (tail - queue->cachedHead);
+    }
+    if (count > room) {
+        count = room;
+    }
+    if (count == 0) {
+        return 0;
+    }
+    spsc_queue_copy_in(queue, tail, elements, count);
+    atomic_store_explicit(&queue->tail, tail + count, memory_order_release);
+    return count;
+}
+
+size_t spsc_queue_pop(spsc_queue_t *queue, void *elements, size_t count) {
+    size_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    size_t available = queue->cachedTail - head;
+    if (available < count) {
+        queue->cachedTail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+        available = queue->cachedTail - head;
+    }
+    if (count > available) {
+        count = available;
+    }
+    if (count == 0) {
+        return 0;
+    }
+    spsc_queue_copy_out(queue, head, elements, count);
+    atomic_store_explicit(&queue->head, head + count, memory_order_release);
+    return count;
+}
+
+void spsc_queue_delete(spsc_queue_t *queue) {
+    if (queue != NULL) {
+        free(queue->slots);
+        free(queue);
+    }
+}
@@ -0,0 +1,318 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <collectc.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define U64MAP_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#include "bits.h"
+
+/** The smallest table that the map allocates. */
+#define MIN_CAPACITY 16
+
+/**
+ * The number of keys that probing compares at once. The first
+ * `BLOCK_LENGTH - 1` keys are copied after the last slot, so that a
+ * block can start at any slot without wrapping around.
+ */
+#define BLOCK_LENGTH 4
+
+/** The odd constant for multiply-shift hashing: 2^64 divided by the golden ratio. */
+static const uint64_t HASH_MULTIPLIER = 0x9e3779b97f4a7c15;
+
+/** Returns the number of entries a table can hold before it grows: 3/4 of its slots. */
+static inline size_t u64map_max_length(size_t capacity) {
+    return capacity - (capacity / 4);
+}
+
+/** Returns the slot where a key's probe sequence starts. */
+static inline size_t u64map_home(const u64map_t *map, uint64_t key) {
+    return (size_t)((key * HASH_MULTIPLIER) >> map->shift);
+}
+
+static inline char *u64map_value(const u64map_t *map, size_t index) {
+    return map->values + (index * map->valueSize);
+}
+
+/** Sets the key in a slot, and its copy after the last slot. */
+static inline void u64map_set_key(u64map_t *map, size_t index, uint64_t key) {
+    map->keys[index] = key;
+    if (index < BLOCK_LENGTH - 1) {
+        map->keys[map->capacity + index] = key;
+    }
+}
+
+/**
+ * Returns a bitmask of the keys in the block at a slot that equal `key`.
+ * The comparisons don't branch, so a probe that ends anywhere in the
+ * block costs one branch, which is usually predicted correctly.
+ */
+static inline unsigned u64map_block_match(const uint64_t *keys, uint64_t key) {
+#if defined(U64MAP_SSE2)
+    // SSE2 can only compare 32-bit lanes, so a key matches if both
+    // of its halves do.
+    __m128i needle = _mm_set1_epi64x((long long)key);
+    __m128i low = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *)keys), needle);
+    __m128i high = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *)(keys + 2)), needle);
+    low = _mm_and_si128(low, _mm_shuffle_epi32(low, _MM_SHUFFLE(2, 3, 0, 1)));
+    high = _mm_and_si128(high, _mm_shuffle_epi32(high, _MM_SHUFFLE(2, 3, 0, 1)));
+    return (unsigned)_mm_movemask_pd(_mm_castsi128_pd(low)) | ((unsigned)_mm_movemask_pd(_mm_castsi128_pd(high)) << 2);
+#else
+    return (unsigned)(keys[0] == key) | ((unsigned)(keys[1] == key) << 1) | ((unsigned)(keys[2] == key) << 2) |
+           ((unsigned)(keys[3] == key) << 3);
+#endif
+}
+
+/**
+ * Finds the slot that holds a non-zero key, or returns `SIZE_MAX` if
+ * the key isn't in the map. Keys in a run are never separated by an
+ * empty slot, so the probe stops at the first slot that holds either
+ * the key or 0, and whichever it holds decides.
+ */
+static inline size_t u64map_find(const u64map_t *map, uint64_t key) {
+    if (map->capacity == 0) {
+        return SIZE_MAX;
+    }
+    size_t mask = map->capacity - 1;
+    for (size_t index = u64map_home(map, key);; index = (index + BLOCK_LENGTH) & mask) {
+        unsigned found = u64map_block_match(&map->keys[index], key);
+        unsigned stop = found | u64map_block_match(&map->keys[index], 0);
+        if (stop != 0) {
+            unsigned offset = bits_ctz64(stop);
+            return (found >> offset) & 1 ? (index + offset) & mask : SIZE_MAX;
+        }
+    }
+}
+
+/** Finds the first empty slot in a key's probe sequence. */
+static inline size_t u64map_find_empty(const u64map_t *map, uint64_t key) {
+    size_t mask = map->capacity - 1;
+    for (size_t index = u64map_home(map, key);; index = (index + BLOCK_LENGTH) & mask) {
+        unsigned empty = u64map_block_match(&map->keys[index], 0);
+        if (empty != 0) {
+            return (index + bits_ctz64(empty)) & mask;
+        }
+    }
+}
+
+/** Moves every entry into a new table with a capacity. */
+static void u64map_resize(u64map_t *map, size_t capacity) {
+    u64map_t old = *map;
+    size_t keysSize = (capacity + BLOCK_LENGTH - 1) * sizeof(uint64_t);
+    map->keys = calloc(1, keysSize + ((capacity + 1) * map->valueSize));
+    if (map->keys == NULL) {
+        abort();
+    }
+    map->values = (char *)map->keys + keysSize;
+    map->capacity = capacity;
+    map->shift = 64;
+    for (size_t bits = capacity; bits > 1; bits >>= 1) {
+        map->shift--;
+    }
+    for (size_t i = 0; i < old.capacity; i++) {
+        uint64_t key = old.keys[i];
+        if (key == 0) {
+            continue;
+        }
+        size_t index = u64map_find_empty(map, key);
+        u64map_set_key(map, index, key);
+        memcpy(u64map_value(map, index), u64map_value(&old, i), map->valueSize);
+    }
+    if (old.hasZeroKey) {
+        memcpy(u64map_value(map, capacity), u64map_value(&old, old.capacity), map->valueSize);
+    }
+    free(old.keys);
+}
+
+/**
+ * Returns the value slot for a key, inserting the key first if it
+ * isn't in the map. A new slot's value is left uninitialized.
+ */
+static char *u64map_claim(u64map_t *map, uint64_t key, bool *inserted) {
+    if (map->capacity == 0) {
+        u64map_resize(map, MIN_CAPACITY);
+    }
+    if (key == 0) {
+        *inserted = !map->hasZeroKey;
+        map->length += *inserted;
+        map->hasZeroKey = true;
+        return u64map_value(map, map->capacity);
+    }
+    size_t index = u64map_find(map, key);
+    if (index != SIZE_MAX) {
+        *inserted = false;
+        return u64map_value(map, index);
+    }
+    // Key 0 doesn't use a slot, so it doesn't count toward the load.
+    if (map->length - map->hasZeroKey + 1 > u64map_max_length(map->capacity)) {
+        u64map_resize(map, map->capacity * 2);
+    }
+    index = u64map_find_empty(map, key);
+    u64map_set_key(map, index, key);
+    map->length++;
+    *inserted = true;
+    return u64map_value(map, index);
+}
+
+u64map_t u64map_new(size_t valueSize) {
+    return (u64map_t){
+        .keys = NULL,
+        .values = NULL,
+        .capacity = 0,
+        .shift = 64,
+        .length = 0,
+        .hasZeroKey = false,
+        .valueSize = valueSize,
+    };
+}
+
+size_t u64map_len(const u64map_t *map) {
+    return map->length;
+}
+
+bool u64map_is_empty(const u64map_t *map) {
+    return map->length == 0;
+}
+
+size_t u64map_capacity(const u64map_t *map) {
+    return map->capacity == 0 ? 0 : u64map_max_length(map->capacity) + 1;
+}
+
+size_t u64map_value_size(const u64map_t *map) {
+    return map->valueSize;
+}
+
+const void *u64map_get(const u64map_t *map, uint64_t key) {
+    return u64map_get_mut((u64map_t *)map, key);
+}
+
+void *u64map_get_mut(u64map_t *map, uint64_t key) {
+    if (key == 0) {
+        return map->hasZeroKey ? u64map_value(map, map->capacity) : NULL;
+    }
+    size_t index = u64map_find(map, key);
+    return index == SIZE_MAX ? NULL : u64map_value(map, index);
+}
+
+bool u64map_contains(const u64map_t *map, uint64_t key) {
+    return key == 0 ? map->hasZeroKey : u64map_find(map, key) != SIZE_MAX;
+}
+
+bool u64map_insert(u64map_t *map, uint64_t key, const void *value) {
+    bool inserted;
+    char *slot = u64map_claim(map, key, &inserted);
+    if (map->valueSize > 0) {
+        memcpy(slot, value, map->valueSize);
+    }
+    return inserted;
+}
+
+void *u64map_get_or_insert(u64map_t *map, uint64_t key, bool *inserted) {
+    bool isNew;
+    char *slot = u64map_claim(map, key, &isNew);
+    if (isNew) {
+        memset(slot, 0, map->valueSize);
+    }
+    if (inserted != NULL) {
+        *inserted = isNew;
+    }
+    return slot;
+}
+
+bool u64map_remove(u64map_t *map, uint64_t key, void *value) {
+    if (key == 0) {
+        if (!map->hasZeroKey) {
+            return false;
+        }
+        if (value != NULL && map->valueSize > 0) {
+            memcpy(value, u64map_value(map, map->capacity), map->valueSize);
+        }
+        map->hasZeroKey = false;
+        map->length--;
+        return true;
+    }
+    size_t hole = u64map_find(map, key);
+    if (hole == SIZE_MAX) {
+        return false;
+    }
+    if (value != NULL && map->valueSize > 0) {
+        memcpy(value, u64map_value(map, hole), map->valueSize);
+    }
+    // Shift back every following key in the run that can't be found
+    // from its home slot once the hole is there: that is, every key
+    // whose home isn't cyclically in `(hole, index]`.
+    size_t mask = map->capacity - 1;
+    for (size_t index = (hole + 1) & mask; map->keys[index] != 0; index = (index + 1) & mask) {
+        size_t home = u64map_home(map, map->keys[index]);
+        bool reachable = hole <= index ? (hole < home && home <= index) : (hole < home || home <= index);
+        if (!reachable) {
+            u64map_set_key(map, hole, map->keys[index]);
+            memcpy(u64map_value(map, hole), u64map_value(map, index), map->valueSize);
+            hole = index;
+        }
+    }
+    u64map_set_key(map, hole, 0);
+    map->length--;
+    return true;
+}
+
+void u64map_reserve(u64map_t *map, size_t extraCapacity) {
+    size_t needed = map->length - map->hasZeroKey + extraCapacity;
+    size_t capacity = map->capacity == 0 ? MIN_CAPACITY : map->capacity;
+    while (u64map_max_length(capacity) < needed) {
+        capacity *= 2;
+    }
+    if (capacity != map->capacity) {
+        u64map_resize(map, capacity);
+    }
+}
+
+void u64map_clear(u64map_t *map) {
+    if (map->capacity > 0) {
+        memset(map->keys, 0, (map->capacity + BLOCK_LENGTH - 1) * sizeof(uint64_t));
+    }
+    map->length = 0;
+    map->hasZeroKey = false;
+}
+
+void u64map_delete(u64map_t *map) {
+    free(map->keys);
+}
+
+u64map_iter_t u64map_iter_new(const u64map_t *map) {
+    return (u64map_iter_t){
+        .map = map,
+        .index = 0,
+    };
+}
+
+bool u64map_iter_next(u64map_iter_t *iter, uint64_t *key, void **value) {
+    const u64map_t *map = iter->map;
+    while (iter->index < map->capacity) {
+        size_t index = iter->index++;
+        if (map->keys[index] != 0) {
+            *key = map->keys[index];
+            if (value != NULL) {
+                *value = u64map_value(map, index);
+            }
+            return true;
+        }
+    }
+    // Key 0 comes last, after all the slots.
+    if (iter->index == map->capacity && map->hasZeroKey) {
+        iter->index++;
+        *key = 0;
+        if (value != NULL) {
+            *value = u64map_value(map, map->capacity);
+        }
+        return true;
+    }
+    return false;
+}
@@ -8,11 +8,38 @@
 #include <stdlib.h>
 #include <string.h>
 
+/**
+ * The kinds of vectors, encoded in bits 1 and 2 of a vector's handle.
+ * All kinds share the same API, but store their headers differently.
+ */
+typedef enum vector_kind {
+    /** A vector with a `vector_header_t`. */
+    VECTOR_KIND_STANDARD = 0,
+    /** A vector with a `vector_compact_header_t`. */
+    VECTOR_KIND_COMPACT = 1,
+    /** A vector with a `vector_devector_header_t`. */
+    VECTOR_KIND_DEVECTOR = 2,
+    /** A vector with a `vector_incremental_header_t`. */
+    VECTOR_KIND_INCREMENTAL = 3,
+} vector_kind_t;
+
+/** The tag bit that marks a handle as a zero-capacity vector. */
+static const vector_t ZERO_CAPACITY_TAG = 1;
+
+/** The bits of a handle that hold the vector's kind. */
+static const vector_t KIND_MASK = 3 << 1;
+
+/**
+ * The number of low bits of a zero-capacity vector's handle that hold
+ * its tags. The element size is encoded in the higher bits.
+ */
+static const int ZERO_CAPACITY_ELEMENT_SIZE_SHIFT = 3;
+
 /**
  * The maximum element size that can be encoded in the higher bits of a
  * tagged "pointer" for a zero-capacity vector.
  */
-static const size_t MAX_ZERO_CAPACITY_ELEMENT_SIZE = (size_t)1 << (sizeof(vector_t) * CHAR_BIT - 1);
+static const size_t MAX_ZERO_CAPACITY_ELEMENT_SIZE = SIZE_MAX >> 3;
 
 /** The allocation header for an above-zero-capacity vector. */
 typedef struct vector_header {
@@ -21,19 +48,123 @@ typedef struct vector_header {
     size_t elementSize;
 } vector_header_t;
 
+/**
+ * The allocation header for an above-zero-capacity compact vector.
+ *
+ * Only the first `COMPACT_HEADER_SIZE` bytes are part of the header;
+ * the elements start right after them, or at the next multiple of
+ * their alignment.
+ */
+typedef struct vector_compact_header {
+    uint32_t capacity;
+    uint32_t length;
+    uint16_t elementSize;
+} vector_compact_header_t;
+
+/**
+ * The allocation header for an above-zero-capacity devector. The
+ * elements are at slots `[front, front + length)`, so there can be
+ * spare capacity on both sides of them.
+ */
+typedef struct vector_devector_header {
+    vector_header_t header;
+    size_t front;
+} vector_devector_header_t;
+
+/**
+ * The allocation header for an above-zero-capacity incremental vector.
+ * While `old` is set, the elements at `[moved, split)` are still in the
+ * previous allocation, at the same indices; all the others are in this one.
+ */
+typedef struct vector_incremental_header {
+    vector_header_t header;
+    struct vector_incremental_header *old;
+    /** The length of the vector when it grew. */
+    size_t split;
+    size_t moved;
+} vector_incremental_header_t;
+
+/**
+ * The least number of bytes of elements that an incremental vector moves
+ * out of its previous allocation on each insert, so that pushing single
+ * small elements still moves them in cheap batches.
+ */
+static const size_t INCREMENTAL_MOVE_BYTES = 4096;
+
+/** The number of bytes that `vector_hash` hashes at a time. */
+#define HASH_BLOCK_BYTES 4096
+
+static const size_t COMPACT_HEADER_SIZE = offsetof(vector_compact_header_t, elementSize) + sizeof(uint16_t);
+
 _Static_assert(
     // Dynamically allocated memory addresses must be aligned such that
-    // the least significant bit is never set. This lets us distinguish
-    // between real pointers returned by `malloc`, and tagged "pointers"
-    // that encode a zero-capacity vector's element size in the higher bits.
-    (_Alignof(max_align_t) & 1) == 0,
-    "Can't use tagged pointers for zero-capacity vectors"
+    // the three least significant bits are never set. This lets us
+    // distinguish between real pointers returned by `malloc`, and tagged
+    // "pointers" that encode a zero-capacity vector's element size in
+    // the higher bits, and lets us store the vector's kind in the
+    // lower bits of both.
+    (_Alignof(max_align_t) & 7) == 0,
+    "Can't use tagged pointers for vectors"
 );
 
+static inline vector_kind_t vector_kind(vector_t vec) {
+    return (vector_kind_t)((vec & KIND_MASK) >> 1);
+}
+
+/** Returns the handle for an allocated vector of the given kind. */
+static inline vector_t vector_tag(void *base, vector_kind_t kind) {
+    return (vector_t)base | ((vector_t)kind << 1);
+}
+
+/** Returns the handle for a zero-capacity vector of the given kind. */
+static inline vector_t vector_tag_zero_capacity(size_t elementSize, vector_kind_t kind) {
+    return ((vector_t)elementSize << ZERO_CAPACITY_ELEMENT_SIZE_SHIFT) | ((vector_t)kind << 1) | ZERO_CAPACITY_TAG;
+}
+
 /** Recovers and returns a pointer to the base address of a vector. */
 static inline void *vector_base(vector_t vec) {
-    bool isZeroCapacity = (vec & 1) != 0;
-    return isZeroCapacity ? NULL : (void *)vec;
+    bool isZeroCapacity = (vec & ZERO_CAPACITY_TAG) != 0;
+    return isZeroCapacity ? NULL : (void *)(vec & ~KIND_MASK);
+}
+
+/**
+ * Returns the offset of the first element of a compact vector.
+ * Elements are aligned to the largest power of two that divides
+ * their size, up to the maximum fundamental alignment.
+ */
+static inline size_t vector_compact_data_offset(size_t elementSize) {
+    size_t alignment = elementSize & (~elementSize + 1);
+    if (alignment == 0 || alignment > _Alignof(max_align_t)) {
+        alignment = _Alignof(max_align_t);
+    }
+    return (COMPACT_HEADER_SIZE + alignment - 1) & ~(alignment - 1);
+}
+
+/** Returns the offset of the first element from the vector's base address. */
+static inline size_t vector_data_offset(vector_kind_t kind, size_t elementSize) {
+    switch (kind) {
+    case VECTOR_KIND_COMPACT:
+        return vector_compact_data_offset(elementSize);
+    case VECTOR_KIND_DEVECTOR:
+        return sizeof(vector_devector_header_t);
+    case VECTOR_KIND_INCREMENTAL:
+        return sizeof(vector_incremental_header_t);
+    default:
+        return sizeof(vector_header_t);
+    }
+}
+
+/** Updates the length of an above-zero-capacity vector. */
+static inline void vector_set_len(vector_t vec, size_t length) {
+    void *base = vector_base(vec);
+    switch (vector_kind(vec)) {
+    case VECTOR_KIND_COMPACT:
+        ((vector_compact_header_t *)base)->length = (uint32_t)length;
+        break;
+    default:
+        ((vector_header_t *)base)->length = length;
+        break;
+    }
 }
 
 /**
@@ -43,78 +174,369 @@ static inline void *vector_base(vector_t vec) {
  */
 static inline void *vector_at_unchecked(vector_t vec, size_t index) {
     char *base = vector_base(vec);
-    vector_header_t *header = (vector_header_t *)base;
-    return base + sizeof(*header) + (index * header->elementSize);
+    size_t elementSize = vector_element_size(vec);
+    vector_kind_t kind = vector_kind(vec);
+    if (kind == VECTOR_KIND_DEVECTOR) {
+        index += ((vector_devector_header_t *)base)->front;
+    } else if (kind == VECTOR_KIND_INCREMENTAL) {
+        // The previous allocation has the same header size, so an element
+        // that hasn't moved yet is at the same offset from its base.
+        vector_incremental_header_t *header = (vector_incremental_header_t *)base;
+        if (header->old != NULL && index >= header->moved && index < header->split) {
+            base = (char *)header->old;
+        }
+    }
+    return base + vector_data_offset(kind, elementSize) + (index * elementSize);
 }
 
-vector_t vector_new(size_t initialCapacity, size_t elementSize) {
+/**
+ * Returns the number of elements, up to `count`, from the given index on
+ * that are contiguous in memory with the element at the index. This is
+ * `count` for every kind but an incremental vector that's still moving
+ * its elements.
+ */
+static size_t vector_contiguous_len(vector_t vec, size_t index, size_t count) {
+    const vector_incremental_header_t *header = vector_base(vec);
+    if (vector_kind(vec) != VECTOR_KIND_INCREMENTAL || header == NULL || header->old == NULL) {
+        return count;
+    }
+    size_t end = index < header->moved ? header->moved : (index < header->split ? header->split : SIZE_MAX);
+    return end - index < count ? end - index : count;
+}
+
+/**
+ * Moves up to `count` of an incremental vector's elements out of its
+ * previous allocation, in order, and frees that allocation once they've
+ * all moved. Does nothing for other kinds.
+ */
+static void vector_incremental_move(vector_t vec, size_t count) {
+    vector_incremental_header_t *header = vector_base(vec);
+    if (vector_kind(vec) != VECTOR_KIND_INCREMENTAL || header == NULL || header->old == NULL) {
+        return;
+    }
+    size_t elementSize = header->header.elementSize;
+    size_t moving = header->split - header->moved < count ? header->split - header->moved : count;
+    size_t offset = sizeof(vector_incremental_header_t) + (header->moved * elementSize);
+    memcpy((char *)header + offset, (const char *)header->old + offset, moving * elementSize);
+    header->moved += moving;
+    if (header->moved == header->split) {
+        free(header->old);
+        header->old = NULL;
+        header->split = 0;
+        header->moved = 0;
+    }
+}
+
+/**
+ * Writes the header for an above-zero-capacity vector of the given kind,
+ * and returns the vector's handle.
+ */
+static vector_t vector_init(void *base, vector_kind_t kind, size_t capacity, size_t length, size_t elementSize) {
+    switch (kind) {
+    case VECTOR_KIND_COMPACT: {
+        vector_compact_header_t *header = base;
+        header->capacity = (uint32_t)capacity;
+        header->length = (uint32_t)length;
+        header->elementSize = (uint16_t)elementSize;
+        break;
+    }
+    case VECTOR_KIND_DEVECTOR: {
+        vector_devector_header_t *header = base;
+        header->header.capacity = capacity;
+        header->header.length = length;
+        header->header.elementSize = elementSize;
+        // Start in the middle, with room to grow at both ends.
+        header->front = (capacity - length) / 2;
+        break;
+    }
+    case VECTOR_KIND_INCREMENTAL: {
+        vector_incremental_header_t *header = base;
+        header->header.capacity = capacity;
+        header->header.length = length;
+        header->header.elementSize = elementSize;
+        header->old = NULL;
+        header->split = 0;
+        header->moved = 0;
+        break;
+    }
+    default: {
+        vector_header_t *header = base;
+        header->capacity = capacity;
+        header->length = length;
+        header->elementSize = elementSize;
+        break;
+    }
+    }
+    return vector_tag(base, kind);
+}
+
+/** Creates a new, empty vector of the given kind. */
+static vector_t vector_new_kind(size_t initialCapacity, size_t elementSize, vector_kind_t kind) {
     bool isZeroCapacity = initialCapacity == 0 && elementSize <= MAX_ZERO_CAPACITY_ELEMENT_SIZE;
     if (isZeroCapacity) {
-        return ((vector_t)elementSize << 1) | 1;
+        return vector_tag_zero_capacity(elementSize, kind);
     }
-    void *base = malloc(sizeof(vector_header_t) + (initialCapacity * elementSize));
+    size_t offset = vector_data_offset(kind, elementSize);
+    void *base = malloc(offset + (initialCapacity * elementSize));
     if (base == NULL) {
         abort();
     }
-    vector_header_t *header = base;
-    header->capacity = initialCapacity;
-    header->length = 0;
-    header->elementSize = elementSize;
-    return (vector_t)header;
+    return vector_init(base, kind, initialCapacity, 0, elementSize);
+}
+
+vector_t vector_new(size_t initialCapacity, size_t elementSize) {
+    return vector_new_kind(initialCapacity, elementSize, VECTOR_KIND_STANDARD);
+}
+
+vector_t vector_new_compact(size_t initialCapacity, size_t elementSize) {
+    if (elementSize > UINT16_MAX || initialCapacity > UINT32_MAX) {
+        abort();
+    }
+    return vector_new_kind(initialCapacity, elementSize, VECTOR_KIND_COMPACT);
+}
+
+vector_t vector_new_devector(size_t initialCapacity, size_t elementSize) {
+    return vector_new_kind(initialCapacity, elementSize, VECTOR_KIND_DEVECTOR);
+}
+
+vector_t vector_new_incremental(size_t initialCapacity, size_t elementSize) {
+    return vector_new_kind(initialCapacity, elementSize, VECTOR_KIND_INCREMENTAL);
 }
 
 size_t vector_len(vector_t vec) {
-    vector_header_t *header = vector_base(vec);
-    return header == NULL ? 0 : header->length;
+    void *base = vector_base(vec);
+    if (base == NULL) {
+        return 0;
+    }
+    switch (vector_kind(vec)) {
+    case VECTOR_KIND_COMPACT:
+        return ((vector_compact_header_t *)base)->length;
+    default:
+        return ((vector_header_t *)base)->length;
+    }
 }
 
 size_t vector_capacity(vector_t vec) {
-    vector_header_t *header = vector_base(vec);
-    return header == NULL ? 0 : header->capacity;
+    void *base = vector_base(vec);
+    if (base == NULL) {
+        return 0;
+    }
+    switch (vector_kind(vec)) {
+    case VECTOR_KIND_COMPACT:
+        return ((vector_compact_header_t *)base)->capacity;
+    default:
+        return ((vector_header_t *)base)->capacity;
+    }
 }
 
 size_t vector_element_size(vector_t vec) {
-    vector_header_t *header = vector_base(vec);
-    return header == NULL ? vec >> 1 : header->elementSize;
+    void *base = vector_base(vec);
+    if (base == NULL) {
+        return vec >> ZERO_CAPACITY_ELEMENT_SIZE_SHIFT;
+    }
+    switch (vector_kind(vec)) {
+    case VECTOR_KIND_COMPACT:
+        return ((vector_compact_header_t *)base)->elementSize;
+    default:
+        return ((vector_header_t *)base)->elementSize;
+    }
 }
 
 bool vector_is_empty(vector_t vec) {
     return vector_len(vec) == 0;
 }
 
-void vector_reserve(vector_t *vec, size_t extraCapacity) {
+bool vector_is_compact(vector_t vec) {
+    return vector_kind(vec) == VECTOR_KIND_COMPACT;
+}
+
+bool vector_is_devector(vector_t vec) {
+    return vector_kind(vec) == VECTOR_KIND_DEVECTOR;
+}
+
+bool vector_is_incremental(vector_t vec) {
+    return vector_kind(vec) == VECTOR_KIND_INCREMENTAL;
+}
+
+size_t vector_allocation_size(vector_t vec) {
+    const vector_incremental_header_t *header = vector_base(vec);
+    if (header == NULL) {
+        return 0;
+    }
+    size_t elementSize = vector_element_size(vec);
+    size_t size = vector_data_offset(vector_kind(vec), elementSize) + (vector_capacity(vec) * elementSize);
+    if (vector_kind(vec) == VECTOR_KIND_INCREMENTAL && header->old != NULL) {
+        size += sizeof(vector_incremental_header_t) + (header->old->header.capacity * elementSize);
+    }
+    return size;
+}
+
+void vector_make_contiguous(vector_t vec) {
+    vector_incremental_move(vec, SIZE_MAX);
+}
+
+size_t vector_run_len(vector_t vec, size_t index) {
+    size_t length = vector_len(vec);
+    return index < length ? vector_contiguous_len(vec, index, length - index) : 0;
+}
+
+/**
+ * Makes room in a devector for at least `frontExtra` more elements before
+ * its first element, and `backExtra` more after its last element.
+ *
+ * If the devector has plenty of spare capacity, but on the wrong side,
+ * this recenters the elements in place. Otherwise, it grows the devector,
+ * and centers the elements in the new allocation, so that pushing to
+ * either end stays amortized O(1).
+ */
+static void vector_devector_reserve(vector_t *vec, size_t frontExtra, size_t backExtra) {
+    vector_devector_header_t *header = vector_base(*vec);
+    size_t length = vector_len(*vec);
+    size_t capacity = vector_capacity(*vec);
+    size_t elementSize = vector_element_size(*vec);
+    size_t front = header == NULL ? 0 : header->front;
+    if (frontExtra <= front && front + length + backExtra <= capacity) {
+        return;
+    }
+    size_t needed = length + frontExtra + backExtra;
+    if (header != NULL && needed <= capacity / 2) {
+        size_t newFront = frontExtra + ((capacity - needed) / 2);
+        char *data = (char *)header + sizeof(vector_devector_header_t);
+        memmove(data + (newFront * elementSize), data + (front * elementSize), length * elementSize);
+        header->front = newFront;
+        return;
+    }
+    size_t newCapacity = capacity + (capacity / 2 * 3) + frontExtra + backExtra;
+    vector_devector_header_t *newHeader = malloc(sizeof(vector_devector_header_t) + (newCapacity * elementSize));
+    if (newHeader == NULL) {
+        abort();
+    }
+    *vec = vector_init(newHeader, VECTOR_KIND_DEVECTOR, newCapacity, length, elementSize);
+    newHeader->front = frontExtra + ((newCapacity - needed) / 2);
+    if (length > 0) {
+        const char *data = (const char *)header + sizeof(vector_devector_header_t);
+        memcpy(vector_at_unchecked(*vec, 0), data + (front * elementSize), length * elementSize);
+    }
+    free(header);
+}
+
+/**
+ * Moves an incremental vector into a new allocation with a capacity,
+ * keeping the old allocation for its elements to move out of over the
+ * next inserts. Any elements still moving out of an earlier allocation
+ * move first, so there are never more than two.
+ */
+static void vector_incremental_grow(vector_t *vec, size_t newCapacity) {
+    vector_incremental_move(*vec, SIZE_MAX);
+    vector_incremental_header_t *old = vector_base(*vec);
+    size_t length = vector_len(*vec);
+    size_t elementSize = vector_element_size(*vec);
+    void *base = malloc(sizeof(vector_incremental_header_t) + (newCapacity * elementSize));
+    if (base == NULL) {
+        abort();
+    }
+    *vec = vector_init(base, VECTOR_KIND_INCREMENTAL, newCapacity, length, elementSize);
+    if (length == 0) {
+        free(old);
+        return;
+    }
+    vector_incremental_header_t *header = base;
+    header->old = old;
+    header->split = length;
+}
+
+/**
+ * Grows a vector to hold `extraCapacity` more elements. Unless `exact`
+ * is set, the vector grows by more than that, so that repeated growth
+ * is amortized O(1).
+ */
+static void vector_grow(vector_t *vec, size_t extraCapacity, bool exact) {
+    if (vector_kind(*vec) == VECTOR_KIND_DEVECTOR) {
+        vector_devector_reserve(vec, 0, extraCapacity);
+        return;
+    }
     size_t length = vector_len(*vec);
     size_t oldCapacity = vector_capacity(*vec);
     if (length + extraCapacity <= oldCapacity) {
         return;
     }
+    vector_kind_t kind = vector_kind(*vec);
     size_t elementSize = vector_element_size(*vec);
-    size_t newCapacity = oldCapacity + (oldCapacity / 2 * 3) + extraCapacity;
+    size_t newCapacity = exact ? length + extraCapacity : oldCapacity + (oldCapacity / 2 * 3) + extraCapacity;
+    if (kind == VECTOR_KIND_INCREMENTAL) {
+        vector_incremental_grow(vec, newCapacity);
+        return;
+    }
+    if (kind == VECTOR_KIND_COMPACT) {
+        // Compact vectors can't grow past a 32-bit capacity, so
+        // only grow up to that, and abort if it's not enough.
+        if (length + extraCapacity > UINT32_MAX) {
+            abort();
+        }
+        if (newCapacity > UINT32_MAX) {
+            newCapacity = UINT32_MAX;
+        }
+    }
     void *oldBase = vector_base(*vec);
-    void *newBase = realloc(oldBase, sizeof(vector_header_t) + (newCapacity * elementSize));
+    void *newBase = realloc(oldBase, vector_data_offset(kind, elementSize) + (newCapacity * elementSize));
     if (newBase == NULL) {
         abort();
     }
-    vector_header_t *newHeader = newBase;
-    newHeader->length = length;
-    newHeader->capacity = newCapacity;
-    newHeader->elementSize = elementSize;
-    *vec = (vector_t)newHeader;
+    *vec = vector_init(newBase, kind, newCapacity, length, elementSize);
+}
+
+void vector_reserve(vector_t *vec, size_t extraCapacity) {
+    vector_grow(vec, extraCapacity, false);
+}
+
+void vector_reserve_exact(vector_t *vec, size_t extraCapacity) {
+    vector_grow(vec, extraCapacity, true);
 }
 
 void vector_insert(vector_t *vec, size_t index, const void *elements, size_t count) {
-    vector_reserve(vec, count);
-    vector_header_t *header = vector_base(*vec);
-    if (header == NULL || index > header->length) {
+    size_t length = vector_len(*vec);
+    if (index > length) {
         abort();
     }
+    if (count == 0) {
+        return;
+    }
+    if (vector_kind(*vec) == VECTOR_KIND_DEVECTOR && index < length - index) {
+        // Devectors shift whichever side of the index is shorter, so
+        // inserting near the front moves the front elements forward.
+        vector_devector_reserve(vec, count, 0);
+        size_t elementSize = vector_element_size(*vec);
+        ((vector_devector_header_t *)vector_base(*vec))->front -= count;
+        void *at = vector_at_unchecked(*vec, index);
+        if (index > 0) {
+            memmove(vector_at_unchecked(*vec, 0), vector_at_unchecked(*vec, count), index * elementSize);
+        }
+        memcpy(at, elements, count * elementSize);
+        vector_set_len(*vec, length + count);
+        return;
+    }
+    vector_reserve(vec, count);
+    size_t elementSize = vector_element_size(*vec);
+    if (vector_kind(*vec) == VECTOR_KIND_INCREMENTAL) {
+        // Each insert moves a batch of elements out of the previous
+        // allocation: at least twice as many as it inserts, which is
+        // enough for all of them to move before the vector grows again.
+        // Inserting among them needs them all in one place first.
+        size_t batch = (2 * count) + (elementSize > 0 ? INCREMENTAL_MOVE_BYTES / elementSize : 0);
+        bool isAmongMoving = index < ((vector_incremental_header_t *)vector_base(*vec))->split;
+        vector_incremental_move(*vec, isAmongMoving ? SIZE_MAX : batch);
+    }
     void *at = vector_at_unchecked(*vec, index);
-    if (index < header->length) {
+    if (index < length) {
         void *to = vector_at_unchecked(*vec, index + count);
-        memmove(to, at, (header->length - 1 - count) * header->elementSize);
+        memmove(to, at, (length - index) * elementSize);
     }
-    memcpy(at, elements, count * header->elementSize);
-    header->length += count;
+    memcpy(at, elements, count * elementSize);
+    vector_set_len(*vec, length + count);
+}
+
+void vector_push_front(vector_t *vec, const void *elements, size_t count) {
+    vector_insert(vec, 0, elements, count);
 }
 
 void vector_push(vector_t *vec, const void *elements, size_t count) {
@@ -123,34 +545,65 @@ void vector_push(vector_t *vec, const void *elements, size_t count) {
 }
 
 void vector_slice(vector_t vec, size_t index, void *slice, size_t count) {
-    vector_header_t *header = vector_base(vec);
-    if (header == NULL || index + count > header->length) {
+    if (index + count > vector_len(vec)) {
         abort();
     }
-    void *from = vector_at_unchecked(vec, index);
-    memcpy(slice, from, count * header->elementSize);
+    size_t elementSize = vector_element_size(vec);
+    while (count > 0) {
+        size_t run = vector_contiguous_len(vec, index, count);
+        memcpy(slice, vector_at_unchecked(vec, index), run * elementSize);
+        slice = (char *)slice + (run * elementSize);
+        index += run;
+        count -= run;
+    }
 }
 
 void vector_extend(vector_t *vec, vector_t other) {
     if (vector_element_size(*vec) != vector_element_size(other)) {
         abort();
     }
-    char *otherBase = vector_base(other);
-    if (otherBase != NULL) {
-        vector_header_t *otherHeader = (vector_header_t *)otherBase;
-        vector_push(vec, otherBase + sizeof(*otherHeader), otherHeader->length);
+    size_t otherLength = vector_len(other);
+    for (size_t index = 0; index < otherLength;) {
+        size_t run = vector_contiguous_len(other, index, otherLength - index);
+        vector_push(vec, vector_at_unchecked(other, index), run);
+        index += run;
     }
 }
 
 void vector_remove(vector_t vec, size_t index, size_t count) {
-    vector_header_t *header = vector_base(vec);
-    if (header == NULL || index + count > vector_len(vec)) {
+    size_t length = vector_len(vec);
+    if (index + count > length) {
         abort();
     }
+    if (count == 0) {
+        return;
+    }
+    vector_incremental_header_t *header = vector_base(vec);
+    if (vector_kind(vec) == VECTOR_KIND_INCREMENTAL && index < header->split) {
+        // Removing from the end of an incremental vector drops any
+        // elements that haven't moved yet, but shifting them down needs
+        // them all in one place.
+        if (index + count == length) {
+            header->split = index;
+            header->moved = header->moved < index ? header->moved : index;
+        }
+        vector_incremental_move(vec, index + count == length ? 0 : SIZE_MAX);
+    }
+    if (vector_kind(vec) == VECTOR_KIND_DEVECTOR && index < length - index - count) {
+        // Shift the elements before the range back, and
+        // advance the front past the removed elements.
+        if (index > 0) {
+            void *to = vector_at_unchecked(vec, count);
+            memmove(to, vector_at_unchecked(vec, 0), index * vector_element_size(vec));
+        }
+        ((vector_devector_header_t *)vector_base(vec))->front += count;
+        vector_set_len(vec, length - count);
+        return;
+    }
     void *from = vector_at_unchecked(vec, index + count);
     void *to = vector_at_unchecked(vec, index);
-    memmove(to, from, (header->length - index - count) * header->elementSize);
-    header->length -= count;
+    memmove(to, from, (length - index - count) * vector_element_size(vec));
+    vector_set_len(vec, length - count);
 }
 
 const void *vector_first(const vector_t vec) {
@@ -170,13 +623,75 @@ const void *vector_last(const vector_t vec) {
     return length > 0 ? vector_at_unchecked(vec, length - 1) : NULL;
 }
 
+uint64_t vector_hash(const vector_t vec) {
+    size_t length = vector_len(vec);
+    size_t elementSize = vector_element_size(vec);
+    size_t size = length * elementSize;
+    if (size == 0) {
+        return hash_bytes(NULL, 0, 0);
+    }
+    unsigned char buffer[HASH_BLOCK_BYTES];
+    uint64_t hash = 0;
+    for (size_t offset = 0; offset < size; offset += HASH_BLOCK_BYTES) {
+        size_t blockSize = size - offset < HASH_BLOCK_BYTES ? size - offset : HASH_BLOCK_BYTES;
+        // Hash blocks that lie in one run in place, and copy the few
+        // that straddle two runs together first.
+        size_t index = offset / elementSize;
+        size_t lastIndex = (offset + blockSize - 1) / elementSize;
+        const unsigned char *block = buffer;
+        if (vector_contiguous_len(vec, index, lastIndex - index + 1) == lastIndex - index + 1) {
+            block = (const unsigned char *)vector_at_unchecked(vec, index) + (offset % elementSize);
+        } else {
+            for (size_t copied = 0; copied < blockSize;) {
+                size_t at = offset + copied;
+                size_t run = vector_contiguous_len(vec, at / elementSize, length - (at / elementSize));
+                size_t available = (run * elementSize) - (at % elementSize);
+                size_t count = blockSize - copied < available ? blockSize - copied : available;
+                const char *from = (const char *)vector_at_unchecked(vec, at / elementSize) + (at % elementSize);
+                memcpy(buffer + copied, from, count);
+                copied += count;
+            }
+        }
+        hash = hash_bytes(block, blockSize, hash);
+    }
+    return hash;
+}
+
+bool vector_equal(const vector_t a, const vector_t b) {
+    size_t length = vector_len(a);
+    size_t elementSize = vector_element_size(a);
+    if (length != vector_len(b) || elementSize != vector_element_size(b)) {
+        return false;
+    }
+    for (size_t index = 0; index < length;) {
+        size_t run = vector_contiguous_len(b, index, vector_contiguous_len(a, index, length - index));
+        if (memcmp(vector_at_unchecked(a, index), vector_at_unchecked(b, index), run * elementSize) != 0) {
+            return false;
+        }
+        index += run;
+    }
+    return true;
+}
+
 void vector_clear(vector_t vec) {
-    vector_header_t *header = vector_base(vec);
-    if (header != NULL) {
-        header->length = 0;
+    void *base = vector_base(vec);
+    if (base != NULL) {
+        vector_set_len(vec, 0);
+        if (vector_kind(vec) == VECTOR_KIND_DEVECTOR) {
+            ((vector_devector_header_t *)base)->front = vector_capacity(vec) / 2;
+        } else if (vector_kind(vec) == VECTOR_KIND_INCREMENTAL) {
+            vector_incremental_header_t *header = base;
+            free(header->old);
+            header->old = NULL;
+            header->split = 0;
+            header->moved = 0;
+        }
     }
 }
 
 void vector_delete(vector_t vec) {
+    if (vector_kind(vec) == VECTOR_KIND_INCREMENTAL && vector_base(vec) != NULL) {
+        free(((vector_incremental_header_t *)vector_base(vec))->old);
+    }
     free(vector_base(vec));
 }
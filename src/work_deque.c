@@ -0,0 +1,217 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <collectc.h>
+
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** The assumed size of a cache line, for keeping indices apart. */
+#define CACHE_LINE_SIZE 64
+
+/**
+ * The number of pushes between the owner's checks for whether it can
+ * free the buffers that the deque has outgrown.
+ */
+#define RECLAIM_INTERVAL 64
+
+/**
+ * A circular buffer of elements. The element at index `i` is in slot
+ * `i & mask`. Each buffer links to the smaller one that it replaced,
+ * until that one is freed.
+ */
+typedef struct work_deque_buffer {
+    size_t mask;
+    struct work_deque_buffer *retired;
+} work_deque_buffer_t;
+
+/**
+ * The deque holds the elements at `[top, bottom)`. Thieves advance `top`,
+ * and only the owner writes `bottom`. The indices are signed, because
+ * the owner's pop briefly moves `bottom` below `top` when the deque is
+ * empty.
+ */
+struct work_deque {
+    _Alignas(CACHE_LINE_SIZE) atomic_ptrdiff_t top;
+    /**
+     * The number of thieves in the middle of a steal. Thieves already
+     * share `top`, so this doesn't cost them another cache line.
+     */
+    atomic_size_t stealing;
+    _Alignas(CACHE_LINE_SIZE) atomic_ptrdiff_t bottom;
+    _Atomic(work_deque_buffer_t *) buffer;
+    size_t elementSize;
+};
+
+static inline char *work_deque_slot(const work_deque_t *deque, work_deque_buffer_t *buffer, ptrdiff_t index) {
+    return (char *)buffer + sizeof(work_deque_buffer_t) + (((size_t)index & buffer->mask) * deque->elementSize);
+}
+
+static work_deque_buffer_t *work_deque_buffer_new(const work_deque_t *deque, size_t capacity) {
+    work_deque_buffer_t *buffer = malloc(sizeof(work_deque_buffer_t) + (capacity * deque->elementSize));
+    if (buffer == NULL) {
+        abort();
+    }
+    buffer->mask = capacity - 1;
+    buffer->retired = NULL;
+    return buffer;
+}
+
+work_deque_t *work_deque_new(size_t initialCapacity, size_t elementSize) {
+    size_t capacity = 2;
+    while (capacity < initialCapacity) {
+        capacity <<= 1;
+    }
+    work_deque_t *deque = aligned_alloc(CACHE_LINE_SIZE, sizeof(work_deque_t));
+    if (deque == NULL) {
+        abort();
+    }
+    deque->elementSize = elementSize;
+    atomic_init(&deque->top, 0);
+    atomic_init(&deque->stealing, 0);
+    atomic_init(&deque->bottom, 0);
+    atomic_init(&deque->buffer, work_deque_buffer_new(deque, capacity));
+    return deque;
+}
+
+size_t work_deque_element_size(const work_deque_t *deque) {
+    return deque->elementSize;
+}
+
+size_t work_deque_len(const work_deque_t *deque) {
+    ptrdiff_t top = atomic_load_explicit(&((work_deque_t *)deque)->top, memory_order_acquire);
+    ptrdiff_t bottom = atomic_load_explicit(&((work_deque_t *)deque)->bottom, memory_order_acquire);
+    return bottom > top ? (size_t)(bottom - top) : 0;
+}
+
+size_t work_deque_allocation_size(const work_deque_t *deque) {
+    const work_deque_buffer_t *buffer = atomic_load_explicit(
+        &((work_deque_t *)deque)->buffer, memory_order_relaxed
+    );
+    size_t size = 0;
+    for (; buffer != NULL; buffer = buffer->retired) {
+        size += sizeof(work_deque_buffer_t) + ((buffer->mask + 1) * deque->elementSize);
+    }
+    return size;
+}
+
+/**
+ * Frees the buffers that the current one replaced, if no thief is in the
+ * middle of a steal. A thief counts itself in before it loads the buffer,
+ * with a fence in between, and the owner publishes a new buffer before
+ * the fence here. So either the owner sees the thief counted in, or the
+ * thief sees the new buffer; a thief that starts later can't load an
+ * old one.
+ */
+static void work_deque_reclaim(work_deque_t *deque, work_deque_buffer_t *buffer) {
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&deque->stealing, memory_order_acquire) != 0) {
+        return;
+    }
+    while (buffer->retired != NULL) {
+        work_deque_buffer_t *retired = buffer->retired;
+        buffer->retired = retired->retired;
+        free(retired);
+    }
+}
+
+/**
+ * Moves the elements at `[top, bottom)` into a buffer twice as big, and
+ * publishes it. The old buffer is retired, and only freed once no thief
+ * can still be copying elements out of it.
+ */
+static work_deque_buffer_t *work_deque_grow(
+    work_deque_t *deque, work_deque_buffer_t *buffer, ptrdiff_t top, ptrdiff_t bottom
+) {
+    work_deque_buffer_t *grown = work_deque_buffer_new(deque, (buffer->mask + 1) * 2);
+    for (ptrdiff_t i = top; i < bottom; i++) {
+        memcpy(work_deque_slot(deque, grown, i), work_deque_slot(deque, buffer, i), deque->elementSize);
+    }
+    grown->retired = buffer;
+    atomic_store_explicit(&deque->buffer, grown, memory_order_release);
+    work_deque_reclaim(deque, grown);
+    return grown;
+}
+
+void work_deque_push(work_deque_t *deque, const void *element) {
+    ptrdiff_t bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+    ptrdiff_t top = atomic_load_explicit(&deque->top, memory_order_acquire);
+    work_deque_buffer_t *buffer = atomic_load_explicit(&deque->buffer, memory_order_relaxed);
+    if ((size_t)(bottom - top) > buffer->mask) {
+        buffer = work_deque_grow(deque, buffer, top, bottom);
+    } else if (buffer->retired != NULL && bottom % RECLAIM_INTERVAL == 0) {
+        // Thieves were stealing when the deque last grew.
+        work_deque_reclaim(deque, buffer);
+    }
+    memcpy(work_deque_slot(deque, buffer, bottom), element, deque->elementSize);
+    // Publish the element before the new bottom.
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+}
+
+bool work_deque_pop(work_deque_t *deque, void *element) {
+    ptrdiff_t bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed) - 1;
+    work_deque_buffer_t *buffer = atomic_load_explicit(&deque->buffer, memory_order_relaxed);
+    // Reserve the bottom element before looking at the top, so that
+    // thieves either see the reservation, or we see their steal.
+    atomic_store_explicit(&deque->bottom, bottom, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    ptrdiff_t top = atomic_load_explicit(&deque->top, memory_order_relaxed);
+    if (top > bottom) {
+        atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+        return false;
+    }
+    memcpy(element, work_deque_slot(deque, buffer, bottom), deque->elementSize);
+    if (top < bottom) {
+        return true;
+    }
+    // This is the last element, so race the thieves for it.
+    bool won = atomic_compare_exchange_strong_explicit(
+        &deque->top, &top, top + 1, memory_order_seq_cst, memory_order_relaxed
+    );
+    atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+    return won;
+}
+
+bool work_deque_steal(work_deque_t *deque, void *element) {
+    // Count in, so that the owner keeps any buffer this might load.
+    atomic_fetch_add_explicit(&deque->stealing, 1, memory_order_relaxed);
+    bool won = false;
+    for (;;) {
+        ptrdiff_t top = atomic_load_explicit(&deque->top, memory_order_acquire);
+        atomic_thread_fence(memory_order_seq_cst);
+        ptrdiff_t bottom = atomic_load_explicit(&deque->bottom, memory_order_acquire);
+        if (top >= bottom) {
+            break;
+        }
+        // Copy the element before claiming it, because once the top moves
+        // past it, the owner can overwrite its slot. If another thief
+        // claims it first, the copy is discarded.
+        work_deque_buffer_t *buffer = atomic_load_explicit(&deque->buffer, memory_order_acquire);
+        memcpy(element, work_deque_slot(deque, buffer, top), deque->elementSize);
+        won = atomic_compare_exchange_strong_explicit(
+            &deque->top, &top, top + 1, memory_order_seq_cst, memory_order_relaxed
+        );
+        if (won) {
+            break;
+        }
+    }
+    // Count out only after the last read from the buffer.
+    atomic_fetch_sub_explicit(&deque->stealing, 1, memory_order_release);
+    return won;
+}
+
+void work_deque_delete(work_deque_t *deque) {
+    if (deque == NULL) {
+        return;
+    }
+    work_deque_buffer_t *buffer = atomic_load_explicit(&deque->buffer, memory_order_relaxed);
+    while (buffer != NULL) {
+        work_deque_buffer_t *retired = buffer->retired;
+        free(buffer);
+        buffer = retired;
+    }
+    free(deque);
+}
@@ -0,0 +1,68 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <collectc.h>
+
+#include "test.h"
+
+void test_bitvec_bits(void) {
+    bitvec_t bv = bitvec_new(0);
+    for (size_t i = 0; i < 200; i++) {
+        bitvec_push(&bv, i % 3 == 0);
+    }
+    t_assert(bitvec_len(&bv) == 200, "got %zu", bitvec_len(&bv));
+    t_assert(bitvec_get(&bv, 99), "want bit 99 set");
+    t_assert(!bitvec_get(&bv, 100), "want bit 100 clear");
+    t_assert(bitvec_count_ones(&bv) == 67, "got %zu", bitvec_count_ones(&bv));
+
+    bitvec_set(&bv, 100, true);
+    bitvec_set(&bv, 99, false);
+    t_assert(bitvec_find_first_set(&bv, 97) == 100, "got %zu", bitvec_find_first_set(&bv, 97));
+    t_assert(bitvec_find_first_set(&bv, 199) == 200, "got %zu", bitvec_find_first_set(&bv, 199));
+
+    {
+        bitvec_t other = bitvec_new_filled(200, true);
+        bitvec_set(&other, 0, false);
+        bitvec_and(&other, &bv);
+        t_assert(bitvec_count_ones(&other) == 66, "got %zu", bitvec_count_ones(&other));
+        bitvec_xor(&other, &bv);
+        t_assert(bitvec_count_ones(&other) == 1, "got %zu", bitvec_count_ones(&other));
+        t_assert(bitvec_find_first_set(&other, 0) == 0, "got %zu", bitvec_find_first_set(&other, 0));
+        bitvec_or(&other, &bv);
+        t_assert(bitvec_count_ones(&other) == 67, "got %zu", bitvec_count_ones(&other));
+        bitvec_not(&other);
+        t_assert(bitvec_count_ones(&other) == 133, "got %zu", bitvec_count_ones(&other));
+        bitvec_delete(&other);
+    }
+
+    bitvec_clear(&bv);
+    t_assert(bitvec_len(&bv) == 0, "got %zu", bitvec_len(&bv));
+    t_assert(bitvec_count_ones(&bv) == 0, "got %zu", bitvec_count_ones(&bv));
+    bitvec_delete(&bv);
+}
+
+void test_bitvec_rank_select(void) {
+    bitvec_t bv = bitvec_new_filled(5000, false);
+    size_t ones = 0;
+    for (size_t i = 7; i < 5000; i += 13) {
+        bitvec_set(&bv, i, true);
+        ones++;
+    }
+    t_assert(bitvec_rank(&bv, 0) == 0, "got %zu", bitvec_rank(&bv, 0));
+    t_assert(bitvec_rank(&bv, 5000) == ones, "got %zu; want %zu", bitvec_rank(&bv, 5000), ones);
+    for (size_t n = 0; n < ones; n++) {
+        size_t index = bitvec_select(&bv, n);
+        t_assert(index == 7 + (n * 13), "select %zu: got %zu", n, index);
+        t_assert(bitvec_rank(&bv, index) == n, "rank %zu: got %zu", index, bitvec_rank(&bv, index));
+        t_assert(bitvec_rank(&bv, index + 1) == n + 1, "rank %zu: got %zu", index + 1, bitvec_rank(&bv, index + 1));
+    }
+    t_assert(bitvec_select(&bv, ones) == 5000, "got %zu", bitvec_select(&bv, ones));
+
+    // Modifying the bits rebuilds the index on the next query.
+    bitvec_set(&bv, 0, true);
+    t_assert(bitvec_select(&bv, 0) == 0, "got %zu", bitvec_select(&bv, 0));
+    t_assert(bitvec_rank(&bv, 8) == 2, "got %zu", bitvec_rank(&bv, 8));
+
+    bitvec_delete(&bv);
+}
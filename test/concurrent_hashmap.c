@@ -0,0 +1,150 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdbool.h>
+
+#include <collectc.h>
+
+#include "test.h"
+
+/** A hash with only 8 distinct values, so most keys share a shard and a bucket. */
+static uint64_t colliding_hash(const void *key) {
+    return (*(const uint32_t *)key % 8) * 0x9e3779b97f4a7c15;
+}
+
+void test_concurrent_hashmap_single(void) {
+    // Random inserts and removals against a plain array, in one thread,
+    // with every key in one shard and then with keys that collide.
+    hashmap_hash_t hashes[] = {NULL, colliding_hash};
+    for (size_t h = 0; h < sizeof(hashes) / sizeof(hashes[0]); h++) {
+        concurrent_hashmap_t *map = concurrent_hashmap_new(sizeof(uint32_t), sizeof(uint64_t), hashes[h], NULL);
+        t_assert(concurrent_hashmap_key_size(map) == sizeof(uint32_t), "got %zu", concurrent_hashmap_key_size(map));
+        t_assert(
+            concurrent_hashmap_value_size(map) == sizeof(uint64_t), "got %zu", concurrent_hashmap_value_size(map)
+        );
+        static uint64_t values[2000];
+        size_t length = 0;
+        for (size_t i = 0; i < 2000; i++) {
+            values[i] = 0;
+        }
+        uint64_t state = 7;
+        for (size_t step = 0; step < 20000; step++) {
+            state = state * 6364136223846793005 + 1442695040888963407;
+            uint32_t key = (uint32_t)((state >> 33) % (h == 0 ? 2000 : 200));
+            uint64_t value = 0;
+            bool found = concurrent_hashmap_get(map, &key, &value);
+            t_assert(found == (values[key] != 0), "step %zu: key %u", step, key);
+            t_assert(value == values[key], "step %zu: got %llu", step, (unsigned long long)value);
+            if ((state >> 20) % 3 != 0) {
+                value = step + 1;
+                t_assert(concurrent_hashmap_insert(map, &key, &value) == !found, "step %zu", step);
+                length += !found;
+                values[key] = value;
+            } else {
+                t_assert(concurrent_hashmap_remove(map, &key, &value) == found, "step %zu", step);
+                t_assert(!found || value == values[key], "step %zu: wrong value", step);
+                length -= found;
+                values[key] = 0;
+            }
+            t_assert(concurrent_hashmap_len(map) == length, "step %zu: got %zu", step, concurrent_hashmap_len(map));
+        }
+        for (uint32_t key = 0; key < 2000; key++) {
+            t_assert(concurrent_hashmap_contains(map, &key) == (values[key] != 0), "key %u", key);
+        }
+        concurrent_hashmap_delete(map);
+    }
+
+    // Maps with empty values work as sets.
+    concurrent_hashmap_t *set = concurrent_hashmap_new(sizeof(uint64_t), 0, NULL, NULL);
+    for (uint64_t i = 0; i < 100; i++) {
+        uint64_t element = i % 10;
+        concurrent_hashmap_insert(set, &element, NULL);
+    }
+    t_assert(concurrent_hashmap_len(set) == 10, "got %zu", concurrent_hashmap_len(set));
+    concurrent_hashmap_delete(set);
+}
+
+#define WRITERS 2
+#define READERS 2
+#define KEYS_PER_WRITER 2000
+#define ROUNDS 21
+
+typedef struct concurrent_test_context {
+    concurrent_hashmap_t *map;
+    unsigned id;
+    /** The number of values a reader saw that weren't written together. */
+    size_t torn;
+    size_t found;
+} concurrent_test_context_t;
+
+/** A value made of two halves that each say which key and round wrote it. */
+typedef struct concurrent_test_value {
+    uint64_t key;
+    uint64_t round;
+    uint64_t check;
+} concurrent_test_value_t;
+
+static void *concurrent_hashmap_write(void *context) {
+    concurrent_test_context_t *writer = context;
+    // Each writer owns its own keys, and inserts, replaces and removes
+    // them in rounds. Even rounds insert every key, and odd rounds remove
+    // every other one, so the last round leaves every key in.
+    for (uint64_t round = 0; round < ROUNDS; round++) {
+        for (uint64_t i = 0; i < KEYS_PER_WRITER; i++) {
+            uint32_t key = (uint32_t)(writer->id * KEYS_PER_WRITER + i);
+            if (round % 2 == 1 && i % 2 == 1) {
+                concurrent_hashmap_remove(writer->map, &key, NULL);
+            } else {
+                concurrent_test_value_t value = {.key = key, .round = round, .check = key ^ round};
+                concurrent_hashmap_insert(writer->map, &key, &value);
+            }
+        }
+    }
+    return NULL;
+}
+
+static void *concurrent_hashmap_read(void *context) {
+    concurrent_test_context_t *reader = context;
+    uint64_t state = reader->id + 1;
+    for (size_t i = 0; i < ROUNDS * KEYS_PER_WRITER * WRITERS; i++) {
+        state = state * 6364136223846793005 + 1442695040888963407;
+        uint32_t key = (uint32_t)((state >> 33) % (WRITERS * KEYS_PER_WRITER));
+        concurrent_test_value_t value;
+        if (concurrent_hashmap_get(reader->map, &key, &value)) {
+            reader->found++;
+            reader->torn += value.key != key || value.check != (value.key ^ value.round) || value.round >= ROUNDS;
+        }
+    }
+    return NULL;
+}
+
+void test_concurrent_hashmap_threads(void) {
+    concurrent_hashmap_t *map = concurrent_hashmap_new(sizeof(uint32_t), sizeof(concurrent_test_value_t), NULL, NULL);
+    pthread_t threads[WRITERS + READERS];
+    concurrent_test_context_t contexts[WRITERS + READERS];
+    for (unsigned i = 0; i < WRITERS + READERS; i++) {
+        contexts[i] = (concurrent_test_context_t){.map = map, .id = i < WRITERS ? i : i - WRITERS};
+        void *(*run)(void *) = i < WRITERS ? concurrent_hashmap_write : concurrent_hashmap_read;
+        if (pthread_create(&threads[i], NULL, run, &contexts[i]) != 0) {
+            t_assert(false, "can't create thread %u", i);
+        }
+    }
+    for (unsigned i = 0; i < WRITERS + READERS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    for (unsigned i = WRITERS; i < WRITERS + READERS; i++) {
+        t_assert(contexts[i].torn == 0, "reader %u saw %zu torn values", i, contexts[i].torn);
+    }
+
+    t_assert(concurrent_hashmap_len(map) == WRITERS * KEYS_PER_WRITER, "got %zu", concurrent_hashmap_len(map));
+    for (uint32_t key = 0; key < WRITERS * KEYS_PER_WRITER; key++) {
+        concurrent_test_value_t value;
+        t_assert(concurrent_hashmap_get(map, &key, &value), "key %u missing", key);
+        t_assert(value.key == key && value.round == ROUNDS - 1, "key %u", key);
+    }
+    concurrent_hashmap_delete(map);
+}
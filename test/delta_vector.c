@@ -0,0 +1,85 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <collectc.h>
+
+#include "test.h"
+
+void test_delta_vector_roundtrip(void) {
+    vector_t vec = vector_new(0, sizeof(uint64_t));
+    uint64_t value = 1000000;
+    for (uint64_t i = 0; i < 1000; i++) {
+        // Runs of duplicates make some blocks encode with zero-width gaps.
+        value += i >= 256 && i < 384 ? 0 : (i * 37) % 101;
+        vector_push(&vec, &value, 1);
+    }
+
+    delta_vector_t dv = delta_vector_from_vector(vec);
+    t_assert(delta_vector_len(&dv) == 1000, "got %zu", delta_vector_len(&dv));
+    t_assert(
+        delta_vector_allocation_size(&dv) * 3 < vector_allocation_size(vec),
+        "got %zu; want less than a third of %zu",
+        delta_vector_allocation_size(&dv),
+        vector_allocation_size(vec)
+    );
+
+    {
+        vector_t decoded = delta_vector_to_vector(&dv);
+        t_assert(vector_len(decoded) == 1000, "got %zu", vector_len(decoded));
+        for (size_t i = 0; i < 1000; i++) {
+            uint64_t actual = *(const uint64_t *)vector_at(decoded, i);
+            uint64_t expected = *(const uint64_t *)vector_at(vec, i);
+            t_assert(actual == expected, "at %zu: got %llu; want %llu", i, (unsigned long long)actual, (unsigned long long)expected);
+        }
+        vector_delete(decoded);
+    }
+
+    {
+        uint64_t decoded[300];
+        delta_vector_decode(&dv, 100, decoded, 300);
+        for (size_t i = 0; i < 300; i++) {
+            uint64_t expected = *(const uint64_t *)vector_at(vec, 100 + i);
+            t_assert(decoded[i] == expected, "at %zu: got %llu", 100 + i, (unsigned long long)decoded[i]);
+        }
+        uint64_t last = delta_vector_get(&dv, 999);
+        t_assert(last == value, "got %llu; want %llu", (unsigned long long)last, (unsigned long long)value);
+    }
+
+    vector_delete(vec);
+    delta_vector_delete(&dv);
+
+    // Incremental vectors are encoded across both of their allocations.
+    vec = t_moving_vector(100000);
+    dv = delta_vector_from_vector(vec);
+    t_assert(delta_vector_len(&dv) == vector_len(vec), "got %zu", delta_vector_len(&dv));
+    for (size_t i = 0; i < vector_len(vec); i += 997) {
+        uint64_t got = delta_vector_get(&dv, i);
+        t_assert(got == i * 3, "at %zu: got %llu", i, (unsigned long long)got);
+    }
+    vector_delete(vec);
+    delta_vector_delete(&dv);
+}
+
+void test_delta_vector_lower_bound(void) {
+    delta_vector_t dv = delta_vector_new();
+    for (uint64_t i = 0; i < 500; i++) {
+        uint64_t value = 10 + (i * 4);
+        delta_vector_push(&dv, &value, 1);
+    }
+    t_assert(delta_vector_lower_bound(&dv, 0) == 0, "got %zu", delta_vector_lower_bound(&dv, 0));
+    t_assert(delta_vector_lower_bound(&dv, 10) == 0, "got %zu", delta_vector_lower_bound(&dv, 10));
+    t_assert(delta_vector_lower_bound(&dv, 11) == 1, "got %zu", delta_vector_lower_bound(&dv, 11));
+    // In an encoded block, at a block boundary, and in the unencoded tail.
+    t_assert(delta_vector_lower_bound(&dv, 10 + 200 * 4) == 200, "got %zu", delta_vector_lower_bound(&dv, 810));
+    t_assert(delta_vector_lower_bound(&dv, 10 + 256 * 4 - 1) == 256, "got %zu", delta_vector_lower_bound(&dv, 1033));
+    t_assert(delta_vector_lower_bound(&dv, 10 + 450 * 4) == 450, "got %zu", delta_vector_lower_bound(&dv, 1810));
+    t_assert(delta_vector_lower_bound(&dv, 5000) == 500, "got %zu", delta_vector_lower_bound(&dv, 5000));
+
+    delta_vector_clear(&dv);
+    t_assert(delta_vector_len(&dv) == 0, "got %zu", delta_vector_len(&dv));
+    uint64_t values[2] = {1, 2};
+    delta_vector_push(&dv, values, 2);
+    t_assert(delta_vector_get(&dv, 1) == 2, "got %llu", (unsigned long long)delta_vector_get(&dv, 1));
+    delta_vector_delete(&dv);
+}
@@ -0,0 +1,101 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <collectc.h>
+
+#include "test.h"
+
+void test_deque_ends(void) {
+    deque_t dq = deque_new(0, sizeof(int));
+    t_assert(deque_is_empty(dq), "got %zu", deque_len(dq));
+    t_assert(deque_front(dq) == NULL, "want null");
+    t_assert(deque_back(dq) == NULL, "want null");
+
+    int values[] = {1, 2, 3, 4, 5};
+    deque_push_back(&dq, values, 3);
+    deque_push_front(&dq, &values[3], 2);
+    t_assert(deque_len(dq) == 5, "got %zu", deque_len(dq));
+    t_assert(deque_capacity(dq) == 8, "got %zu", deque_capacity(dq));
+    {
+        // The front elements keep the order they were pushed in.
+        int expected[] = {4, 5, 1, 2, 3};
+        for (size_t i = 0; i < 5; i++) {
+            int got = *(const int *)deque_at(dq, i);
+            t_assert(got == expected[i], "at %zu: got %d; want %d", i, got, expected[i]);
+        }
+    }
+    t_assert(deque_at(dq, 5) == NULL, "want out-of-bounds");
+
+    {
+        int popped[2];
+        deque_pop_front(dq, popped, 2);
+        t_assert(popped[0] == 4 && popped[1] == 5, "got %d, %d", popped[0], popped[1]);
+        deque_pop_back(dq, popped, 2);
+        t_assert(popped[0] == 2 && popped[1] == 3, "got %d, %d", popped[0], popped[1]);
+    }
+    t_assert(*(const int *)deque_front(dq) == 1, "got %d", *(const int *)deque_front(dq));
+    t_assert(*(const int *)deque_back(dq) == 1, "got %d", *(const int *)deque_back(dq));
+
+    *(int *)deque_at_mut(dq, 0) = 7;
+    deque_pop_front(dq, NULL, 1);
+    t_assert(deque_is_empty(dq), "got %zu", deque_len(dq));
+
+    deque_push_back(&dq, values, 5);
+    deque_clear(dq);
+    t_assert(deque_is_empty(dq), "got %zu", deque_len(dq));
+    deque_delete(dq);
+}
+
+void test_deque_wrap(void) {
+    deque_t dq = deque_new(5, sizeof(int));
+    t_assert(deque_capacity(dq) == 8, "got %zu", deque_capacity(dq));
+
+    // Use the deque as a FIFO, so the elements wrap around many times,
+    // and grow it while wrapped with both short and long wrapped runs.
+    int next = 0;
+    int expected = 0;
+    for (int round = 0; round < 200; round++) {
+        for (int i = 0; i < round % 7 + 1; i++, next++) {
+            deque_push_back(&dq, &next, 1);
+        }
+        for (int i = 0; i < round % 5 && !deque_is_empty(dq); i++, expected++) {
+            int got;
+            deque_pop_front(dq, &got, 1);
+            t_assert(got == expected, "got %d; want %d", got, expected);
+        }
+    }
+
+    {
+        const int *first;
+        const int *second;
+        size_t firstLength;
+        size_t secondLength;
+        deque_as_slices(dq, (const void **)&first, &firstLength, (const void **)&second, &secondLength);
+        t_assert(firstLength + secondLength == deque_len(dq), "got %zu + %zu", firstLength, secondLength);
+        for (size_t i = 0; i < firstLength + secondLength; i++, expected++) {
+            int got = i < firstLength ? first[i] : second[i - firstLength];
+            t_assert(got == expected, "at %zu: got %d; want %d", i, got, expected);
+        }
+        t_assert(expected == next, "got %d; want %d", expected, next);
+    }
+
+    // Fill a small deque so that it wraps, then grow it from the front.
+    deque_t small = deque_new(4, sizeof(int));
+    int values[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    deque_push_back(&small, &values[2], 2);
+    deque_push_front(&small, values, 2);
+    deque_push_front(&small, values, 1);
+    deque_push_back(&small, &values[4], 6);
+    {
+        int want[] = {0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+        t_assert(deque_len(small) == 11, "got %zu", deque_len(small));
+        for (size_t i = 0; i < 11; i++) {
+            int got = *(const int *)deque_at(small, i);
+            t_assert(got == want[i], "at %zu: got %d; want %d", i, got, want[i]);
+        }
+    }
+
+    deque_delete(small);
+    deque_delete(dq);
+}
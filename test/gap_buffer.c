@@ -0,0 +1,77 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <string.h>
+
+#include <collectc.h>
+
+#include "test.h"
+
+void test_gap_buffer_editing(void) {
+    gap_buffer_t gb = gap_buffer_new(0, sizeof(char));
+    t_assert(gap_buffer_is_empty(gb), "got %zu", gap_buffer_len(gb));
+    t_assert(gap_buffer_as_contiguous(gb) == NULL, "want null");
+
+    gap_buffer_insert(&gb, 0, "hello world", 11);
+    t_assert(gap_buffer_cursor(gb) == 11, "got %zu", gap_buffer_cursor(gb));
+
+    // Type in the middle, one character at a time.
+    gap_buffer_insert(&gb, 5, ",", 1);
+    gap_buffer_insert(&gb, gap_buffer_cursor(gb), " dear", 5);
+    t_assert(gap_buffer_len(gb) == 17, "got %zu", gap_buffer_len(gb));
+    t_assert(*(const char *)gap_buffer_at(gb, 5) == ',', "got %c", *(const char *)gap_buffer_at(gb, 5));
+    t_assert(*(const char *)gap_buffer_at(gb, 12) == 'w', "got %c", *(const char *)gap_buffer_at(gb, 12));
+    t_assert(gap_buffer_at(gb, 17) == NULL, "want out-of-bounds");
+
+    {
+        char actual[9];
+        gap_buffer_slice(gb, 3, actual, 9);
+        t_assert(memcmp(actual, "lo, dear ", 9) == 0, "got %.9s", actual);
+    }
+
+    // Backspace over " dear".
+    gap_buffer_remove(gb, gap_buffer_cursor(gb) - 5, 5);
+    t_assert(gap_buffer_cursor(gb) == 6, "got %zu", gap_buffer_cursor(gb));
+
+    gap_buffer_move_cursor(gb, 0);
+    gap_buffer_insert(&gb, 0, ">", 1);
+    gap_buffer_remove(gb, 12, 1);
+
+    {
+        const char *contents = gap_buffer_as_contiguous(gb);
+        t_assert(gap_buffer_len(gb) == 12, "got %zu", gap_buffer_len(gb));
+        t_assert(memcmp(contents, ">hello, worl", 12) == 0, "got %.12s", contents);
+        t_assert(gap_buffer_cursor(gb) == 12, "got %zu", gap_buffer_cursor(gb));
+    }
+
+    gap_buffer_clear(gb);
+    t_assert(gap_buffer_is_empty(gb), "got %zu", gap_buffer_len(gb));
+    gap_buffer_delete(gb);
+}
+
+void test_gap_buffer_growth(void) {
+    gap_buffer_t gb = gap_buffer_new(4, sizeof(int));
+    for (int i = 0; i < 100; i++) {
+        gap_buffer_insert(&gb, gap_buffer_len(gb) / 2, &i, 1);
+    }
+    t_assert(gap_buffer_len(gb) == 100, "got %zu", gap_buffer_len(gb));
+
+    int expected[100];
+    int actual[100];
+    gap_buffer_slice(gb, 0, actual, 100);
+    {
+        // Replay the same edits on a vector.
+        vector_t vec = vector_new(0, sizeof(int));
+        for (int i = 0; i < 100; i++) {
+            vector_insert(&vec, vector_len(vec) / 2, &i, 1);
+        }
+        vector_slice(vec, 0, expected, 100);
+        vector_delete(vec);
+    }
+    for (size_t i = 0; i < 100; i++) {
+        t_assert(actual[i] == expected[i], "at %zu: got %d; want %d", i, actual[i], expected[i]);
+    }
+
+    gap_buffer_delete(gb);
+}
@@ -0,0 +1,104 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <collectc.h>
+
+#include <string.h>
+
+#include "test.h"
+
+static uint64_t hash_vector_key(const void *key) {
+    return vector_hash(*(const vector_t *)key);
+}
+
+static bool equal_vector_keys(const void *a, const void *b) {
+    return vector_equal(*(const vector_t *)a, *(const vector_t *)b);
+}
+
+void test_hash_bytes(void) {
+    unsigned char bytes[301];
+    for (size_t i = 0; i < sizeof(bytes); i++) {
+        bytes[i] = (unsigned char)(i * 131 + 7);
+    }
+
+    // Every prefix has a different hash, including the empty one, and
+    // the hash doesn't depend on where the bytes are.
+    uint64_t hashes[300];
+    for (size_t size = 0; size < 300; size++) {
+        hashes[size] = hash_bytes(bytes, size, 0);
+        unsigned char copy[300];
+        memcpy(copy, bytes, size);
+        t_assert(hash_bytes(copy, size, 0) == hashes[size], "size %zu: want same hash", size);
+        t_assert(hash_bytes(bytes, size, 1) != hashes[size], "size %zu: want seed to change hash", size);
+        for (size_t other = 0; other < size; other++) {
+            t_assert(hashes[other] != hashes[size], "sizes %zu and %zu collide", other, size);
+        }
+    }
+    t_assert(hash_bytes(NULL, 0, 0) == hashes[0], "want same empty hash");
+
+    // Flipping any bit changes the hash, on both sides of the size
+    // where long inputs switch to AES rounds.
+    const size_t sizes[] = {1, 3, 8, 15, 16, 17, 48, 49, 63, 64, 65, 127, 128, 300};
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        size_t size = sizes[i];
+        uint64_t want = hash_bytes(bytes + 1, size, 42);
+        for (size_t bit = 0; bit < size * 8; bit++) {
+            bytes[1 + (bit / 8)] ^= (unsigned char)(1u << (bit % 8));
+            uint64_t got = hash_bytes(bytes + 1, size, 42);
+            bytes[1 + (bit / 8)] ^= (unsigned char)(1u << (bit % 8));
+            t_assert(got != want, "size %zu: bit %zu doesn't change hash", size, bit);
+        }
+    }
+
+    for (uint64_t i = 0; i < 1000; i++) {
+        t_assert(hash_u64(i, 0) != hash_u64(i + 1, 0), "%llu: want different hashes", (unsigned long long)i);
+        t_assert(hash_u64(i, 0) != hash_u64(i, 1), "%llu: want seed to change hash", (unsigned long long)i);
+    }
+    t_assert(hash_u32(7, 3) == hash_u64(7, 3), "want u32 hash to match u64 hash");
+    t_assert(hash_combine(1, 2) != hash_combine(2, 1), "want order to matter");
+    t_assert(hash_random_seed() != hash_random_seed(), "want different seeds");
+
+    // The standard check value, and a checksum continued across calls.
+    uint32_t crc = hash_crc32c("123456789", 9, 0);
+    t_assert(crc == 0xe3069283, "got %08x", crc);
+    t_assert(hash_crc32c("", 0, 0) == 0, "want 0");
+    crc = hash_crc32c(bytes, 100, 0);
+    crc = hash_crc32c(bytes + 100, 201, crc);
+    t_assert(crc == hash_crc32c(bytes, 301, 0), "got %08x", crc);
+}
+
+void test_hash_vector(void) {
+    // Vectors of different kinds with the same elements are equal,
+    // and have the same hash.
+    vector_t standard = vector_new(0, sizeof(int));
+    vector_t devector = vector_new_devector(100, sizeof(int));
+    for (int i = 0; i < 50; i++) {
+        int value = 49 - i;
+        vector_push(&standard, &i, 1);
+        vector_push_front(&devector, &value, 1);
+    }
+    t_assert(vector_equal(standard, devector), "want equal");
+    t_assert(vector_hash(standard) == vector_hash(devector), "want same hash");
+    vector_t empty = vector_new(0, sizeof(int));
+    t_assert(!vector_equal(standard, empty), "want different lengths");
+    t_assert(vector_equal(empty, vector_new(0, sizeof(int))), "want empty vectors equal");
+    t_assert(!vector_equal(empty, vector_new(0, sizeof(char))), "want different element sizes");
+
+    // Vectors can be keys, through callbacks that hash their elements.
+    hashmap_t map = hashmap_new(sizeof(vector_t), sizeof(int), hash_vector_key, equal_vector_keys);
+    int value = 1;
+    hashmap_insert(&map, &standard, &value);
+    t_assert(!hashmap_insert(&map, &devector, &value), "want same key");
+    t_assert(hashmap_get(&map, &empty) == NULL, "want null");
+    int last = 0;
+    vector_remove(devector, 0, 1);
+    vector_push(&devector, &last, 1);
+    t_assert(!vector_equal(standard, devector), "want different elements");
+    t_assert(!hashmap_contains(&map, &devector), "want missing");
+    hashmap_delete(&map);
+
+    vector_delete(standard);
+    vector_delete(devector);
+    vector_delete(empty);
+}
@@ -0,0 +1,228 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <collectc.h>
+
+#include <stdio.h>
+
+#include "test.h"
+
+/** A deliberately poor hash, so that many keys share groups and control bytes. */
+static uint64_t hash_clustered(const void *key) {
+    return (*(const uint64_t *)key % 7) * 0x0101010101010101;
+}
+
+static bool equal_u64(const void *a, const void *b) {
+    return *(const uint64_t *)a == *(const uint64_t *)b;
+}
+
+typedef struct name {
+    char text[21];
+} name_t;
+
+void test_hashmap_ops(void) {
+    hashmap_t map = hashmap_new(sizeof(uint64_t), sizeof(uint32_t), NULL, NULL);
+    t_assert(hashmap_is_empty(&map), "got %zu", hashmap_len(&map));
+    t_assert(hashmap_capacity(&map) == 0, "got %zu", hashmap_capacity(&map));
+    uint64_t key = 1;
+    t_assert(hashmap_get(&map, &key) == NULL, "want null");
+    t_assert(!hashmap_remove(&map, &key, NULL), "want missing");
+
+    for (uint64_t i = 0; i < 1000; i++) {
+        key = i * 7919;
+        uint32_t value = (uint32_t)i;
+        t_assert(hashmap_insert(&map, &key, &value), "%llu: want new", (unsigned long long)key);
+    }
+    t_assert(hashmap_len(&map) == 1000, "got %zu", hashmap_len(&map));
+    t_assert(hashmap_capacity(&map) >= 1000, "got %zu", hashmap_capacity(&map));
+    for (uint64_t i = 0; i < 2000; i++) {
+        key = i * 7919;
+        const uint32_t *value = hashmap_get(&map, &key);
+        if (i < 1000) {
+            t_assert(value != NULL && *value == i, "%llu: want %llu", (unsigned long long)key, (unsigned long long)i);
+        } else {
+            t_assert(value == NULL, "%llu: want null", (unsigned long long)key);
+        }
+    }
+
+    // Replace values, and count with `get_or_insert`.
+    key = 7919;
+    uint32_t value = 42;
+    t_assert(!hashmap_insert(&map, &key, &value), "want replaced");
+    t_assert(*(const uint32_t *)hashmap_get(&map, &key) == 42, "got %u", *(const uint32_t *)hashmap_get(&map, &key));
+    bool inserted;
+    key = 3;
+    uint32_t *count = hashmap_get_or_insert(&map, &key, &inserted);
+    t_assert(inserted && *count == 0, "got %u", *count);
+    (*count)++;
+    count = hashmap_get_or_insert(&map, &key, &inserted);
+    t_assert(!inserted && *count == 1, "got %u", *count);
+
+    // Remove every other key.
+    for (uint64_t i = 0; i < 1000; i += 2) {
+        key = i * 7919;
+        t_assert(hashmap_remove(&map, &key, &value), "%llu: want removed", (unsigned long long)key);
+        t_assert(value == i, "got %u", value);
+        t_assert(!hashmap_contains(&map, &key), "%llu: want missing", (unsigned long long)key);
+    }
+    t_assert(hashmap_len(&map) == 501, "got %zu", hashmap_len(&map));
+
+    // Every remaining entry is visited once.
+    hashmap_iter_t iter = hashmap_iter_new(&map);
+    const void *entryKey;
+    void *entryValue;
+    size_t visited = 0;
+    while (hashmap_iter_next(&iter, &entryKey, &entryValue)) {
+        t_assert(hashmap_get(&map, entryKey) == entryValue, "want same value");
+        visited++;
+    }
+    t_assert(visited == 501, "got %zu", visited);
+
+    size_t capacity = hashmap_capacity(&map);
+    hashmap_shrink(&map);
+    t_assert(hashmap_capacity(&map) < capacity, "got %zu", hashmap_capacity(&map));
+    for (uint64_t i = 1; i < 1000; i += 2) {
+        key = i * 7919;
+        t_assert(hashmap_contains(&map, &key), "%llu: want present", (unsigned long long)key);
+    }
+    hashmap_reserve(&map, 10000);
+    t_assert(hashmap_capacity(&map) >= 10501, "got %zu", hashmap_capacity(&map));
+    key = 3;
+    t_assert(*(const uint32_t *)hashmap_get(&map, &key) == 1, "want 1");
+
+    hashmap_clear(&map);
+    t_assert(hashmap_is_empty(&map), "got %zu", hashmap_len(&map));
+    t_assert(!hashmap_contains(&map, &key), "want missing");
+    hashmap_shrink(&map);
+    t_assert(hashmap_capacity(&map) == 0, "got %zu", hashmap_capacity(&map));
+    hashmap_delete(&map);
+}
+
+void test_hashmap_collisions(void) {
+    // With a clustered hash, removals leave tombstones in long full runs,
+    // and inserts reuse them. Check against a plain array of flags.
+    hashmap_t map = hashmap_new(sizeof(uint64_t), sizeof(uint64_t), hash_clustered, equal_u64);
+    bool present[512] = {false};
+    size_t length = 0;
+    uint64_t state = 1;
+    for (size_t step = 0; step < 20000; step++) {
+        state = state * 6364136223846793005 + 1442695040888963407;
+        uint64_t key = (state >> 33) % 512;
+        uint64_t value = key * 3;
+        if ((state >> 20) % 3 == 0) {
+            bool removed = hashmap_remove(&map, &key, &value);
+            t_assert(removed == present[key], "step %zu: key %llu", step, (unsigned long long)key);
+            t_assert(!removed || value == key * 3, "got %llu", (unsigned long long)value);
+            length -= removed;
+            present[key] = false;
+        } else {
+            bool inserted = hashmap_insert(&map, &key, &value);
+            t_assert(inserted == !present[key], "step %zu: key %llu", step, (unsigned long long)key);
+            length += inserted;
+            present[key] = true;
+        }
+        t_assert(hashmap_len(&map) == length, "got %zu, want %zu", hashmap_len(&map), length);
+    }
+    for (uint64_t key = 0; key < 512; key++) {
+        t_assert(hashmap_contains(&map, &key) == present[key], "key %llu", (unsigned long long)key);
+    }
+    hashmap_delete(&map);
+
+    // Keys and values with odd sizes keep their bytes.
+    hashmap_t names = hashmap_new(sizeof(name_t), 3, NULL, NULL);
+    for (unsigned i = 0; i < 300; i++) {
+        name_t name = {{0}};
+        snprintf(name.text, sizeof(name.text), "name-%u", i);
+        unsigned char bytes[3] = {(unsigned char)i, (unsigned char)(i >> 8), 0x5a};
+        hashmap_insert(&names, &name, bytes);
+    }
+    for (unsigned i = 0; i < 300; i++) {
+        name_t name = {{0}};
+        snprintf(name.text, sizeof(name.text), "name-%u", i);
+        const unsigned char *bytes = hashmap_get(&names, &name);
+        t_assert(bytes != NULL && bytes[0] == (unsigned char)i && bytes[2] == 0x5a, "%s: want bytes", name.text);
+    }
+    hashmap_delete(&names);
+}
+
+void test_hashmap_incremental(void) {
+    // Mix inserts, removals, and lookups in an incremental map against an
+    // array of flags, so many of them land while entries are being moved.
+    hashmap_t map = hashmap_new_incremental(sizeof(uint64_t), sizeof(uint64_t), NULL, NULL);
+    static bool present[4096];
+    size_t length = 0;
+    uint64_t state = 3;
+    for (size_t step = 0; step < 30000; step++) {
+        state = state * 6364136223846793005 + 1442695040888963407;
+        // The key range widens as the test goes on, so the map keeps growing.
+        uint64_t key = (state >> 33) % (step / 8 + 16) % 4096;
+        uint64_t value = key * 5;
+        if ((state >> 20) % 4 == 0) {
+            bool removed = hashmap_remove(&map, &key, &value);
+            t_assert(removed == present[key], "step %zu: key %llu", step, (unsigned long long)key);
+            t_assert(!removed || value == key * 5, "got %llu", (unsigned long long)value);
+            length -= removed;
+            present[key] = false;
+        } else {
+            bool inserted = hashmap_insert(&map, &key, &value);
+            t_assert(inserted == !present[key], "step %zu: key %llu", step, (unsigned long long)key);
+            length += inserted;
+            present[key] = true;
+        }
+        t_assert(hashmap_len(&map) == length, "got %zu, want %zu", hashmap_len(&map), length);
+        t_assert(hashmap_capacity(&map) >= length, "got %zu", hashmap_capacity(&map));
+        uint64_t probe = (state >> 40) % 4096;
+        const uint64_t *found = hashmap_get(&map, &probe);
+        t_assert((found != NULL) == present[probe], "step %zu: key %llu", step, (unsigned long long)probe);
+        t_assert(found == NULL || *found == probe * 5, "got %llu", (unsigned long long)*found);
+    }
+
+    // Start a migration, then check that iteration visits both tables.
+    size_t capacity = hashmap_capacity(&map);
+    for (uint64_t key = 0; hashmap_capacity(&map) == capacity; key++) {
+        uint64_t value = key * 5;
+        length += hashmap_insert(&map, &key, &value);
+        present[key] = true;
+    }
+    hashmap_iter_t iter = hashmap_iter_new(&map);
+    const void *key;
+    void *value;
+    size_t visited = 0;
+    while (hashmap_iter_next(&iter, &key, &value)) {
+        t_assert(present[*(const uint64_t *)key], "key %llu", (unsigned long long)*(const uint64_t *)key);
+        t_assert(*(const uint64_t *)value == *(const uint64_t *)key * 5, "wrong value");
+        visited++;
+    }
+    t_assert(visited == length, "got %zu, want %zu", visited, length);
+
+    hashmap_reserve(&map, 10000);
+    t_assert(hashmap_capacity(&map) >= length + 10000, "got %zu", hashmap_capacity(&map));
+    hashmap_shrink(&map);
+    for (uint64_t k = 0; k < 4096; k++) {
+        t_assert(hashmap_contains(&map, &k) == present[k], "key %llu", (unsigned long long)k);
+    }
+    hashmap_clear(&map);
+    t_assert(hashmap_is_empty(&map), "got %zu", hashmap_len(&map));
+
+    // Grow through tables large enough that their slots are given back
+    // to the system during a migration, while looking up and removing
+    // entries that haven't moved yet.
+    for (uint64_t k = 0; k < 200000; k++) {
+        uint64_t v = k * 5;
+        hashmap_insert(&map, &k, &v);
+        uint64_t probe = (k * 7919) % (k + 1);
+        const uint64_t *found = hashmap_get(&map, &probe);
+        t_assert(probe % 3 == 1 || (found != NULL && *found == probe * 5), "key %llu", (unsigned long long)probe);
+        if (k % 3 == 1) {
+            t_assert(hashmap_remove(&map, &k, NULL), "key %llu", (unsigned long long)k);
+        }
+    }
+    t_assert(hashmap_len(&map) == 200000 - 66667, "got %zu", hashmap_len(&map));
+    for (uint64_t k = 0; k < 200000; k++) {
+        const uint64_t *found = hashmap_get(&map, &k);
+        t_assert((found != NULL) == (k % 3 != 1), "key %llu", (unsigned long long)k);
+        t_assert(found == NULL || *found == k * 5, "got %llu", (unsigned long long)*found);
+    }
+    hashmap_delete(&map);
+}
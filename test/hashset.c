@@ -0,0 +1,109 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <collectc.h>
+
+#include "test.h"
+
+/** Builds a set of the multiples of `step` below `limit`. */
+static hashset_t multiples(int step, int limit) {
+    hashset_t set = hashset_new(sizeof(int), NULL, NULL);
+    for (int i = 0; i < limit; i += step) {
+        hashset_insert(&set, &i);
+    }
+    return set;
+}
+
+void test_hashset_elements(void) {
+    hashset_t set = hashset_new(sizeof(int), NULL, NULL);
+    t_assert(hashset_is_empty(&set), "got %zu", hashset_len(&set));
+    t_assert(hashset_element_size(&set) == sizeof(int), "got %zu", hashset_element_size(&set));
+    for (int i = 0; i < 500; i++) {
+        int element = i % 250;
+        t_assert(hashset_insert(&set, &element) == (i < 250), "%d: wrong insert", i);
+    }
+    t_assert(hashset_len(&set) == 250, "got %zu", hashset_len(&set));
+    int element = 100;
+    t_assert(hashset_contains(&set, &element), "want 100");
+    t_assert(hashset_remove(&set, &element), "want removed");
+    t_assert(!hashset_remove(&set, &element), "want missing");
+    t_assert(!hashset_contains(&set, &element), "want missing");
+
+    // Round-trip through a vector with duplicates.
+    vector_t vec = vector_new(0, sizeof(int));
+    for (int i = 0; i < 3000; i++) {
+        int value = (i * 37) % 1000;
+        vector_push(&vec, &value, 1);
+    }
+    hashset_t unique = hashset_from_vector(vec, NULL, NULL);
+    t_assert(hashset_len(&unique) == 1000, "got %zu", hashset_len(&unique));
+    t_assert(hashset_capacity(&unique) >= 3000, "got %zu", hashset_capacity(&unique));
+    vector_t exported = hashset_to_vector(&unique);
+    t_assert(vector_len(exported) == 1000, "got %zu", vector_len(exported));
+    t_assert(vector_capacity(exported) == 1000, "got %zu", vector_capacity(exported));
+    bool seen[1000] = {false};
+    for (size_t i = 0; i < vector_len(exported); i++) {
+        int value = *(const int *)vector_at(exported, i);
+        t_assert(value >= 0 && value < 1000 && !seen[value], "got %d", value);
+        seen[value] = true;
+    }
+
+    size_t visited = 0;
+    hashset_iter_t iter = hashset_iter_new(&unique);
+    const void *item;
+    while (hashset_iter_next(&iter, &item)) {
+        t_assert(hashset_contains(&unique, item), "want element");
+        visited++;
+    }
+    t_assert(visited == 1000, "got %zu", visited);
+
+    hashset_clear(&unique);
+    t_assert(hashset_is_empty(&unique), "got %zu", hashset_len(&unique));
+    hashset_shrink(&unique);
+    t_assert(hashset_capacity(&unique) == 0, "got %zu", hashset_capacity(&unique));
+
+    vector_delete(exported);
+    vector_delete(vec);
+    hashset_delete(&unique);
+    hashset_delete(&set);
+}
+
+void test_hashset_bulk(void) {
+    // Multiples of 2 and 3 below 600: 300 and 200, with 100 in common.
+    hashset_t twos = multiples(2, 600);
+    hashset_t threes = multiples(3, 600);
+
+    hashset_t both = multiples(2, 600);
+    hashset_union(&both, &threes);
+    t_assert(hashset_len(&both) == 400, "got %zu", hashset_len(&both));
+
+    hashset_t common = multiples(2, 600);
+    hashset_intersection(&common, &threes);
+    t_assert(hashset_len(&common) == 100, "got %zu", hashset_len(&common));
+    for (int i = 0; i < 600; i++) {
+        t_assert(hashset_contains(&common, &i) == (i % 6 == 0), "%d: wrong membership", i);
+    }
+
+    hashset_t onlyTwos = multiples(2, 600);
+    hashset_difference(&onlyTwos, &threes);
+    t_assert(hashset_len(&onlyTwos) == 200, "got %zu", hashset_len(&onlyTwos));
+    for (int i = 0; i < 600; i++) {
+        bool want = i % 2 == 0 && i % 3 != 0;
+        t_assert(hashset_contains(&onlyTwos, &i) == want, "%d: wrong membership", i);
+    }
+
+    // A set combined with itself.
+    hashset_union(&twos, &twos);
+    t_assert(hashset_len(&twos) == 300, "got %zu", hashset_len(&twos));
+    hashset_intersection(&twos, &twos);
+    t_assert(hashset_len(&twos) == 300, "got %zu", hashset_len(&twos));
+    hashset_difference(&twos, &twos);
+    t_assert(hashset_is_empty(&twos), "got %zu", hashset_len(&twos));
+
+    hashset_delete(&onlyTwos);
+    hashset_delete(&common);
+    hashset_delete(&both);
+    hashset_delete(&threes);
+    hashset_delete(&twos);
+}
@@ -0,0 +1,92 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <collectc.h>
+
+#include "test.h"
+
+static int compare_ints(const void *a, const void *b) {
+    int x = *(const int *)a;
+    int y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+static int compare_u64_descending(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x < y) - (x > y);
+}
+
+void test_heap_order(void) {
+    static const size_t ARITIES[] = {2, 4};
+    for (size_t a = 0; a < 2; a++) {
+        heap_t heap = heap_new(sizeof(int), ARITIES[a], compare_ints);
+        t_assert(heap_is_empty(&heap), "got %zu", heap_len(&heap));
+        t_assert(heap_peek(&heap) == NULL, "want null");
+        t_assert(!heap_pop(&heap, NULL), "want empty");
+
+        // Push a scrambled sequence with duplicates.
+        for (int i = 0; i < 1000; i++) {
+            int value = (i * 7919) % 500;
+            heap_push(&heap, &value);
+        }
+        t_assert(heap_len(&heap) == 1000, "got %zu", heap_len(&heap));
+        t_assert(*(const int *)heap_peek(&heap) == 0, "got %d", *(const int *)heap_peek(&heap));
+
+        // Interleave pops with pushes of larger values.
+        int previous = -1;
+        for (int i = 0; i < 1000; i++) {
+            int value;
+            t_assert(heap_pop(&heap, &value), "want element");
+            t_assert(value >= previous, "arity %zu: got %d after %d", ARITIES[a], value, previous);
+            previous = value;
+            if (i % 10 == 0) {
+                int larger = 500 + i;
+                heap_push(&heap, &larger);
+            }
+        }
+        t_assert(heap_len(&heap) == 100, "got %zu", heap_len(&heap));
+        heap_clear(&heap);
+        t_assert(heap_is_empty(&heap), "got %zu", heap_len(&heap));
+        heap_delete(&heap);
+    }
+}
+
+void test_heap_from_vector(void) {
+    static const size_t ARITIES[] = {2, 4};
+    for (size_t a = 0; a < 2; a++) {
+        for (int length = 0; length < 40; length++) {
+            vector_t vec = vector_new(0, sizeof(int));
+            for (int i = 0; i < length; i++) {
+                int value = (i * 37 + length) % 23;
+                vector_push(&vec, &value, 1);
+            }
+            heap_t heap = heap_from_vector(vec, ARITIES[a], compare_ints);
+            t_assert(heap_len(&heap) == (size_t)length, "got %zu", heap_len(&heap));
+            int previous = -1;
+            int value;
+            while (heap_pop(&heap, &value)) {
+                t_assert(value >= previous, "length %d: got %d after %d", length, value, previous);
+                previous = value;
+            }
+            heap_delete(&heap);
+        }
+    }
+
+    // An incremental vector is heapified across both of its allocations,
+    // and stays usable as the heap grows it again.
+    vector_t vec = t_moving_vector(100000);
+    size_t length = vector_len(vec);
+    size_t capacity = vector_capacity(vec);
+    heap_t heap = heap_from_vector(vec, 4, compare_u64_descending);
+    uint64_t value = length * 3;
+    while (vector_capacity(heap.elements) == capacity) {
+        heap_push(&heap, &value);
+        value += 3;
+    }
+    for (uint64_t want = value - 3; heap_pop(&heap, &value); want -= 3) {
+        t_assert(value == want, "got %llu; want %llu", (unsigned long long)value, (unsigned long long)want);
+    }
+    heap_delete(&heap);
+}
@@ -0,0 +1,71 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <collectc.h>
+
+#include "test.h"
+
+static int compare_doubles(const void *a, const void *b) {
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+void test_indexed_heap_keys(void) {
+    static const size_t ARITIES[] = {2, 4};
+    for (size_t a = 0; a < 2; a++) {
+        indexed_heap_t heap = indexed_heap_new(sizeof(double), ARITIES[a], compare_doubles);
+        size_t id;
+        t_assert(indexed_heap_peek(&heap, &id) == NULL, "want empty");
+        t_assert(!indexed_heap_contains(&heap, 3), "want not contained");
+
+        // Ids don't need to be pushed in order.
+        for (size_t i = 0; i < 200; i++) {
+            size_t itemId = (i * 7) % 200;
+            double key = (double)((i * 37) % 101);
+            indexed_heap_push(&heap, itemId, &key);
+        }
+        t_assert(indexed_heap_len(&heap) == 200, "got %zu", indexed_heap_len(&heap));
+        {
+            const double *seventh = indexed_heap_key(&heap, 7);
+            t_assert(*seventh == 37, "got %f", *seventh);
+        }
+
+        // Move some items to the top, some to the bottom, and remove others.
+        double key = -1;
+        indexed_heap_decrease_key(&heap, 151, &key);
+        t_assert(*(const double *)indexed_heap_peek(&heap, &id) == -1, "want the decreased key on top");
+        t_assert(id == 151, "got %zu", id);
+        key = 1000;
+        indexed_heap_increase_key(&heap, 151, &key);
+        for (size_t i = 0; i < 200; i += 3) {
+            t_assert(indexed_heap_remove(&heap, i, NULL), "want %zu removed", i);
+        }
+        t_assert(!indexed_heap_remove(&heap, 0, NULL), "want already removed");
+        t_assert(!indexed_heap_contains(&heap, 3), "want not contained");
+        t_assert(indexed_heap_len(&heap) == 133, "got %zu", indexed_heap_len(&heap));
+
+        // Pop everything, checking order and the final key of item 151.
+        double previous = -1;
+        size_t popped = 0;
+        while (indexed_heap_pop(&heap, &id, &key)) {
+            t_assert(key >= previous, "arity %zu: got %f after %f", ARITIES[a], key, previous);
+            t_assert(id % 3 != 0, "got removed item %zu", id);
+            t_assert(!indexed_heap_contains(&heap, id), "want %zu gone", id);
+            previous = key;
+            popped++;
+        }
+        t_assert(popped == 133, "got %zu", popped);
+        t_assert(id == 151 && key == 1000, "got %zu with %f", id, key);
+
+        // Items can return after they're popped or cleared.
+        indexed_heap_push(&heap, 151, &key);
+        indexed_heap_clear(&heap);
+        t_assert(!indexed_heap_contains(&heap, 151), "want cleared");
+        indexed_heap_push(&heap, 151, &key);
+        t_assert(indexed_heap_len(&heap) == 1, "got %zu", indexed_heap_len(&heap));
+
+        indexed_heap_delete(&heap);
+    }
+}
@@ -0,0 +1,138 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <collectc.h>
+
+#include "test.h"
+
+/** A hash with only 8 distinct values, so most keys collide. */
+static uint64_t colliding_hash(const void *key) {
+    return (*(const uint32_t *)key % 8) * 0x9e3779b97f4a7c15;
+}
+
+/** Checks that the map holds exactly `keys[0..length)`, in order, each with the value `~key`. */
+static void check_order(const indexmap_t *map, const uint32_t *keys, size_t length) {
+    t_assert(indexmap_len(map) == length, "got %zu, want %zu", indexmap_len(map), length);
+    indexmap_iter_t iter = indexmap_iter_new(map);
+    const void *key;
+    void *value;
+    for (size_t i = 0; i < length; i++) {
+        t_assert(indexmap_iter_next(&iter, &key, &value), "%zu: want entry", i);
+        t_assert(*(const uint32_t *)key == keys[i], "%zu: got %u, want %u", i, *(const uint32_t *)key, keys[i]);
+        t_assert(*(const uint32_t *)value == ~keys[i], "%zu: wrong value", i);
+        t_assert(indexmap_index_of(map, &keys[i]) == i, "%zu: got %zu", i, indexmap_index_of(map, &keys[i]));
+    }
+    t_assert(!indexmap_iter_next(&iter, &key, &value), "want end");
+}
+
+void test_indexmap_order(void) {
+    indexmap_t map = indexmap_new(sizeof(uint32_t), sizeof(uint32_t), NULL, NULL);
+    t_assert(indexmap_is_empty(&map), "got %zu", indexmap_len(&map));
+    uint32_t missing = 12345;
+    t_assert(indexmap_get(&map, &missing) == NULL, "want null");
+    t_assert(indexmap_key_at(&map, 0) == NULL, "want null");
+
+    uint32_t keys[100];
+    for (uint32_t i = 0; i < 100; i++) {
+        keys[i] = i * 7919 + 3;
+        uint32_t value = ~keys[i];
+        t_assert(indexmap_insert(&map, &keys[i], &value), "%u: want new", i);
+    }
+    check_order(&map, keys, 100);
+    t_assert(indexmap_capacity(&map) >= 100, "got %zu", indexmap_capacity(&map));
+    t_assert(*(const uint32_t *)indexmap_key_at(&map, 42) == keys[42], "wrong key at 42");
+    t_assert(*(const uint32_t *)indexmap_value_at(&map, 42) == ~keys[42], "wrong value at 42");
+    t_assert(indexmap_value_at(&map, 100) == NULL, "want null");
+
+    // Replacing a value keeps its position.
+    uint32_t value = 0;
+    t_assert(!indexmap_insert(&map, &keys[10], &value), "want replaced");
+    t_assert(indexmap_index_of(&map, &keys[10]) == 10, "got %zu", indexmap_index_of(&map, &keys[10]));
+    *(uint32_t *)indexmap_value_at_mut(&map, 10) = ~keys[10];
+
+    // Swap removal moves the last entry into the hole.
+    t_assert(indexmap_swap_remove(&map, &keys[5], &value) && value == ~keys[5], "got %u", value);
+    t_assert(!indexmap_swap_remove(&map, &keys[5], NULL), "want missing");
+    keys[5] = keys[99];
+    check_order(&map, keys, 99);
+
+    // Ordered removal shifts the later entries down, both near the end,
+    // where each moved entry's slot is found by probing, and near the
+    // start, where every slot is renumbered.
+    static const size_t REMOVALS[] = {97, 90, 30, 1};
+    for (size_t r = 0; r < sizeof(REMOVALS) / sizeof(REMOVALS[0]); r++) {
+        size_t index = REMOVALS[r];
+        t_assert(indexmap_remove(&map, &keys[index], &value) && value == ~keys[index], "%zu: got %u", index, value);
+        size_t length = indexmap_len(&map);
+        for (size_t i = index; i < length; i++) {
+            keys[i] = keys[i + 1];
+        }
+        check_order(&map, keys, length);
+    }
+
+    bool inserted;
+    uint32_t key = 7;
+    uint32_t *slot = indexmap_get_or_insert(&map, &key, &inserted);
+    t_assert(inserted && *slot == 0, "got %u", *slot);
+    t_assert(indexmap_index_of(&map, &key) == indexmap_len(&map) - 1, "want last");
+    t_assert(!indexmap_remove(&map, &missing, NULL), "want missing");
+
+    indexmap_reserve(&map, 1000);
+    t_assert(indexmap_capacity(&map) >= indexmap_len(&map) + 1000, "got %zu", indexmap_capacity(&map));
+    t_assert(indexmap_contains(&map, &keys[0]), "want key");
+    indexmap_clear(&map);
+    t_assert(indexmap_is_empty(&map), "got %zu", indexmap_len(&map));
+    t_assert(!indexmap_contains(&map, &keys[0]), "want missing");
+    indexmap_delete(&map);
+}
+
+void test_indexmap_collisions(void) {
+    // Random inserts and both kinds of removal against a plain array,
+    // with keys that collide, so probes and backward shifts cross long runs.
+    indexmap_t map = indexmap_new(sizeof(uint32_t), sizeof(uint32_t), colliding_hash, NULL);
+    uint32_t keys[300];
+    size_t length = 0;
+    uint64_t state = 11;
+    for (size_t step = 0; step < 6000; step++) {
+        state = state * 6364136223846793005 + 1442695040888963407;
+        uint32_t key = (uint32_t)((state >> 33) % 300);
+        size_t index = indexmap_index_of(&map, &key);
+        size_t want = SIZE_MAX;
+        for (size_t i = 0; i < length; i++) {
+            if (keys[i] == key) {
+                want = i;
+            }
+        }
+        t_assert(index == want, "step %zu: got %zu, want %zu", step, index, want);
+        unsigned action = (unsigned)((state >> 20) % 4);
+        if (action < 2) {
+            uint32_t value = ~key;
+            t_assert(indexmap_insert(&map, &key, &value) == (want == SIZE_MAX), "step %zu", step);
+            if (want == SIZE_MAX) {
+                keys[length++] = key;
+            }
+        } else if (want != SIZE_MAX && action == 2) {
+            t_assert(indexmap_swap_remove(&map, &key, NULL), "step %zu", step);
+            keys[want] = keys[--length];
+        } else if (want != SIZE_MAX) {
+            t_assert(indexmap_remove(&map, &key, NULL), "step %zu", step);
+            for (size_t i = want; i + 1 < length; i++) {
+                keys[i] = keys[i + 1];
+            }
+            length--;
+        }
+    }
+    check_order(&map, keys, length);
+    indexmap_delete(&map);
+
+    // Maps with empty values work as ordered sets.
+    indexmap_t set = indexmap_new(sizeof(uint64_t), 0, NULL, NULL);
+    for (uint64_t i = 0; i < 100; i++) {
+        uint64_t element = 9 - (i % 10);
+        indexmap_insert(&set, &element, NULL);
+    }
+    t_assert(indexmap_len(&set) == 10, "got %zu", indexmap_len(&set));
+    t_assert(*(const uint64_t *)indexmap_key_at(&set, 0) == 9, "want 9 first");
+    indexmap_delete(&set);
+}
@@ -6,12 +6,102 @@ extern void test_vector_mutation(void);
 extern void test_vector_slice(void);
 extern void test_vector_iteration(void);
 extern void test_vector_nops(void);
+extern void test_vector_compact(void);
+extern void test_vector_devector(void);
+extern void test_vector_incremental(void);
+extern void test_ragged_vector_rows(void);
+extern void test_ragged_vector_compact(void);
+extern void test_ragged_vector_incremental(void);
+extern void test_soa_vector_columns(void);
+extern void test_bitvec_bits(void);
+extern void test_bitvec_rank_select(void);
+extern void test_packed_int_vector_access(void);
+extern void test_packed_int_vector_widen(void);
+extern void test_delta_vector_roundtrip(void);
+extern void test_delta_vector_lower_bound(void);
+extern void test_gap_buffer_editing(void);
+extern void test_gap_buffer_growth(void);
+extern void test_rope_edits(void);
+extern void test_rope_split_concat(void);
+extern void test_rope_chunk_fill(void);
+extern void test_deque_ends(void);
+extern void test_deque_wrap(void);
+extern void test_spsc_queue_batches(void);
+extern void test_spsc_queue_threads(void);
+extern void test_mpmc_queue_batches(void);
+extern void test_mpmc_queue_threads(void);
+extern void test_work_deque_ends(void);
+extern void test_work_deque_threads(void);
+extern void test_work_deque_grow(void);
+extern void test_heap_order(void);
+extern void test_heap_from_vector(void);
+extern void test_indexed_heap_keys(void);
+extern void test_radix_heap_order(void);
+extern void test_radix_heap_keys_only(void);
+extern void test_hashmap_ops(void);
+extern void test_hashmap_collisions(void);
+extern void test_hashmap_incremental(void);
+extern void test_hashset_elements(void);
+extern void test_hashset_bulk(void);
+extern void test_u64map_ops(void);
+extern void test_u64map_removal(void);
+extern void test_hash_bytes(void);
+extern void test_hash_vector(void);
+extern void test_indexmap_order(void);
+extern void test_indexmap_collisions(void);
+extern void test_concurrent_hashmap_single(void);
+extern void test_concurrent_hashmap_threads(void);
 
 int main(int argc, char **argv) {
     test_vector_mutation();
     test_vector_slice();
     test_vector_iteration();
     test_vector_nops();
+    test_vector_compact();
+    test_vector_devector();
+    test_vector_incremental();
+    test_ragged_vector_rows();
+    test_ragged_vector_compact();
+    test_ragged_vector_incremental();
+    test_soa_vector_columns();
+    test_bitvec_bits();
+    test_bitvec_rank_select();
+    test_packed_int_vector_access();
+    test_packed_int_vector_widen();
+    test_delta_vector_roundtrip();
+    test_delta_vector_lower_bound();
+    test_gap_buffer_editing();
+    test_gap_buffer_growth();
+    test_rope_edits();
+    test_rope_split_concat();
+    test_rope_chunk_fill();
+    test_deque_ends();
+    test_deque_wrap();
+    test_spsc_queue_batches();
+    test_spsc_queue_threads();
+    test_mpmc_queue_batches();
+    test_mpmc_queue_threads();
+    test_work_deque_ends();
+    test_work_deque_threads();
+    test_work_deque_grow();
+    test_heap_order();
+    test_heap_from_vector();
+    test_indexed_heap_keys();
+    test_radix_heap_order();
+    test_radix_heap_keys_only();
+    test_hashmap_ops();
+    test_hashmap_collisions();
+    test_hashmap_incremental();
+    test_hashset_elements();
+    test_hashset_bulk();
+    test_u64map_ops();
+    test_u64map_removal();
+    test_hash_bytes();
+    test_hash_vector();
+    test_indexmap_order();
+    test_indexmap_collisions();
+    test_concurrent_hashmap_single();
+    test_concurrent_hashmap_threads();
 
     return 0;
 }
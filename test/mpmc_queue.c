@@ -0,0 +1,122 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdbool.h>
+
+#include <collectc.h>
+
+#include "test.h"
+
+void test_mpmc_queue_batches(void) {
+    mpmc_queue_t *queue = mpmc_queue_new(1, sizeof(short));
+    t_assert(mpmc_queue_capacity(queue) == 2, "got %zu", mpmc_queue_capacity(queue));
+    mpmc_queue_delete(queue);
+
+    queue = mpmc_queue_new(6, sizeof(short));
+    t_assert(mpmc_queue_capacity(queue) == 8, "got %zu", mpmc_queue_capacity(queue));
+    t_assert(mpmc_queue_element_size(queue) == sizeof(short), "got %zu", mpmc_queue_element_size(queue));
+
+    short values[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    short popped[10];
+    t_assert(mpmc_queue_try_pop(queue, popped, 4) == 0, "want empty");
+    t_assert(mpmc_queue_try_push(queue, values, 0) == 0, "want nothing pushed");
+    t_assert(mpmc_queue_try_push(queue, values, 10) == 8, "want a partial push");
+    t_assert(mpmc_queue_len(queue) == 8, "got %zu", mpmc_queue_len(queue));
+    t_assert(mpmc_queue_try_push(queue, values, 1) == 0, "want full");
+
+    // Free some slots, then push a batch that wraps around.
+    t_assert(mpmc_queue_try_pop(queue, popped, 6) == 6, "want 6 popped");
+    mpmc_queue_push(queue, &values[8], 2);
+    size_t count = mpmc_queue_pop(queue, popped, 10);
+    t_assert(count == 4, "got %zu", count);
+    short expected[4] = {6, 7, 8, 9};
+    for (size_t i = 0; i < count; i++) {
+        t_assert(popped[i] == expected[i], "at %zu: got %d; want %d", i, popped[i], expected[i]);
+    }
+    t_assert(mpmc_queue_len(queue) == 0, "got %zu", mpmc_queue_len(queue));
+
+    mpmc_queue_delete(queue);
+}
+
+#define THREAD_COUNT 4
+#define PER_PRODUCER 100000
+
+typedef struct mpmc_test_context {
+    mpmc_queue_t *queue;
+    unsigned id;
+    /** How many of each producer's elements this consumer saw. */
+    unsigned seen[THREAD_COUNT];
+    bool inOrder;
+    size_t received;
+} mpmc_test_context_t;
+
+static void *mpmc_queue_produce(void *context) {
+    mpmc_test_context_t *producer = context;
+    unsigned batch[8];
+    for (unsigned i = 0; i < PER_PRODUCER; i += 8) {
+        for (unsigned j = 0; j < 8; j++) {
+            batch[j] = (producer->id << 24) | (i + j);
+        }
+        mpmc_queue_push(producer->queue, batch, i + 8 <= PER_PRODUCER ? 8 : PER_PRODUCER - i);
+    }
+    return NULL;
+}
+
+static void *mpmc_queue_consume(void *context) {
+    mpmc_test_context_t *consumer = context;
+    unsigned batch[5];
+    for (;;) {
+        size_t count = mpmc_queue_pop(consumer->queue, batch, 5);
+        for (size_t i = 0; i < count; i++) {
+            if (batch[i] == UINT32_MAX) {
+                // Leave any other stop markers for the other consumers.
+                mpmc_queue_push(consumer->queue, &batch[i + 1], count - i - 1);
+                return NULL;
+            }
+            consumer->received++;
+            // Each producer's elements arrive in order at each consumer.
+            unsigned producer = batch[i] >> 24;
+            unsigned sequence = batch[i] & 0xffffff;
+            if (sequence < consumer->seen[producer]) {
+                consumer->inOrder = false;
+            }
+            consumer->seen[producer] = sequence + 1;
+        }
+    }
+}
+
+void test_mpmc_queue_threads(void) {
+    mpmc_queue_t *queue = mpmc_queue_new(64, sizeof(unsigned));
+    mpmc_test_context_t producers[THREAD_COUNT];
+    mpmc_test_context_t consumers[THREAD_COUNT];
+    pthread_t producerThreads[THREAD_COUNT];
+    pthread_t consumerThreads[THREAD_COUNT];
+    for (unsigned i = 0; i < THREAD_COUNT; i++) {
+        producers[i] = (mpmc_test_context_t){.queue = queue, .id = i};
+        consumers[i] = (mpmc_test_context_t){.queue = queue, .id = i, .inOrder = true};
+        t_assert(pthread_create(&consumerThreads[i], NULL, mpmc_queue_consume, &consumers[i]) == 0, "want thread");
+        t_assert(pthread_create(&producerThreads[i], NULL, mpmc_queue_produce, &producers[i]) == 0, "want thread");
+    }
+    for (unsigned i = 0; i < THREAD_COUNT; i++) {
+        pthread_join(producerThreads[i], NULL);
+    }
+
+    // Stop each consumer, which must have been waiting for more elements.
+    unsigned stop = UINT32_MAX;
+    for (unsigned i = 0; i < THREAD_COUNT; i++) {
+        mpmc_queue_push(queue, &stop, 1);
+    }
+    size_t received = 0;
+    for (unsigned i = 0; i < THREAD_COUNT; i++) {
+        pthread_join(consumerThreads[i], NULL);
+        t_assert(consumers[i].inOrder, "consumer %u saw elements out of order", i);
+        received += consumers[i].received;
+    }
+    t_assert(received == THREAD_COUNT * PER_PRODUCER, "got %zu", received);
+    t_assert(mpmc_queue_len(queue) == 0, "got %zu", mpmc_queue_len(queue));
+    mpmc_queue_delete(queue);
+}
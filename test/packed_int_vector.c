@@ -0,0 +1,76 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <collectc.h>
+
+#include "test.h"
+
+void test_packed_int_vector_access(void) {
+    packed_int_vector_t pv = packed_int_vector_new(0, 20);
+    for (uint64_t i = 0; i < 1000; i++) {
+        uint64_t value = (i * 7919) % (1 << 20);
+        packed_int_vector_push(&pv, &value, 1);
+    }
+    t_assert(packed_int_vector_len(&pv) == 1000, "got %zu", packed_int_vector_len(&pv));
+    t_assert(packed_int_vector_width(&pv) == 20, "got %u", packed_int_vector_width(&pv));
+    for (uint64_t i = 0; i < 1000; i++) {
+        uint64_t value = packed_int_vector_get(&pv, i);
+        t_assert(value == (i * 7919) % (1 << 20), "at %llu: got %llu", (unsigned long long)i, (unsigned long long)value);
+    }
+
+    packed_int_vector_set(&pv, 500, 3);
+    t_assert(packed_int_vector_get(&pv, 500) == 3, "got %llu", (unsigned long long)packed_int_vector_get(&pv, 500));
+    t_assert(packed_int_vector_get(&pv, 499) == (499 * 7919) % (1 << 20), "neighbor changed");
+    t_assert(packed_int_vector_get(&pv, 501) == (501 * 7919) % (1 << 20), "neighbor changed");
+
+    {
+        uint64_t decoded[997];
+        packed_int_vector_decode(&pv, 3, decoded, 997);
+        for (uint64_t i = 0; i < 997; i++) {
+            uint64_t expected = i + 3 == 500 ? 3 : ((i + 3) * 7919) % (1 << 20);
+            t_assert(decoded[i] == expected, "at %llu: got %llu", (unsigned long long)i, (unsigned long long)decoded[i]);
+        }
+    }
+
+    packed_int_vector_delete(&pv);
+
+    // Incremental vectors are copied from both of their allocations.
+    vector_t vec = t_moving_vector(100000);
+    pv = packed_int_vector_new(0, 20);
+    packed_int_vector_extend(&pv, vec);
+    t_assert(packed_int_vector_len(&pv) == vector_len(vec), "got %zu", packed_int_vector_len(&pv));
+    for (size_t i = 0; i < vector_len(vec); i++) {
+        uint64_t value = packed_int_vector_get(&pv, i);
+        t_assert(value == (i * 3) % (1 << 20), "at %zu: got %llu", i, (unsigned long long)value);
+    }
+    vector_delete(vec);
+    packed_int_vector_delete(&pv);
+}
+
+void test_packed_int_vector_widen(void) {
+    packed_int_vector_t pv = packed_int_vector_new(4, 3);
+    uint64_t small[4] = {1, 7, 0, 5};
+    packed_int_vector_push(&pv, small, 4);
+    t_assert(packed_int_vector_width(&pv) == 3, "got %u", packed_int_vector_width(&pv));
+
+    vector_t wide = vector_new(0, sizeof(uint64_t));
+    uint64_t values[3] = {1 << 12, UINT64_MAX, 9};
+    vector_push(&wide, values, 3);
+    packed_int_vector_extend(&pv, wide);
+    t_assert(packed_int_vector_width(&pv) == 64, "got %u", packed_int_vector_width(&pv));
+
+    uint64_t expected[7] = {1, 7, 0, 5, 1 << 12, UINT64_MAX, 9};
+    uint64_t decoded[7];
+    packed_int_vector_decode(&pv, 0, decoded, 7);
+    for (size_t i = 0; i < 7; i++) {
+        t_assert(decoded[i] == expected[i], "at %zu: got %llu", i, (unsigned long long)decoded[i]);
+    }
+
+    packed_int_vector_clear(&pv);
+    packed_int_vector_push(&pv, small, 4);
+    t_assert(packed_int_vector_get(&pv, 3) == 5, "got %llu", (unsigned long long)packed_int_vector_get(&pv, 3));
+
+    vector_delete(wide);
+    packed_int_vector_delete(&pv);
+}
@@ -0,0 +1,103 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <collectc.h>
+
+#include "test.h"
+
+void test_radix_heap_order(void) {
+    radix_heap_t heap = radix_heap_new(sizeof(uint64_t));
+    t_assert(radix_heap_is_empty(&heap), "got %zu", radix_heap_len(&heap));
+    t_assert(radix_heap_value_size(&heap) == sizeof(uint64_t), "got %zu", radix_heap_value_size(&heap));
+    uint64_t key;
+    t_assert(!radix_heap_peek(&heap, &key), "want empty");
+    t_assert(!radix_heap_pop(&heap, NULL, NULL), "want empty");
+
+    // Push scrambled keys with duplicates, and interleave pops with
+    // pushes that never go below the last popped key. Each value is
+    // derived from its key, so mixed-up entries are caught.
+    uint64_t pushedSum = 0;
+    for (uint64_t i = 0; i < 1000; i++) {
+        uint64_t k = (i * 7919) % 500;
+        uint64_t value = k * 3;
+        radix_heap_push(&heap, k, &value);
+        pushedSum += k;
+    }
+    t_assert(radix_heap_len(&heap) == 1000, "got %zu", radix_heap_len(&heap));
+    t_assert(radix_heap_peek(&heap, &key) && key == 0, "got %llu", (unsigned long long)key);
+
+    uint64_t previous = 0;
+    uint64_t poppedSum = 0;
+    size_t popped = 0;
+    uint64_t value;
+    while (radix_heap_pop(&heap, &key, &value)) {
+        t_assert(key >= previous, "got %llu after %llu", (unsigned long long)key, (unsigned long long)previous);
+        t_assert(value == key * 3, "key %llu: got %llu", (unsigned long long)key, (unsigned long long)value);
+        t_assert(radix_heap_last(&heap) == key, "got %llu", (unsigned long long)radix_heap_last(&heap));
+        previous = key;
+        poppedSum += key;
+        popped++;
+        if (popped % 7 == 0 && popped < 3000) {
+            uint64_t k = key + (popped % 3 == 0 ? 0 : (popped * 2654435761u) % 100000);
+            value = k * 3;
+            radix_heap_push(&heap, k, &value);
+            pushedSum += k;
+        }
+    }
+    t_assert(
+        poppedSum == pushedSum,
+        "got %llu, want %llu",
+        (unsigned long long)poppedSum,
+        (unsigned long long)pushedSum
+    );
+    t_assert(radix_heap_is_empty(&heap), "got %zu", radix_heap_len(&heap));
+
+    // Keys that differ in their highest bit use the last bucket.
+    uint64_t keys[] = {UINT64_MAX, (uint64_t)1 << 63, previous, UINT64_MAX - 1};
+    for (size_t i = 0; i < 4; i++) {
+        value = keys[i] * 3;
+        radix_heap_push(&heap, keys[i], &value);
+    }
+    uint64_t want[] = {previous, (uint64_t)1 << 63, UINT64_MAX - 1, UINT64_MAX};
+    for (size_t i = 0; i < 4; i++) {
+        t_assert(radix_heap_pop(&heap, &key, &value), "want entry");
+        t_assert(key == want[i], "%zu: got %llu", i, (unsigned long long)key);
+        t_assert(value == key * 3, "key %llu: got %llu", (unsigned long long)key, (unsigned long long)value);
+    }
+
+    // Peeking doesn't raise the smallest key that can be pushed.
+    radix_heap_clear(&heap);
+    radix_heap_push(&heap, 5, &value);
+    t_assert(radix_heap_pop(&heap, &key, NULL) && key == 5, "got %llu", (unsigned long long)key);
+    radix_heap_push(&heap, 100, &value);
+    t_assert(radix_heap_peek(&heap, &key) && key == 100, "got %llu", (unsigned long long)key);
+    t_assert(radix_heap_last(&heap) == 5, "got %llu", (unsigned long long)radix_heap_last(&heap));
+    radix_heap_push(&heap, 50, &value);
+    t_assert(radix_heap_peek(&heap, &key) && key == 50, "got %llu", (unsigned long long)key);
+    t_assert(radix_heap_pop(&heap, &key, NULL) && key == 50, "got %llu", (unsigned long long)key);
+    t_assert(radix_heap_pop(&heap, &key, NULL) && key == 100, "got %llu", (unsigned long long)key);
+
+    radix_heap_push(&heap, UINT64_MAX, &value);
+    radix_heap_clear(&heap);
+    t_assert(radix_heap_is_empty(&heap), "got %zu", radix_heap_len(&heap));
+    t_assert(radix_heap_last(&heap) == 0, "got %llu", (unsigned long long)radix_heap_last(&heap));
+    radix_heap_delete(&heap);
+}
+
+void test_radix_heap_keys_only(void) {
+    radix_heap_t heap = radix_heap_new(0);
+    for (uint64_t i = 0; i < 200; i++) {
+        radix_heap_push(&heap, (i * 37) % 64, NULL);
+    }
+    uint64_t previous = 0;
+    uint64_t key;
+    size_t count = 0;
+    while (radix_heap_pop(&heap, &key, NULL)) {
+        t_assert(key >= previous, "got %llu after %llu", (unsigned long long)key, (unsigned long long)previous);
+        previous = key;
+        count++;
+    }
+    t_assert(count == 200, "got %zu", count);
+    radix_heap_delete(&heap);
+}
@@ -0,0 +1,143 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <collectc.h>
+
+#include "test.h"
+
+static void t_assert_row(const ragged_vector_t *rv, size_t row, const int *expected, size_t expectedLength) {
+    size_t length;
+    const int *actual = ragged_vector_row(rv, row, &length);
+    t_assert(length == expectedLength, "row %zu: got %zu; want %zu", row, length, expectedLength);
+    for (size_t i = 0; i < length; i++) {
+        t_assert(actual[i] == expected[i], "row %zu at %zu: got %d; want %d", row, i, actual[i], expected[i]);
+    }
+}
+
+void test_ragged_vector_rows(void) {
+    ragged_vector_t rv = ragged_vector_new(sizeof(int));
+    t_assert(ragged_vector_len(&rv) == 0, "got %zu", ragged_vector_len(&rv));
+
+    int first[3] = {1, 2, 3};
+    int second[1] = {4};
+    int third[4] = {5, 6, 7, 8};
+    ragged_vector_push_row(&rv, first, 3);
+    ragged_vector_push_row(&rv, NULL, 0);
+    ragged_vector_push_row(&rv, second, 1);
+    ragged_vector_push(&rv, third, 4);
+    t_assert(ragged_vector_len(&rv) == 3, "got %zu", ragged_vector_len(&rv));
+    t_assert(ragged_vector_values_len(&rv) == 8, "got %zu", ragged_vector_values_len(&rv));
+
+    {
+        size_t length;
+        t_assert(ragged_vector_row(&rv, 1, &length) == NULL, "want empty row");
+        t_assert(length == 0, "got %zu", length);
+        t_assert_row(&rv, 0, first, 3);
+        int expected[5] = {4, 5, 6, 7, 8};
+        t_assert_row(&rv, 2, expected, 5);
+    }
+
+    {
+        // Rows are stored back-to-back, so a full scan is one pass
+        // over the values.
+        const int *values = vector_first(ragged_vector_values(&rv));
+        for (int i = 0; i < 8; i++) {
+            t_assert(values[i] == i + 1, "at %d: got %d", i, values[i]);
+        }
+    }
+
+    ragged_vector_delete(&rv);
+}
+
+void test_ragged_vector_compact(void) {
+    ragged_vector_t rv = ragged_vector_new(sizeof(int));
+    for (int i = 0; i < 5; i++) {
+        int row[3] = {i * 10, i * 10 + 1, i * 10 + 2};
+        ragged_vector_push_row(&rv, row, 3);
+    }
+
+    ragged_vector_remove_rows(&rv, 1, 2);
+    ragged_vector_truncate_row(&rv, 0, 1);
+    t_assert(ragged_vector_len(&rv) == 3, "got %zu", ragged_vector_len(&rv));
+    t_assert(ragged_vector_values_len(&rv) == 7, "got %zu", ragged_vector_values_len(&rv));
+    t_assert(vector_len(ragged_vector_values(&rv)) == 15, "got %zu", vector_len(ragged_vector_values(&rv)));
+
+    ragged_vector_truncate_row(&rv, 2, 2);
+    int extra[2] = {99, 100};
+    ragged_vector_push(&rv, extra, 2);
+
+    ragged_vector_compact(&rv);
+    t_assert(vector_len(ragged_vector_values(&rv)) == 8, "got %zu", vector_len(ragged_vector_values(&rv)));
+    {
+        int expected[1] = {0};
+        t_assert_row(&rv, 0, expected, 1);
+    }
+    {
+        int expected[3] = {30, 31, 32};
+        t_assert_row(&rv, 1, expected, 3);
+    }
+    {
+        int expected[4] = {40, 41, 99, 100};
+        t_assert_row(&rv, 2, expected, 4);
+    }
+
+    {
+        // A compacted ragged vector round-trips through its flat parts.
+        vector_t values = vector_new(0, sizeof(int));
+        vector_extend(&values, ragged_vector_values(&rv));
+        vector_t rows = vector_new(0, sizeof(ragged_vector_row_t));
+        vector_extend(&rows, ragged_vector_rows(&rv));
+        ragged_vector_t copy = ragged_vector_from_parts(values, rows);
+        t_assert(ragged_vector_values_len(&copy) == 8, "got %zu", ragged_vector_values_len(&copy));
+        int expected[3] = {30, 31, 32};
+        t_assert_row(&copy, 1, expected, 3);
+        ragged_vector_delete(&copy);
+    }
+
+    ragged_vector_delete(&rv);
+}
+
+/** Checks that a row of `uint64_t`s holds 0, 3, 6, and so on, through its pointer. */
+static void t_assert_multiples_row(const ragged_vector_t *rv, size_t row, size_t expectedLength) {
+    size_t length;
+    const uint64_t *actual = ragged_vector_row(rv, row, &length);
+    t_assert(length == expectedLength, "row %zu: got %zu; want %zu", row, length, expectedLength);
+    for (size_t i = 0; i < length; i++) {
+        t_assert(actual[i] == 3 * i, "row %zu at %zu: got %llu", row, i, (unsigned long long)actual[i]);
+    }
+}
+
+void test_ragged_vector_incremental(void) {
+    {
+        // Values whose elements are still moving between allocations.
+        vector_t values = t_moving_vector(1600);
+        size_t length = vector_len(values);
+        vector_t rows = vector_new(0, sizeof(ragged_vector_row_t));
+        ragged_vector_row_t row = {.start = 0, .length = length};
+        vector_push(&rows, &row, 1);
+        ragged_vector_t rv = ragged_vector_from_parts(values, rows);
+        t_assert_multiples_row(&rv, 0, length);
+        ragged_vector_delete(&rv);
+    }
+
+    {
+        // Growing a row one element at a time, through several growths
+        // of an incremental values vector.
+        vector_t rows = vector_new(0, sizeof(ragged_vector_row_t));
+        ragged_vector_t rv = ragged_vector_from_parts(vector_new_incremental(0, sizeof(uint64_t)), rows);
+        ragged_vector_push_row(&rv, NULL, 0);
+        for (uint64_t i = 0; i < 2000; i++) {
+            uint64_t value = 3 * i;
+            ragged_vector_push(&rv, &value, 1);
+            t_assert_multiples_row(&rv, 0, i + 1);
+        }
+        uint64_t row[3] = {0, 3, 6};
+        for (size_t i = 1; i < 300; i++) {
+            ragged_vector_push_row(&rv, row, 3);
+            t_assert_multiples_row(&rv, i, 3);
+        }
+        t_assert_multiples_row(&rv, 0, 2000);
+        ragged_vector_delete(&rv);
+    }
+}
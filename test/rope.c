@@ -0,0 +1,169 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <collectc.h>
+
+#include "test.h"
+
+/** Checks that a rope holds the same elements as a vector of ints. */
+static void assert_rope_eq(const rope_t *rope, vector_t expected) {
+    t_assert(rope_len(rope) == vector_len(expected), "got %zu; want %zu", rope_len(rope), vector_len(expected));
+    rope_iter_t iter = rope_iter_new(rope);
+    size_t index = 0;
+    size_t length;
+    const int *chunk;
+    while ((chunk = rope_iter_next(&iter, &length)) != NULL) {
+        t_assert(length > 0, "want non-empty chunk at %zu", index);
+        for (size_t i = 0; i < length; i++, index++) {
+            int want = *(const int *)vector_at(expected, index);
+            t_assert(chunk[i] == want, "at %zu: got %d; want %d", index, chunk[i], want);
+        }
+    }
+    t_assert(index == vector_len(expected), "iterated %zu", index);
+    rope_iter_delete(&iter);
+}
+
+void test_rope_edits(void) {
+    rope_t rope = rope_new(sizeof(int));
+    vector_t expected = vector_new(0, sizeof(int));
+    t_assert(rope_len(&rope) == 0, "got %zu", rope_len(&rope));
+    t_assert(rope_at(&rope, 0) == NULL, "want out-of-bounds");
+
+    // Bulk inserts span many chunks.
+    int values[3000];
+    for (int i = 0; i < 3000; i++) {
+        values[i] = i;
+    }
+    rope_push(&rope, values, 3000);
+    vector_push(&expected, values, 3000);
+    rope_insert(&rope, 1500, values, 3000);
+    vector_insert(&expected, 1500, values, 3000);
+    assert_rope_eq(&rope, expected);
+
+    // Mix single-element edits throughout.
+    uint64_t seed = 1;
+    for (int i = 0; i < 5000; i++) {
+        seed = seed * 6364136223846793005 + 1442695040888963407;
+        size_t index = (size_t)(seed >> 33) % (vector_len(expected) + 1);
+        if (i % 3 == 2 && index < vector_len(expected)) {
+            // Occasionally remove a range across several chunks.
+            size_t maxCount = i % 500 == 497 ? 700 : 4;
+            size_t count = vector_len(expected) - index < maxCount ? vector_len(expected) - index : maxCount;
+            count = (size_t)(seed >> 13) % count + 1;
+            rope_remove(&rope, index, count);
+            vector_remove(expected, index, count);
+        } else {
+            rope_insert(&rope, index, &i, 1);
+            vector_insert(&expected, index, &i, 1);
+        }
+    }
+    assert_rope_eq(&rope, expected);
+    for (size_t i = 0; i < vector_len(expected); i += 97) {
+        int got = *(const int *)rope_at(&rope, i);
+        int want = *(const int *)vector_at(expected, i);
+        t_assert(got == want, "at %zu: got %d; want %d", i, got, want);
+    }
+    *(int *)rope_at_mut(&rope, 7) = -1;
+    *(int *)vector_at_mut(expected, 7) = -1;
+    assert_rope_eq(&rope, expected);
+
+    rope_remove(&rope, 0, rope_len(&rope));
+    t_assert(rope_len(&rope) == 0, "got %zu", rope_len(&rope));
+
+    rope_delete(&rope);
+    vector_delete(expected);
+}
+
+void test_rope_split_concat(void) {
+    rope_t rope = rope_new(sizeof(int));
+    vector_t expected = vector_new(0, sizeof(int));
+    for (int i = 0; i < 10000; i++) {
+        rope_push(&rope, &i, 1);
+        vector_push(&expected, &i, 1);
+    }
+
+    rope_t tail = rope_split(&rope, 6123);
+    t_assert(rope_len(&rope) == 6123, "got %zu", rope_len(&rope));
+    t_assert(rope_len(&tail) == 3877, "got %zu", rope_len(&tail));
+    t_assert(*(const int *)rope_at(&tail, 0) == 6123, "got %d", *(const int *)rope_at(&tail, 0));
+
+    // Swap the halves, and check against the vector.
+    rope_concat(&tail, &rope);
+    t_assert(rope_len(&rope) == 0, "got %zu", rope_len(&rope));
+    {
+        vector_t swapped = vector_new(0, sizeof(int));
+        vector_push(&swapped, vector_at(expected, 6123), 3877);
+        vector_push(&swapped, vector_first(expected), 6123);
+        assert_rope_eq(&tail, swapped);
+        vector_delete(swapped);
+    }
+
+    rope_t empty = rope_split(&tail, rope_len(&tail));
+    t_assert(rope_len(&empty) == 0, "got %zu", rope_len(&empty));
+    rope_concat(&empty, &tail);
+    t_assert(rope_len(&empty) == 10000, "got %zu", rope_len(&empty));
+
+    rope_delete(&empty);
+    rope_delete(&tail);
+    rope_delete(&rope);
+    vector_delete(expected);
+}
+
+/**
+ * Checks that a rope's chunks aren't mostly empty: each chunk of a
+ * rope with more than one is at least half full, and sized to fit.
+ */
+static void assert_rope_fill(const rope_t *rope) {
+    rope_iter_t iter = rope_iter_new(rope);
+    size_t chunks = 0;
+    size_t length;
+    while (rope_iter_next(&iter, &length) != NULL) {
+        chunks++;
+    }
+    rope_iter_delete(&iter);
+    size_t bytes = rope_len(rope) * sizeof(int);
+    size_t limit = (2 * bytes) + (chunks * 128);
+    t_assert(rope_allocation_size(rope) <= limit, "got %zu; want at most %zu", rope_allocation_size(rope), limit);
+}
+
+void test_rope_chunk_fill(void) {
+    rope_t rope = rope_new(sizeof(int));
+    vector_t expected = vector_new(0, sizeof(int));
+
+    // Random single-element inserts split full chunks over and over.
+    uint64_t seed = 7;
+    for (int i = 0; i < 20000; i++) {
+        seed = seed * 6364136223846793005 + 1442695040888963407;
+        size_t index = (size_t)(seed >> 33) % (vector_len(expected) + 1);
+        rope_insert(&rope, index, &i, 1);
+        vector_insert(&expected, index, &i, 1);
+    }
+    assert_rope_eq(&rope, expected);
+    assert_rope_fill(&rope);
+
+    // Removing most of the elements one at a time leaves sparse chunks
+    // to merge.
+    while (vector_len(expected) > 3000) {
+        seed = seed * 6364136223846793005 + 1442695040888963407;
+        size_t index = (size_t)(seed >> 33) % vector_len(expected);
+        rope_remove(&rope, index, 1);
+        vector_remove(expected, index, 1);
+    }
+    assert_rope_eq(&rope, expected);
+    assert_rope_fill(&rope);
+
+    // Splits leave sparse chunks at the ends of both ropes.
+    for (size_t at = 1; at < 3000; at += 211) {
+        rope_t tail = rope_split(&rope, at);
+        assert_rope_fill(&rope);
+        assert_rope_fill(&tail);
+        rope_concat(&rope, &tail);
+        rope_delete(&tail);
+    }
+    assert_rope_eq(&rope, expected);
+    assert_rope_fill(&rope);
+
+    rope_delete(&rope);
+    vector_delete(expected);
+}
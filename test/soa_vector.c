@@ -0,0 +1,72 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <collectc.h>
+
+#include "test.h"
+
+void test_soa_vector_columns(void) {
+    size_t elementSizes[3] = {sizeof(int64_t), sizeof(double), sizeof(char)};
+    soa_vector_t vec = soa_vector_new(0, 3, elementSizes);
+    t_assert(soa_vector_is_empty(vec), "got %zu", soa_vector_len(vec));
+    t_assert(soa_vector_column_count(vec) == 3, "got %zu", soa_vector_column_count(vec));
+
+    for (int i = 0; i < 10; i++) {
+        int64_t timestamp = 1000 + i;
+        double value = i * 0.5;
+        char flag = (char)('a' + i);
+        const void *row[3] = {&timestamp, &value, &flag};
+        soa_vector_push(&vec, row, 1);
+    }
+    t_assert(soa_vector_len(vec) == 10, "got %zu", soa_vector_len(vec));
+
+    {
+        int64_t timestamps[2] = {2000, 2001};
+        double values[2] = {100.0, 200.0};
+        char flags[2] = {'y', 'z'};
+        const void *rows[3] = {timestamps, values, flags};
+        soa_vector_push(&vec, rows, 2);
+        t_assert(soa_vector_len(vec) == 12, "got %zu", soa_vector_len(vec));
+    }
+
+    {
+        // Each column is contiguous, and aligned for bulk scans.
+        const int64_t *timestamps = soa_vector_column(vec, 0);
+        const double *values = soa_vector_column(vec, 1);
+        t_assert(((uintptr_t)values % _Alignof(max_align_t)) == 0, "misaligned %p", (const void *)values);
+        int64_t sum = 0;
+        for (size_t i = 0; i < soa_vector_len(vec); i++) {
+            sum += timestamps[i];
+        }
+        t_assert(sum == 10045 + 4001, "got %lld", (long long)sum);
+        t_assert(values[11] == 200.0, "got %f", values[11]);
+    }
+
+    {
+        soa_vector_remove(vec, 2, 3);
+        t_assert(soa_vector_len(vec) == 9, "got %zu", soa_vector_len(vec));
+        const int64_t *timestamp = soa_vector_at(vec, 0, 2);
+        const char *flag = soa_vector_at(vec, 2, 2);
+        t_assert(*timestamp == 1005, "got %lld", (long long)*timestamp);
+        t_assert(*flag == 'f', "got %c", *flag);
+        t_assert(soa_vector_at(vec, 1, 9) == NULL, "want out-of-bounds");
+    }
+
+    {
+        soa_vector_swap_remove(vec, 0);
+        t_assert(soa_vector_len(vec) == 8, "got %zu", soa_vector_len(vec));
+        int64_t timestamp;
+        double value;
+        char flag;
+        void *row[3] = {&timestamp, &value, &flag};
+        soa_vector_get(vec, 0, row);
+        t_assert(timestamp == 2001, "got %lld", (long long)timestamp);
+        t_assert(value == 200.0, "got %f", value);
+        t_assert(flag == 'z', "got %c", flag);
+    }
+
+    soa_vector_clear(vec);
+    t_assert(soa_vector_is_empty(vec), "got %zu", soa_vector_len(vec));
+    soa_vector_delete(vec);
+}
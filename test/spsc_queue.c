@@ -0,0 +1,82 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <collectc.h>
+
+#include "test.h"
+
+void test_spsc_queue_batches(void) {
+    spsc_queue_t *queue = spsc_queue_new(5, sizeof(int));
+    t_assert(spsc_queue_capacity(queue) == 8, "got %zu", spsc_queue_capacity(queue));
+    t_assert(spsc_queue_element_size(queue) == sizeof(int), "got %zu", spsc_queue_element_size(queue));
+
+    int values[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    int popped[10];
+    t_assert(spsc_queue_pop(queue, popped, 1) == 0, "want empty");
+
+    // Fill the queue, and check that the rest of the batch is rejected.
+    t_assert(spsc_queue_push(queue, values, 10) == 8, "want a partial push");
+    t_assert(spsc_queue_len(queue) == 8, "got %zu", spsc_queue_len(queue));
+    t_assert(spsc_queue_push(queue, values, 1) == 0, "want full");
+
+    // Pop part of it, then push a batch that wraps around.
+    t_assert(spsc_queue_pop(queue, popped, 5) == 5, "want 5 popped");
+    t_assert(spsc_queue_push(queue, &values[8], 2) == 2, "want 2 pushed");
+    size_t count = spsc_queue_pop(queue, popped, 10);
+    t_assert(count == 5, "got %zu", count);
+    int expected[5] = {5, 6, 7, 8, 9};
+    for (size_t i = 0; i < count; i++) {
+        t_assert(popped[i] == expected[i], "at %zu: got %d; want %d", i, popped[i], expected[i]);
+    }
+    t_assert(spsc_queue_len(queue) == 0, "got %zu", spsc_queue_len(queue));
+
+    spsc_queue_delete(queue);
+}
+
+static const unsigned THREADED_COUNT = 1000000;
+
+static void *spsc_queue_produce(void *context) {
+    spsc_queue_t *queue = context;
+    unsigned batch[37];
+    for (unsigned next = 0; next < THREADED_COUNT;) {
+        size_t count = THREADED_COUNT - next < 37 ? THREADED_COUNT - next : 37;
+        for (size_t i = 0; i < count; i++) {
+            batch[i] = next + (unsigned)i;
+        }
+        size_t pushed = spsc_queue_push(queue, batch, count);
+        if (pushed == 0) {
+            sched_yield();
+        }
+        next += (unsigned)pushed;
+    }
+    return NULL;
+}
+
+void test_spsc_queue_threads(void) {
+    spsc_queue_t *queue = spsc_queue_new(1024, sizeof(unsigned));
+    pthread_t producer;
+    t_assert(pthread_create(&producer, NULL, spsc_queue_produce, queue) == 0, "want thread");
+
+    // Every element arrives exactly once, in order.
+    unsigned expected = 0;
+    unsigned batch[64];
+    while (expected < THREADED_COUNT) {
+        size_t count = spsc_queue_pop(queue, batch, 64);
+        if (count == 0) {
+            sched_yield();
+        }
+        for (size_t i = 0; i < count; i++, expected++) {
+            t_assert(batch[i] == expected, "got %u; want %u", batch[i], expected);
+        }
+    }
+
+    pthread_join(producer, NULL);
+    t_assert(spsc_queue_len(queue) == 0, "got %zu", spsc_queue_len(queue));
+    spsc_queue_delete(queue);
+}
@@ -41,3 +41,16 @@ end:
     fflush(stderr);
     free(message);
 }
+
+vector_t t_moving_vector(size_t minLength) {
+    vector_t vec = vector_new_incremental(0, sizeof(uint64_t));
+    for (uint64_t value = 0;; value += 3) {
+        size_t capacity = vector_capacity(vec);
+        vector_push(&vec, &value, 1);
+        if (vector_len(vec) >= minLength && vector_capacity(vec) != capacity) {
+            break;
+        }
+    }
+    t_assert(vector_run_len(vec, 0) < vector_len(vec) / 2, "want most elements still moving");
+    return vec;
+}
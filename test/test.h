@@ -7,6 +7,8 @@
 
 #include <stdlib.h>
 
+#include <collectc.h>
+
 #define t_assert(cond, ...)                                                                                            \
     do {                                                                                                               \
         if (!(cond)) {                                                                                                 \
@@ -17,4 +19,11 @@
 
 void t_log(const char *func, int line, const char *expr, const char *format, ...);
 
+/**
+ * Returns an incremental vector of at least `minLength` `uint64_t`s,
+ * `0, 3, 6, ...`, that has just grown, so that most of its elements
+ * are still in its previous allocation.
+ */
+vector_t t_moving_vector(size_t minLength);
+
 #endif // COLLECTC_TEST_H_
@@ -0,0 +1,106 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <collectc.h>
+
+#include "test.h"
+
+void test_u64map_ops(void) {
+    u64map_t map = u64map_new(sizeof(uint32_t));
+    t_assert(u64map_is_empty(&map), "got %zu", u64map_len(&map));
+    t_assert(u64map_get(&map, 1) == NULL, "want null");
+    t_assert(!u64map_remove(&map, 0, NULL), "want missing");
+
+    for (uint64_t i = 0; i < 1000; i++) {
+        uint32_t value = (uint32_t)i;
+        t_assert(u64map_insert(&map, i * 1000003, &value), "%llu: want new", (unsigned long long)i);
+    }
+    // Key 0 is in the map, from `i = 0`.
+    t_assert(u64map_len(&map) == 1000, "got %zu", u64map_len(&map));
+    t_assert(u64map_contains(&map, 0), "want key 0");
+    t_assert(u64map_capacity(&map) >= 1000, "got %zu", u64map_capacity(&map));
+    for (uint64_t i = 0; i < 2000; i++) {
+        const uint32_t *value = u64map_get(&map, i * 1000003);
+        if (i < 1000) {
+            t_assert(value != NULL && *value == i, "%llu: want value", (unsigned long long)i);
+        } else {
+            t_assert(value == NULL, "%llu: want null", (unsigned long long)i);
+        }
+    }
+
+    uint32_t value = 7;
+    t_assert(!u64map_insert(&map, 0, &value), "want replaced");
+    t_assert(*(const uint32_t *)u64map_get(&map, 0) == 7, "got %u", *(const uint32_t *)u64map_get(&map, 0));
+    bool inserted;
+    uint32_t *count = u64map_get_or_insert(&map, UINT64_MAX, &inserted);
+    t_assert(inserted && *count == 0, "got %u", *count);
+    (*count)++;
+    count = u64map_get_or_insert(&map, UINT64_MAX, &inserted);
+    t_assert(!inserted && *count == 1, "got %u", *count);
+
+    size_t visited = 0;
+    bool sawZero = false;
+    u64map_iter_t iter = u64map_iter_new(&map);
+    uint64_t key;
+    void *entryValue;
+    while (u64map_iter_next(&iter, &key, &entryValue)) {
+        t_assert(u64map_get(&map, key) == entryValue, "%llu: want same value", (unsigned long long)key);
+        sawZero |= key == 0;
+        visited++;
+    }
+    t_assert(visited == 1001 && sawZero, "got %zu", visited);
+
+    t_assert(u64map_remove(&map, 0, &value) && value == 7, "got %u", value);
+    t_assert(!u64map_contains(&map, 0), "want missing");
+    u64map_reserve(&map, 10000);
+    t_assert(u64map_capacity(&map) >= 11000, "got %zu", u64map_capacity(&map));
+    t_assert(*(const uint32_t *)u64map_get(&map, UINT64_MAX) == 1, "want 1");
+    u64map_clear(&map);
+    t_assert(u64map_is_empty(&map), "got %zu", u64map_len(&map));
+    t_assert(!u64map_contains(&map, 1000003), "want missing");
+    u64map_delete(&map);
+}
+
+void test_u64map_removal(void) {
+    // Keys that are multiples of a large power of 2 have few distinct
+    // high bits after hashing, so they form long runs, and removals
+    // shift keys back across them and around the end of the table.
+    u64map_t map = u64map_new(sizeof(uint64_t));
+    bool present[700] = {false};
+    size_t length = 0;
+    uint64_t state = 7;
+    for (size_t step = 0; step < 30000; step++) {
+        state = state * 6364136223846793005 + 1442695040888963407;
+        uint64_t id = (state >> 33) % 700;
+        uint64_t key = id << 52 | id;
+        uint64_t value = ~key;
+        if ((state >> 21) % 5 < 2) {
+            bool removed = u64map_remove(&map, key, &value);
+            t_assert(removed == present[id], "step %zu: id %llu", step, (unsigned long long)id);
+            t_assert(!removed || value == ~key, "got %llx", (unsigned long long)value);
+            length -= removed;
+            present[id] = false;
+        } else {
+            bool inserted = u64map_insert(&map, key, &value);
+            t_assert(inserted == !present[id], "step %zu: id %llu", step, (unsigned long long)id);
+            length += inserted;
+            present[id] = true;
+        }
+        t_assert(u64map_len(&map) == length, "got %zu, want %zu", u64map_len(&map), length);
+    }
+    for (uint64_t id = 0; id < 700; id++) {
+        const uint64_t *value = u64map_get(&map, id << 52 | id);
+        t_assert((value != NULL) == present[id], "id %llu", (unsigned long long)id);
+        t_assert(value == NULL || *value == ~(id << 52 | id), "id %llu", (unsigned long long)id);
+    }
+    u64map_delete(&map);
+
+    // Maps with empty values work as sets.
+    u64map_t set = u64map_new(0);
+    for (uint64_t i = 0; i < 100; i++) {
+        u64map_insert(&set, i % 10, NULL);
+    }
+    t_assert(u64map_len(&set) == 10, "got %zu", u64map_len(&set));
+    u64map_delete(&set);
+}
@@ -3,6 +3,7 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <sys/types.h>
 
@@ -159,3 +160,220 @@ void test_vector_nops(void) {
 
     vector_delete(vec);
 }
+
+void test_vector_compact(void) {
+    vector_t vec = vector_new_compact(0, sizeof(int));
+    t_assert(vector_is_compact(vec), "want compact");
+    t_assert(vector_element_size(vec) == sizeof(int), "got %zu", vector_element_size(vec));
+    t_assert(vector_allocation_size(vec) == 0, "got %zu", vector_allocation_size(vec));
+
+    for (int i = 1; i <= 9; i++) {
+        vector_push(&vec, &i, 1);
+    }
+    t_assert(vector_is_compact(vec), "want compact after growing");
+    t_assert(vector_len(vec) == 9, "got %zu", vector_len(vec));
+
+    {
+        int newElements[2] = {10, 11};
+        vector_insert(&vec, 0, newElements, 2);
+        vector_remove(vec, 5, 1);
+        int expected[10] = {10, 11, 1, 2, 3, 5, 6, 7, 8, 9};
+        for (size_t i = 0; i < vector_len(vec); i++) {
+            const int *element = vector_at(vec, i);
+            t_assert(*element == expected[i], "at %zu: got %d; want %d", i, *element, expected[i]);
+        }
+        t_assert(*(const int *)vector_last(vec) == 9, "got %d", *(const int *)vector_last(vec));
+    }
+
+    {
+        vector_t regular = vector_new(vector_capacity(vec), sizeof(int));
+        vector_extend(&regular, vec);
+        t_assert(vector_len(regular) == vector_len(vec), "got %zu", vector_len(regular));
+        t_assert(
+            vector_allocation_size(vec) < vector_allocation_size(regular),
+            "got %zu; want less than %zu",
+            vector_allocation_size(vec),
+            vector_allocation_size(regular)
+        );
+        vector_delete(regular);
+    }
+
+    {
+        vector_t wide = vector_new_compact(3, sizeof(uint64_t));
+        uint64_t elements[3] = {1, UINT64_MAX, 3};
+        vector_push(&wide, elements, 3);
+        const uint64_t *first = vector_first(wide);
+        t_assert(((uintptr_t)first % _Alignof(uint64_t)) == 0, "misaligned %p", (const void *)first);
+        t_assert(first[1] == UINT64_MAX, "got %llu", (unsigned long long)first[1]);
+        vector_delete(wide);
+    }
+
+    vector_clear(vec);
+    t_assert(vector_is_empty(vec), "got %zu", vector_len(vec));
+    vector_delete(vec);
+}
+
+void test_vector_devector(void) {
+    vector_t vec = vector_new_devector(0, sizeof(int));
+    t_assert(vector_is_devector(vec), "want devector");
+    t_assert(!vector_is_compact(vec), "want not compact");
+
+    // Mirror pushes at both ends, and a few middle edits, on a vector.
+    vector_t expected = vector_new(0, sizeof(int));
+    for (int i = 0; i < 1000; i++) {
+        if (i % 3 == 0) {
+            vector_push(&vec, &i, 1);
+            vector_push(&expected, &i, 1);
+        } else {
+            vector_push_front(&vec, &i, 1);
+            vector_push_front(&expected, &i, 1);
+        }
+        if (i % 50 == 49) {
+            size_t index = vector_len(vec) / (size_t)(i % 7 + 2);
+            vector_insert(&vec, index, &i, 1);
+            vector_insert(&expected, index, &i, 1);
+            vector_remove(vec, index / 2, 3);
+            vector_remove(expected, index / 2, 3);
+        }
+    }
+    t_assert(vector_is_devector(vec), "want devector after growing");
+    t_assert(vector_len(vec) == vector_len(expected), "got %zu; want %zu", vector_len(vec), vector_len(expected));
+    {
+        // The elements stay contiguous.
+        const int *actual = vector_first(vec);
+        const int *want = vector_first(expected);
+        for (size_t i = 0; i < vector_len(vec); i++) {
+            t_assert(actual[i] == want[i], "at %zu: got %d; want %d", i, actual[i], want[i]);
+        }
+    }
+
+    // Use it as a FIFO queue.
+    for (int i = 0; i < 5000; i++) {
+        int front = *(const int *)vector_first(vec);
+        vector_remove(vec, 0, 1);
+        vector_push(&vec, &front, 1);
+    }
+    t_assert(vector_len(vec) == vector_len(expected), "got %zu", vector_len(vec));
+    for (size_t i = 0; i < vector_len(vec); i++) {
+        int got = *(const int *)vector_at(vec, i);
+        int want = *(const int *)vector_at(expected, (i + 5000) % vector_len(expected));
+        t_assert(got == want, "at %zu: got %d; want %d", i, got, want);
+    }
+    {
+        vector_t copy = vector_new(0, sizeof(int));
+        vector_extend(&copy, vec);
+        t_assert(vector_len(copy) == vector_len(vec), "got %zu", vector_len(copy));
+        vector_delete(copy);
+    }
+
+    vector_clear(vec);
+    int values[] = {1, 2, 3};
+    vector_push_front(&vec, values, 3);
+    t_assert(*(const int *)vector_first(vec) == 1, "got %d", *(const int *)vector_first(vec));
+    t_assert(*(const int *)vector_last(vec) == 3, "got %d", *(const int *)vector_last(vec));
+
+    vector_delete(expected);
+    vector_delete(vec);
+}
+
+void test_vector_incremental(void) {
+    vector_t vec = vector_new_incremental(0, sizeof(int));
+    t_assert(vector_is_incremental(vec), "want incremental");
+    t_assert(!vector_is_devector(vec), "want not devector");
+
+    // Mirror pushes, pops, and a few middle edits on a regular vector,
+    // checking elements on both sides of the ones that are still moving.
+    vector_t expected = vector_new(0, sizeof(int));
+    bool sawMoving = false;
+    for (int i = 0; i < 100000; i++) {
+        if (i % 97 == 0) {
+            int batch[5] = {i, i + 1, i + 2, i + 3, i + 4};
+            vector_push(&vec, batch, 5);
+            vector_push(&expected, batch, 5);
+        } else {
+            vector_push(&vec, &i, 1);
+            vector_push(&expected, &i, 1);
+        }
+        if (i % 11 == 0) {
+            vector_remove(vec, vector_len(vec) - 2, 2);
+            vector_remove(expected, vector_len(expected) - 2, 2);
+        }
+        if (i % 5000 == 4999) {
+            size_t index = vector_len(vec) / 3;
+            vector_insert(&vec, index, &i, 1);
+            vector_insert(&expected, index, &i, 1);
+            vector_remove(vec, index / 2, 3);
+            vector_remove(expected, index / 2, 3);
+        }
+        size_t length = vector_len(expected);
+        t_assert(vector_len(vec) == length, "got %zu; want %zu", vector_len(vec), length);
+        size_t probe = (size_t)i * 7919 % length;
+        t_assert(
+            *(const int *)vector_at(vec, probe) == *(const int *)vector_at(expected, probe),
+            "%d: at %zu: got %d",
+            i,
+            probe,
+            *(const int *)vector_at(vec, probe)
+        );
+        sawMoving |= vector_allocation_size(vec) > vector_capacity(vec) * sizeof(int) + 64;
+    }
+    t_assert(sawMoving, "want elements to move over several pushes");
+    t_assert(vector_equal(vec, expected), "want equal");
+    t_assert(*(const int *)vector_last(vec) == *(const int *)vector_last(expected), "wrong last");
+
+    {
+        // Slices and copies can span both allocations.
+        size_t length = vector_len(vec);
+        int *slice = malloc(length * sizeof(int));
+        vector_slice(vec, 0, slice, length);
+        vector_t copy = vector_new(0, sizeof(int));
+        vector_extend(&copy, vec);
+        for (size_t i = 0; i < length; i++) {
+            int want = *(const int *)vector_at(expected, i);
+            t_assert(slice[i] == want, "at %zu: got %d; want %d", i, slice[i], want);
+        }
+        t_assert(vector_equal(copy, expected), "want equal copy");
+        free(slice);
+        vector_delete(copy);
+    }
+
+    t_assert(vector_hash(vec) == vector_hash(expected), "want same hash");
+    {
+        // Hashing doesn't move elements, and doesn't depend on where the
+        // runs split.
+        vector_t moving = t_moving_vector(100000);
+        size_t length = vector_len(moving);
+        vector_t flat = vector_new(0, sizeof(uint64_t));
+        vector_extend(&flat, moving);
+        size_t firstRun = vector_run_len(moving, 0);
+        size_t runs = 0;
+        for (size_t index = 0; index < length; runs++) {
+            index += vector_run_len(moving, index);
+        }
+        t_assert(runs >= 2, "got %zu runs", runs);
+        t_assert(vector_run_len(flat, 0) == length, "got %zu", vector_run_len(flat, 0));
+        t_assert(vector_run_len(flat, length) == 0, "got %zu", vector_run_len(flat, length));
+        t_assert(vector_hash(moving) == vector_hash(flat), "want same hash");
+        t_assert(vector_run_len(moving, 0) == firstRun, "want elements still moving");
+        vector_delete(flat);
+        vector_delete(moving);
+    }
+    vector_make_contiguous(vec);
+    {
+        const int *actual = vector_first(vec);
+        const int *want = vector_first(expected);
+        for (size_t i = 0; i < vector_len(vec); i++) {
+            t_assert(actual[i] == want[i], "at %zu: got %d; want %d", i, actual[i], want[i]);
+        }
+    }
+    t_assert(vector_allocation_size(vec) <= vector_capacity(vec) * sizeof(int) + 64, "want one allocation");
+
+    vector_clear(vec);
+    t_assert(vector_is_empty(vec), "got %zu", vector_len(vec));
+    int value = 7;
+    vector_push(&vec, &value, 1);
+    t_assert(*(const int *)vector_first(vec) == 7, "got %d", *(const int *)vector_first(vec));
+
+    vector_delete(expected);
+    vector_delete(vec);
+}
@@ -0,0 +1,186 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include <collectc.h>
+
+#include "test.h"
+
+/** A task stored by value, with a check value to catch torn copies. */
+typedef struct work_deque_task {
+    uint64_t id;
+    uint64_t check;
+} work_deque_task_t;
+
+static work_deque_task_t work_deque_task(uint64_t id) {
+    return (work_deque_task_t){.id = id, .check = ~id * 0x9e3779b97f4a7c15};
+}
+
+void test_work_deque_ends(void) {
+    work_deque_t *deque = work_deque_new(0, sizeof(work_deque_task_t));
+    t_assert(work_deque_element_size(deque) == sizeof(work_deque_task_t), "got %zu", work_deque_element_size(deque));
+
+    work_deque_task_t task;
+    t_assert(!work_deque_pop(deque, &task), "want empty");
+    t_assert(!work_deque_steal(deque, &task), "want empty");
+
+    // Grow through several buffers.
+    for (uint64_t i = 0; i < 100; i++) {
+        work_deque_task_t pushed = work_deque_task(i);
+        work_deque_push(deque, &pushed);
+    }
+    t_assert(work_deque_len(deque) == 100, "got %zu", work_deque_len(deque));
+
+    // The owner pops the newest tasks; thieves steal the oldest.
+    t_assert(work_deque_pop(deque, &task) && task.id == 99, "got %llu", (unsigned long long)task.id);
+    t_assert(work_deque_steal(deque, &task) && task.id == 0, "got %llu", (unsigned long long)task.id);
+    t_assert(work_deque_steal(deque, &task) && task.id == 1, "got %llu", (unsigned long long)task.id);
+    for (uint64_t i = 98; i >= 2; i--) {
+        t_assert(work_deque_pop(deque, &task), "want task %llu", (unsigned long long)i);
+        t_assert(task.id == i && task.check == work_deque_task(i).check, "got %llu", (unsigned long long)task.id);
+    }
+    t_assert(!work_deque_pop(deque, &task), "want empty");
+    t_assert(work_deque_len(deque) == 0, "got %zu", work_deque_len(deque));
+
+    work_deque_delete(deque);
+}
+
+#define THIEF_COUNT 3
+#define TASK_COUNT 200000
+
+typedef struct work_deque_worker {
+    work_deque_t *deque;
+    atomic_bool *done;
+    size_t count;
+    uint64_t sum;
+    bool intact;
+} work_deque_worker_t;
+
+static void work_deque_take(work_deque_worker_t *worker, const work_deque_task_t *task) {
+    if (task->check != work_deque_task(task->id).check) {
+        worker->intact = false;
+    }
+    worker->count++;
+    worker->sum += task->id;
+}
+
+static void *work_deque_thieve(void *context) {
+    work_deque_worker_t *thief = context;
+    work_deque_task_t task;
+    for (;;) {
+        // Check whether the owner is done before stealing, so that
+        // nothing is left behind after the last failed steal.
+        bool done = atomic_load(thief->done);
+        if (work_deque_steal(thief->deque, &task)) {
+            work_deque_take(thief, &task);
+        } else if (done) {
+            return NULL;
+        }
+    }
+}
+
+void test_work_deque_threads(void) {
+    work_deque_t *deque = work_deque_new(4, sizeof(work_deque_task_t));
+    atomic_bool done = false;
+    work_deque_worker_t owner = {.deque = deque, .done = &done, .intact = true};
+    work_deque_worker_t thieves[THIEF_COUNT];
+    pthread_t threads[THIEF_COUNT];
+    for (size_t i = 0; i < THIEF_COUNT; i++) {
+        thieves[i] = owner;
+        t_assert(pthread_create(&threads[i], NULL, work_deque_thieve, &thieves[i]) == 0, "want thread");
+    }
+
+    // Push in bursts, and pop some of each burst, racing the thieves.
+    work_deque_task_t task;
+    for (uint64_t i = 0; i < TASK_COUNT; i++) {
+        task = work_deque_task(i);
+        work_deque_push(deque, &task);
+        if (i % 7 == 0) {
+            while (work_deque_pop(deque, &task)) {
+                work_deque_take(&owner, &task);
+            }
+        }
+    }
+    while (work_deque_pop(deque, &task)) {
+        work_deque_take(&owner, &task);
+    }
+    atomic_store(&done, true);
+
+    size_t count = owner.count;
+    uint64_t sum = owner.sum;
+    t_assert(owner.intact, "owner saw a torn task");
+    for (size_t i = 0; i < THIEF_COUNT; i++) {
+        pthread_join(threads[i], NULL);
+        t_assert(thieves[i].intact, "thief %zu saw a torn task", i);
+        count += thieves[i].count;
+        sum += thieves[i].sum;
+    }
+    t_assert(count == TASK_COUNT, "got %zu", count);
+    t_assert(sum == (uint64_t)TASK_COUNT * (TASK_COUNT - 1) / 2, "got %llu", (unsigned long long)sum);
+
+    work_deque_delete(deque);
+}
+
+void test_work_deque_grow(void) {
+    // Grow the deque from its smallest size in bursts while thieves
+    // steal, so that they race the owner across each grow.
+    work_deque_t *deque = work_deque_new(0, sizeof(work_deque_task_t));
+    size_t smallest = work_deque_allocation_size(deque);
+    atomic_bool done = false;
+    work_deque_worker_t owner = {.deque = deque, .done = &done, .intact = true};
+    work_deque_worker_t thieves[THIEF_COUNT];
+    pthread_t threads[THIEF_COUNT];
+    for (size_t i = 0; i < THIEF_COUNT; i++) {
+        thieves[i] = owner;
+        t_assert(pthread_create(&threads[i], NULL, work_deque_thieve, &thieves[i]) == 0, "want thread");
+    }
+    work_deque_task_t task;
+    uint64_t next = 0;
+    for (size_t burst = 1; next < TASK_COUNT; burst *= 2) {
+        for (size_t i = 0; i < burst && next < TASK_COUNT; i++, next++) {
+            task = work_deque_task(next);
+            work_deque_push(deque, &task);
+        }
+        while (work_deque_len(deque) > burst / 4 && work_deque_pop(deque, &task)) {
+            work_deque_take(&owner, &task);
+        }
+    }
+    while (work_deque_pop(deque, &task)) {
+        work_deque_take(&owner, &task);
+    }
+    atomic_store(&done, true);
+
+    size_t count = owner.count;
+    uint64_t sum = owner.sum;
+    t_assert(owner.intact, "owner saw a torn task");
+    for (size_t i = 0; i < THIEF_COUNT; i++) {
+        pthread_join(threads[i], NULL);
+        t_assert(thieves[i].intact, "thief %zu saw a torn task", i);
+        count += thieves[i].count;
+        sum += thieves[i].sum;
+    }
+    t_assert(count == TASK_COUNT, "got %zu", count);
+    t_assert(sum == (uint64_t)TASK_COUNT * (TASK_COUNT - 1) / 2, "got %llu", (unsigned long long)sum);
+
+    // With no thieves left, the next few pushes free every retired
+    // buffer, leaving one that's a power-of-2 multiple of the first.
+    for (uint64_t i = 0; i < 64; i++) {
+        task = work_deque_task(i);
+        work_deque_push(deque, &task);
+    }
+    size_t size = work_deque_allocation_size(deque);
+    size_t header = smallest - (2 * sizeof(work_deque_task_t));
+    size_t capacity = (size - header) / sizeof(work_deque_task_t);
+    t_assert(size > smallest, "want the deque to have grown");
+    t_assert(
+        (capacity & (capacity - 1)) == 0 && size == header + (capacity * sizeof(work_deque_task_t)),
+        "got %zu bytes; want one buffer",
+        size
+    );
+    work_deque_delete(deque);
+}